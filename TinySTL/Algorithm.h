@@ -2,10 +2,14 @@
 #define _ALGORITHM_H_
 
 #include <cstring>
+#include <new>
+#include <utility>
 
 #include "Utility.h"
 #include "Functional.h"
 #include "Iterator.h"
+#include "Construct.h"
+#include "AlgorithmSimd.h"
 
 namespace TinySTL
 {
@@ -232,13 +236,13 @@ namespace TinySTL
 	template<class RanIt, class Compare, class Distance, class T>
 	inline void __push_heap_aux(RanIt First, RanIt Last, Compare Comp, Distance*, T*)
 	{	// (Last - First) - 1为容器最尾端的坐标
-		__push_heap(First, Distance((Last - First) - 1), Distance(0), T(*(Last - 1)), Comp);
+		TinySTL::__push_heap(First, Distance((Last - First) - 1), Distance(0), T(*(Last - 1)), Comp);
 	}
 
 	template<class RanIt, class Compare>
 	inline void push_heap(RanIt First, RanIt Last, Compare Comp)
 	{	// 此函数被调用时，新元素应已置于底部容器的最尾端
-		__push_heap_aux(First, Last, distance_type(First), Comp, value_type(First));
+		TinySTL::__push_heap_aux(First, Last, distance_type(First), Comp, value_type(First));
 	}
 
 	template<class RanIt>
@@ -295,33 +299,33 @@ namespace TinySTL
 			holeIndex = secondChild - 1;
 		}
 		// 将欲调整值填入目前的洞号内，此时肯定满足次序特征
-		__push_heap(First, holeIndex, topIndex, Val, Comp);
+		TinySTL::__push_heap(First, holeIndex, topIndex, Val, Comp);
 	}
 
 	template<class RanIt, class T, class Compare, class Distance>
 	inline void __pop_heap(RanIt First, RanIt Last, RanIt Result, T Val, Distance*, Compare Comp)
 	{
 		*Result = *First; // 设定尾值为首值，于是尾值即为欲求结果，可由稍后再以底层容器之pop_back()取出尾值
-		__adjust_heap(First, Distance(0), Distance(Last - First), Val, Comp);
+		TinySTL::__adjust_heap(First, Distance(0), Distance(Last - First), Val, Comp);
 		// 以上欲重新整理heap，洞号为0（即为树根处），欲调整值为Val（原尾值）
 	}
 
 	template<class RanIt, class Compare, class T>
 	inline void __pop_heap_aux(RanIt First, RanIt Last, T*, Compare Comp)
 	{
-		__pop_heap(First, Last - 1, Last - 1, T(*(Last - 1)), distance_type(First), Comp);
+		TinySTL::__pop_heap(First, Last - 1, Last - 1, T(*(Last - 1)), distance_type(First), Comp);
 	}
 
 	template<class RanIt, class Compare>
 	inline void pop_heap(RanIt First, RanIt Last, Compare Comp)
 	{
-		__pop_heap_aux(First, Last, value_type(First), Comp);
+		TinySTL::__pop_heap_aux(First, Last, value_type(First), Comp);
 	}
 
 	template<class RanIt>
 	inline void pop_heap(RanIt First, RanIt Last)
 	{
-		__pop_heap_aux(First, Last, value_type(First), TinySTL::less<typename TinySTL::iterator_traits<RanIt>::value_type>());
+		TinySTL::__pop_heap_aux(First, Last, value_type(First), TinySTL::less<typename TinySTL::iterator_traits<RanIt>::value_type>());
 	}
 
 	/*
@@ -336,13 +340,13 @@ namespace TinySTL
 	{	// 没执行一次pop_heap()，极值即被放在尾端
 		// 扣除尾端再执行一次pop_heap()，次极值又被放在新尾端，一直到完成排序
 		while (Last - First > 1)
-			pop_heap(First, Last--); // 每执行pop_heap()一次，操作范围即退缩一格
+			TinySTL::pop_heap(First, Last--, Comp); // 每执行pop_heap()一次，操作范围即退缩一格
 	}
 
 	template <class RanIt>
 	void sort_heap(RanIt First, RanIt Last)
 	{
-		sort_heap(First, Last, TinySTL::less<typename TinySTL::iterator_traits<RanIt>::value_type>());
+		TinySTL::sort_heap(First, Last, TinySTL::less<typename TinySTL::iterator_traits<RanIt>::value_type>());
 	}
 
 	/*
@@ -400,7 +404,7 @@ namespace TinySTL
 
 		while (true)
 		{	// 重排以parent为首的子树，len是为了让__adjust_heap()判断操作范围
-			__adjust_heap(First, holeIndex, Len, T(*(First + holeIndex)), Comp);
+			TinySTL::__adjust_heap(First, holeIndex, Len, T(*(First + holeIndex)), Comp);
 			if (0 == holeIndex) return; // 走完根节点结束
 			holeIndex--; // 即将重排之子树的头部向前一个节点
 		}
@@ -409,13 +413,13 @@ namespace TinySTL
 	template<class RanIt, class Compare>
 	inline void make_heap(RanIt First, RanIt Last, Compare Comp)
 	{
-		__make_heap(First, Last, value_type(First), distance_type(First), Comp);
+		TinySTL::__make_heap(First, Last, value_type(First), distance_type(First), Comp);
 	}
 
 	template<class RanIt>
 	inline void make_heap(RanIt First, RanIt Last)
 	{
-		__make_heap(First, Last, value_type(First), distance_type(First), TinySTL::less<typename TinySTL::iterator_traits<RanIt>::value_type>());
+		TinySTL::__make_heap(First, Last, value_type(First), distance_type(First), TinySTL::less<typename TinySTL::iterator_traits<RanIt>::value_type>());
 	}
 
 	/*
@@ -527,18 +531,29 @@ namespace TinySTL
 	* find
 	* find first matching _Val
 	* Algorithm Complexity: O(N)
+	* 指针(包括vector的迭代器)区间上的整数、浮点数与指针以SIMD逐块比较
 	* ***********************************
 	*/
 	template <class InIt, class T>
 	inline InIt find(InIt First, const InIt Last, const T Val)
 	{
-		while (First != Last)
+		if constexpr (TinySTL::_Simd_value_search_v<InIt, T>)
 		{
-			if (*First == Val)
-				return First;
-			++First;
+			using E = typename TinySTL::iterator_traits<InIt>::value_type;
+			if (!TinySTL::_Simd_value_fits<E>(Val))
+				return Last;
+			return First + TinySTL::_Simd_find(First, static_cast<size_t>(Last - First), static_cast<E>(Val));
+		}
+		else
+		{
+			while (First != Last)
+			{
+				if (*First == Val)
+					return First;
+				++First;
+			}
+			return Last;
 		}
-		return Last;
 	}
 
 	/*
@@ -579,70 +594,13 @@ namespace TinySTL
 		return Last;
 	}
 
-	/*
-	* ***********************************
-	* find_end
-	* find last [_First2, _Last2) satisfying _Pred
-	* Algorithm Complexity: O(N*N)
-	* ***********************************
-	*/
-	template <class FwdIt1, class FwdIt2>
-	inline FwdIt1 find_end(FwdIt1 First1, FwdIt1 Last1, FwdIt2 First2, FwdIt2 Last2)
-	{
-		if (First2 == Last2)
-			return Last1;
-		FwdIt1 ret = Last1;
-		while (First1 != Last1)
-		{
-			FwdIt1 it1 = First1;
-			FwdIt1 it2 = First2;
-			while (*it1 == *it2)
-			{
-				++it1;
-				++it2;
-				if (it2 == Last2)
-				{
-					ret = First1;
-					break;
-				}
-				if (it1 == Last1)
-					return ret;
-			}
-		}
-		return ret;
-	}
-
-	template <class FwdIt1, class FwdIt2, class Pr>
-	inline FwdIt1 find_end(FwdIt1 First1, FwdIt1 Last1, FwdIt2 First2, FwdIt2 Last2, Pr Pred)
-	{
-		if (First2 == Last2)
-			return Last1;
-		FwdIt1 ret = Last1;
-		while (First1 != Last1)
-		{
-			FwdIt1 it1 = First1;
-			FwdIt1 it2 = First2;
-			while (Pred(*it1, *it2))
-			{
-				++it1;
-				++it2;
-				if (it2 == Last2)
-				{
-					ret = First1;
-					break;
-				}
-				if (it1 == Last1)
-					return ret;
-			}
-		}
-		return ret;
-	}
-
 	/*
 	* ***********************************
 	* find_first_of
 	* look for one of [_First2, _Last2) satisfying _Pred with element
 	* Algorithm Complexity: O(N*N)
+	* 不带谓词的版本在指针区间上按SIMD匹配：单字节元素对任意大小的集合都以常数时间判断一块，
+	* 其他元素在集合不多于16个时逐个比较后相或
 	* ***********************************
 	*/
 	template <class FwdIt1, class FwdIt2, class Pr>
@@ -663,6 +621,24 @@ namespace TinySTL
 	template <class FwdIt1, class FwdIt2>
 	inline FwdIt1 find_first_of(FwdIt1 First1, FwdIt1 Last1, FwdIt2 First2, FwdIt2 Last2)
 	{
+		using E = typename TinySTL::iterator_traits<FwdIt1>::value_type;
+		if constexpr (TinySTL::_Simd_value_search_v<FwdIt1, E>
+			&& TinySTL::is_same_v<E, TinySTL::remove_cv_t<typename TinySTL::iterator_traits<FwdIt2>::value_type>>)
+		{
+			size_t N = static_cast<size_t>(Last1 - First1);
+			if constexpr (sizeof(E) == 1)
+				return First1 + TinySTL::_Simd_find_any_byte(First1, N, First2, Last2);
+			else
+			{
+				E Set[16];
+				size_t M = 0;
+				for (FwdIt2 it = First2; it != Last2 && M <= 16; ++it, ++M)
+					if (M < 16)
+						Set[M] = *it;
+				if (M <= 16)
+					return First1 + TinySTL::_Simd_find_any(First1, N, static_cast<const E*>(Set), M);
+			}
+		}
 		while (First1 != Last1)
 		{
 			for (FwdIt2 it = First2; it != Last2; ++it)
@@ -717,11 +693,20 @@ namespace TinySTL
 	inline typename TinySTL::iterator_traits<InIt>::difference_type count(InIt First, InIt Last, const T& Val)
 	{
 		typename TinySTL::iterator_traits<InIt>::difference_type ret = 0;
-		while (First != Last)
+		if constexpr (TinySTL::_Simd_value_search_v<InIt, T>)
+		{	// 指针区间上的整数、浮点数与指针以SIMD逐块计数
+			using E = typename TinySTL::iterator_traits<InIt>::value_type;
+			if (TinySTL::_Simd_value_fits<E>(Val))
+				ret = static_cast<decltype(ret)>(TinySTL::_Simd_count(First, static_cast<size_t>(Last - First), static_cast<E>(Val)));
+		}
+		else
 		{
-			if (*First == Val)
-				++ret;
-			++First;
+			while (First != Last)
+			{
+				if (*First == Val)
+					++ret;
+				++First;
+			}
 		}
 		return ret;
 	}
@@ -751,17 +736,47 @@ namespace TinySTL
 	* mismatch
 	* return first position where two ranges differ
 	* Algorithm Complexity: O(N)
+	* 不带谓词的版本在两个指向同种整数或指针的指针区间上按字节成块比较
 	* ***********************************
 	*/
 	template <class InIt1, class InIt2>
 	TinySTL::pair<InIt1, InIt2> mismatch(InIt1 First1, InIt1 Last1, InIt2 First2)
 	{
-		while (First1 != Last1 && *First1 == *First2)
+		if constexpr (TinySTL::_Simd_bitwise_compare_v<InIt1, InIt2>)
 		{
-			++First1;
-			++First2;
+			size_t N = TinySTL::_Simd_mismatch(First1, First2, static_cast<size_t>(Last1 - First1));
+			return TinySTL::make_pair(First1 + N, First2 + N);
+		}
+		else
+		{
+			while (First1 != Last1 && *First1 == *First2)
+			{
+				++First1;
+				++First2;
+			}
+			return TinySTL::make_pair(First1, First2);
+		}
+	}
+
+	// 第二个区间给出终点，在较短的区间结束处停止
+	template <class InIt1, class InIt2>
+	TinySTL::pair<InIt1, InIt2> mismatch(InIt1 First1, InIt1 Last1, InIt2 First2, InIt2 Last2)
+	{
+		if constexpr (TinySTL::_Simd_bitwise_compare_v<InIt1, InIt2>)
+		{
+			size_t N1 = static_cast<size_t>(Last1 - First1), N2 = static_cast<size_t>(Last2 - First2);
+			size_t N = TinySTL::_Simd_mismatch(First1, First2, N1 < N2 ? N1 : N2);
+			return TinySTL::make_pair(First1 + N, First2 + N);
+		}
+		else
+		{
+			while (First1 != Last1 && First2 != Last2 && *First1 == *First2)
+			{
+				++First1;
+				++First2;
+			}
+			return TinySTL::make_pair(First1, First2);
 		}
-		return TinySTL::make_pair(First1, First2);
 	}
 
 	template <class InIt1, class InIt2, class Pr>
@@ -780,19 +795,44 @@ namespace TinySTL
 	* equal
 	* Test whether the elements in two ranges are equal
 	* Algorithm Complexity: O(N)
+	* 不带谓词的版本在两个指向同种整数或指针的指针区间上化为memcmp
 	* ***********************************
 	*/
 	template <class InIt1, class InIt2>
 	inline bool equal(InIt1 First1, InIt1 Last1, InIt2 First2)
 	{
-		while (First1 != Last1)
+		if constexpr (TinySTL::_Simd_bitwise_compare_v<InIt1, InIt2>)
+			return TinySTL::_Simd_equal(First1, First2, static_cast<size_t>(Last1 - First1));
+		else
+		{
+			while (First1 != Last1)
+			{
+				if (!(*First1 == *First2))
+					return false;
+				++First1;
+				++First2;
+			}
+			return true;
+		}
+	}
+
+	// 两个区间长度不同时不相等
+	template <class InIt1, class InIt2>
+	inline bool equal(InIt1 First1, InIt1 Last1, InIt2 First2, InIt2 Last2)
+	{
+		if constexpr (TinySTL::is_random_iter_v<InIt1> && TinySTL::is_random_iter_v<InIt2>)
 		{
-			if (!(*First1 == *First2))
+			if (Last1 - First1 != Last2 - First2)
 				return false;
-			++First1;
-			++First2;
+			return TinySTL::equal(First1, Last1, First2);
+		}
+		else
+		{
+			for (; First1 != Last1 && First2 != Last2; ++First1, (void)++First2)
+				if (!(*First1 == *First2))
+					return false;
+			return First1 == Last1 && First2 == Last2;
 		}
-		return true;
 	}
 
 	template <class InIt1, class InIt2, class Pr>
@@ -849,6 +889,8 @@ namespace TinySTL
 	* search
 	* Search range for subsequence
 	* Algorithm Complexity: O(N*N)
+	* 不带谓词的版本在单字节元素的随机访问区间上为O(N)：指针区间先用SIMD首末字节过滤，
+	* 过滤失效(逐个比较的候选过多)或不是指针时用Two-Way算法；也可以传入Searcher.h中的查找器
 	* ***********************************
 	*/
 	template <class InIt1, class InIt2, class Pr>
@@ -886,6 +928,8 @@ namespace TinySTL
 		}
 		else
 		{
+			if (First2 == Last2)
+				return First1;
 			while (First1 != Last1)
 			{
 				FwdIt1 it1 = First1;
@@ -905,6 +949,273 @@ namespace TinySTL
 		return Last1;
 	}
 
+	/*
+	* Two-Way算法(Crochemore-Perrin)：在临界分解处把needle分为左右两半，先从左向右比较右半，再从右向左比较左半，
+	* 失配时按已比较的长度或needle的周期移动，比较次数不超过2N，只用O(1)额外空间
+	* 只以下标访问两个区间，元素须能以<排序、以==比较
+	*/
+	struct _Two_way_factor
+	{
+		size_t _M_suffix; // 右半的起点
+		size_t _M_period; // 左半在右半中重复出现时为needle的周期，否则为右半失配后的移动距离
+		bool _M_periodic;
+	};
+
+	// 按<(Reverse时按>)的最大后缀的起点减一，Period为其周期
+	template <class RanIt>
+	inline size_t _Two_way_max_suffix(RanIt Needle, size_t M, bool Reverse, size_t& Period)
+	{
+		size_t MaxSuffix = static_cast<size_t>(-1), j = 0, k = 1, p = 1;
+		while (j + k < M)
+		{
+			const auto& a = Needle[j + k];
+			const auto& b = Needle[MaxSuffix + k];
+			if (Reverse ? b < a : a < b)
+			{
+				j += k;
+				k = 1;
+				p = j - MaxSuffix;
+			}
+			else if (a == b)
+			{
+				if (k != p)
+					++k;
+				else
+				{
+					j += p;
+					k = 1;
+				}
+			}
+			else
+			{
+				MaxSuffix = j++;
+				k = p = 1;
+			}
+		}
+		Period = p;
+		return MaxSuffix;
+	}
+
+	// 预处理needle，M >= 1
+	template <class RanIt>
+	inline _Two_way_factor _Two_way_prepare(RanIt Needle, size_t M)
+	{
+		_Two_way_factor F;
+		if (M < 3)
+		{
+			F._M_suffix = M - 1;
+			F._M_period = 1;
+		}
+		else
+		{	// 两种次序下的最大后缀中较靠后的一个即为临界分解
+			size_t P1, P2;
+			const size_t S1 = TinySTL::_Two_way_max_suffix(Needle, M, false, P1);
+			const size_t S2 = TinySTL::_Two_way_max_suffix(Needle, M, true, P2);
+			F._M_suffix = S2 + 1 < S1 + 1 ? S1 + 1 : S2 + 1;
+			F._M_period = S2 + 1 < S1 + 1 ? P1 : P2;
+		}
+		F._M_periodic = true;
+		for (size_t i = 0; i < F._M_suffix; ++i)
+		{
+			if (!(Needle[i] == Needle[i + F._M_period]))
+			{
+				F._M_periodic = false;
+				break;
+			}
+		}
+		if (!F._M_periodic)
+			F._M_period = TinySTL::max(F._M_suffix, M - F._M_suffix) + 1;
+		return F;
+	}
+
+	// 在Hay[0, N)中查找Needle[0, M)，返回第一次出现的下标，没有时返回N
+	template <class RanIt1, class RanIt2>
+	inline size_t _Two_way_search(RanIt1 Hay, size_t N, RanIt2 Needle, size_t M, const _Two_way_factor& F)
+	{
+		const size_t Suffix = F._M_suffix, Period = F._M_period;
+		size_t j = 0;
+		if (F._M_periodic)
+		{	// 移动一个周期后，needle的前M - Period个元素一定已经匹配，以Memory记住，不再重复比较
+			size_t Memory = 0;
+			while (j + M <= N)
+			{
+				size_t i = TinySTL::max(Suffix, Memory);
+				while (i < M && Needle[i] == Hay[i + j])
+					++i;
+				if (i >= M)
+				{
+					i = Suffix - 1;
+					while (Memory < i + 1 && Needle[i] == Hay[i + j])
+						--i;
+					if (i + 1 < Memory + 1)
+						return j;
+					j += Period;
+					Memory = M - Period;
+				}
+				else
+				{
+					j += i - Suffix + 1;
+					Memory = 0;
+				}
+			}
+		}
+		else
+		{
+			while (j + M <= N)
+			{
+				size_t i = Suffix;
+				while (i < M && Needle[i] == Hay[i + j])
+					++i;
+				if (i >= M)
+				{
+					i = Suffix - 1;
+					while (i != static_cast<size_t>(-1) && Needle[i] == Hay[i + j])
+						--i;
+					if (i == static_cast<size_t>(-1))
+						return j;
+					j += Period;
+				}
+				else
+					j += i - Suffix + 1;
+			}
+		}
+		return N;
+	}
+
+	// 两个区间都是随机访问的，元素是同一种单字节整数；_Byte_ptr_search_v还要求都是指针
+	template <class It1, class It2>
+	inline constexpr bool _Byte_search_v = TinySTL::is_random_iter_v<It1> && TinySTL::is_random_iter_v<It2>
+		&& TinySTL::is_same_v<TinySTL::remove_cv_t<typename TinySTL::iterator_traits<It1>::value_type>, TinySTL::remove_cv_t<typename TinySTL::iterator_traits<It2>::value_type>>
+		&& TinySTL::is_integral_v<typename TinySTL::iterator_traits<It1>::value_type> && sizeof(typename TinySTL::iterator_traits<It1>::value_type) == 1;
+
+	template <class It1, class It2>
+	inline constexpr bool _Byte_ptr_search_v = TinySTL::_Simd_bitwise_compare_v<It1, It2> && sizeof(typename TinySTL::iterator_traits<It1>::value_type) == 1
+		&& !TinySTL::is_same_v<typename TinySTL::iterator_traits<It1>::value_type, bool>;
+
+	// 单字节元素的指针区间，1 <= M <= N：先用SIMD首末字节过滤，过滤失效或没有SIMD时从尚未检查的位置起改用Two-Way
+	// F为预先算好的Two-Way分解，为空时需要才计算
+	template <class T>
+	inline size_t _Search_bytes(const T* Hay, size_t N, const T* Needle, size_t M, const _Two_way_factor* F = nullptr)
+	{
+		if (M == 1)
+			return TinySTL::_Simd_find(Hay, N, Needle[0]);
+		size_t Pos = 0;
+		const size_t R = TinySTL::_Simd_search_bytes(Hay, N, Needle, M, Pos);
+		if (R != N || Pos == N - M + 1)
+			return R;
+		const size_t Q = TinySTL::_Two_way_search(Hay + Pos, N - Pos, Needle, M, F ? *F : TinySTL::_Two_way_prepare(Needle, M));
+		return Q == N - Pos ? N : Pos + Q;
+	}
+
+	template <class FwdIt1, class FwdIt2>
+	inline FwdIt1 search(FwdIt1 First1, FwdIt1 Last1, FwdIt2 First2, FwdIt2 Last2)
+	{
+		if constexpr (TinySTL::_Byte_search_v<FwdIt1, FwdIt2>)
+		{
+			const size_t N = static_cast<size_t>(Last1 - First1), M = static_cast<size_t>(Last2 - First2);
+			if (M == 0)
+				return First1;
+			if (N < M)
+				return Last1;
+			size_t R;
+			if constexpr (TinySTL::_Byte_ptr_search_v<FwdIt1, FwdIt2>)
+				R = TinySTL::_Search_bytes(First1, N, First2, M);
+			else
+				R = TinySTL::_Two_way_search(First1, N, First2, M, TinySTL::_Two_way_prepare(First2, M));
+			return R == N ? Last1 : First1 + R;
+		}
+		else
+			return TinySTL::search(First1, Last1, First2, Last2, [](const auto& Left, const auto& Right) { return Left == Right; });
+	}
+
+	// 用查找器在[First, Last)中查找，查找器的构造与选择见Searcher.h
+	template <class FwdIt, class Searcher>
+	inline FwdIt search(FwdIt First, FwdIt Last, const Searcher& Srch)
+	{
+		return Srch(First, Last).first;
+	}
+
+	/*
+	* ***********************************
+	* find_end
+	* find last [_First2, _Last2) satisfying _Pred
+	* Algorithm Complexity: O(N*N)
+	* 双向迭代器从后向前逐个终点比较，前向迭代器只能反复向后search；
+	* 不带谓词的版本在单字节元素的指针区间上为O(N)：从后向前做SIMD首末字节过滤，过滤失效时对倒过来的两个区间用Two-Way
+	* ***********************************
+	*/
+	template <class FwdIt1, class FwdIt2, class Pr>
+	inline FwdIt1 find_end(FwdIt1 First1, FwdIt1 Last1, FwdIt2 First2, FwdIt2 Last2, Pr Pred)
+	{
+		if (First2 == Last2)
+			return Last1;
+		if constexpr (TinySTL::is_convertible_v<typename TinySTL::iterator_traits<FwdIt1>::iterator_category, TinySTL::bidirectional_iterator_tag>
+			&& TinySTL::is_convertible_v<typename TinySTL::iterator_traits<FwdIt2>::iterator_category, TinySTL::bidirectional_iterator_tag>)
+		{
+			for (FwdIt1 End = Last1;; --End)
+			{
+				FwdIt1 it1 = End;
+				FwdIt2 it2 = Last2;
+				for (;;)
+				{
+					if (it2 == First2)
+						return it1; // 整个needle都已匹配
+					if (it1 == First1)
+						return Last1; // 剩下的区间比needle短
+					--it1;
+					--it2;
+					if (!Pred(*it1, *it2))
+						break;
+				}
+			}
+		}
+		else
+		{
+			FwdIt1 ret = Last1;
+			for (;;)
+			{
+				FwdIt1 New = TinySTL::search(First1, Last1, First2, Last2, Pred);
+				if (New == Last1)
+					return ret;
+				ret = New;
+				First1 = ++New;
+			}
+		}
+	}
+
+	// 把指针区间倒过来按下标访问
+	template <class T>
+	struct _Reverse_index
+	{
+		const T* _M_last;
+		const T& operator[](size_t Off) const { return *(_M_last - 1 - Off); }
+	};
+
+	template <class FwdIt1, class FwdIt2>
+	inline FwdIt1 find_end(FwdIt1 First1, FwdIt1 Last1, FwdIt2 First2, FwdIt2 Last2)
+	{
+		if constexpr (TinySTL::_Byte_ptr_search_v<FwdIt1, FwdIt2>)
+		{
+			using T = typename TinySTL::iterator_traits<FwdIt1>::value_type;
+			const size_t N = static_cast<size_t>(Last1 - First1), M = static_cast<size_t>(Last2 - First2);
+			if (M == 0 || N < M)
+				return Last1;
+			size_t Pos = N - M + 1;
+			const size_t R = TinySTL::_Simd_search_last_bytes(First1, N, First2, M, Pos);
+			if (R != N)
+				return First1 + R;
+			if (Pos == 0)
+				return Last1;
+			// 起点在Pos之前的匹配都落在[First1, First1 + Pos + M - 1)中
+			const size_t H = Pos + M - 1;
+			const _Reverse_index<T> Hay{ First1 + H }, Needle{ Last2 };
+			const size_t Q = TinySTL::_Two_way_search(Hay, H, Needle, M, TinySTL::_Two_way_prepare(Needle, M));
+			return Q == H ? Last1 : First1 + (H - Q - M);
+		}
+		else
+			return TinySTL::find_end(First1, Last1, First2, Last2, [](const auto& Left, const auto& Right) { return Left == Right; });
+	}
+
 	/*
 	* ***********************************
 	* sort
@@ -922,10 +1233,10 @@ namespace TinySTL
 		{
 			for (BidIt Mid = First + 1; Mid != Last; ++Mid)
 			{
-				typename TinySTL::iterator_traits<BidIt>::value_type Val = *Mid;
+				typename TinySTL::iterator_traits<BidIt>::value_type Val = std::move(*Mid);
 				for (Prev = Mid; Prev != First && Pred(Val, *(Prev - 1)); --Prev)
-					*Prev = *(Prev - 1);
-				*Prev = Val;
+					*Prev = std::move(*(Prev - 1));
+				*Prev = std::move(Val);
 			}
 		}
 	}
@@ -956,6 +1267,7 @@ namespace TinySTL
 			{
 				TinySTL::make_heap(First, Last, Pred);
 				TinySTL::sort_heap(First, Last, Pred);
+				return;
 			}
 			Ideal = (Ideal >> 1) + (Ideal >> 2); // 每次乘0.75，即分割1.5*log2(N)次
 
@@ -974,8 +1286,8 @@ namespace TinySTL
 			}
 			TinySTL::swap(*Pfirst, *(Last - 2)); // 交换Pfirst是因为*Pfirst一定大于Mid，*Pfirst一定排在Mid右边
 			
-			_sort(First, Pfirst, Pfirst - First, Pred);
-			_sort(Plast, Last, Last - Plast, Pred);
+			_sort(First, Pfirst, Ideal, Pred); // 枢轴已在Pfirst处就位
+			_sort(Pfirst + 1, Last, Ideal, Pred);
 		}
 		else // 当元素个数小于32时，使用插入排序
 			insertionSort(First, Last, Pred);
@@ -1023,6 +1335,29 @@ namespace TinySTL
 			*First = Func();
 	}
 
+	/*
+	* ***********************************
+	* transform
+	* [_Dest, ...) = _Func(*[_First1, _Last1))，或_Func(*[_First1, _Last1), *[_First2, ...))
+	* Algorithm Complexity: O(N)
+	* ***********************************
+	*/
+	template <class InIt, class OutIt, class Fn>
+	inline OutIt transform(InIt First, InIt Last, OutIt Dest, Fn Func)
+	{
+		for (; First != Last; ++First, (void)++Dest)
+			*Dest = Func(*First);
+		return Dest;
+	}
+
+	template <class InIt1, class InIt2, class OutIt, class Fn>
+	inline OutIt transform(InIt1 First1, InIt1 Last1, InIt2 First2, OutIt Dest, Fn Func)
+	{
+		for (; First1 != Last1; ++First1, (void)++First2, ++Dest)
+			*Dest = Func(*First1, *First2);
+		return Dest;
+	}
+
 	/*
 	* ***********************************
 	* copy
@@ -1140,11 +1475,9 @@ namespace TinySTL
 		{
 			for (;;)
 			{
-				First = TinySTL::find_if_not(First, Last, Pred);
+				First = TinySTL::find_if_not(First, Last, Pred); // 从左往右找到第一个不符合Pred的元素
 				if (First == Last)
 					return First;
-				if (!Pred(*First)) // 从左往右找到第一个不符合Pred的元素
-					break;
 
 				do
 				{
@@ -1194,17 +1527,295 @@ namespace TinySTL
 		return true;
 	}
 
+	/*
+	* ***********************************
+	* lower_bound upper_bound
+	* find first element not before / after _Val in ordered range
+	* Algorithm Complexity: O(logN)
+	* ***********************************
+	*/
+	template <class FwdIt, class T, class Pr>
+	inline FwdIt lower_bound(FwdIt First, FwdIt Last, const T& Val, Pr Pred)
+	{
+		auto Count = TinySTL::distance(First, Last);
+		while (Count > 0)
+		{
+			const auto Step = Count / 2;
+			FwdIt Mid = First;
+			if constexpr (TinySTL::is_random_iter_v<FwdIt>)
+				Mid += Step;
+			else
+				for (auto I = Step; I > 0; --I)
+					++Mid;
+			if (Pred(*Mid, Val))
+			{
+				First = ++Mid;
+				Count -= Step + 1;
+			}
+			else
+				Count = Step;
+		}
+		return First;
+	}
+
+	template <class FwdIt, class T>
+	inline FwdIt lower_bound(FwdIt First, FwdIt Last, const T& Val)
+	{
+		return TinySTL::lower_bound(First, Last, Val, TinySTL::less<typename TinySTL::iterator_traits<FwdIt>::value_type>());
+	}
+
+	template <class FwdIt, class T, class Pr>
+	inline FwdIt upper_bound(FwdIt First, FwdIt Last, const T& Val, Pr Pred)
+	{
+		auto Count = TinySTL::distance(First, Last);
+		while (Count > 0)
+		{
+			const auto Step = Count / 2;
+			FwdIt Mid = First;
+			if constexpr (TinySTL::is_random_iter_v<FwdIt>)
+				Mid += Step;
+			else
+				for (auto I = Step; I > 0; --I)
+					++Mid;
+			if (!Pred(Val, *Mid))
+			{
+				First = ++Mid;
+				Count -= Step + 1;
+			}
+			else
+				Count = Step;
+		}
+		return First;
+	}
+
+	template <class FwdIt, class T>
+	inline FwdIt upper_bound(FwdIt First, FwdIt Last, const T& Val)
+	{
+		return TinySTL::upper_bound(First, Last, Val, TinySTL::less<typename TinySTL::iterator_traits<FwdIt>::value_type>());
+	}
+
+	/*
+	* ***********************************
+	* merge
+	* copy merging ranges, both ordered by _Pred
+	* Algorithm Complexity: O(N)
+	* 相等的元素先取第一个区间中的，因此是稳定的
+	* ***********************************
+	*/
+	template <class InIt1, class InIt2, class OutIt, class Pr>
+	inline OutIt merge(InIt1 First1, InIt1 Last1, InIt2 First2, InIt2 Last2, OutIt Dest, Pr Pred)
+	{
+		for (; First1 != Last1 && First2 != Last2; ++Dest)
+		{
+			if (Pred(*First2, *First1))
+			{
+				*Dest = *First2;
+				++First2;
+			}
+			else
+			{
+				*Dest = *First1;
+				++First1;
+			}
+		}
+		Dest = TinySTL::copy(First1, Last1, Dest);
+		return TinySTL::copy(First2, Last2, Dest);
+	}
+
+	template <class InIt1, class InIt2, class OutIt>
+	inline OutIt merge(InIt1 First1, InIt1 Last1, InIt2 First2, InIt2 Last2, OutIt Dest)
+	{
+		return TinySTL::merge(First1, Last1, First2, Last2, Dest, TinySTL::less<typename TinySTL::iterator_traits<InIt1>::value_type>());
+	}
+
+	template <class InIt, class OutIt>
+	inline OutIt _Move_range(InIt First, InIt Last, OutIt Dest)
+	{
+		for (; First != Last; ++First, (void)++Dest)
+			*Dest = std::move(*First);
+		return Dest;
+	}
+
+	// 与merge相同，但元素是移动而不是复制过去的，供排序内部使用
+	template <class InIt1, class InIt2, class OutIt, class Pr>
+	inline OutIt _Merge_move(InIt1 First1, InIt1 Last1, InIt2 First2, InIt2 Last2, OutIt Dest, Pr& Pred)
+	{
+		for (; First1 != Last1 && First2 != Last2; ++Dest)
+		{
+			if (Pred(*First2, *First1))
+			{
+				*Dest = std::move(*First2);
+				++First2;
+			}
+			else
+			{
+				*Dest = std::move(*First1);
+				++First1;
+			}
+		}
+		Dest = TinySTL::_Move_range(First1, Last1, Dest);
+		return TinySTL::_Move_range(First2, Last2, Dest);
+	}
+
+	/*
+	* ***********************************
+	* stable_sort
+	* sort preserving order of equivalents
+	* Algorithm Complexity: O(NlogN)
+	* 每_ISORT_MAX个元素先做插入排序，再自底向上两两归并，归并在原区间与临时区间之间来回进行；
+	* 临时区间见_Temp_buffer，与原区间等长
+	* ***********************************
+	*/
+	// 算法内部使用的临时区间
+	// 内存直接取自::operator new：alloc的空闲链表不是线程安全的，而多个线程可能同时排序各自的数据，
+	// 并行算法的各个任务也会同时分配临时区间
+	template <class T>
+	class _Temp_buffer
+	{
+	public:
+		// 分配N个元素并以*First为种子构造：Buf[0]由*First移动构造，Buf[I]由Buf[I - 1]移动构造，
+		// 最后把Buf[N - 1]移回*First(与SGI/libstdc++的_Temporary_buffer相同)。
+		// 只花N次移动，不复制整个区间，元素都处于被移动后的状态(如空string，不占用额外内存)，由使用者移动赋值覆盖；
+		// 元素可以平凡复制时只分配不构造，内容由使用者先写后读
+		template <class InIt>
+		_Temp_buffer(InIt First, size_t N) : _M_data(_S_allocate(N)), _M_size(0)
+		{
+			if constexpr (!TinySTL::is_trivially_copyable_v<T>)
+			{
+				if (N == 0)
+					return;
+				try
+				{
+					::new (static_cast<void*>(_M_data)) T(std::move(*First));
+					for (_M_size = 1; _M_size < N; ++_M_size)
+						::new (static_cast<void*>(_M_data + _M_size)) T(std::move(_M_data[_M_size - 1]));
+					*First = std::move(_M_data[N - 1]);
+				}
+				catch (...)
+				{
+					if (_M_size != 0)
+						*First = std::move(_M_data[_M_size - 1]);
+					_M_release();
+					throw;
+				}
+			}
+		}
+
+		// 分配N个元素，均复制自Val；元素可以平凡复制时只分配不构造
+		_Temp_buffer(size_t N, const T& Val) : _M_data(_S_allocate(N)), _M_size(0)
+		{
+			if constexpr (!TinySTL::is_trivially_copyable_v<T>)
+			{
+				try
+				{
+					for (; _M_size < N; ++_M_size)
+						::new (static_cast<void*>(_M_data + _M_size)) T(Val);
+				}
+				catch (...)
+				{
+					_M_release();
+					throw;
+				}
+			}
+		}
+
+		// 只分配不构造，只用于可以平凡复制的元素
+		explicit _Temp_buffer(size_t N) : _M_data(_S_allocate(N)), _M_size(0)
+		{
+			static_assert(TinySTL::is_trivially_copyable_v<T>, "uninitialized _Temp_buffer requires a trivially copyable type");
+		}
+
+		_Temp_buffer(const _Temp_buffer&) = delete;
+		_Temp_buffer& operator=(const _Temp_buffer&) = delete;
+
+		~_Temp_buffer() { _M_release(); }
+
+		T* _M_begin() const { return _M_data; }
+
+	private:
+		static T* _S_allocate(size_t N)
+		{
+			if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+				return static_cast<T*>(::operator new(N * sizeof(T), std::align_val_t(alignof(T))));
+			else
+				return static_cast<T*>(::operator new(N * sizeof(T)));
+		}
+
+		void _M_release()
+		{
+			TinySTL::destroy(_M_data, _M_data + _M_size);
+			if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+				::operator delete(_M_data, std::align_val_t(alignof(T)));
+			else
+				::operator delete(_M_data);
+		}
+
+	private:
+		T* _M_data;
+		size_t _M_size;
+	};
+
+	// Buf是至少与[First, Last)等长的临时区间
+	template <class RanIt, class T, class Pr>
+	inline void _Stable_sort_buffered(RanIt First, RanIt Last, T* Buf, Pr& Pred)
+	{
+		using Diff = typename TinySTL::iterator_traits<RanIt>::difference_type;
+		const Diff N = Last - First;
+		for (Diff I = 0; I < N; I += _ISORT_MAX) // 插入排序对相等的元素是稳定的
+			insertionSort(First + I, First + TinySTL::min(I + static_cast<Diff>(_ISORT_MAX), N), Pred);
+
+		bool InBuf = false; // 当前有序的各段在Buf中还是在原区间中
+		for (Diff Width = _ISORT_MAX; Width < N; Width *= 2, InBuf = !InBuf)
+		{
+			for (Diff I = 0; I < N; I += 2 * Width)
+			{
+				const Diff Mid = TinySTL::min(I + Width, N);
+				const Diff End = TinySTL::min(I + 2 * Width, N);
+				if (InBuf)
+					TinySTL::_Merge_move(Buf + I, Buf + Mid, Buf + Mid, Buf + End, First + I, Pred);
+				else
+					TinySTL::_Merge_move(First + I, First + Mid, First + Mid, First + End, Buf + I, Pred);
+			}
+		}
+		if (InBuf)
+			TinySTL::_Move_range(Buf, Buf + N, First);
+	}
+
+	template <class RanIt, class Pr>
+	inline void stable_sort(RanIt First, RanIt Last, Pr Pred)
+	{
+		using T = typename TinySTL::iterator_traits<RanIt>::value_type;
+		const auto N = Last - First;
+		if (N <= _ISORT_MAX)
+		{
+			insertionSort(First, Last, Pred);
+			return;
+		}
+		TinySTL::_Temp_buffer<T> Buf(First, static_cast<size_t>(N));
+		TinySTL::_Stable_sort_buffered(First, Last, Buf._M_begin(), Pred);
+	}
+
+	template <class RanIt>
+	inline void stable_sort(RanIt First, RanIt Last)
+	{
+		TinySTL::stable_sort(First, Last, TinySTL::less<typename TinySTL::iterator_traits<RanIt>::value_type>());
+	}
+
 	/*
 	* ***********************************
 	* compare
 	* order [_First1, _Last1) vs. [_First2, _Last2)
 	* Algorithm Complexity: O(N)
+	* 谓词为less时与lexicographical_compare一样成块比较
 	* ***********************************
 	*/
 	template <class InIt, class Pr>
 	inline bool compare(InIt First1, InIt Last1, InIt First2, InIt Last2, Pr Pred)
 	{
-		for (; First1 != Last1 && First2 && Last2; ++First1, (void)++First2)
+		if constexpr (TinySTL::_Simd_bitwise_compare_v<InIt, InIt>
+			&& TinySTL::is_same_v<Pr, TinySTL::less<typename TinySTL::iterator_traits<InIt>::value_type>>)
+			return TinySTL::_Simd_lexicographical_less(First1, static_cast<size_t>(Last1 - First1), First2, static_cast<size_t>(Last2 - First2));
+		for (; First1 != Last1 && First2 != Last2; ++First1, (void)++First2)
 		{
 			if (Pred(*First1, *First2))
 				return true;
@@ -1219,6 +1830,46 @@ namespace TinySTL
 	{
 		return compare(First1, Last1, First2, Last2, less<typename iterator_traits<InIt>::value_type>());
 	}
+
+	/*
+	* ***********************************
+	* lexicographical_compare
+	* order [_First1, _Last1) vs. [_First2, _Last2)，两个区间的迭代器类型可以不同
+	* Algorithm Complexity: O(N)
+	* 两个指向同种整数或指针的指针区间先成块找到第一对不相等的元素，无符号单字节直接用memcmp；
+	* 带谓词的版本只在谓词为less时如此
+	* ***********************************
+	*/
+	template <class InIt1, class InIt2, class Pr>
+	inline bool lexicographical_compare(InIt1 First1, InIt1 Last1, InIt2 First2, InIt2 Last2, Pr Pred)
+	{
+		if constexpr (TinySTL::_Simd_bitwise_compare_v<InIt1, InIt2>
+			&& TinySTL::is_same_v<Pr, TinySTL::less<typename TinySTL::iterator_traits<InIt1>::value_type>>)
+			return TinySTL::_Simd_lexicographical_less(First1, static_cast<size_t>(Last1 - First1), First2, static_cast<size_t>(Last2 - First2));
+		for (; First1 != Last1 && First2 != Last2; ++First1, (void)++First2)
+		{
+			if (Pred(*First1, *First2))
+				return true;
+			if (Pred(*First2, *First1))
+				return false;
+		}
+		return First1 == Last1 && First2 != Last2;
+	}
+
+	template <class InIt1, class InIt2>
+	inline bool lexicographical_compare(InIt1 First1, InIt1 Last1, InIt2 First2, InIt2 Last2)
+	{
+		if constexpr (TinySTL::_Simd_bitwise_compare_v<InIt1, InIt2>)
+			return TinySTL::_Simd_lexicographical_less(First1, static_cast<size_t>(Last1 - First1), First2, static_cast<size_t>(Last2 - First2));
+		for (; First1 != Last1 && First2 != Last2; ++First1, (void)++First2)
+		{
+			if (*First1 < *First2)
+				return true;
+			if (*First2 < *First1)
+				return false;
+		}
+		return First1 == Last1 && First2 != Last2;
+	}
 }
 
 #endif // !_ALGORITHM_H_
@@ -0,0 +1,1112 @@
+﻿#ifndef _ALGORITHM_SIMD_H_
+#define _ALGORITHM_SIMD_H_
+
+#include <cstddef>
+#include <cstring>
+
+#include "TypeTraits.h"
+
+/*
+* 连续区间上的SIMD算法核心，供Algorithm.h中的find/count/find_first_of等与Numeric.h中的求和按元素类型分派
+* x86上SSE2为基线；编译器能生成AVX2指令时(GCC/Clang借助target属性，MSVC直接可用)另编译一份AVX2版本，
+* 运行时检测CPU支持AVX2才使用。其他平台退回逐元素比较
+* 定义_TINYSTL_DISABLE_SIMD可关闭全部SIMD版本，定义_TINYSTL_DISABLE_AVX2只关闭AVX2版本
+*/
+#if !defined(_TINYSTL_DISABLE_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define _TINYSTL_SIMD_SSE2
+#include <emmintrin.h>
+#if !defined(_TINYSTL_DISABLE_AVX2) && (defined(_MSC_VER) || defined(__GNUC__))
+#define _TINYSTL_SIMD_AVX2
+#include <immintrin.h>
+#endif
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#if defined(_TINYSTL_SIMD_AVX2) && !defined(_MSC_VER)
+#define _TINYSTL_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define _TINYSTL_AVX2_TARGET
+#endif
+
+namespace TinySTL
+{
+	// 可以按位模式(或浮点比较指令)成块比较的元素类型：除bool外的整数、float、double与指针
+	template<class T>
+	inline constexpr bool _Simd_element_v = (is_integral_v<T> && !is_same_v<remove_cv_t<T>, bool>)
+		|| is_same_v<remove_cv_t<T>, float> || is_same_v<remove_cv_t<T>, double> || is_pointer_v<T>;
+
+	// It为指向这类元素的指针(vector的迭代器即是指针)，且与T比较可以化为与元素类型的值比较：T与元素类型相同，或二者都是整数
+	template<class It, class T>
+	inline constexpr bool _Simd_value_search_v = is_pointer_v<It> && _Simd_element_v<typename iterator_traits<It>::value_type>
+		&& is_same_v<typename iterator_traits<It>::value_type, remove_cv_t<typename iterator_traits<It>::value_type>>
+		&& (is_same_v<typename iterator_traits<It>::value_type, remove_cv_t<T>>
+			|| (is_integral_v<typename iterator_traits<It>::value_type> && is_integral_v<T>));
+
+	// 两个指针迭代器指向同一种整数或指针(可以一边带const)，逐元素相等即逐字节相等，可以按内存比较
+	template<class It1, class It2>
+	inline constexpr bool _Simd_bitwise_compare_v = is_pointer_v<It1> && is_pointer_v<It2>
+		&& is_same_v<typename iterator_traits<It1>::value_type, typename iterator_traits<It2>::value_type>
+		&& is_same_v<typename iterator_traits<It1>::value_type, remove_cv_t<typename iterator_traits<It1>::value_type>>
+		&& (is_integral_v<typename iterator_traits<It1>::value_type> || is_pointer_v<typename iterator_traits<It1>::value_type>);
+
+	// 整数__v转换为元素类型E后仍与原值相等时，元素等于__v当且仅当等于E(__v)；否则没有元素能等于__v
+	template<class E, class T>
+	inline bool _Simd_value_fits(const T& __v)
+	{
+		return static_cast<E>(__v) == __v;
+	}
+
+	// 最低的置位，__x不为0
+	inline unsigned _Simd_ctz(unsigned __x)
+	{
+#ifdef _MSC_VER
+		unsigned long __r;
+		_BitScanForward(&__r, __x);
+		return static_cast<unsigned>(__r);
+#else
+		return static_cast<unsigned>(__builtin_ctz(__x));
+#endif
+	}
+
+	// 最高的置位，__x不为0
+	inline unsigned _Simd_bsr(unsigned __x)
+	{
+#ifdef _MSC_VER
+		unsigned long __r;
+		_BitScanReverse(&__r, __x);
+		return static_cast<unsigned>(__r);
+#else
+		return 31u - static_cast<unsigned>(__builtin_clz(__x));
+#endif
+	}
+
+#ifdef _TINYSTL_SIMD_AVX2
+	inline bool _Simd_detect_avx2()
+	{
+#ifdef _MSC_VER
+		int __info[4];
+		__cpuid(__info, 0);
+		if (__info[0] < 7)
+			return false;
+		__cpuid(__info, 1);
+		const int __osxsave = 1 << 27, __avx = 1 << 28;
+		if ((__info[2] & (__osxsave | __avx)) != (__osxsave | __avx) || (_xgetbv(0) & 6) != 6)
+			return false; // 操作系统须保存YMM寄存器
+		__cpuidex(__info, 7, 0);
+		return (__info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2") != 0;
+#endif
+	}
+
+	// 只检测一次
+	inline bool _Simd_has_avx2()
+	{
+		static const bool __r = _Simd_detect_avx2();
+		return __r;
+	}
+#endif
+
+#ifdef _TINYSTL_SIMD_SSE2
+	/*
+	* 各种元素宽度的比较、广播与减法：比较结果中相等的元素所有位为1，即-1，以减法累加即得每个通道的命中次数
+	* SSE2没有64位整数的比较，以32位比较的结果与其两半交换后的结果相与
+	*/
+	template<size_t _Size>
+	struct _Simd_int_ops;
+
+	template<>
+	struct _Simd_int_ops<1>
+	{
+		static __m128i _Sse2_eq(__m128i __a, __m128i __b) { return _mm_cmpeq_epi8(__a, __b); }
+		static __m128i _Sse2_set1(unsigned long long __x) { return _mm_set1_epi8(static_cast<char>(__x)); }
+		static __m128i _Sse2_sub(__m128i __a, __m128i __b) { return _mm_sub_epi8(__a, __b); }
+#ifdef _TINYSTL_SIMD_AVX2
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_eq(__m256i __a, __m256i __b) { return _mm256_cmpeq_epi8(__a, __b); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_set1(unsigned long long __x) { return _mm256_set1_epi8(static_cast<char>(__x)); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_sub(__m256i __a, __m256i __b) { return _mm256_sub_epi8(__a, __b); }
+#endif
+	};
+
+	template<>
+	struct _Simd_int_ops<2>
+	{
+		static __m128i _Sse2_eq(__m128i __a, __m128i __b) { return _mm_cmpeq_epi16(__a, __b); }
+		static __m128i _Sse2_set1(unsigned long long __x) { return _mm_set1_epi16(static_cast<short>(__x)); }
+		static __m128i _Sse2_sub(__m128i __a, __m128i __b) { return _mm_sub_epi16(__a, __b); }
+#ifdef _TINYSTL_SIMD_AVX2
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_eq(__m256i __a, __m256i __b) { return _mm256_cmpeq_epi16(__a, __b); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_set1(unsigned long long __x) { return _mm256_set1_epi16(static_cast<short>(__x)); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_sub(__m256i __a, __m256i __b) { return _mm256_sub_epi16(__a, __b); }
+#endif
+	};
+
+	template<>
+	struct _Simd_int_ops<4>
+	{
+		static __m128i _Sse2_eq(__m128i __a, __m128i __b) { return _mm_cmpeq_epi32(__a, __b); }
+		static __m128i _Sse2_set1(unsigned long long __x) { return _mm_set1_epi32(static_cast<int>(__x)); }
+		static __m128i _Sse2_sub(__m128i __a, __m128i __b) { return _mm_sub_epi32(__a, __b); }
+#ifdef _TINYSTL_SIMD_AVX2
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_eq(__m256i __a, __m256i __b) { return _mm256_cmpeq_epi32(__a, __b); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_set1(unsigned long long __x) { return _mm256_set1_epi32(static_cast<int>(__x)); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_sub(__m256i __a, __m256i __b) { return _mm256_sub_epi32(__a, __b); }
+#endif
+	};
+
+	template<>
+	struct _Simd_int_ops<8>
+	{
+		static __m128i _Sse2_eq(__m128i __a, __m128i __b)
+		{
+			__m128i __m = _mm_cmpeq_epi32(__a, __b);
+			return _mm_and_si128(__m, _mm_shuffle_epi32(__m, _MM_SHUFFLE(2, 3, 0, 1)));
+		}
+		static __m128i _Sse2_set1(unsigned long long __x) { return _mm_set1_epi64x(static_cast<long long>(__x)); }
+		static __m128i _Sse2_sub(__m128i __a, __m128i __b) { return _mm_sub_epi64(__a, __b); }
+#ifdef _TINYSTL_SIMD_AVX2
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_eq(__m256i __a, __m256i __b) { return _mm256_cmpeq_epi64(__a, __b); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_set1(unsigned long long __x) { return _mm256_set1_epi64x(static_cast<long long>(__x)); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_sub(__m256i __a, __m256i __b) { return _mm256_sub_epi64(__a, __b); }
+#endif
+	};
+
+	// 整数与指针按位模式比较
+	template<class T>
+	struct _Simd_ops : _Simd_int_ops<sizeof(T)>
+	{
+		static unsigned long long _Bits(T __v)
+		{
+			unsigned long long __b = 0;
+			std::memcpy(&__b, &__v, sizeof(T));
+			return __b;
+		}
+	};
+
+	// 浮点数用浮点比较指令：NaN与任何值都不相等，+0.0与-0.0相等；计数时比较结果按同宽度的整数累加
+	template<>
+	struct _Simd_ops<float> : _Simd_int_ops<4>
+	{
+		static float _Bits(float __v) { return __v; }
+		static __m128i _Sse2_eq(__m128i __a, __m128i __b)
+		{
+			return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(__a), _mm_castsi128_ps(__b)));
+		}
+		static __m128i _Sse2_set1(float __x) { return _mm_castps_si128(_mm_set1_ps(__x)); }
+#ifdef _TINYSTL_SIMD_AVX2
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_eq(__m256i __a, __m256i __b)
+		{
+			return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(__a), _mm256_castsi256_ps(__b), _CMP_EQ_OQ));
+		}
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_set1(float __x) { return _mm256_castps_si256(_mm256_set1_ps(__x)); }
+#endif
+	};
+
+	template<>
+	struct _Simd_ops<double> : _Simd_int_ops<8>
+	{
+		static double _Bits(double __v) { return __v; }
+		static __m128i _Sse2_eq(__m128i __a, __m128i __b)
+		{
+			return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(__a), _mm_castsi128_pd(__b)));
+		}
+		static __m128i _Sse2_set1(double __x) { return _mm_castpd_si128(_mm_set1_pd(__x)); }
+#ifdef _TINYSTL_SIMD_AVX2
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_eq(__m256i __a, __m256i __b)
+		{
+			return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(__a), _mm256_castsi256_pd(__b), _CMP_EQ_OQ));
+		}
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_set1(double __x) { return _mm256_castpd_si256(_mm256_set1_pd(__x)); }
+#endif
+	};
+
+	inline __m128i _Sse2_load(const void* __p) { return _mm_loadu_si128(static_cast<const __m128i*>(__p)); }
+
+	/*
+	* SSE2版本
+	* 区间不短于一个向量时，末尾不足一个向量的部分以与前面重叠的一次读取处理
+	*/
+	template<class T>
+	inline size_t _Sse2_find(const T* __p, size_t __n, T __v)
+	{
+		using _Ops = _Simd_ops<T>;
+		const size_t __lanes = 16 / sizeof(T);
+		if (__n < __lanes)
+		{
+			for (size_t __i = 0; __i < __n; ++__i)
+				if (__p[__i] == __v)
+					return __i;
+			return __n;
+		}
+		const __m128i __x = _Ops::_Sse2_set1(_Ops::_Bits(__v));
+		size_t __i = 0;
+		for (; __i + 4 * __lanes <= __n; __i += 4 * __lanes)
+		{	// 四个比较结果相或后只做一次判断，命中的块在下面逐个向量定位
+			__m128i __e0 = _Ops::_Sse2_eq(_Sse2_load(__p + __i), __x);
+			__m128i __e1 = _Ops::_Sse2_eq(_Sse2_load(__p + __i + __lanes), __x);
+			__m128i __e2 = _Ops::_Sse2_eq(_Sse2_load(__p + __i + 2 * __lanes), __x);
+			__m128i __e3 = _Ops::_Sse2_eq(_Sse2_load(__p + __i + 3 * __lanes), __x);
+			if (_mm_movemask_epi8(_mm_or_si128(_mm_or_si128(__e0, __e1), _mm_or_si128(__e2, __e3))) != 0)
+				break;
+		}
+		for (; __i + __lanes <= __n; __i += __lanes)
+		{
+			unsigned __m = static_cast<unsigned>(_mm_movemask_epi8(_Ops::_Sse2_eq(_Sse2_load(__p + __i), __x)));
+			if (__m != 0)
+				return __i + _Simd_ctz(__m) / sizeof(T);
+		}
+		if (__i != __n)
+		{
+			__i = __n - __lanes;
+			unsigned __m = static_cast<unsigned>(_mm_movemask_epi8(_Ops::_Sse2_eq(_Sse2_load(__p + __i), __x)));
+			if (__m != 0)
+				return __i + _Simd_ctz(__m) / sizeof(T);
+		}
+		return __n;
+	}
+
+	// 累加器中各通道的计数之和，通道宽度为_Size字节；_Size为2时各通道不超过32767
+	template<size_t _Size>
+	inline size_t _Sse2_sum_lanes(__m128i __acc)
+	{
+		if constexpr (_Size == 1)
+			__acc = _mm_sad_epu8(__acc, _mm_setzero_si128());
+		else if constexpr (_Size == 2)
+			__acc = _mm_madd_epi16(__acc, _mm_set1_epi16(1));
+		if constexpr (_Size == 2 || _Size == 4)
+		{
+			__acc = _mm_add_epi32(__acc, _mm_shuffle_epi32(__acc, _MM_SHUFFLE(1, 0, 3, 2)));
+			__acc = _mm_add_epi32(__acc, _mm_shuffle_epi32(__acc, _MM_SHUFFLE(2, 3, 0, 1)));
+			return static_cast<size_t>(static_cast<unsigned>(_mm_cvtsi128_si32(__acc)));
+		}
+		else
+		{	// 两个64位通道
+			alignas(16) unsigned long long __lanes[2];
+			_mm_store_si128(reinterpret_cast<__m128i*>(__lanes), __acc);
+			return static_cast<size_t>(__lanes[0] + __lanes[1]);
+		}
+	}
+
+	template<class T>
+	inline size_t _Sse2_count(const T* __p, size_t __n, T __v)
+	{	// 每个通道的计数器宽度与元素相同，单字节每255块、其他每16383块汇总一次，避免溢出
+		using _Ops = _Simd_ops<T>;
+		const size_t __lanes = 16 / sizeof(T);
+		const size_t __limit = sizeof(T) == 1 ? 255 : 16383;
+		const __m128i __x = _Ops::_Sse2_set1(_Ops::_Bits(__v));
+		size_t __i = 0, __r = 0;
+		while (__i + __lanes <= __n)
+		{
+			__m128i __acc = _mm_setzero_si128();
+			for (size_t __k = 0; __k < __limit && __i + __lanes <= __n; ++__k, __i += __lanes)
+				__acc = _Ops::_Sse2_sub(__acc, _Ops::_Sse2_eq(_Sse2_load(__p + __i), __x));
+			__r += _Sse2_sum_lanes<sizeof(T)>(__acc);
+		}
+		for (; __i < __n; ++__i)
+			__r += __p[__i] == __v ? 1 : 0;
+		return __r;
+	}
+
+	// 与__set中任一元素相等，__m <= 16
+	template<class T>
+	inline size_t _Sse2_find_any(const T* __p, size_t __n, const T* __set, size_t __m)
+	{
+		using _Ops = _Simd_ops<T>;
+		const size_t __lanes = 16 / sizeof(T);
+		__m128i __xs[16];
+		for (size_t __k = 0; __k < __m; ++__k)
+			__xs[__k] = _Ops::_Sse2_set1(_Ops::_Bits(__set[__k]));
+		size_t __i = 0;
+		for (; __i + __lanes <= __n; __i += __lanes)
+		{
+			__m128i __in = _Sse2_load(__p + __i), __hit = _mm_setzero_si128();
+			for (size_t __k = 0; __k < __m; ++__k)
+				__hit = _mm_or_si128(__hit, _Ops::_Sse2_eq(__in, __xs[__k]));
+			unsigned __mask = static_cast<unsigned>(_mm_movemask_epi8(__hit));
+			if (__mask != 0)
+				return __i + _Simd_ctz(__mask) / sizeof(T);
+		}
+		for (; __i < __n; ++__i)
+			for (size_t __k = 0; __k < __m; ++__k)
+				if (__p[__i] == __set[__k])
+					return __i;
+		return __n;
+	}
+
+	// 两块内存中第一个不同的字节，__n不小于16；不同的字节所在的通道比较结果为0
+	inline size_t _Sse2_mismatch(const unsigned char* __a, const unsigned char* __b, size_t __n)
+	{
+		size_t __i = 0;
+		for (; __i + 64 <= __n; __i += 64)
+		{	// 四个比较结果相与后只做一次判断
+			__m128i __e0 = _mm_cmpeq_epi8(_Sse2_load(__a + __i), _Sse2_load(__b + __i));
+			__m128i __e1 = _mm_cmpeq_epi8(_Sse2_load(__a + __i + 16), _Sse2_load(__b + __i + 16));
+			__m128i __e2 = _mm_cmpeq_epi8(_Sse2_load(__a + __i + 32), _Sse2_load(__b + __i + 32));
+			__m128i __e3 = _mm_cmpeq_epi8(_Sse2_load(__a + __i + 48), _Sse2_load(__b + __i + 48));
+			if (_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(__e0, __e1), _mm_and_si128(__e2, __e3))) != 0xFFFF)
+				break;
+		}
+		for (; __i + 16 <= __n; __i += 16)
+		{
+			unsigned __m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_Sse2_load(__a + __i), _Sse2_load(__b + __i)))) ^ 0xFFFFu;
+			if (__m != 0)
+				return __i + _Simd_ctz(__m);
+		}
+		if (__i != __n)
+		{
+			__i = __n - 16;
+			unsigned __m = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_Sse2_load(__a + __i), _Sse2_load(__b + __i)))) ^ 0xFFFFu;
+			if (__m != 0)
+				return __i + _Simd_ctz(__m);
+		}
+		return __n;
+	}
+
+	/*
+	* 子串查找的首末字节过滤：以needle的首字节与末字节同时比较一块起始位置，两处都相等的位置才比较中间部分
+	* 从__pos开始检查起始位置，__m >= 2，且至少有16个起始位置；找到时返回其下标，否则返回__n
+	* 逐个比较的候选过多时(如重复字符构成的文本)提前停止，__pos给出尚未检查的第一个起始位置，由调用者换用线性的算法
+	*/
+	inline bool _Simd_search_over_budget(size_t __checked, size_t __candidates, size_t __m)
+	{
+		return __candidates * __m > 4 * __checked + 4096;
+	}
+
+	inline size_t _Sse2_search_bytes(const unsigned char* __h, size_t __n, const unsigned char* __nd, size_t __m, size_t& __pos)
+	{
+		const __m128i __f = _mm_set1_epi8(static_cast<char>(__nd[0])), __l = _mm_set1_epi8(static_cast<char>(__nd[__m - 1]));
+		const size_t __starts = __n - __m + 1, __begin = __pos;
+		size_t __candidates = 0;
+		for (size_t __i = __pos; __i < __starts; __i += 16)
+		{
+			unsigned __skip = 0;
+			if (__i + 16 > __starts)
+			{	// 最后一块与前面重叠，屏蔽已经检查过的起始位置
+				__skip = static_cast<unsigned>(__i - (__starts - 16));
+				__i = __starts - 16;
+			}
+			__m128i __e = _mm_and_si128(_mm_cmpeq_epi8(_Sse2_load(__h + __i), __f), _mm_cmpeq_epi8(_Sse2_load(__h + __i + __m - 1), __l));
+			unsigned __mask = static_cast<unsigned>(_mm_movemask_epi8(__e));
+			if (__skip != 0)
+				__mask &= ~0u << __skip;
+			for (; __mask != 0; __mask &= __mask - 1, ++__candidates)
+			{
+				size_t __k = __i + _Simd_ctz(__mask);
+				if (std::memcmp(__h + __k + 1, __nd + 1, __m - 2) == 0)
+					return __k;
+			}
+			if (_Simd_search_over_budget(__i + 16 - __begin, __candidates, __m))
+			{
+				__pos = __i + 16;
+				return __n;
+			}
+		}
+		__pos = __starts;
+		return __n;
+	}
+
+	/*
+	* 从后向前的首末字节过滤，供find_end使用：__pos为尚未检查的起始位置的上界(不含)，开始时为__n - __m + 1
+	* 找到时返回最后一个匹配的下标；提前停止时__pos之前的起始位置尚未检查；__m >= 1，至少有16个起始位置
+	*/
+	inline size_t _Sse2_search_last_bytes(const unsigned char* __h, size_t __n, const unsigned char* __nd, size_t __m, size_t& __pos)
+	{
+		const __m128i __f = _mm_set1_epi8(static_cast<char>(__nd[0])), __l = _mm_set1_epi8(static_cast<char>(__nd[__m - 1]));
+		const size_t __end = __pos;
+		size_t __candidates = 0, __i = __pos;
+		while (__i != 0)
+		{
+			size_t __b = __i - 16;
+			unsigned __keep = 0xFFFFu;
+			if (__i < 16)
+			{	// 最前一块与后面重叠
+				__b = 0;
+				__keep = (1u << __i) - 1;
+			}
+			__m128i __e = _mm_and_si128(_mm_cmpeq_epi8(_Sse2_load(__h + __b), __f), _mm_cmpeq_epi8(_Sse2_load(__h + __b + __m - 1), __l));
+			unsigned __mask = static_cast<unsigned>(_mm_movemask_epi8(__e)) & __keep;
+			for (; __mask != 0; __mask ^= 1u << _Simd_bsr(__mask), ++__candidates)
+			{
+				size_t __k = __b + _Simd_bsr(__mask);
+				if (__m <= 2 || std::memcmp(__h + __k + 1, __nd + 1, __m - 2) == 0)
+					return __k;
+			}
+			__i = __b;
+			if (_Simd_search_over_budget(__end - __i, __candidates, __m))
+				break;
+		}
+		__pos = __i;
+		return __n;
+	}
+
+#ifdef _TINYSTL_SIMD_AVX2
+	_TINYSTL_AVX2_TARGET inline __m256i _Avx2_load(const void* __p) { return _mm256_loadu_si256(static_cast<const __m256i*>(__p)); }
+
+	// 先把两个128位的半边相加(单字节先以_mm256_sad_epu8扩展为64位，避免溢出)
+	template<size_t _Size>
+	_TINYSTL_AVX2_TARGET inline size_t _Avx2_sum_lanes(__m256i __acc)
+	{
+		if constexpr (_Size == 1)
+		{
+			__acc = _mm256_sad_epu8(__acc, _mm256_setzero_si256());
+			return _Sse2_sum_lanes<8>(_mm_add_epi64(_mm256_castsi256_si128(__acc), _mm256_extracti128_si256(__acc, 1)));
+		}
+		__m128i __lo = _mm256_castsi256_si128(__acc), __hi = _mm256_extracti128_si256(__acc, 1);
+		if constexpr (_Size == 2)
+			return _Sse2_sum_lanes<2>(_mm_add_epi16(__lo, __hi));
+		else if constexpr (_Size == 4)
+			return _Sse2_sum_lanes<4>(_mm_add_epi32(__lo, __hi));
+		else
+			return _Sse2_sum_lanes<8>(_mm_add_epi64(__lo, __hi));
+	}
+
+	/*
+	* AVX2版本：调用前已确认区间不短于一个向量
+	* 主循环每次处理四个向量，四个比较结果相或后只做一次判断
+	*/
+	template<class T>
+	_TINYSTL_AVX2_TARGET inline size_t _Avx2_find(const T* __p, size_t __n, T __v)
+	{
+		using _Ops = _Simd_ops<T>;
+		const size_t __lanes = 32 / sizeof(T);
+		const __m256i __x = _Ops::_Avx2_set1(_Ops::_Bits(__v));
+		size_t __i = 0;
+		for (; __i + 4 * __lanes <= __n; __i += 4 * __lanes)
+		{
+			__m256i __e0 = _Ops::_Avx2_eq(_Avx2_load(__p + __i), __x);
+			__m256i __e1 = _Ops::_Avx2_eq(_Avx2_load(__p + __i + __lanes), __x);
+			__m256i __e2 = _Ops::_Avx2_eq(_Avx2_load(__p + __i + 2 * __lanes), __x);
+			__m256i __e3 = _Ops::_Avx2_eq(_Avx2_load(__p + __i + 3 * __lanes), __x);
+			if (!_mm256_testz_si256(_mm256_or_si256(_mm256_or_si256(__e0, __e1), _mm256_or_si256(__e2, __e3)), _mm256_set1_epi8(-1)))
+				break; // 命中的块在下面逐个向量定位
+		}
+		for (; __i + __lanes <= __n; __i += __lanes)
+		{
+			unsigned __m = static_cast<unsigned>(_mm256_movemask_epi8(_Ops::_Avx2_eq(_Avx2_load(__p + __i), __x)));
+			if (__m != 0)
+				return __i + _Simd_ctz(__m) / sizeof(T);
+		}
+		if (__i != __n)
+		{
+			__i = __n - __lanes;
+			unsigned __m = static_cast<unsigned>(_mm256_movemask_epi8(_Ops::_Avx2_eq(_Avx2_load(__p + __i), __x)));
+			if (__m != 0)
+				return __i + _Simd_ctz(__m) / sizeof(T);
+		}
+		return __n;
+	}
+
+	template<class T>
+	_TINYSTL_AVX2_TARGET inline size_t _Avx2_count(const T* __p, size_t __n, T __v)
+	{
+		using _Ops = _Simd_ops<T>;
+		const size_t __lanes = 32 / sizeof(T);
+		const size_t __limit = sizeof(T) == 1 ? 255 : 16383;
+		const __m256i __x = _Ops::_Avx2_set1(_Ops::_Bits(__v));
+		size_t __i = 0, __r = 0;
+		while (__i + __lanes <= __n)
+		{
+			__m256i __acc = _mm256_setzero_si256();
+			for (size_t __k = 0; __k < __limit && __i + __lanes <= __n; ++__k, __i += __lanes)
+				__acc = _Ops::_Avx2_sub(__acc, _Ops::_Avx2_eq(_Avx2_load(__p + __i), __x));
+			__r += _Avx2_sum_lanes<sizeof(T)>(__acc);
+		}
+		for (; __i < __n; ++__i)
+			__r += __p[__i] == __v ? 1 : 0;
+		return __r;
+	}
+
+	template<class T>
+	_TINYSTL_AVX2_TARGET inline size_t _Avx2_find_any(const T* __p, size_t __n, const T* __set, size_t __m)
+	{
+		using _Ops = _Simd_ops<T>;
+		const size_t __lanes = 32 / sizeof(T);
+		__m256i __xs[16];
+		for (size_t __k = 0; __k < __m; ++__k)
+			__xs[__k] = _Ops::_Avx2_set1(_Ops::_Bits(__set[__k]));
+		size_t __i = 0;
+		for (; __i + __lanes <= __n; __i += __lanes)
+		{
+			__m256i __in = _Avx2_load(__p + __i), __hit = _mm256_setzero_si256();
+			for (size_t __k = 0; __k < __m; ++__k)
+				__hit = _mm256_or_si256(__hit, _Ops::_Avx2_eq(__in, __xs[__k]));
+			unsigned __mask = static_cast<unsigned>(_mm256_movemask_epi8(__hit));
+			if (__mask != 0)
+				return __i + _Simd_ctz(__mask) / sizeof(T);
+		}
+		for (; __i < __n; ++__i)
+			for (size_t __k = 0; __k < __m; ++__k)
+				if (__p[__i] == __set[__k])
+					return __i;
+		return __n;
+	}
+
+	/*
+	* 任意字节集合的匹配(shufti)：字节按高低半字节查两张16项的表(vpshufb)，两次查表的结果相与不为0即属于集合
+	* 高半字节0~7与8~15各用一对表，每个集合元素在低半字节表中占一位，结果是精确的，与集合大小无关
+	*/
+	struct _Simd_byte_set
+	{
+		alignas(16) unsigned char _M_lo[2][16];
+		alignas(16) unsigned char _M_hi[2][16];
+
+		_Simd_byte_set() { std::memset(this, 0, sizeof(*this)); }
+		void _M_add(unsigned char __c)
+		{
+			_M_lo[__c >> 7][__c & 15] |= static_cast<unsigned char>(1u << ((__c >> 4) & 7));
+		}
+		void _M_finish()
+		{
+			for (int __h = 0; __h < 16; ++__h)
+				_M_hi[__h >> 3][__h] = static_cast<unsigned char>(1u << (__h & 7));
+		}
+	};
+
+	_TINYSTL_AVX2_TARGET inline unsigned _Avx2_byte_set_mask(__m256i __in, __m256i __lo0, __m256i __hi0, __m256i __lo1, __m256i __hi1)
+	{
+		const __m256i __nibble = _mm256_set1_epi8(0x0F);
+		__m256i __l = _mm256_and_si256(__in, __nibble);
+		__m256i __h = _mm256_and_si256(_mm256_srli_epi16(__in, 4), __nibble);
+		__m256i __r0 = _mm256_and_si256(_mm256_shuffle_epi8(__lo0, __l), _mm256_shuffle_epi8(__hi0, __h));
+		__m256i __r1 = _mm256_and_si256(_mm256_shuffle_epi8(__lo1, __l), _mm256_shuffle_epi8(__hi1, __h));
+		__m256i __miss = _mm256_cmpeq_epi8(_mm256_or_si256(__r0, __r1), _mm256_setzero_si256());
+		return ~static_cast<unsigned>(_mm256_movemask_epi8(__miss));
+	}
+
+	_TINYSTL_AVX2_TARGET inline size_t _Avx2_find_any_byte(const unsigned char* __p, size_t __n, const _Simd_byte_set& __set)
+	{
+		const __m256i __lo0 = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(__set._M_lo[0])));
+		const __m256i __lo1 = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(__set._M_lo[1])));
+		const __m256i __hi0 = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(__set._M_hi[0])));
+		const __m256i __hi1 = _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(__set._M_hi[1])));
+		size_t __i = 0;
+		for (; __i + 32 <= __n; __i += 32)
+		{
+			unsigned __m = _Avx2_byte_set_mask(_Avx2_load(__p + __i), __lo0, __hi0, __lo1, __hi1);
+			if (__m != 0)
+				return __i + _Simd_ctz(__m);
+		}
+		if (__i != __n)
+		{
+			__i = __n - 32;
+			unsigned __m = _Avx2_byte_set_mask(_Avx2_load(__p + __i), __lo0, __hi0, __lo1, __hi1);
+			if (__m != 0)
+				return __i + _Simd_ctz(__m);
+		}
+		return __n;
+	}
+	// __n不小于32
+	_TINYSTL_AVX2_TARGET inline size_t _Avx2_mismatch(const unsigned char* __a, const unsigned char* __b, size_t __n)
+	{
+		size_t __i = 0;
+		for (; __i + 128 <= __n; __i += 128)
+		{
+			__m256i __e0 = _mm256_cmpeq_epi8(_Avx2_load(__a + __i), _Avx2_load(__b + __i));
+			__m256i __e1 = _mm256_cmpeq_epi8(_Avx2_load(__a + __i + 32), _Avx2_load(__b + __i + 32));
+			__m256i __e2 = _mm256_cmpeq_epi8(_Avx2_load(__a + __i + 64), _Avx2_load(__b + __i + 64));
+			__m256i __e3 = _mm256_cmpeq_epi8(_Avx2_load(__a + __i + 96), _Avx2_load(__b + __i + 96));
+			if (!_mm256_testc_si256(_mm256_and_si256(_mm256_and_si256(__e0, __e1), _mm256_and_si256(__e2, __e3)), _mm256_set1_epi8(-1)))
+				break; // 有不同的字节，在下面逐个向量定位
+		}
+		for (; __i + 32 <= __n; __i += 32)
+		{
+			unsigned __m = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_Avx2_load(__a + __i), _Avx2_load(__b + __i))));
+			if (__m != 0)
+				return __i + _Simd_ctz(__m);
+		}
+		if (__i != __n)
+		{
+			__i = __n - 32;
+			unsigned __m = ~static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_Avx2_load(__a + __i), _Avx2_load(__b + __i))));
+			if (__m != 0)
+				return __i + _Simd_ctz(__m);
+		}
+		return __n;
+	}
+
+	// 至少有32个起始位置
+	_TINYSTL_AVX2_TARGET inline size_t _Avx2_search_bytes(const unsigned char* __h, size_t __n, const unsigned char* __nd, size_t __m, size_t& __pos)
+	{
+		const __m256i __f = _mm256_set1_epi8(static_cast<char>(__nd[0])), __l = _mm256_set1_epi8(static_cast<char>(__nd[__m - 1]));
+		const size_t __starts = __n - __m + 1, __begin = __pos;
+		size_t __candidates = 0;
+		for (size_t __i = __pos; __i < __starts; __i += 32)
+		{
+			unsigned __skip = 0;
+			if (__i + 32 > __starts)
+			{
+				__skip = static_cast<unsigned>(__i - (__starts - 32));
+				__i = __starts - 32;
+			}
+			__m256i __e = _mm256_and_si256(_mm256_cmpeq_epi8(_Avx2_load(__h + __i), __f), _mm256_cmpeq_epi8(_Avx2_load(__h + __i + __m - 1), __l));
+			unsigned __mask = static_cast<unsigned>(_mm256_movemask_epi8(__e));
+			if (__skip != 0)
+				__mask &= ~0u << __skip;
+			for (; __mask != 0; __mask &= __mask - 1, ++__candidates)
+			{
+				size_t __k = __i + _Simd_ctz(__mask);
+				if (std::memcmp(__h + __k + 1, __nd + 1, __m - 2) == 0)
+					return __k;
+			}
+			if (_Simd_search_over_budget(__i + 32 - __begin, __candidates, __m))
+			{
+				__pos = __i + 32;
+				return __n;
+			}
+		}
+		__pos = __starts;
+		return __n;
+	}
+
+	_TINYSTL_AVX2_TARGET inline size_t _Avx2_search_last_bytes(const unsigned char* __h, size_t __n, const unsigned char* __nd, size_t __m, size_t& __pos)
+	{
+		const __m256i __f = _mm256_set1_epi8(static_cast<char>(__nd[0])), __l = _mm256_set1_epi8(static_cast<char>(__nd[__m - 1]));
+		const size_t __end = __pos;
+		size_t __candidates = 0, __i = __pos;
+		while (__i != 0)
+		{
+			size_t __b = __i - 32;
+			unsigned __keep = ~0u;
+			if (__i < 32)
+			{
+				__b = 0;
+				__keep = (1u << __i) - 1;
+			}
+			__m256i __e = _mm256_and_si256(_mm256_cmpeq_epi8(_Avx2_load(__h + __b), __f), _mm256_cmpeq_epi8(_Avx2_load(__h + __b + __m - 1), __l));
+			unsigned __mask = static_cast<unsigned>(_mm256_movemask_epi8(__e)) & __keep;
+			for (; __mask != 0; __mask ^= 1u << _Simd_bsr(__mask), ++__candidates)
+			{
+				size_t __k = __b + _Simd_bsr(__mask);
+				if (__m <= 2 || std::memcmp(__h + __k + 1, __nd + 1, __m - 2) == 0)
+					return __k;
+			}
+			__i = __b;
+			if (_Simd_search_over_budget(__end - __i, __candidates, __m))
+				break;
+		}
+		__pos = __i;
+		return __n;
+	}
+#endif // _TINYSTL_SIMD_AVX2
+#endif // _TINYSTL_SIMD_SSE2
+
+	/*
+	* 分派：返回下标，没有找到时返回__n
+	*/
+	template<class T>
+	inline size_t _Simd_find(const T* __p, size_t __n, T __v)
+	{
+#ifdef _TINYSTL_SIMD_SSE2
+#ifdef _TINYSTL_SIMD_AVX2
+		if (__n >= 32 / sizeof(T) && _Simd_has_avx2())
+			return _Avx2_find(__p, __n, __v);
+#endif
+		return _Sse2_find(__p, __n, __v);
+#else
+		for (size_t __i = 0; __i < __n; ++__i)
+			if (__p[__i] == __v)
+				return __i;
+		return __n;
+#endif
+	}
+
+	template<class T>
+	inline size_t _Simd_count(const T* __p, size_t __n, T __v)
+	{
+#ifdef _TINYSTL_SIMD_SSE2
+#ifdef _TINYSTL_SIMD_AVX2
+		if (__n >= 32 / sizeof(T) && _Simd_has_avx2())
+			return _Avx2_count(__p, __n, __v);
+#endif
+		return _Sse2_count(__p, __n, __v);
+#else
+		size_t __r = 0;
+		for (size_t __i = 0; __i < __n; ++__i)
+			__r += __p[__i] == __v ? 1 : 0;
+		return __r;
+#endif
+	}
+
+	// 在[__p, __p + __n)中查找第一个属于__set[0, __m)的元素，__m <= 16
+	template<class T>
+	inline size_t _Simd_find_any(const T* __p, size_t __n, const T* __set, size_t __m)
+	{
+#ifdef _TINYSTL_SIMD_SSE2
+#ifdef _TINYSTL_SIMD_AVX2
+		if (__n >= 32 / sizeof(T) && _Simd_has_avx2())
+			return _Avx2_find_any(__p, __n, __set, __m);
+#endif
+		return _Sse2_find_any(__p, __n, __set, __m);
+#else
+		for (size_t __i = 0; __i < __n; ++__i)
+			for (size_t __k = 0; __k < __m; ++__k)
+				if (__p[__i] == __set[__k])
+					return __i;
+		return __n;
+#endif
+	}
+
+	// 单字节元素，集合大小不限：只有一个元素时即是find；AVX2用shufti，否则小集合逐个比较、大集合查256项的表
+	template<class T, class FwdIt>
+	inline size_t _Simd_find_any_byte(const T* __p, size_t __n, FwdIt __first2, FwdIt __last2)
+	{
+		static_assert(sizeof(T) == 1, "_Simd_find_any_byte requires a byte element type");
+		unsigned char __small[16];
+		size_t __m = 0;
+		for (FwdIt __it = __first2; __it != __last2 && __m <= 16; ++__it, ++__m)
+			if (__m < 16)
+				__small[__m] = static_cast<unsigned char>(*__it);
+		if (__m == 0)
+			return __n;
+		const unsigned char* __s = reinterpret_cast<const unsigned char*>(__p);
+		if (__m == 1)
+			return _Simd_find(__s, __n, __small[0]);
+#ifdef _TINYSTL_SIMD_AVX2
+		if (__n >= 32 && _Simd_has_avx2())
+		{
+			_Simd_byte_set __set;
+			for (FwdIt __it = __first2; __it != __last2; ++__it)
+				__set._M_add(static_cast<unsigned char>(*__it));
+			__set._M_finish();
+			return _Avx2_find_any_byte(__s, __n, __set);
+		}
+#endif
+		if (__m <= 16)
+			return _Simd_find_any(__s, __n, __small, __m);
+		bool __bits[256] = {};
+		for (FwdIt __it = __first2; __it != __last2; ++__it)
+			__bits[static_cast<unsigned char>(*__it)] = true;
+		for (size_t __i = 0; __i < __n; ++__i)
+			if (__bits[__s[__i]])
+				return __i;
+		return __n;
+	}
+
+	// 单字节元素的首末字节过滤，约定同_Sse2_search_bytes；起始位置不足一个向量或没有SIMD时不做任何检查，__pos不变
+	template<class T>
+	inline size_t _Simd_search_bytes(const T* __h, size_t __n, const T* __nd, size_t __m, size_t& __pos)
+	{
+		static_assert(sizeof(T) == 1, "_Simd_search_bytes requires a byte element type");
+#ifdef _TINYSTL_SIMD_SSE2
+		const unsigned char* __x = reinterpret_cast<const unsigned char*>(__h);
+		const unsigned char* __y = reinterpret_cast<const unsigned char*>(__nd);
+#ifdef _TINYSTL_SIMD_AVX2
+		if (__n - __m + 1 >= 32 && _Simd_has_avx2())
+			return _Avx2_search_bytes(__x, __n, __y, __m, __pos);
+#endif
+		if (__n - __m + 1 >= 16)
+			return _Sse2_search_bytes(__x, __n, __y, __m, __pos);
+#endif
+		return __n;
+	}
+
+	// 从后向前，约定同_Sse2_search_last_bytes；起始位置不足一个向量或没有SIMD时不做任何检查，__pos不变
+	template<class T>
+	inline size_t _Simd_search_last_bytes(const T* __h, size_t __n, const T* __nd, size_t __m, size_t& __pos)
+	{
+		static_assert(sizeof(T) == 1, "_Simd_search_last_bytes requires a byte element type");
+#ifdef _TINYSTL_SIMD_SSE2
+		const unsigned char* __x = reinterpret_cast<const unsigned char*>(__h);
+		const unsigned char* __y = reinterpret_cast<const unsigned char*>(__nd);
+#ifdef _TINYSTL_SIMD_AVX2
+		if (__n - __m + 1 >= 32 && _Simd_has_avx2())
+			return _Avx2_search_last_bytes(__x, __n, __y, __m, __pos);
+#endif
+		if (__n - __m + 1 >= 16)
+			return _Sse2_search_last_bytes(__x, __n, __y, __m, __pos);
+#endif
+		return __n;
+	}
+
+	// [__a, __a + __n)与[__b, __b + __n)中第一对不相等元素的下标，全部相等时返回__n
+	// 按字节比较后把第一个不同字节的位置换算为元素下标；不足一个向量时逐元素比较
+	template<class T>
+	inline size_t _Simd_mismatch(const T* __a, const T* __b, size_t __n)
+	{
+#ifdef _TINYSTL_SIMD_SSE2
+		const size_t __bytes = __n * sizeof(T);
+		const unsigned char* __x = reinterpret_cast<const unsigned char*>(__a);
+		const unsigned char* __y = reinterpret_cast<const unsigned char*>(__b);
+#ifdef _TINYSTL_SIMD_AVX2
+		if (__bytes >= 32 && _Simd_has_avx2())
+			return _Avx2_mismatch(__x, __y, __bytes) / sizeof(T);
+#endif
+		if (__bytes >= 16)
+			return _Sse2_mismatch(__x, __y, __bytes) / sizeof(T);
+#endif
+		size_t __i = 0;
+		while (__i < __n && __a[__i] == __b[__i])
+			++__i;
+		return __i;
+	}
+
+	template<class T>
+	inline bool _Simd_equal(const T* __a, const T* __b, size_t __n)
+	{
+		return __n == 0 || std::memcmp(__a, __b, __n * sizeof(T)) == 0;
+	}
+
+	// 字典序[__a, __a + __n1) < [__b, __b + __n2)：无符号单字节直接用memcmp，其他类型先找到第一对不相等的元素
+	template<class T>
+	inline bool _Simd_lexicographical_less(const T* __a, size_t __n1, const T* __b, size_t __n2)
+	{
+		const size_t __n = __n1 < __n2 ? __n1 : __n2;
+		if constexpr (sizeof(T) == 1 && is_integral_v<T> && static_cast<T>(-1) > static_cast<T>(0))
+		{
+			const int __r = __n == 0 ? 0 : std::memcmp(__a, __b, __n);
+			return __r != 0 ? __r < 0 : __n1 < __n2;
+		}
+		else
+		{
+			const size_t __i = _Simd_mismatch(__a, __b, __n);
+			return __i != __n ? __a[__i] < __b[__i] : __n1 < __n2;
+		}
+	}
+
+	/*
+	* ***********************************
+	* 求和与点积，供Numeric.h中的accumulate/reduce/transform_reduce分派
+	* ***********************************
+	* 每次循环累加到四个向量累加器中，最后把各通道相加；相加的次序与依次累加不同，
+	* 因此浮点数只用于允许重排的reduce/transform_reduce，整数(按补码回绕相加，次序不影响结果)也用于accumulate
+	* 求和的元素为4或8字节的整数、float或double，点积只用于float与double(SSE2没有32位整数的乘法)
+	*/
+	template<class T>
+	inline constexpr bool _Simd_sum_element_v = (is_integral_v<T> && !is_same_v<T, bool> && (sizeof(T) == 4 || sizeof(T) == 8))
+		|| is_same_v<T, float> || is_same_v<T, double>;
+
+	template<class T>
+	inline constexpr bool _Simd_dot_element_v = is_same_v<T, float> || is_same_v<T, double>;
+
+	// 整数以无符号数相加，避免有符号溢出
+	template<class T>
+	inline T _Simd_add_wrap(T __a, T __b)
+	{
+		if constexpr (is_integral_v<T>)
+			return static_cast<T>(static_cast<unsigned long long>(__a) + static_cast<unsigned long long>(__b));
+		else
+			return __a + __b;
+	}
+
+#ifdef _TINYSTL_SIMD_SSE2
+	template<class T, size_t _Size = sizeof(T)>
+	struct _Simd_arith_ops;
+
+	template<class T>
+	struct _Simd_arith_ops<T, 4>
+	{
+		using _V128 = __m128i;
+		static __m128i _Sse2_zero() { return _mm_setzero_si128(); }
+		static __m128i _Sse2_load(const T* __p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(__p)); }
+		static void _Sse2_store(T* __p, __m128i __v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(__p), __v); }
+		static __m128i _Sse2_add(__m128i __a, __m128i __b) { return _mm_add_epi32(__a, __b); }
+#ifdef _TINYSTL_SIMD_AVX2
+		using _V256 = __m256i;
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_zero() { return _mm256_setzero_si256(); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_load(const T* __p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(__p)); }
+		_TINYSTL_AVX2_TARGET static void _Avx2_store(T* __p, __m256i __v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(__p), __v); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_add(__m256i __a, __m256i __b) { return _mm256_add_epi32(__a, __b); }
+#endif
+	};
+
+	template<class T>
+	struct _Simd_arith_ops<T, 8>
+	{
+		using _V128 = __m128i;
+		static __m128i _Sse2_zero() { return _mm_setzero_si128(); }
+		static __m128i _Sse2_load(const T* __p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(__p)); }
+		static void _Sse2_store(T* __p, __m128i __v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(__p), __v); }
+		static __m128i _Sse2_add(__m128i __a, __m128i __b) { return _mm_add_epi64(__a, __b); }
+#ifdef _TINYSTL_SIMD_AVX2
+		using _V256 = __m256i;
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_zero() { return _mm256_setzero_si256(); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_load(const T* __p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(__p)); }
+		_TINYSTL_AVX2_TARGET static void _Avx2_store(T* __p, __m256i __v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(__p), __v); }
+		_TINYSTL_AVX2_TARGET static __m256i _Avx2_add(__m256i __a, __m256i __b) { return _mm256_add_epi64(__a, __b); }
+#endif
+	};
+
+	template<>
+	struct _Simd_arith_ops<float, 4>
+	{
+		using _V128 = __m128;
+		static __m128 _Sse2_zero() { return _mm_setzero_ps(); }
+		static __m128 _Sse2_load(const float* __p) { return _mm_loadu_ps(__p); }
+		static void _Sse2_store(float* __p, __m128 __v) { _mm_storeu_ps(__p, __v); }
+		static __m128 _Sse2_add(__m128 __a, __m128 __b) { return _mm_add_ps(__a, __b); }
+		static __m128 _Sse2_mul(__m128 __a, __m128 __b) { return _mm_mul_ps(__a, __b); }
+#ifdef _TINYSTL_SIMD_AVX2
+		using _V256 = __m256;
+		_TINYSTL_AVX2_TARGET static __m256 _Avx2_zero() { return _mm256_setzero_ps(); }
+		_TINYSTL_AVX2_TARGET static __m256 _Avx2_load(const float* __p) { return _mm256_loadu_ps(__p); }
+		_TINYSTL_AVX2_TARGET static void _Avx2_store(float* __p, __m256 __v) { _mm256_storeu_ps(__p, __v); }
+		_TINYSTL_AVX2_TARGET static __m256 _Avx2_add(__m256 __a, __m256 __b) { return _mm256_add_ps(__a, __b); }
+		_TINYSTL_AVX2_TARGET static __m256 _Avx2_mul(__m256 __a, __m256 __b) { return _mm256_mul_ps(__a, __b); }
+#endif
+	};
+
+	template<>
+	struct _Simd_arith_ops<double, 8>
+	{
+		using _V128 = __m128d;
+		static __m128d _Sse2_zero() { return _mm_setzero_pd(); }
+		static __m128d _Sse2_load(const double* __p) { return _mm_loadu_pd(__p); }
+		static void _Sse2_store(double* __p, __m128d __v) { _mm_storeu_pd(__p, __v); }
+		static __m128d _Sse2_add(__m128d __a, __m128d __b) { return _mm_add_pd(__a, __b); }
+		static __m128d _Sse2_mul(__m128d __a, __m128d __b) { return _mm_mul_pd(__a, __b); }
+#ifdef _TINYSTL_SIMD_AVX2
+		using _V256 = __m256d;
+		_TINYSTL_AVX2_TARGET static __m256d _Avx2_zero() { return _mm256_setzero_pd(); }
+		_TINYSTL_AVX2_TARGET static __m256d _Avx2_load(const double* __p) { return _mm256_loadu_pd(__p); }
+		_TINYSTL_AVX2_TARGET static void _Avx2_store(double* __p, __m256d __v) { _mm256_storeu_pd(__p, __v); }
+		_TINYSTL_AVX2_TARGET static __m256d _Avx2_add(__m256d __a, __m256d __b) { return _mm256_add_pd(__a, __b); }
+		_TINYSTL_AVX2_TARGET static __m256d _Avx2_mul(__m256d __a, __m256d __b) { return _mm256_mul_pd(__a, __b); }
+#endif
+	};
+
+	template<class T>
+	inline T _Sse2_sum(const T* __p, size_t __n)
+	{
+		using _Ops = _Simd_arith_ops<T>;
+		constexpr size_t __lanes = 16 / sizeof(T);
+		typename _Ops::_V128 __a0 = _Ops::_Sse2_zero(), __a1 = __a0, __a2 = __a0, __a3 = __a0;
+		size_t __i = 0;
+		for (; __i + 4 * __lanes <= __n; __i += 4 * __lanes)
+		{
+			__a0 = _Ops::_Sse2_add(__a0, _Ops::_Sse2_load(__p + __i));
+			__a1 = _Ops::_Sse2_add(__a1, _Ops::_Sse2_load(__p + __i + __lanes));
+			__a2 = _Ops::_Sse2_add(__a2, _Ops::_Sse2_load(__p + __i + 2 * __lanes));
+			__a3 = _Ops::_Sse2_add(__a3, _Ops::_Sse2_load(__p + __i + 3 * __lanes));
+		}
+		for (; __i + __lanes <= __n; __i += __lanes)
+			__a0 = _Ops::_Sse2_add(__a0, _Ops::_Sse2_load(__p + __i));
+		__a0 = _Ops::_Sse2_add(_Ops::_Sse2_add(__a0, __a1), _Ops::_Sse2_add(__a2, __a3));
+		T __t[__lanes], __r = T();
+		_Ops::_Sse2_store(__t, __a0);
+		for (size_t __k = 0; __k < __lanes; ++__k)
+			__r = _Simd_add_wrap(__r, __t[__k]);
+		for (; __i < __n; ++__i)
+			__r = _Simd_add_wrap(__r, __p[__i]);
+		return __r;
+	}
+
+	template<class T>
+	inline T _Sse2_dot(const T* __a, const T* __b, size_t __n)
+	{
+		using _Ops = _Simd_arith_ops<T>;
+		constexpr size_t __lanes = 16 / sizeof(T);
+		typename _Ops::_V128 __a0 = _Ops::_Sse2_zero(), __a1 = __a0, __a2 = __a0, __a3 = __a0;
+		size_t __i = 0;
+		for (; __i + 4 * __lanes <= __n; __i += 4 * __lanes)
+		{
+			__a0 = _Ops::_Sse2_add(__a0, _Ops::_Sse2_mul(_Ops::_Sse2_load(__a + __i), _Ops::_Sse2_load(__b + __i)));
+			__a1 = _Ops::_Sse2_add(__a1, _Ops::_Sse2_mul(_Ops::_Sse2_load(__a + __i + __lanes), _Ops::_Sse2_load(__b + __i + __lanes)));
+			__a2 = _Ops::_Sse2_add(__a2, _Ops::_Sse2_mul(_Ops::_Sse2_load(__a + __i + 2 * __lanes), _Ops::_Sse2_load(__b + __i + 2 * __lanes)));
+			__a3 = _Ops::_Sse2_add(__a3, _Ops::_Sse2_mul(_Ops::_Sse2_load(__a + __i + 3 * __lanes), _Ops::_Sse2_load(__b + __i + 3 * __lanes)));
+		}
+		for (; __i + __lanes <= __n; __i += __lanes)
+			__a0 = _Ops::_Sse2_add(__a0, _Ops::_Sse2_mul(_Ops::_Sse2_load(__a + __i), _Ops::_Sse2_load(__b + __i)));
+		__a0 = _Ops::_Sse2_add(_Ops::_Sse2_add(__a0, __a1), _Ops::_Sse2_add(__a2, __a3));
+		T __t[__lanes], __r = T();
+		_Ops::_Sse2_store(__t, __a0);
+		for (size_t __k = 0; __k < __lanes; ++__k)
+			__r = _Simd_add_wrap(__r, __t[__k]);
+		for (; __i < __n; ++__i)
+			__r += __a[__i] * __b[__i];
+		return __r;
+	}
+
+#ifdef _TINYSTL_SIMD_AVX2
+	template<class T>
+	_TINYSTL_AVX2_TARGET inline T _Avx2_sum(const T* __p, size_t __n)
+	{
+		using _Ops = _Simd_arith_ops<T>;
+		constexpr size_t __lanes = 32 / sizeof(T);
+		typename _Ops::_V256 __a0 = _Ops::_Avx2_zero(), __a1 = __a0, __a2 = __a0, __a3 = __a0;
+		size_t __i = 0;
+		for (; __i + 4 * __lanes <= __n; __i += 4 * __lanes)
+		{
+			__a0 = _Ops::_Avx2_add(__a0, _Ops::_Avx2_load(__p + __i));
+			__a1 = _Ops::_Avx2_add(__a1, _Ops::_Avx2_load(__p + __i + __lanes));
+			__a2 = _Ops::_Avx2_add(__a2, _Ops::_Avx2_load(__p + __i + 2 * __lanes));
+			__a3 = _Ops::_Avx2_add(__a3, _Ops::_Avx2_load(__p + __i + 3 * __lanes));
+		}
+		for (; __i + __lanes <= __n; __i += __lanes)
+			__a0 = _Ops::_Avx2_add(__a0, _Ops::_Avx2_load(__p + __i));
+		__a0 = _Ops::_Avx2_add(_Ops::_Avx2_add(__a0, __a1), _Ops::_Avx2_add(__a2, __a3));
+		T __t[__lanes], __r = T();
+		_Ops::_Avx2_store(__t, __a0);
+		for (size_t __k = 0; __k < __lanes; ++__k)
+			__r = _Simd_add_wrap(__r, __t[__k]);
+		for (; __i < __n; ++__i)
+			__r = _Simd_add_wrap(__r, __p[__i]);
+		return __r;
+	}
+
+	template<class T>
+	_TINYSTL_AVX2_TARGET inline T _Avx2_dot(const T* __a, const T* __b, size_t __n)
+	{
+		using _Ops = _Simd_arith_ops<T>;
+		constexpr size_t __lanes = 32 / sizeof(T);
+		typename _Ops::_V256 __a0 = _Ops::_Avx2_zero(), __a1 = __a0, __a2 = __a0, __a3 = __a0;
+		size_t __i = 0;
+		for (; __i + 4 * __lanes <= __n; __i += 4 * __lanes)
+		{
+			__a0 = _Ops::_Avx2_add(__a0, _Ops::_Avx2_mul(_Ops::_Avx2_load(__a + __i), _Ops::_Avx2_load(__b + __i)));
+			__a1 = _Ops::_Avx2_add(__a1, _Ops::_Avx2_mul(_Ops::_Avx2_load(__a + __i + __lanes), _Ops::_Avx2_load(__b + __i + __lanes)));
+			__a2 = _Ops::_Avx2_add(__a2, _Ops::_Avx2_mul(_Ops::_Avx2_load(__a + __i + 2 * __lanes), _Ops::_Avx2_load(__b + __i + 2 * __lanes)));
+			__a3 = _Ops::_Avx2_add(__a3, _Ops::_Avx2_mul(_Ops::_Avx2_load(__a + __i + 3 * __lanes), _Ops::_Avx2_load(__b + __i + 3 * __lanes)));
+		}
+		for (; __i + __lanes <= __n; __i += __lanes)
+			__a0 = _Ops::_Avx2_add(__a0, _Ops::_Avx2_mul(_Ops::_Avx2_load(__a + __i), _Ops::_Avx2_load(__b + __i)));
+		__a0 = _Ops::_Avx2_add(_Ops::_Avx2_add(__a0, __a1), _Ops::_Avx2_add(__a2, __a3));
+		T __t[__lanes], __r = T();
+		_Ops::_Avx2_store(__t, __a0);
+		for (size_t __k = 0; __k < __lanes; ++__k)
+			__r = _Simd_add_wrap(__r, __t[__k]);
+		for (; __i < __n; ++__i)
+			__r += __a[__i] * __b[__i];
+		return __r;
+	}
+#endif // _TINYSTL_SIMD_AVX2
+#endif // _TINYSTL_SIMD_SSE2
+
+	template<class T>
+	inline T _Simd_sum(const T* __p, size_t __n)
+	{
+#ifdef _TINYSTL_SIMD_SSE2
+#ifdef _TINYSTL_SIMD_AVX2
+		if (__n >= 32 / sizeof(T) && _Simd_has_avx2())
+			return _Avx2_sum(__p, __n);
+#endif
+		return _Sse2_sum(__p, __n);
+#else
+		T __r = T();
+		for (size_t __i = 0; __i < __n; ++__i)
+			__r = _Simd_add_wrap(__r, __p[__i]);
+		return __r;
+#endif
+	}
+
+	template<class T>
+	inline T _Simd_dot(const T* __a, const T* __b, size_t __n)
+	{
+#ifdef _TINYSTL_SIMD_SSE2
+#ifdef _TINYSTL_SIMD_AVX2
+		if (__n >= 32 / sizeof(T) && _Simd_has_avx2())
+			return _Avx2_dot(__a, __b, __n);
+#endif
+		return _Sse2_dot(__a, __b, __n);
+#else
+		T __r = T();
+		for (size_t __i = 0; __i < __n; ++__i)
+			__r += __a[__i] * __b[__i];
+		return __r;
+#endif
+	}
+}
+
+#endif // !_ALGORITHM_SIMD_H_
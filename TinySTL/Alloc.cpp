@@ -55,6 +55,51 @@ namespace TinySTL
 		return ptr;
 	}
 
+	void* alloc::allocate_chain(size_t bytes, size_t n)
+	{
+		obj* head = nullptr;
+		obj** tail = &head; // 指向链尾区块的free_list_link
+
+		if (bytes > alloc::__MAX_BYTES)
+		{
+			for (; n > 0; --n)
+			{
+				obj* current_obj = (obj*)malloc(bytes);
+				*tail = current_obj;
+				tail = &current_obj->free_list_link;
+			}
+			*tail = nullptr;
+			return head;
+		}
+
+		bytes = ROUND_UP(bytes);
+		// 先取走free_list中已有的区块
+		obj* volatile* my_free_list = free_list + FREELIST_INDEX(bytes);
+		for (; n > 0 && *my_free_list != nullptr; --n)
+		{
+			obj* current_obj = *my_free_list;
+			*my_free_list = current_obj->free_list_link;
+			*tail = current_obj;
+			tail = &current_obj->free_list_link;
+		}
+		// 其余区块直接从内存池切割，地址连续
+		while (n > 0)
+		{
+			size_t nobjs = n < alloc::__CHAIN_OBJ_NUM ? n : alloc::__CHAIN_OBJ_NUM;
+			char* chunk = chunk_alloc(bytes, nobjs); // nobjs可能降低
+			for (size_t i = 0; i < nobjs; ++i)
+			{
+				obj* current_obj = (obj*)(chunk + i * bytes);
+				*tail = current_obj;
+				tail = &current_obj->free_list_link;
+			}
+			n -= nobjs;
+		}
+		*tail = nullptr;
+
+		return head;
+	}
+
 	void* alloc::refill(size_t bytes)
 	{
 		size_t nobjs = alloc::__OBJ_NUM; // 预设20个区块，但不一定够
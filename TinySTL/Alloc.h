@@ -17,6 +17,7 @@ namespace TinySTL
 		static const size_t __MAX_BYTES = 128;					      // 小型区块的上限，超过__MAX_BYTES的内存块申请，直接从操作系统new
 		static const size_t __FREE_LIST_SIZE = __MAX_BYTES / __ALIGN; // free_lists的个数
 		static const size_t __OBJ_NUM = 20;						      // 每次增加的节点数，即每个free_lists一次申请 20*当前负责字节数大小*2 的内存空间
+		static const size_t __CHAIN_OBJ_NUM = 256;				      // allocate_chain每次向内存池切割的区块数上限
 
 	private:
 		// 将申请新的内存块时计算大小的追加量(bytes >> 4)上调至8的倍数，即对齐8位
@@ -51,6 +52,9 @@ namespace TinySTL
 		static void* allocate(size_t bytes);                               // 内存空间分配
 		static void deallocate(void* ptr, size_t bytes);                   // 内存空间的回收
 		static void* reallocate(void* ptr, size_t old_sz, size_t new_sz);  // 将已经分配的空间大小重新分配为new_sz
+		// 一次取得n个大小为bytes的区块，以每个区块首个指针大小的字段串成单链表，返回链首
+		// 每个区块仍须以deallocate(ptr, bytes)逐个归还；小型区块尽量由内存池连续切割，不逐个经过free_list
+		static void* allocate_chain(size_t bytes, size_t n);
 
 	private:
 		// 自建内存池
@@ -69,6 +73,8 @@ namespace TinySTL
 		static T* allocate(void) { return (T*)Alloc::allocate(sizeof(T)); }
 		static void deallocate(T* p, size_t n) { if (0 != n) Alloc::deallocate(p, n * sizeof(T)); }
 		static void deallocate(T* p) { Alloc::deallocate(p, sizeof(T)); }
+		static T* allocate_chain(size_t n) { return 0 == n ? 0 : (T*)Alloc::allocate_chain(sizeof(T), n); }
+		static T* chain_next(T* p) { return *(T**)p; } // allocate_chain所得链表中的下一区块
 	};
 
 }
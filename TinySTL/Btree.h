@@ -0,0 +1,1010 @@
+﻿#ifndef _BTREE_H_
+#define _BTREE_H_
+
+#include <utility>
+
+#include "Iterator.h"
+#include "Allocator.h"
+#include "Construct.h"
+#include "Utility.h"
+#include "Algorithm.h"
+#include "ReserverseIterator.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* _Btree : 节点按cache line组织的B树
+	* ***********************************
+	* 每个节点连续存放多个元素，查找时在节点内二分，再沿孩子下降一层。元素都放在叶节点中，树高只有红黑树的几分之一，
+	* 每层在节点内的比较落在同一组cache line上，查找的cache miss随之减少。
+	* _NodeBytes为叶节点大小的目标值，默认256字节(4条cache line)，节点内的元素个数由它与sizeof(_Value)推出(3 ~ 255)
+	*
+	* 与_Rb_tree的接口相同(insert_unique/insert_equal/_M_insert_before/erase/find/lower_bound/upper_bound/equal_range)，
+	* 可以直接替换为上层容器的底层结构，但有以下区别：
+	*   元素会在节点之间移动，任何插入、删除都使所有迭代器、指针与引用失效(erase返回的迭代器除外)
+	*   元素须可移动构造，且移动构造不抛出异常
+	*/
+
+	// 节点内的元素个数
+	template<class _Value, size_t _NodeBytes>
+	struct _Btree_node_slots
+	{
+		enum : size_t
+		{
+			_S_fit = _NodeBytes > 2 * sizeof(void*) ? (_NodeBytes - 2 * sizeof(void*)) / sizeof(_Value) : 0,
+			value  = _S_fit < 3 ? 3 : (_S_fit > 255 ? 255 : _S_fit)
+		};
+	};
+
+	template<class _Value, size_t _Slots>
+	struct _Btree_internal_node;
+
+	// 叶节点，同时是内部节点的基类
+	template<class _Value, size_t _Slots>
+	struct _Btree_node
+	{
+		using _Node_ptr = _Btree_node<_Value, _Slots>*;
+
+		_Node_ptr      _M_parent;   // 根节点为null
+		unsigned short _M_position; // 在父节点中的孩子下标
+		unsigned short _M_count;    // 元素个数
+		bool           _M_leaf;
+		alignas(_Value) unsigned char _M_storage[sizeof(_Value) * _Slots]; // [0, _M_count)中为已构造的元素
+
+		_Value* _M_value(size_t __i) { return reinterpret_cast<_Value*>(_M_storage) + __i; }
+		_Node_ptr& _M_child(size_t __i) { return static_cast<_Btree_internal_node<_Value, _Slots>*>(this)->_M_children[__i]; }
+	};
+
+	// 内部节点，孩子个数为_M_count + 1
+	template<class _Value, size_t _Slots>
+	struct _Btree_internal_node : public _Btree_node<_Value, _Slots>
+	{
+		_Btree_node<_Value, _Slots>* _M_children[_Slots + 1];
+	};
+
+	// 以(节点, 下标)表示位置；end()为最右叶节点的末尾
+	template<class _Value, class _Ref, class _Ptr, size_t _Slots>
+	struct _Btree_iterator
+	{
+		using iterator_category = bidirectional_iterator_tag;
+		using value_type        = _Value;
+		using difference_type   = ptrdiff_t;
+		using reference         = _Ref;
+		using pointer           = _Ptr;
+		using iterator          = _Btree_iterator<_Value, _Value&, _Value*, _Slots>;
+		using const_iterator    = _Btree_iterator<_Value, const _Value&, const _Value*, _Slots>;
+		using _Self             = _Btree_iterator<_Value, _Ref, _Ptr, _Slots>;
+		using _Node_ptr         = _Btree_node<_Value, _Slots>*;
+
+		_Node_ptr _M_node;
+		int       _M_position;
+
+		_Btree_iterator() : _M_node(nullptr), _M_position(0) {}
+		_Btree_iterator(_Node_ptr __x, int __i) : _M_node(__x), _M_position(__i) {}
+		_Btree_iterator(const iterator& __it) : _M_node(__it._M_node), _M_position(__it._M_position) {}
+		_Btree_iterator& operator=(const _Btree_iterator&) = default;
+
+		reference operator*() const { return *_M_node->_M_value(_M_position); }
+		pointer operator->() const { return &(operator*()); }
+
+		_Self& operator++()
+		{
+			_M_increment();
+			return *this;
+		}
+
+		_Self operator++(int)
+		{
+			_Self tmp = *this;
+			_M_increment();
+			return tmp;
+		}
+
+		_Self& operator--()
+		{
+			_M_decrement();
+			return *this;
+		}
+
+		_Self operator--(int)
+		{
+			_Self tmp = *this;
+			_M_decrement();
+			return tmp;
+		}
+
+		void _M_increment()
+		{
+			if (_M_node->_M_leaf && ++_M_position < _M_node->_M_count) // 绝大多数情况只在叶节点内移动
+				return;
+			if (_M_node->_M_leaf)
+			{	// 越过了叶节点的末尾：沿父节点上溯，直到所在位置不是父节点的末尾
+				_Self __save = *this;
+				while (_M_position == _M_node->_M_count && _M_node->_M_parent != nullptr)
+				{
+					_M_position = _M_node->_M_position;
+					_M_node = _M_node->_M_parent;
+				}
+				if (_M_position == _M_node->_M_count) // 原本就是最后一个元素，结果为end()
+					*this = __save;
+			}
+			else
+			{	// 内部节点：后继为右侧子树中最左叶节点的首个元素
+				_M_node = _M_node->_M_child(_M_position + 1);
+				while (!_M_node->_M_leaf)
+					_M_node = _M_node->_M_child(0);
+				_M_position = 0;
+			}
+		}
+
+		void _M_decrement()
+		{
+			if (_M_node->_M_leaf && --_M_position >= 0)
+				return;
+			if (_M_node->_M_leaf)
+			{	// 越过了叶节点的开头：沿父节点上溯，直到所在位置不是父节点的开头
+				_Self __save = *this;
+				while (_M_position < 0 && _M_node->_M_parent != nullptr)
+				{
+					_M_position = _M_node->_M_position - 1;
+					_M_node = _M_node->_M_parent;
+				}
+				if (_M_position < 0)
+					*this = __save;
+			}
+			else
+			{	// 内部节点：前驱为左侧子树中最右叶节点的末个元素
+				_M_node = _M_node->_M_child(_M_position);
+				while (!_M_node->_M_leaf)
+					_M_node = _M_node->_M_child(_M_node->_M_count);
+				_M_position = _M_node->_M_count - 1;
+			}
+		}
+	};
+
+	template<class _Value, class _Ref1, class _Ptr1, class _Ref2, class _Ptr2, size_t _Slots>
+	inline bool operator==(const _Btree_iterator<_Value, _Ref1, _Ptr1, _Slots>& __x, const _Btree_iterator<_Value, _Ref2, _Ptr2, _Slots>& __y)
+	{
+		return __x._M_node == __y._M_node && __x._M_position == __y._M_position;
+	}
+
+	template<class _Value, class _Ref1, class _Ptr1, class _Ref2, class _Ptr2, size_t _Slots>
+	inline bool operator!=(const _Btree_iterator<_Value, _Ref1, _Ptr1, _Slots>& __x, const _Btree_iterator<_Value, _Ref2, _Ptr2, _Slots>& __y)
+	{
+		return !(__x == __y);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc = TinySTL::alloc, size_t _NodeBytes = 256>
+	class _Btree
+	{
+	public:
+		using key_type        = _Key;
+		using value_type      = _Value;
+		using pointer         = value_type*;
+		using const_pointer   = const value_type*;
+		using reference       = value_type&;
+		using const_reference = const value_type&;
+		using size_type       = size_t;
+		using difference_type = ptrdiff_t;
+		using allocator_type  = _Alloc;
+
+		enum : size_t
+		{
+			_S_node_slots = _Btree_node_slots<_Value, _NodeBytes>::value, // 每个节点最多容纳的元素个数
+			_S_min_values = _S_node_slots / 2 // 删除后非根节点的元素少于此数时与兄弟节点合并或借入元素
+		};
+
+		using iterator               = _Btree_iterator<value_type, reference, pointer, _S_node_slots>;
+		using const_iterator         = _Btree_iterator<value_type, const_reference, const_pointer, _S_node_slots>;
+		using reverse_iterator       = TinySTL::reverse_iterator<iterator>;
+		using const_reverse_iterator = TinySTL::reverse_iterator<const_iterator>;
+
+	private:
+		using _Node           = _Btree_node<_Value, _S_node_slots>;
+		using _Internal_node  = _Btree_internal_node<_Value, _S_node_slots>;
+		using _Node_ptr       = _Node*;
+		using _Leaf_alloc     = simple_alloc<_Node, _Alloc>;
+		using _Internal_alloc = simple_alloc<_Internal_node, _Alloc>;
+
+		_Node_ptr _M_root;
+		_Node_ptr _M_leftmost;  // 最左叶节点，begin()所在
+		_Node_ptr _M_rightmost; // 最右叶节点，end()所在
+		size_type _M_node_count; // 元素个数
+		_Compare  _M_key_compare;
+
+	private:
+		_Node_ptr _M_new_node(_Node_ptr __p, bool __leaf)
+		{
+			_Node_ptr __x = __leaf ? _Leaf_alloc::allocate(1) : _Internal_alloc::allocate(1);
+			__x->_M_parent = __p;
+			__x->_M_position = 0;
+			__x->_M_count = 0;
+			__x->_M_leaf = __leaf;
+			return __x;
+		}
+		void _M_put_node(_Node_ptr __x) // 只归还内存，不析构元素
+		{
+			if (__x->_M_leaf)
+				_Leaf_alloc::deallocate(__x, 1);
+			else
+				_Internal_alloc::deallocate(static_cast<_Internal_node*>(__x), 1);
+		}
+
+		static const key_type& _S_key(_Node_ptr __x, size_type __i) { return _KeyOfValue()(*__x->_M_value(__i)); }
+
+		// 把__src[__s, __s + __n)移动构造到__dst[__d, __d + __n)并析构原元素，同一节点内可以重叠
+		static void _S_move_values(_Node_ptr __dst, size_type __d, _Node_ptr __src, size_type __s, size_type __n);
+		// 移动孩子指针，并更新孩子的_M_parent与_M_position
+		static void _S_move_children(_Node_ptr __dst, size_type __d, _Node_ptr __src, size_type __s, size_type __n);
+
+		// 节点内第一个键值不小于(大于)__k的元素下标
+		size_type _M_lower_index(_Node_ptr __x, const key_type& __k) const;
+		size_type _M_upper_index(_Node_ptr __x, const key_type& __k) const;
+
+		// 把已满的节点__x一分为二，中间的元素上移到父节点(父节点已满时先分裂父节点)
+		// (__x, __i)为随后要插入的位置，分裂后更新为新元素所在的节点与下标
+		void _M_split(_Node_ptr& __x, size_type& __i);
+		// 合并__r与其左兄弟__l：父节点中的分隔元素与__r的全部元素移入__l，释放__r
+		void _M_merge_nodes(_Node_ptr __l, _Node_ptr __r);
+		// 从右兄弟__r向__l移入__n个元素(经由父节点中的分隔元素轮转)
+		void _M_rebalance_right_to_left(_Node_ptr __l, _Node_ptr __r, size_type __n);
+		// 从左兄弟__l向__r移入__n个元素
+		void _M_rebalance_left_to_right(_Node_ptr __l, _Node_ptr __r, size_type __n);
+		// __it所在的节点元素过少：与兄弟节点合并(返回true)或从兄弟节点借入元素，并修正__it
+		bool _M_merge_or_rebalance(iterator& __it);
+		// 从叶节点删除元素后自下而上调整，返回指向被删除元素后继的迭代器
+		iterator _M_rebalance_after_erase(iterator __it);
+		void _M_try_shrink(); // 根节点没有元素时降低树高
+
+		_Node_ptr _M_copy(_Node_ptr __x, _Node_ptr __p); // 复制以__x为根的子树，其父节点为__p
+		void _M_erase(_Node_ptr __x); // 销毁以__x为根的子树
+		bool _M_verify_node(_Node_ptr __x, size_type __depth, size_type& __leaf_depth, size_type& __count) const;
+
+		// __position是否恰好为键值__k应插入的位置
+		bool _M_is_unique_hint(iterator __position, const key_type& __k);
+		bool _M_is_equal_hint(iterator __position, const key_type& __k);
+
+	public:
+		_Btree(const _Compare& __comp = _Compare(), const allocator_type& = allocator_type())
+			: _M_root(nullptr), _M_leftmost(nullptr), _M_rightmost(nullptr), _M_node_count(0), _M_key_compare(__comp) {}
+
+		_Btree(const _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>& __x)
+			: _M_root(nullptr), _M_leftmost(nullptr), _M_rightmost(nullptr), _M_node_count(0), _M_key_compare(__x._M_key_compare)
+		{
+			*this = __x;
+		}
+
+		~_Btree() { clear(); }
+
+		_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>&
+		operator=(const _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>& __x);
+
+	public:
+		_Compare key_comp() const { return _M_key_compare; }
+		allocator_type get_allocator() const { return allocator_type(); }
+		iterator begin() { return iterator(_M_leftmost, 0); }
+		const_iterator begin() const { return const_iterator(_M_leftmost, 0); }
+		iterator end() { return iterator(_M_rightmost, _M_rightmost == nullptr ? 0 : _M_rightmost->_M_count); }
+		const_iterator end() const { return const_iterator(_M_rightmost, _M_rightmost == nullptr ? 0 : _M_rightmost->_M_count); }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+		bool empty() const { return _M_node_count == 0; }
+		size_type size() const { return _M_node_count; }
+		size_type max_size() const { return size_type(-1); }
+		void swap(_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>& __x)
+		{
+			TinySTL::swap(_M_root, __x._M_root);
+			TinySTL::swap(_M_leftmost, __x._M_leftmost);
+			TinySTL::swap(_M_rightmost, __x._M_rightmost);
+			TinySTL::swap(_M_node_count, __x._M_node_count);
+			TinySTL::swap(_M_key_compare, __x._M_key_compare);
+		}
+
+	public:
+		// 插入新值，节点键值不允许重复，若重复则插入无效
+		TinySTL::pair<iterator, bool> insert_unique(const value_type& __v);
+		// 插入新值，节点键值可以重复，新元素位于键值相等的元素之后
+		iterator insert_equal(const value_type& __v);
+		// __position为提示位置，若新元素恰好应位于其前，则无需从根节点查找
+		iterator insert_unique(iterator __position, const value_type& __v);
+		iterator insert_equal(iterator __position, const value_type& __v);
+		// 已排序的区间逐个在末尾插入，每次只需O(1)的比较
+		template <class InIt>
+		void insert_unique(InIt __first, InIt __last)
+		{
+			for (; __first != __last; ++__first)
+				insert_unique(end(), *__first);
+		}
+		template <class InIt>
+		void insert_equal(InIt __first, InIt __last)
+		{
+			for (; __first != __last; ++__first)
+				insert_equal(end(), *__first);
+		}
+
+		// 调用者保证__v的键值恰好应位于__position之前(例如__position来自lower_bound)
+		iterator _M_insert_before(iterator __position, const value_type& __v);
+
+		// 返回被删除元素的后继
+		iterator erase(iterator __position);
+		size_type erase(const key_type& __k);
+		iterator erase(iterator __first, iterator __last);
+		void clear();
+
+	public:
+		iterator find(const key_type& __k);
+		const_iterator find(const key_type& __k) const { return const_cast<_Btree*>(this)->find(__k); }
+		size_type count(const key_type& __k) const;
+		iterator lower_bound(const key_type& __k);
+		const_iterator lower_bound(const key_type& __k) const { return const_cast<_Btree*>(this)->lower_bound(__k); }
+		iterator upper_bound(const key_type& __k);
+		const_iterator upper_bound(const key_type& __k) const { return const_cast<_Btree*>(this)->upper_bound(__k); }
+		pair<iterator, iterator> equal_range(const key_type& __k)
+		{
+			return pair<iterator, iterator>(lower_bound(__k), upper_bound(__k));
+		}
+		pair<const_iterator, const_iterator> equal_range(const key_type& __k) const
+		{
+			return pair<const_iterator, const_iterator>(lower_bound(__k), upper_bound(__k));
+		}
+
+	public:
+		// 验证该B树是否合法：键值有序、叶节点等深、父子链接与元素个数一致
+		bool __btree_verify() const;
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_S_move_values(_Node_ptr __dst, size_type __d, _Node_ptr __src, size_type __s, size_type __n)
+	{
+		if (__dst == __src && __d > __s)
+		{	// 向后移动时从末尾开始，避免覆盖尚未移动的元素
+			for (size_type __k = __n; __k-- > 0;)
+			{
+				new ((void*)__dst->_M_value(__d + __k)) _Value(std::move(*__src->_M_value(__s + __k)));
+				destroy(__src->_M_value(__s + __k));
+			}
+		}
+		else
+		{
+			for (size_type __k = 0; __k < __n; ++__k)
+			{
+				new ((void*)__dst->_M_value(__d + __k)) _Value(std::move(*__src->_M_value(__s + __k)));
+				destroy(__src->_M_value(__s + __k));
+			}
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_S_move_children(_Node_ptr __dst, size_type __d, _Node_ptr __src, size_type __s, size_type __n)
+	{
+		if (__dst == __src && __d > __s)
+		{
+			for (size_type __k = __n; __k-- > 0;)
+				__dst->_M_child(__d + __k) = __src->_M_child(__s + __k);
+		}
+		else
+		{
+			for (size_type __k = 0; __k < __n; ++__k)
+				__dst->_M_child(__d + __k) = __src->_M_child(__s + __k);
+		}
+		for (size_type __k = 0; __k < __n; ++__k)
+		{
+			_Node_ptr __c = __dst->_M_child(__d + __k);
+			__c->_M_parent = __dst;
+			__c->_M_position = static_cast<unsigned short>(__d + __k);
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::size_type
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_lower_index(_Node_ptr __x, const key_type& __k) const
+	{
+		size_type __lo = 0, __hi = __x->_M_count;
+		while (__lo < __hi)
+		{
+			size_type __mid = (__lo + __hi) / 2;
+			if (_M_key_compare(_S_key(__x, __mid), __k))
+				__lo = __mid + 1;
+			else
+				__hi = __mid;
+		}
+		return __lo;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::size_type
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_upper_index(_Node_ptr __x, const key_type& __k) const
+	{
+		size_type __lo = 0, __hi = __x->_M_count;
+		while (__lo < __hi)
+		{
+			size_type __mid = (__lo + __hi) / 2;
+			if (_M_key_compare(__k, _S_key(__x, __mid)))
+				__hi = __mid;
+			else
+				__lo = __mid + 1;
+		}
+		return __lo;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_split(_Node_ptr& __x, size_type& __i)
+	{
+		if (__x->_M_parent != nullptr && __x->_M_parent->_M_count == _S_node_slots)
+		{	// 中间元素将插入父节点中__x的位置
+			_Node_ptr __p = __x->_M_parent;
+			size_type __pi = __x->_M_position;
+			_M_split(__p, __pi);
+		}
+
+		_Node_ptr __y = _M_new_node(nullptr, __x->_M_leaf);
+		if (__x->_M_parent == nullptr)
+		{	// 分裂根节点，树高加一
+			_Node_ptr __root;
+			try
+			{
+				__root = _M_new_node(nullptr, false);
+			}
+			catch (...)
+			{
+				_M_put_node(__y);
+				throw;
+			}
+			__root->_M_child(0) = __x;
+			__x->_M_parent = __root;
+			__x->_M_position = 0;
+			_M_root = __root;
+		}
+
+		// 顺序插入时新元素总在节点的一端，此时让满的一侧保持满，另一侧留出空间，顺序插入的节点几乎都是满的
+		size_type __mid = __i == _S_node_slots ? _S_node_slots - 1 : (__i == 0 ? 1 : _S_node_slots / 2);
+		size_type __n = _S_node_slots - __mid - 1; // 移入__y的元素个数
+		_S_move_values(__y, 0, __x, __mid + 1, __n);
+		if (!__x->_M_leaf)
+			_S_move_children(__y, 0, __x, __mid + 1, __n + 1);
+		__y->_M_count = static_cast<unsigned short>(__n);
+		__x->_M_count = static_cast<unsigned short>(__mid);
+
+		// 中间元素上移到父节点，__y成为__x右侧的兄弟
+		_Node_ptr __p = __x->_M_parent;
+		size_type __pos = __x->_M_position;
+		_S_move_children(__p, __pos + 2, __p, __pos + 1, __p->_M_count - __pos);
+		_S_move_values(__p, __pos + 1, __p, __pos, __p->_M_count - __pos);
+		_S_move_values(__p, __pos, __x, __mid, 1);
+		__p->_M_child(__pos + 1) = __y;
+		__y->_M_parent = __p;
+		__y->_M_position = static_cast<unsigned short>(__pos + 1);
+		++__p->_M_count;
+		if (__x == _M_rightmost)
+			_M_rightmost = __y;
+
+		if (__i > __mid)
+		{
+			__x = __y;
+			__i -= __mid + 1;
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_insert_before(iterator __position, const value_type& __v)
+	{
+		if (_M_root == nullptr)
+		{
+			_M_root = _M_leftmost = _M_rightmost = _M_new_node(nullptr, true);
+			__position = iterator(_M_root, 0);
+		}
+		else if (!__position._M_node->_M_leaf)
+		{	// 新元素只能放在叶节点：改为插入到前驱(必在叶节点末尾)之后
+			--__position;
+			++__position._M_position;
+		}
+
+		_Node_ptr __x = __position._M_node;
+		size_type __i = __position._M_position;
+		if (__x->_M_count == _S_node_slots)
+			_M_split(__x, __i);
+
+		_S_move_values(__x, __i + 1, __x, __i, __x->_M_count - __i);
+		try
+		{
+			construct(__x->_M_value(__i), __v);
+		}
+		catch (...)
+		{
+			_S_move_values(__x, __i, __x, __i + 1, __x->_M_count - __i);
+			throw;
+		}
+		++__x->_M_count;
+		++_M_node_count;
+		return iterator(__x, static_cast<int>(__i));
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline TinySTL::pair<typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator, bool>
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::insert_unique(const value_type& __v)
+	{
+		if (_M_root == nullptr)
+			return TinySTL::pair<iterator, bool>(_M_insert_before(end(), __v), true);
+
+		const key_type& __k = _KeyOfValue()(__v);
+		_Node_ptr __x = _M_root;
+		for (;;)
+		{
+			size_type __i = _M_lower_index(__x, __k);
+			if (__i < __x->_M_count && !_M_key_compare(__k, _S_key(__x, __i))) // 键值已存在
+				return TinySTL::pair<iterator, bool>(iterator(__x, static_cast<int>(__i)), false);
+			if (__x->_M_leaf)
+				return TinySTL::pair<iterator, bool>(_M_insert_before(iterator(__x, static_cast<int>(__i)), __v), true);
+			__x = __x->_M_child(__i);
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::insert_equal(const value_type& __v)
+	{
+		if (_M_root == nullptr)
+			return _M_insert_before(end(), __v);
+
+		const key_type& __k = _KeyOfValue()(__v);
+		_Node_ptr __x = _M_root;
+		for (;;)
+		{
+			size_type __i = _M_upper_index(__x, __k);
+			if (__x->_M_leaf)
+				return _M_insert_before(iterator(__x, static_cast<int>(__i)), __v);
+			__x = __x->_M_child(__i);
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_is_unique_hint(iterator __position, const key_type& __k)
+	{
+		if (__position != end() && !_M_key_compare(__k, _KeyOfValue()(*__position)))
+			return false;
+		if (__position == begin())
+			return true;
+		iterator __before = __position;
+		--__before;
+		return _M_key_compare(_KeyOfValue()(*__before), __k);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_is_equal_hint(iterator __position, const key_type& __k)
+	{
+		if (__position != end() && _M_key_compare(_KeyOfValue()(*__position), __k))
+			return false;
+		if (__position == begin())
+			return true;
+		iterator __before = __position;
+		--__before;
+		return !_M_key_compare(__k, _KeyOfValue()(*__before));
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::insert_unique(iterator __position, const value_type& __v)
+	{
+		if (_M_is_unique_hint(__position, _KeyOfValue()(__v)))
+			return _M_insert_before(__position, __v);
+		return insert_unique(__v).first;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::insert_equal(iterator __position, const value_type& __v)
+	{
+		if (_M_is_equal_hint(__position, _KeyOfValue()(__v)))
+			return _M_insert_before(__position, __v);
+		return insert_equal(__v);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_merge_nodes(_Node_ptr __l, _Node_ptr __r)
+	{
+		_Node_ptr __p = __l->_M_parent;
+		size_type __k = __l->_M_position;
+		size_type __lc = __l->_M_count, __rc = __r->_M_count;
+		_S_move_values(__l, __lc, __p, __k, 1);
+		_S_move_values(__l, __lc + 1, __r, 0, __rc);
+		if (!__l->_M_leaf)
+			_S_move_children(__l, __lc + 1, __r, 0, __rc + 1);
+		__l->_M_count = static_cast<unsigned short>(__lc + 1 + __rc);
+
+		// 从父节点中移除分隔元素与__r
+		_S_move_values(__p, __k, __p, __k + 1, __p->_M_count - __k - 1);
+		_S_move_children(__p, __k + 1, __p, __k + 2, __p->_M_count - __k - 1);
+		--__p->_M_count;
+		if (__r == _M_rightmost)
+			_M_rightmost = __l;
+		_M_put_node(__r);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_rebalance_right_to_left(_Node_ptr __l, _Node_ptr __r, size_type __n)
+	{
+		_Node_ptr __p = __l->_M_parent;
+		size_type __k = __l->_M_position;
+		size_type __lc = __l->_M_count, __rc = __r->_M_count;
+		_S_move_values(__l, __lc, __p, __k, 1);            // 分隔元素移到__l末尾
+		_S_move_values(__l, __lc + 1, __r, 0, __n - 1);
+		_S_move_values(__p, __k, __r, __n - 1, 1);         // __r中第__n个元素成为新的分隔元素
+		_S_move_values(__r, 0, __r, __n, __rc - __n);
+		if (!__l->_M_leaf)
+		{
+			_S_move_children(__l, __lc + 1, __r, 0, __n);
+			_S_move_children(__r, 0, __r, __n, __rc - __n + 1);
+		}
+		__l->_M_count = static_cast<unsigned short>(__lc + __n);
+		__r->_M_count = static_cast<unsigned short>(__rc - __n);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_rebalance_left_to_right(_Node_ptr __l, _Node_ptr __r, size_type __n)
+	{
+		_Node_ptr __p = __l->_M_parent;
+		size_type __k = __l->_M_position;
+		size_type __lc = __l->_M_count, __rc = __r->_M_count;
+		_S_move_values(__r, __n, __r, 0, __rc);
+		_S_move_values(__r, __n - 1, __p, __k, 1);         // 分隔元素移到__r开头
+		_S_move_values(__r, 0, __l, __lc - __n + 1, __n - 1);
+		_S_move_values(__p, __k, __l, __lc - __n, 1);      // __l中倒数第__n个元素成为新的分隔元素
+		if (!__l->_M_leaf)
+		{
+			_S_move_children(__r, __n, __r, 0, __rc + 1);
+			_S_move_children(__r, 0, __l, __lc - __n + 1, __n);
+		}
+		__l->_M_count = static_cast<unsigned short>(__lc - __n);
+		__r->_M_count = static_cast<unsigned short>(__rc + __n);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_merge_or_rebalance(iterator& __it)
+	{
+		_Node_ptr __x = __it._M_node;
+		_Node_ptr __p = __x->_M_parent;
+		size_type __pos = __x->_M_position;
+		if (__pos > 0)
+		{	// 优先与左兄弟合并
+			_Node_ptr __l = __p->_M_child(__pos - 1);
+			if (static_cast<size_type>(__l->_M_count) + 1 + __x->_M_count <= _S_node_slots)
+			{
+				__it._M_position += __l->_M_count + 1;
+				_M_merge_nodes(__l, __x);
+				__it._M_node = __l;
+				return true;
+			}
+		}
+		if (__pos < __p->_M_count)
+		{
+			_Node_ptr __r = __p->_M_child(__pos + 1);
+			if (static_cast<size_type>(__x->_M_count) + 1 + __r->_M_count <= _S_node_slots)
+			{
+				_M_merge_nodes(__x, __r);
+				return true;
+			}
+			if (__r->_M_count > _S_min_values)
+			{	// 无法合并时兄弟节点的元素必多于__x，借入其多出部分的一半
+				_M_rebalance_right_to_left(__x, __r, (__r->_M_count - __x->_M_count) / 2);
+				return false;
+			}
+		}
+		if (__pos > 0)
+		{
+			_Node_ptr __l = __p->_M_child(__pos - 1);
+			size_type __n = (__l->_M_count - __x->_M_count) / 2;
+			_M_rebalance_left_to_right(__l, __x, __n);
+			__it._M_position += static_cast<int>(__n);
+		}
+		return false;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_try_shrink()
+	{
+		if (_M_root->_M_count > 0)
+			return;
+		_Node_ptr __old = _M_root;
+		if (__old->_M_leaf)
+		{
+			_M_root = _M_leftmost = _M_rightmost = nullptr;
+		}
+		else
+		{
+			_M_root = __old->_M_child(0);
+			_M_root->_M_parent = nullptr;
+			_M_root->_M_position = 0;
+		}
+		_M_put_node(__old);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_rebalance_after_erase(iterator __it)
+	{
+		// __res位于叶节点，只有叶节点这一层的调整会移动它所指的元素；更上层的调整只涉及内部节点
+		iterator __res = __it;
+		bool __first = true;
+		for (;;)
+		{
+			if (__it._M_node == _M_root)
+			{
+				_M_try_shrink();
+				if (_M_root == nullptr)
+					return end();
+				break;
+			}
+			if (__it._M_node->_M_count >= _S_min_values)
+				break;
+			bool __merged = _M_merge_or_rebalance(__it);
+			if (__first)
+			{
+				__res = __it;
+				__first = false;
+			}
+			if (!__merged)
+				break;
+			// 父节点失去了一个分隔元素，继续检查父节点
+			__it._M_position = __it._M_node->_M_position;
+			__it._M_node = __it._M_node->_M_parent;
+		}
+		if (__res._M_position == __res._M_node->_M_count)
+		{	// 位于叶节点末尾，后继在祖先节点中
+			--__res._M_position;
+			++__res;
+		}
+		return __res;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::erase(iterator __position)
+	{
+		bool __internal = !__position._M_node->_M_leaf;
+		if (__internal)
+		{	// 内部节点的元素由其前驱(位于叶节点末尾)取代，转为删除叶节点中的前驱
+			iterator __pred = __position;
+			--__pred;
+			destroy(__position._M_node->_M_value(__position._M_position));
+			_S_move_values(__position._M_node, __position._M_position, __pred._M_node, __pred._M_position, 1);
+			__position = __pred;
+		}
+		else
+		{
+			destroy(__position._M_node->_M_value(__position._M_position));
+		}
+
+		_Node_ptr __x = __position._M_node;
+		size_type __i = __position._M_position;
+		_S_move_values(__x, __i, __x, __i + 1, __x->_M_count - __i - 1);
+		--__x->_M_count;
+		--_M_node_count;
+
+		iterator __res = _M_rebalance_after_erase(__position);
+		if (__internal) // __res指向取代被删除元素的前驱，其后继才是结果
+			++__res;
+		return __res;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::size_type
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::erase(const key_type& __k)
+	{
+		size_type __n = 0;
+		iterator __it = lower_bound(__k);
+		while (__it != end() && !_M_key_compare(__k, _KeyOfValue()(*__it)))
+		{
+			__it = erase(__it);
+			++__n;
+		}
+		return __n;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::erase(iterator __first, iterator __last)
+	{
+		if (__first == begin() && __last == end())
+		{
+			clear();
+			return end();
+		}
+		// 每次删除都可能移动__last所指的元素，因此先数出个数
+		size_type __n = 0;
+		for (iterator __it = __first; __it != __last; ++__it)
+			++__n;
+		for (; __n > 0; --__n)
+			__first = erase(__first);
+		return __first;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_erase(_Node_ptr __x)
+	{
+		if (!__x->_M_leaf)
+		{
+			for (size_type __i = 0; __i <= __x->_M_count; ++__i)
+				_M_erase(__x->_M_child(__i));
+		}
+		for (size_type __i = 0; __i < __x->_M_count; ++__i)
+			destroy(__x->_M_value(__i));
+		_M_put_node(__x);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::clear()
+	{
+		if (_M_root != nullptr)
+		{
+			_M_erase(_M_root);
+			_M_root = _M_leftmost = _M_rightmost = nullptr;
+			_M_node_count = 0;
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_Node_ptr
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_copy(_Node_ptr __x, _Node_ptr __p)
+	{
+		_Node_ptr __y = _M_new_node(__p, __x->_M_leaf);
+		__y->_M_position = __x->_M_position;
+		size_type __children = 0;
+		try
+		{
+			for (; __y->_M_count < __x->_M_count; ++__y->_M_count)
+				construct(__y->_M_value(__y->_M_count), *__x->_M_value(__y->_M_count));
+			if (!__x->_M_leaf)
+			{
+				for (; __children <= __x->_M_count; ++__children)
+					__y->_M_child(__children) = _M_copy(__x->_M_child(__children), __y);
+			}
+		}
+		catch (...)
+		{
+			for (size_type __i = 0; __i < __children; ++__i)
+				_M_erase(__y->_M_child(__i));
+			for (size_type __i = 0; __i < __y->_M_count; ++__i)
+				destroy(__y->_M_value(__i));
+			_M_put_node(__y);
+			throw;
+		}
+		return __y;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>&
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::operator=(const _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>& __x)
+	{
+		if (this != &__x)
+		{
+			clear();
+			_M_key_compare = __x._M_key_compare;
+			if (__x._M_root != nullptr)
+			{
+				_M_root = _M_copy(__x._M_root, nullptr);
+				_M_leftmost = _M_rightmost = _M_root;
+				while (!_M_leftmost->_M_leaf)
+					_M_leftmost = _M_leftmost->_M_child(0);
+				while (!_M_rightmost->_M_leaf)
+					_M_rightmost = _M_rightmost->_M_child(_M_rightmost->_M_count);
+				_M_node_count = __x._M_node_count;
+			}
+		}
+		return *this;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::find(const key_type& __k)
+	{
+		for (_Node_ptr __x = _M_root; __x != nullptr;)
+		{
+			size_type __i = _M_lower_index(__x, __k);
+			if (__i < __x->_M_count && !_M_key_compare(__k, _S_key(__x, __i)))
+				return iterator(__x, static_cast<int>(__i));
+			__x = __x->_M_leaf ? nullptr : __x->_M_child(__i);
+		}
+		return end();
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::size_type
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::count(const key_type& __k) const
+	{
+		size_type __n = 0;
+		const_iterator __last = upper_bound(__k);
+		for (const_iterator __it = lower_bound(__k); __it != __last; ++__it)
+			++__n;
+		return __n;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::lower_bound(const key_type& __k)
+	{
+		// 每层的候选位置都比上一层的更靠前，最后记录的即为答案
+		iterator __result = end();
+		for (_Node_ptr __x = _M_root; __x != nullptr;)
+		{
+			size_type __i = _M_lower_index(__x, __k);
+			if (__i < __x->_M_count)
+				__result = iterator(__x, static_cast<int>(__i));
+			__x = __x->_M_leaf ? nullptr : __x->_M_child(__i);
+		}
+		return __result;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline typename _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::iterator
+	_Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::upper_bound(const key_type& __k)
+	{
+		iterator __result = end();
+		for (_Node_ptr __x = _M_root; __x != nullptr;)
+		{
+			size_type __i = _M_upper_index(__x, __k);
+			if (__i < __x->_M_count)
+				__result = iterator(__x, static_cast<int>(__i));
+			__x = __x->_M_leaf ? nullptr : __x->_M_child(__i);
+		}
+		return __result;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::_M_verify_node(_Node_ptr __x, size_type __depth, size_type& __leaf_depth, size_type& __count) const
+	{
+		if (__x->_M_count > _S_node_slots || (__x != _M_root && __x->_M_count == 0))
+			return false;
+		for (size_type __i = 1; __i < __x->_M_count; ++__i)
+			if (_M_key_compare(_S_key(__x, __i), _S_key(__x, __i - 1)))
+				return false;
+		__count += __x->_M_count;
+		if (__x->_M_leaf)
+		{
+			if (__leaf_depth == 0)
+				__leaf_depth = __depth;
+			return __leaf_depth == __depth;
+		}
+		for (size_type __i = 0; __i <= __x->_M_count; ++__i)
+		{
+			_Node_ptr __c = __x->_M_child(__i);
+			if (__c->_M_parent != __x || __c->_M_position != __i)
+				return false;
+			// 孩子__i的键值介于分隔元素__i - 1与__i之间
+			if (__i > 0 && _M_key_compare(_S_key(__c, 0), _S_key(__x, __i - 1)))
+				return false;
+			if (__i < __x->_M_count && _M_key_compare(_S_key(__x, __i), _S_key(__c, __c->_M_count - 1)))
+				return false;
+			if (!_M_verify_node(__c, __depth + 1, __leaf_depth, __count))
+				return false;
+		}
+		return true;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool _Btree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _NodeBytes>::__btree_verify() const
+	{
+		if (_M_root == nullptr)
+			return _M_node_count == 0 && _M_leftmost == nullptr && _M_rightmost == nullptr;
+		if (_M_root->_M_parent != nullptr)
+			return false;
+
+		size_type __leaf_depth = 0, __count = 0;
+		if (!_M_verify_node(_M_root, 1, __leaf_depth, __count) || __count != _M_node_count)
+			return false;
+
+		_Node_ptr __l = _M_root, __r = _M_root;
+		while (!__l->_M_leaf)
+			__l = __l->_M_child(0);
+		while (!__r->_M_leaf)
+			__r = __r->_M_child(__r->_M_count);
+		return __l == _M_leftmost && __r == _M_rightmost;
+	}
+}
+
+#endif // !_BTREE_H_
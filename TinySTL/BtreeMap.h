@@ -0,0 +1,253 @@
+﻿#ifndef _BTREE_MAP_H_
+#define _BTREE_MAP_H_
+
+#include <utility>
+#include <stdexcept>
+
+#include "Btree.h"
+#include "Functional.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* btree_map : 以_Btree为底层的有序关联容器
+	* ***********************************
+	* 接口与map相同(不含node handle、集合运算与顺序统计)，元素较多时查找的cache miss远少于map
+	* 任何插入、删除都使所有迭代器、指针与引用失效，这一点与map不同
+	* _NodeBytes为节点大小的目标值，见_Btree
+	*/
+	template<class _Key, class _Tp, class _Compare = TinySTL::less<_Key>, class _Alloc = TinySTL::alloc, size_t _NodeBytes = 256>
+	class btree_map
+	{
+	public:
+		using key_type    = _Key;
+		using mapped_type = _Tp;
+		using value_type  = TinySTL::pair<const _Key, _Tp>;
+		using key_compare = _Compare;
+
+		// 以键值比较两个元素
+		class value_compare : public binary_function<value_type, value_type, bool>
+		{
+			friend class btree_map;
+		protected:
+			_Compare comp;
+			value_compare(_Compare __c) : comp(__c) {}
+		public:
+			bool operator()(const value_type& __x, const value_type& __y) const
+			{
+				return comp(__x.first, __y.first);
+			}
+		};
+
+	private:
+		using _Rep_type = _Btree<key_type, value_type, TinySTL::select1st<value_type>, key_compare, _Alloc, _NodeBytes>;
+
+		_Rep_type _M_t; // 底层的B树
+
+	public:
+		using pointer                = typename _Rep_type::pointer;
+		using const_pointer          = typename _Rep_type::const_pointer;
+		using reference              = typename _Rep_type::reference;
+		using const_reference        = typename _Rep_type::const_reference;
+		using iterator               = typename _Rep_type::iterator;
+		using const_iterator         = typename _Rep_type::const_iterator;
+		using reverse_iterator       = typename _Rep_type::reverse_iterator;
+		using const_reverse_iterator = typename _Rep_type::const_reverse_iterator;
+		using size_type              = typename _Rep_type::size_type;
+		using difference_type        = typename _Rep_type::difference_type;
+		using allocator_type         = typename _Rep_type::allocator_type;
+
+	private:
+		static iterator _S_unconst(const_iterator __it)
+		{
+			return iterator(__it._M_node, __it._M_position);
+		}
+
+	public:
+		btree_map() : _M_t(_Compare(), allocator_type()) {}
+		explicit btree_map(const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a) {}
+
+		template<class InIt>
+		btree_map(InIt __first, InIt __last) : _M_t(_Compare(), allocator_type())
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		template<class InIt>
+		btree_map(InIt __first, InIt __last, const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a)
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		btree_map(const btree_map& __x) : _M_t(__x._M_t) {}
+
+		btree_map& operator=(const btree_map& __x)
+		{
+			_M_t = __x._M_t;
+			return *this;
+		}
+
+	public:
+		key_compare key_comp() const { return _M_t.key_comp(); }
+		value_compare value_comp() const { return value_compare(_M_t.key_comp()); }
+		allocator_type get_allocator() const { return _M_t.get_allocator(); }
+
+		// Iterator:
+		iterator begin() { return _M_t.begin(); }
+		const_iterator begin() const { return _M_t.begin(); }
+		iterator end() { return _M_t.end(); }
+		const_iterator end() const { return _M_t.end(); }
+		reverse_iterator rbegin() { return _M_t.rbegin(); }
+		const_reverse_iterator rbegin() const { return _M_t.rbegin(); }
+		reverse_iterator rend() { return _M_t.rend(); }
+		const_reverse_iterator rend() const { return _M_t.rend(); }
+		const_iterator cbegin() const { return _M_t.begin(); }
+		const_iterator cend() const { return _M_t.end(); }
+		const_reverse_iterator crbegin() const { return _M_t.rbegin(); }
+		const_reverse_iterator crend() const { return _M_t.rend(); }
+
+		// Capacity:
+		bool empty() const { return _M_t.empty(); }
+		size_type size() const { return _M_t.size(); }
+		size_type max_size() const { return _M_t.max_size(); }
+
+		// Element access:
+		mapped_type& operator[](const key_type& __k)
+		{
+			iterator __i = lower_bound(__k);
+			// __i->first >= __k，若二者不等则__k不存在，且恰好应插入在__i之前
+			if (__i == end() || key_comp()(__k, (*__i).first))
+				__i = _M_t._M_insert_before(__i, value_type(__k, mapped_type()));
+			return (*__i).second;
+		}
+		mapped_type& at(const key_type& __k)
+		{
+			iterator __i = find(__k);
+			if (__i == end())
+				throw std::out_of_range("btree_map::at");
+			return (*__i).second;
+		}
+		const mapped_type& at(const key_type& __k) const
+		{
+			const_iterator __i = find(__k);
+			if (__i == end())
+				throw std::out_of_range("btree_map::at");
+			return (*__i).second;
+		}
+
+		// Modifiers:
+		TinySTL::pair<iterator, bool> insert(const value_type& __x) { return _M_t.insert_unique(__x); }
+		iterator insert(const_iterator __position, const value_type& __x)
+		{
+			return _M_t.insert_unique(_S_unconst(__position), __x);
+		}
+		template<class InIt>
+		void insert(InIt __first, InIt __last)
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> emplace(_Args&&... __args)
+		{
+			return insert(value_type(std::forward<_Args>(__args)...));
+		}
+		template<class... _Args>
+		iterator emplace_hint(const_iterator __position, _Args&&... __args)
+		{
+			return insert(__position, value_type(std::forward<_Args>(__args)...));
+		}
+
+		// 键值已存在时不构造实值，也不做任何修改
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> try_emplace(const key_type& __k, _Args&&... __args)
+		{
+			iterator __i = lower_bound(__k);
+			if (__i != end() && !key_comp()(__k, (*__i).first))
+				return TinySTL::pair<iterator, bool>(__i, false);
+			__i = _M_t._M_insert_before(__i, value_type(__k, mapped_type(std::forward<_Args>(__args)...)));
+			return TinySTL::pair<iterator, bool>(__i, true);
+		}
+
+		// 键值已存在时以__obj赋值实值，否则插入
+		template<class _Obj>
+		TinySTL::pair<iterator, bool> insert_or_assign(const key_type& __k, _Obj&& __obj)
+		{
+			iterator __i = lower_bound(__k);
+			if (__i != end() && !key_comp()(__k, (*__i).first))
+			{
+				(*__i).second = std::forward<_Obj>(__obj);
+				return TinySTL::pair<iterator, bool>(__i, false);
+			}
+			__i = _M_t._M_insert_before(__i, value_type(__k, mapped_type(std::forward<_Obj>(__obj))));
+			return TinySTL::pair<iterator, bool>(__i, true);
+		}
+
+		iterator erase(iterator __position) { return _M_t.erase(__position); }
+		iterator erase(const_iterator __position) { return _M_t.erase(_S_unconst(__position)); }
+		size_type erase(const key_type& __x) { return _M_t.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last)
+		{
+			return _M_t.erase(_S_unconst(__first), _S_unconst(__last));
+		}
+		void clear() { _M_t.clear(); }
+		void swap(btree_map& __x) { _M_t.swap(__x._M_t); }
+
+		// Lookup:
+		iterator find(const key_type& __x) { return _M_t.find(__x); }
+		const_iterator find(const key_type& __x) const { return _M_t.find(__x); }
+		size_type count(const key_type& __x) const { return _M_t.find(__x) == _M_t.end() ? 0 : 1; }
+		bool contains(const key_type& __x) const { return _M_t.find(__x) != _M_t.end(); }
+		iterator lower_bound(const key_type& __x) { return _M_t.lower_bound(__x); }
+		const_iterator lower_bound(const key_type& __x) const { return _M_t.lower_bound(__x); }
+		iterator upper_bound(const key_type& __x) { return _M_t.upper_bound(__x); }
+		const_iterator upper_bound(const key_type& __x) const { return _M_t.upper_bound(__x); }
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) { return _M_t.equal_range(__x); }
+		TinySTL::pair<const_iterator, const_iterator> equal_range(const key_type& __x) const { return _M_t.equal_range(__x); }
+
+		// 验证底层B树是否合法
+		bool __btree_verify() const { return _M_t.__btree_verify(); }
+	};
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator==(const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __x, const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return __x.size() == __y.size() && TinySTL::equal(__x.begin(), __x.end(), __y.begin());
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator!=(const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __x, const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return !(__x == __y);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator<(const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __x, const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return TinySTL::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end());
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator>(const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __x, const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return __y < __x;
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator<=(const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __x, const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return !(__y < __x);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator>=(const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __x, const btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return !(__x < __y);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void swap(btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __x, btree_map<_Key, _Tp, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		__x.swap(__y);
+	}
+}
+
+#endif // !_BTREE_MAP_H_
@@ -0,0 +1,187 @@
+﻿#ifndef _BTREE_SET_H_
+#define _BTREE_SET_H_
+
+#include <utility>
+
+#include "Btree.h"
+#include "Functional.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* btree_set : 以_Btree为底层的有序集合
+	* ***********************************
+	* 接口与set相同(不含node handle、集合运算与顺序统计)，元素较多时查找的cache miss远少于set
+	* 任何插入、删除都使所有迭代器失效，这一点与set不同
+	* _NodeBytes为节点大小的目标值，见_Btree
+	*/
+	template<class _Key, class _Compare = TinySTL::less<_Key>, class _Alloc = TinySTL::alloc, size_t _NodeBytes = 256>
+	class btree_set
+	{
+	public:
+		using key_type        = _Key;
+		using value_type      = _Key;
+		using key_compare     = _Compare;
+		using value_compare   = _Compare;
+
+	private:
+		using _Rep_type       = _Btree<key_type, value_type, TinySTL::identity<value_type>, key_compare, _Alloc, _NodeBytes>;
+		using _Rep_iterator   = typename _Rep_type::iterator;
+
+		_Rep_type _M_t; // 底层的B树
+
+	public:
+		using pointer                = typename _Rep_type::const_pointer;
+		using const_pointer          = typename _Rep_type::const_pointer;
+		using reference              = typename _Rep_type::const_reference;
+		using const_reference        = typename _Rep_type::const_reference;
+		using iterator               = typename _Rep_type::const_iterator;
+		using const_iterator         = typename _Rep_type::const_iterator;
+		using reverse_iterator       = typename _Rep_type::const_reverse_iterator;
+		using const_reverse_iterator = typename _Rep_type::const_reverse_iterator;
+		using size_type              = typename _Rep_type::size_type;
+		using difference_type        = typename _Rep_type::difference_type;
+		using allocator_type         = typename _Rep_type::allocator_type;
+
+	private:
+		// _Btree的erase/insert接受可修改的iterator
+		static _Rep_iterator _S_unconst(const_iterator __it)
+		{
+			return _Rep_iterator(__it._M_node, __it._M_position);
+		}
+
+	public:
+		btree_set() : _M_t(_Compare(), allocator_type()) {}
+		explicit btree_set(const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a) {}
+
+		template<class InIt>
+		btree_set(InIt __first, InIt __last) : _M_t(_Compare(), allocator_type())
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		template<class InIt>
+		btree_set(InIt __first, InIt __last, const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a)
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		btree_set(const btree_set& __x) : _M_t(__x._M_t) {}
+
+		btree_set& operator=(const btree_set& __x)
+		{
+			_M_t = __x._M_t;
+			return *this;
+		}
+
+	public:
+		key_compare key_comp() const { return _M_t.key_comp(); }
+		value_compare value_comp() const { return _M_t.key_comp(); }
+		allocator_type get_allocator() const { return _M_t.get_allocator(); }
+
+		// Iterator:
+		iterator begin() const { return _M_t.begin(); }
+		iterator end() const { return _M_t.end(); }
+		reverse_iterator rbegin() const { return _M_t.rbegin(); }
+		reverse_iterator rend() const { return _M_t.rend(); }
+		const_iterator cbegin() const { return _M_t.begin(); }
+		const_iterator cend() const { return _M_t.end(); }
+		const_reverse_iterator crbegin() const { return _M_t.rbegin(); }
+		const_reverse_iterator crend() const { return _M_t.rend(); }
+
+		// Capacity:
+		bool empty() const { return _M_t.empty(); }
+		size_type size() const { return _M_t.size(); }
+		size_type max_size() const { return _M_t.max_size(); }
+
+		// Modifiers:
+		TinySTL::pair<iterator, bool> insert(const value_type& __x)
+		{
+			TinySTL::pair<_Rep_iterator, bool> __p = _M_t.insert_unique(__x);
+			return TinySTL::pair<iterator, bool>(__p.first, __p.second);
+		}
+		// __position为提示位置，若新元素恰好应位于其前，则无需从根节点查找
+		iterator insert(const_iterator __position, const value_type& __x)
+		{
+			return _M_t.insert_unique(_S_unconst(__position), __x);
+		}
+		template<class InIt>
+		void insert(InIt __first, InIt __last)
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> emplace(_Args&&... __args)
+		{
+			return insert(value_type(std::forward<_Args>(__args)...));
+		}
+		template<class... _Args>
+		iterator emplace_hint(const_iterator __position, _Args&&... __args)
+		{
+			return insert(__position, value_type(std::forward<_Args>(__args)...));
+		}
+
+		iterator erase(const_iterator __position) { return _M_t.erase(_S_unconst(__position)); }
+		size_type erase(const key_type& __x) { return _M_t.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last)
+		{
+			return _M_t.erase(_S_unconst(__first), _S_unconst(__last));
+		}
+		void clear() { _M_t.clear(); }
+		void swap(btree_set& __x) { _M_t.swap(__x._M_t); }
+
+		// Lookup:
+		iterator find(const key_type& __x) const { return _M_t.find(__x); }
+		size_type count(const key_type& __x) const { return _M_t.find(__x) == _M_t.end() ? 0 : 1; }
+		bool contains(const key_type& __x) const { return _M_t.find(__x) != _M_t.end(); }
+		iterator lower_bound(const key_type& __x) const { return _M_t.lower_bound(__x); }
+		iterator upper_bound(const key_type& __x) const { return _M_t.upper_bound(__x); }
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) const { return _M_t.equal_range(__x); }
+
+		// 验证底层B树是否合法
+		bool __btree_verify() const { return _M_t.__btree_verify(); }
+	};
+
+	template<class _Key, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator==(const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __x, const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return __x.size() == __y.size() && TinySTL::equal(__x.begin(), __x.end(), __y.begin());
+	}
+
+	template<class _Key, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator!=(const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __x, const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return !(__x == __y);
+	}
+
+	template<class _Key, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator<(const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __x, const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return TinySTL::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end());
+	}
+
+	template<class _Key, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator>(const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __x, const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return __y < __x;
+	}
+
+	template<class _Key, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator<=(const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __x, const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return !(__y < __x);
+	}
+
+	template<class _Key, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline bool operator>=(const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __x, const btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		return !(__x < __y);
+	}
+
+	template<class _Key, class _Compare, class _Alloc, size_t _NodeBytes>
+	inline void swap(btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __x, btree_set<_Key, _Compare, _Alloc, _NodeBytes>& __y)
+	{
+		__x.swap(__y);
+	}
+}
+
+#endif // !_BTREE_SET_H_
@@ -0,0 +1,619 @@
+﻿#ifndef _CONCURRENT_HASH_MAP_H_
+#define _CONCURRENT_HASH_MAP_H_
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <utility>
+
+#include "Alloc.h"
+#include "Construct.h"
+#include "Utility.h"
+#include "Functional.h"
+#include "FlatHashtable.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* concurrent_hash_map : 读无锁、写分条带加锁的哈希表
+	* ***********************************
+	* 桶为单向链表，桶的个数为2的幂；键值的哈希值低位决定其条带(共s_stripes条)，桶的个数不小于条带数，
+	* 因此无论表多大，同一条带的桶始终由同一把锁保护
+	*
+	* 读：find/contains不加锁，沿链表的原子指针遍历。结点一经发布便不再修改，insert_or_assign与update_fn
+	*     均复制出新结点替换旧结点(copy-on-write)，读者因而总能读到完整的值
+	* 写：insert/insert_or_assign/erase/update_fn只锁键值所在的条带
+	* 扩容：元素个数超过桶的个数时分配两倍大小的新表，此后每次写操作顺带认领并迁移一个条带(复制结点到新表)，
+	*     不会停下所有线程；条带迁移完成前读写仍在旧表进行，完成后转到新表，全部迁移完成即发布新表
+	* 内存回收：基于代次(epoch)。读写操作期间在当前代次的计数器上登记；被摘下的结点与旧表记下摘除时的代次r，
+	*     代次推进到r + 2时，可能看到它的操作均已结束，才真正回收。计数器按线程分散到多个cache line上
+	*
+	* 结点按块经由simple_alloc从Alloc分配，每个条带各自管理空闲结点；整块大于alloc的小区块上限(128 bytes)
+	* 而直接走malloc，因此多个条带同时分配是安全的
+	*/
+	template<class Key, class T, class HashFcn = TinySTL::hash<Key>, class EqualKey = TinySTL::equal_to<Key>, class Alloc = TinySTL::alloc>
+	class concurrent_hash_map
+	{
+	public:
+		using key_type    = Key;
+		using mapped_type = T;
+		using value_type  = TinySTL::pair<const Key, T>;
+		using hasher      = HashFcn;
+		using key_equal   = EqualKey;
+		using size_type   = size_t;
+
+	private:
+		enum { s_stripes = 64 };      // 条带数，2的幂
+		enum { s_readerShards = 32 }; // 代次计数器的分片数
+		enum { s_chunkNodes = 32 };
+		enum { s_cacheLine = 64 };
+		enum { s_reclaimBatch = 32 }; // 条带中待回收的结点达到此数时尝试推进代次
+
+		struct _Node
+		{
+			std::atomic<_Node*> next_;  // 桶内链表，读者无锁遍历
+			size_t              hash_;
+			_Node*              link_;  // 空闲链表、待回收链表或块链表
+			uint64_t            stamp_; // 摘除时的代次
+			value_type          value_;
+		};
+		using Alloc_type = simple_alloc<_Node, Alloc>;
+		static_assert(sizeof(_Node) * s_chunkNodes > 128, "concurrent_hash_map chunk must bypass alloc free lists");
+
+		struct _Table
+		{
+			size_t                mask_;
+			std::atomic<_Table*>  next_;   // 正在迁移到的新表
+			std::atomic<unsigned> cursor_; // 轮转认领条带的起点
+			std::atomic<unsigned> done_;   // 已迁移完成的条带数
+			std::atomic<bool>     claimed_[s_stripes]; // 条带已被认领(迁移失败时交还)
+			std::atomic<bool>     moved_[s_stripes];
+			_Table*               link_;   // 待回收链表
+			uint64_t              stamp_;
+
+			std::atomic<_Node*>* buckets() { return reinterpret_cast<std::atomic<_Node*>*>(this + 1); }
+			std::atomic<_Node*>& bucket(size_t Hash) { return buckets()[Hash & mask_]; }
+		};
+
+		struct alignas(s_cacheLine) _Stripe
+		{
+			std::mutex mutex_;
+			_Node*     free_;         // 空闲结点
+			_Node*     retired_;      // 待回收结点，按摘除的先后排列
+			_Node*     retiredTail_;
+			size_type  retiredCount_;
+			_Node*     chunks_;       // 已分配的块，每块的首个结点用于串起所有块
+		};
+
+		struct alignas(s_cacheLine) _Counter
+		{
+			std::atomic<long> count_;
+		};
+
+		// 读写操作期间的代次登记
+		class _Guard
+		{
+		public:
+			explicit _Guard(concurrent_hash_map& Map) : count_(nullptr)
+			{
+				unsigned Shard = _S_shard();
+				for (;;)
+				{	// 登记后代次未变才算成功，否则推进代次的线程可能没有看到这次登记
+					uint64_t Gen = Map.gen_.load();
+					count_ = &Map.readers_[Gen & 1][Shard].count_;
+					count_->fetch_add(1);
+					if (Map.gen_.load() == Gen)
+						break;
+					count_->fetch_sub(1);
+				}
+			}
+			~_Guard() { count_->fetch_sub(1); }
+			_Guard(const _Guard&) = delete;
+			_Guard& operator=(const _Guard&) = delete;
+
+		private:
+			std::atomic<long>* count_;
+		};
+
+	public:
+		explicit concurrent_hash_map(size_type BucketHint = 0, const hasher& Hf = hasher(), const key_equal& Eql = key_equal());
+		concurrent_hash_map(const concurrent_hash_map&) = delete;
+		concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+		~concurrent_hash_map();
+
+	public:
+		// 找到时把实值复制到Result
+		bool find(const key_type& Key_, mapped_type& Result);
+		bool contains(const key_type& Key_);
+		// 键值不存在时插入，返回是否插入
+		bool insert(const key_type& Key_, const mapped_type& Val);
+		// 键值已存在时替换其实值，否则插入；返回是否插入
+		bool insert_or_assign(const key_type& Key_, const mapped_type& Val);
+		bool erase(const key_type& Key_);
+		// 键值存在时以Func(mapped_type&)修改实值的副本并替换，返回键值是否存在；Func在条带锁内执行
+		template<class Fn>
+		bool update_fn(const key_type& Key_, Fn Func);
+
+		// 近似值，仅供参考
+		size_type size() const { return size_.load(std::memory_order_relaxed); }
+		bool empty() const { return size() == 0; }
+		size_type bucket_count() const { return table_.load(std::memory_order_acquire)->mask_ + 1; }
+
+	private:
+		static unsigned _S_shard()
+		{
+			static std::atomic<unsigned> Next(0);
+			static thread_local unsigned Shard = Next.fetch_add(1, std::memory_order_relaxed) % s_readerShards;
+			return Shard;
+		}
+
+		size_t _M_hash(const key_type& Key_) const { return _Flat_hash_mix(hash_(Key_)); }
+		static unsigned _S_stripe_of(size_t Hash) { return static_cast<unsigned>(Hash & (s_stripes - 1)); }
+
+		static _Table* _S_new_table(size_t Buckets);
+		static void _S_free_table(_Table* Table);
+
+		// 键值为Hash的条带当前所在的表：条带已迁移时为新表
+		_Table* _M_table_for(size_t Hash) const
+		{
+			_Table* Table = table_.load(std::memory_order_acquire);
+			_Table* Next = Table->next_.load(std::memory_order_acquire);
+			if (Next != nullptr && Table->moved_[_S_stripe_of(Hash)].load(std::memory_order_acquire))
+				return Next;
+			return Table;
+		}
+		// 在桶内查找，Link返回指向该结点(或链表末尾)的原子指针
+		_Node* _M_find_in(std::atomic<_Node*>*& Link, size_t Hash, const key_type& Key_) const
+		{
+			_Node* Cur = Link->load(std::memory_order_acquire);
+			while (Cur != nullptr && !(Cur->hash_ == Hash && equals_(Cur->value_.first, Key_)))
+			{
+				Link = &Cur->next_;
+				Cur = Link->load(std::memory_order_acquire);
+			}
+			return Cur;
+		}
+
+		// 以下在持有Stripe.mutex_时调用
+		_Node* _M_get_node(_Stripe& Stripe);
+		_Node* _M_new_node(_Stripe& Stripe, size_t Hash, const value_type& Val)
+		{
+			_Node* Node = _M_get_node(Stripe);
+			try
+			{
+				TinySTL::construct(&Node->value_, Val);
+			}
+			catch (...)
+			{
+				Node->link_ = Stripe.free_;
+				Stripe.free_ = Node;
+				throw;
+			}
+			Node->hash_ = Hash;
+			return Node;
+		}
+		void _M_retire(_Stripe& Stripe, _Node* Node);
+		void _M_reclaim(_Stripe& Stripe);
+
+		// 写操作结束后(已释放条带锁)：推进代次、协助迁移、必要时开始扩容
+		void _M_after_write(bool Advance);
+		bool _M_try_advance();
+		void _M_start_resize();
+		void _M_migrate(_Table* Table, _Table* Next, unsigned Idx);
+		void _M_retire_table(_Table* Table);
+		void _M_collect_tables();
+
+		template<class Fn>
+		bool _M_write(const key_type& Key_, Fn Func);
+
+	private:
+		std::atomic<_Table*>   table_;
+		std::atomic<uint64_t>  gen_;
+		std::atomic<size_type> size_;
+		hasher                 hash_;
+		key_equal              equals_;
+		std::mutex             resizeMutex_;  // 保护开始扩容与旧表的回收
+		_Table*                retiredTables_;
+		_Stripe                stripes_[s_stripes];
+		_Counter               readers_[2][s_readerShards];
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::concurrent_hash_map(size_type BucketHint, const hasher& Hf, const key_equal& Eql)
+		: table_(nullptr), gen_(0), size_(0), hash_(Hf), equals_(Eql), retiredTables_(nullptr)
+	{
+		size_t Buckets = 2 * s_stripes;
+		while (Buckets < BucketHint)
+			Buckets *= 2;
+		table_.store(_S_new_table(Buckets), std::memory_order_relaxed);
+		for (int Idx = 0; Idx < s_stripes; ++Idx)
+		{
+			stripes_[Idx].free_ = nullptr;
+			stripes_[Idx].retired_ = nullptr;
+			stripes_[Idx].retiredTail_ = nullptr;
+			stripes_[Idx].retiredCount_ = 0;
+			stripes_[Idx].chunks_ = nullptr;
+		}
+		for (int Parity = 0; Parity < 2; ++Parity)
+			for (int Idx = 0; Idx < s_readerShards; ++Idx)
+				readers_[Parity][Idx].count_.store(0, std::memory_order_relaxed);
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::~concurrent_hash_map()
+	{	// 此时已没有其他线程访问：销毁仍在表中的结点与待回收结点的值，再归还所有块
+		_Table* Table = table_.load(std::memory_order_acquire);
+		_Table* Next = Table->next_.load(std::memory_order_acquire);
+		for (size_t Idx = 0; Idx <= Table->mask_; ++Idx)
+		{	// 已迁移的条带在旧表中的结点已被摘除，其值在下面随待回收链表销毁
+			_Table* Live = (Next != nullptr && Table->moved_[_S_stripe_of(Idx)].load()) ? nullptr : Table;
+			for (_Node* Cur = Live ? Table->buckets()[Idx].load() : nullptr; Cur != nullptr; Cur = Cur->next_.load())
+				TinySTL::destroy(&Cur->value_);
+		}
+		if (Next != nullptr)
+		{
+			for (size_t Idx = 0; Idx <= Next->mask_; ++Idx)
+				if (Table->moved_[_S_stripe_of(Idx)].load())
+					for (_Node* Cur = Next->buckets()[Idx].load(); Cur != nullptr; Cur = Cur->next_.load())
+						TinySTL::destroy(&Cur->value_);
+			_S_free_table(Next);
+		}
+		_S_free_table(Table);
+		for (_Table* Old = retiredTables_; Old != nullptr;)
+		{
+			_Table* Link = Old->link_;
+			_S_free_table(Old);
+			Old = Link;
+		}
+		for (int Idx = 0; Idx < s_stripes; ++Idx)
+		{
+			for (_Node* Cur = stripes_[Idx].retired_; Cur != nullptr; Cur = Cur->link_)
+				TinySTL::destroy(&Cur->value_);
+			for (_Node* Chunk = stripes_[Idx].chunks_; Chunk != nullptr;)
+			{
+				_Node* Link = Chunk->link_;
+				Alloc_type::deallocate(Chunk, s_chunkNodes);
+				Chunk = Link;
+			}
+		}
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline typename concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_Table*
+	concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_S_new_table(size_t Buckets)
+	{	// 表头与桶数组在同一块内存中，整块大于128 bytes，不经过alloc的空闲链表
+		void* Mem = Alloc::allocate(sizeof(_Table) + Buckets * sizeof(std::atomic<_Node*>));
+		_Table* Table = static_cast<_Table*>(Mem);
+		Table->mask_ = Buckets - 1;
+		new (&Table->next_) std::atomic<_Table*>(nullptr);
+		new (&Table->cursor_) std::atomic<unsigned>(0);
+		new (&Table->done_) std::atomic<unsigned>(0);
+		for (int Idx = 0; Idx < s_stripes; ++Idx)
+		{
+			new (&Table->claimed_[Idx]) std::atomic<bool>(false);
+			new (&Table->moved_[Idx]) std::atomic<bool>(false);
+		}
+		Table->link_ = nullptr;
+		Table->stamp_ = 0;
+		for (size_t Idx = 0; Idx < Buckets; ++Idx)
+			new (&Table->buckets()[Idx]) std::atomic<_Node*>(nullptr);
+		return Table;
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline void concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_S_free_table(_Table* Table)
+	{
+		Alloc::deallocate(Table, sizeof(_Table) + (Table->mask_ + 1) * sizeof(std::atomic<_Node*>));
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline typename concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_Node*
+	concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_M_get_node(_Stripe& Stripe)
+	{
+		if (Stripe.free_ == nullptr)
+		{	// Chunk[0]串入块链表，Chunk[1..]放入空闲链表
+			_Node* Chunk = Alloc_type::allocate(s_chunkNodes);
+			Chunk->link_ = Stripe.chunks_;
+			Stripe.chunks_ = Chunk;
+			for (int Idx = 1; Idx < s_chunkNodes; ++Idx)
+			{
+				new (&Chunk[Idx].next_) std::atomic<_Node*>(nullptr);
+				Chunk[Idx].link_ = Stripe.free_;
+				Stripe.free_ = Chunk + Idx;
+			}
+		}
+		_Node* Node = Stripe.free_;
+		Stripe.free_ = Node->link_;
+		Node->next_.store(nullptr, std::memory_order_relaxed);
+		return Node;
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline void concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_M_retire(_Stripe& Stripe, _Node* Node)
+	{	// 结点已从链表中摘除；此后才开始的操作都看不到它
+		// 摘除是release写，不能阻止下面读取代次被提前到它之前；全屏障保证记下的代次不早于摘除的时刻
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		Node->stamp_ = gen_.load();
+		Node->link_ = nullptr;
+		if (Stripe.retiredTail_ == nullptr)
+			Stripe.retired_ = Node;
+		else
+			Stripe.retiredTail_->link_ = Node;
+		Stripe.retiredTail_ = Node;
+		++Stripe.retiredCount_;
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline void concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_M_reclaim(_Stripe& Stripe)
+	{	// 待回收链表按摘除的先后排列，代次单调不减，遇到第一个不能回收的即可停止
+		uint64_t Gen = gen_.load();
+		while (Stripe.retired_ != nullptr && Stripe.retired_->stamp_ + 2 <= Gen)
+		{
+			_Node* Node = Stripe.retired_;
+			Stripe.retired_ = Node->link_;
+			TinySTL::destroy(&Node->value_);
+			Node->link_ = Stripe.free_;
+			Stripe.free_ = Node;
+			--Stripe.retiredCount_;
+		}
+		if (Stripe.retired_ == nullptr)
+			Stripe.retiredTail_ = nullptr;
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline bool concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_M_try_advance()
+	{	// 从Gen推进到Gen + 1之前，代次Gen - 1(与Gen + 1同奇偶)的操作必须都已结束
+		uint64_t Gen = gen_.load();
+		for (int Idx = 0; Idx < s_readerShards; ++Idx)
+			if (readers_[(Gen + 1) & 1][Idx].count_.load() != 0)
+				return false;
+		return gen_.compare_exchange_strong(Gen, Gen + 1);
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline void concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_M_start_resize()
+	{
+		std::unique_lock<std::mutex> Lock(resizeMutex_, std::try_to_lock);
+		if (!Lock.owns_lock())
+			return;
+		_Table* Table = table_.load(std::memory_order_acquire);
+		if (Table->next_.load(std::memory_order_acquire) != nullptr || size_.load(std::memory_order_relaxed) <= Table->mask_ + 1)
+			return;
+		Table->next_.store(_S_new_table(2 * (Table->mask_ + 1)), std::memory_order_release);
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline void concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_M_migrate(_Table* Table, _Table* Next, unsigned Idx)
+	{	// 把条带Idx在旧表中的结点复制到新表；旧结点留在旧表中供尚未切换的读者遍历，随后摘除回收
+		_Stripe& Stripe = stripes_[Idx];
+		{
+			std::lock_guard<std::mutex> Lock(Stripe.mutex_);
+			try
+			{
+				for (size_t Bucket = Idx; Bucket <= Table->mask_; Bucket += s_stripes)
+				{
+					for (_Node* Cur = Table->buckets()[Bucket].load(std::memory_order_relaxed); Cur != nullptr;
+						Cur = Cur->next_.load(std::memory_order_relaxed))
+					{
+						_Node* Copy = _M_new_node(Stripe, Cur->hash_, Cur->value_);
+						std::atomic<_Node*>& Head = Next->bucket(Cur->hash_);
+						Copy->next_.store(Head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+						Head.store(Copy, std::memory_order_release);
+					}
+				}
+			}
+			catch (...)
+			{	// moved_[Idx]未置位，其他线程不会访问新表中这一条带的桶：已复制的结点退回空闲链表，
+				// 交还条带供之后的写操作重新认领，异常传给本次写操作的调用者(其修改已经完成)
+				for (size_t Bucket = Idx; Bucket <= Next->mask_; Bucket += s_stripes)
+				{
+					_Node* Cur = Next->buckets()[Bucket].load(std::memory_order_relaxed);
+					Next->buckets()[Bucket].store(nullptr, std::memory_order_relaxed);
+					while (Cur != nullptr)
+					{
+						_Node* Link = Cur->next_.load(std::memory_order_relaxed);
+						TinySTL::destroy(&Cur->value_);
+						Cur->link_ = Stripe.free_;
+						Stripe.free_ = Cur;
+						Cur = Link;
+					}
+				}
+				Table->claimed_[Idx].store(false, std::memory_order_release);
+				throw;
+			}
+			Table->moved_[Idx].store(true, std::memory_order_release);
+			// 此后没有新的操作会进入旧表的这些桶，旧结点的link_不与读者共用，可以直接串入待回收链表
+			for (size_t Bucket = Idx; Bucket <= Table->mask_; Bucket += s_stripes)
+				for (_Node* Cur = Table->buckets()[Bucket].load(std::memory_order_relaxed); Cur != nullptr;
+					Cur = Cur->next_.load(std::memory_order_relaxed))
+					_M_retire(Stripe, Cur);
+		}
+		if (Table->done_.fetch_add(1) + 1 == s_stripes)
+		{	// 全部条带迁移完成，发布新表
+			table_.store(Next, std::memory_order_release);
+			_M_retire_table(Table);
+		}
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline void concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_M_retire_table(_Table* Table)
+	{
+		std::lock_guard<std::mutex> Lock(resizeMutex_);
+		Table->stamp_ = gen_.load();
+		Table->link_ = retiredTables_;
+		retiredTables_ = Table;
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline void concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_M_collect_tables()
+	{
+		std::unique_lock<std::mutex> Lock(resizeMutex_, std::try_to_lock);
+		if (!Lock.owns_lock())
+			return;
+		uint64_t Gen = gen_.load();
+		_Table** Link = &retiredTables_;
+		while (*Link != nullptr)
+		{
+			_Table* Old = *Link;
+			if (Old->stamp_ + 2 <= Gen)
+			{
+				*Link = Old->link_;
+				_S_free_table(Old);
+			}
+			else
+				Link = &Old->link_;
+		}
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline void concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_M_after_write(bool Advance)
+	{
+		if (Advance && _M_try_advance())
+			_M_collect_tables();
+
+		_Table* Table = table_.load(std::memory_order_acquire);
+		_Table* Next = Table->next_.load(std::memory_order_acquire);
+		if (Next != nullptr)
+		{	// 每次写操作协助迁移一个条带：从cursor_轮转取一个条带，尚未被认领时认领并迁移
+			unsigned Idx = Table->cursor_.fetch_add(1) & (s_stripes - 1);
+			if (!Table->claimed_[Idx].load(std::memory_order_relaxed) && !Table->claimed_[Idx].exchange(true))
+				_M_migrate(Table, Next, Idx);
+		}
+		else if (size_.load(std::memory_order_relaxed) > Table->mask_ + 1)
+			_M_start_resize();
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	template<class Fn>
+	inline bool concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::_M_write(const key_type& Key_, Fn Func)
+	{	// Func(Stripe, Table, Hash)在条带锁内执行实际的修改
+		size_t Hash = _M_hash(Key_);
+		_Stripe& Stripe = stripes_[_S_stripe_of(Hash)];
+		bool Result, Advance;
+		{
+			_Guard Guard(*this);
+			{
+				std::lock_guard<std::mutex> Lock(Stripe.mutex_);
+				Result = Func(Stripe, _M_table_for(Hash), Hash);
+				_M_reclaim(Stripe);
+				Advance = Stripe.retiredCount_ >= s_reclaimBatch;
+			}
+			_M_after_write(Advance);
+		}
+		return Result;
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline bool concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::find(const key_type& Key_, mapped_type& Result)
+	{
+		size_t Hash = _M_hash(Key_);
+		_Guard Guard(*this);
+		std::atomic<_Node*>* Link = &_M_table_for(Hash)->bucket(Hash);
+		_Node* Node = _M_find_in(Link, Hash, Key_);
+		if (Node == nullptr)
+			return false;
+		Result = Node->value_.second;
+		return true;
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline bool concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::contains(const key_type& Key_)
+	{
+		size_t Hash = _M_hash(Key_);
+		_Guard Guard(*this);
+		std::atomic<_Node*>* Link = &_M_table_for(Hash)->bucket(Hash);
+		return _M_find_in(Link, Hash, Key_) != nullptr;
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline bool concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::insert(const key_type& Key_, const mapped_type& Val)
+	{
+		return _M_write(Key_, [&](_Stripe& Stripe, _Table* Table, size_t Hash)
+		{
+			std::atomic<_Node*>* Link = &Table->bucket(Hash);
+			if (_M_find_in(Link, Hash, Key_) != nullptr)
+				return false;
+			_Node* Node = _M_new_node(Stripe, Hash, value_type(Key_, Val));
+			std::atomic<_Node*>& Head = Table->bucket(Hash);
+			Node->next_.store(Head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			Head.store(Node, std::memory_order_release);
+			size_.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		});
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline bool concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::insert_or_assign(const key_type& Key_, const mapped_type& Val)
+	{
+		return _M_write(Key_, [&](_Stripe& Stripe, _Table* Table, size_t Hash)
+		{
+			std::atomic<_Node*>* Link = &Table->bucket(Hash);
+			_Node* Old = _M_find_in(Link, Hash, Key_);
+			_Node* Node = _M_new_node(Stripe, Hash, value_type(Key_, Val));
+			if (Old != nullptr)
+			{	// 新结点整体替换旧结点，读者看到的要么是旧值，要么是新值
+				Node->next_.store(Old->next_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+				Link->store(Node, std::memory_order_release);
+				_M_retire(Stripe, Old);
+				return false;
+			}
+			std::atomic<_Node*>& Head = Table->bucket(Hash);
+			Node->next_.store(Head.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			Head.store(Node, std::memory_order_release);
+			size_.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		});
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	inline bool concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::erase(const key_type& Key_)
+	{
+		return _M_write(Key_, [&](_Stripe& Stripe, _Table* Table, size_t Hash)
+		{
+			std::atomic<_Node*>* Link = &Table->bucket(Hash);
+			_Node* Old = _M_find_in(Link, Hash, Key_);
+			if (Old == nullptr)
+				return false;
+			// 只修改前驱的指针，正停在Old上的读者仍可沿Old->next_继续
+			Link->store(Old->next_.load(std::memory_order_relaxed), std::memory_order_release);
+			_M_retire(Stripe, Old);
+			size_.fetch_sub(1, std::memory_order_relaxed);
+			return true;
+		});
+	}
+
+	template<class Key, class T, class HashFcn, class EqualKey, class Alloc>
+	template<class Fn>
+	inline bool concurrent_hash_map<Key, T, HashFcn, EqualKey, Alloc>::update_fn(const key_type& Key_, Fn Func)
+	{
+		return _M_write(Key_, [&](_Stripe& Stripe, _Table* Table, size_t Hash)
+		{
+			std::atomic<_Node*>* Link = &Table->bucket(Hash);
+			_Node* Old = _M_find_in(Link, Hash, Key_);
+			if (Old == nullptr)
+				return false;
+			_Node* Node = _M_new_node(Stripe, Hash, Old->value_);
+			try
+			{
+				Func(Node->value_.second);
+			}
+			catch (...)
+			{
+				TinySTL::destroy(&Node->value_);
+				Node->link_ = Stripe.free_;
+				Stripe.free_ = Node;
+				throw;
+			}
+			Node->next_.store(Old->next_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			Link->store(Node, std::memory_order_release);
+			_M_retire(Stripe, Old);
+			return true;
+		});
+	}
+}
+
+#endif // !_CONCURRENT_HASH_MAP_H_
@@ -0,0 +1,326 @@
+﻿#ifndef _CONCURRENT_STACK_H_
+#define _CONCURRENT_STACK_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "Alloc.h"
+#include "Slist.h"
+
+// 支持16字节CAS的平台(x86-64的cmpxchg16b，AArch64等)上栈顶直接存放{指针, tag}对；
+// 定义_TINYSTL_DISABLE_DWCAS可强制使用打包指针的实现
+#if !defined(_TINYSTL_DISABLE_DWCAS) && (defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16) || (defined(_MSC_VER) && defined(_M_X64) && !defined(__clang__)))
+#define _TINYSTL_DWCAS
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* concurrent_stack : Treiber无锁栈
+	* ***********************************
+	* 结点即_slist_node<T>，栈顶为一个带tag的原子量，任意线程都可以push/try_pop/pop_all
+	*
+	* ABA：栈顶除指针外还带有一个修改计数(tag)，每次成功修改栈顶都会使其加一，
+	*      因此即使同一结点被弹出又压回，过期的CAS也会失败
+	* 内存回收：弹出的结点不归还分配器，而是放入同样带tag的空闲链表中复用，
+	*      这样其他线程读取过期栈顶的_M_next时内存依旧有效；所有结点在析构时统一归还
+	*
+	* 定义了_TINYSTL_DWCAS时{指针, tag}各占一个字，用16字节CAS整体修改；
+	* 否则二者打包进一个64位字：64位平台取低48位作指针、高16位作tag，地址超出48位时直接abort而不截断指针；
+	* 32位平台指针与tag各32位
+	*/
+	template<class T, class Alloc = TinySTL::alloc>
+	class concurrent_stack
+	{
+	public:
+		using value_type      = T;
+		using reference       = value_type&;
+		using const_reference = const value_type&;
+		using size_type       = size_t;
+
+	private:
+		using _Node       = _slist_node<T>;
+		using _Node_base  = _slist_node_base;
+		using Alloc_type  = simple_alloc<_Node, Alloc>;
+
+		// 结点按块分配，每块的首个结点用于串起所有块以便析构时归还。
+		// 整块大于alloc的小区块上限(128 bytes)而直接走malloc，因此多个线程同时扩容是安全的
+		enum { s_chunkNodes = 64 };
+		enum { s_cacheLine = 64 };
+		static_assert(sizeof(_Node) * s_chunkNodes > 128, "concurrent_stack chunk must bypass alloc free lists");
+
+#ifdef _TINYSTL_DWCAS
+		struct tagged_type
+		{
+			_Node_base* ptr;
+			uintptr_t   tag;
+		};
+
+		// 两个字分别以原子方式读取，CAS则作用于整个16字节
+		struct alignas(16) _Head
+		{
+			std::atomic<_Node_base*> ptr_;
+			std::atomic<uintptr_t>   tag_;
+
+			explicit _Head(tagged_type Val) : ptr_(Val.ptr), tag_(Val.tag) {}
+
+			// 两个字可能来自不同的修改，但这样的值与栈顶不符，随后的CAS必然失败；
+			// 结点从不归还分配器，因此读取其中过期指针所指结点的_M_next仍然安全
+			tagged_type load(std::memory_order Order) const
+			{
+				tagged_type Val;
+				Val.tag = tag_.load(std::memory_order_relaxed);
+				Val.ptr = ptr_.load(Order);
+				return Val;
+			}
+
+			// 16字节CAS均为全屏障，内存序参数只为与std::atomic接口一致
+			bool compare_exchange_weak(tagged_type& Expected, tagged_type Desired, std::memory_order, std::memory_order)
+			{
+#ifdef _MSC_VER
+				__int64 Cmp[2] = { (__int64)Expected.ptr, (__int64)Expected.tag };
+				if (_InterlockedCompareExchange128(reinterpret_cast<volatile __int64*>(this), (__int64)Desired.tag, (__int64)Desired.ptr, Cmp))
+					return true;
+				Expected.ptr = (_Node_base*)Cmp[0];
+				Expected.tag = (uintptr_t)Cmp[1];
+				return false;
+#else
+				__extension__ typedef unsigned __int128 _Bits;
+				_Bits Old, New;
+				memcpy(&Old, &Expected, sizeof(_Bits));
+				memcpy(&New, &Desired, sizeof(_Bits));
+				const _Bits Cur = __sync_val_compare_and_swap(reinterpret_cast<_Bits*>(this), Old, New);
+				if (Cur == Old)
+					return true;
+				memcpy(&Expected, &Cur, sizeof(_Bits));
+				return false;
+#endif
+			}
+		};
+		static_assert(sizeof(tagged_type) == 16 && sizeof(_Head) == 16, "concurrent_stack head must be a {pointer, tag} pair");
+#else
+		using tagged_type = uint64_t;
+		using _Head       = std::atomic<tagged_type>;
+
+		static const int         s_ptrBits = sizeof(void*) == 8 ? 48 : 32;
+		static const tagged_type s_ptrMask = (tagged_type(1) << s_ptrBits) - 1;
+#endif
+
+	public:
+		concurrent_stack() : top_(pack(nullptr, 0)), free_(pack(nullptr, 0)), chunks_(nullptr) {}
+		concurrent_stack(const concurrent_stack&) = delete;
+		concurrent_stack& operator=(const concurrent_stack&) = delete;
+		~concurrent_stack();
+
+	public:
+		void push(const value_type& Val);
+		// 栈为空时返回false
+		bool try_pop(value_type& Result);
+		// 一次摘下整条链，按从栈顶到栈底的顺序对每个元素调用Func，返回处理的元素个数
+		template<class Fn>
+		size_type pop_all(Fn Func);
+
+		// 近似值，仅供参考
+		bool empty() const { return ptr_of(top_.load(std::memory_order_acquire)) == nullptr; }
+
+	private:
+#ifdef _TINYSTL_DWCAS
+		static tagged_type pack(_Node_base* Ptr, uintptr_t Tag) { return tagged_type{ Ptr, Tag }; }
+		static _Node_base* ptr_of(tagged_type Val) { return Val.ptr; }
+		static uintptr_t tag_of(tagged_type Val) { return Val.tag; }
+#else
+		static tagged_type pack(_Node_base* Ptr, tagged_type Tag)
+		{
+			const tagged_type Addr = static_cast<tagged_type>(reinterpret_cast<uintptr_t>(Ptr));
+			// 截断后的指针会被当作另一个结点使用，宁可立即终止
+			if ((Addr & ~s_ptrMask) != 0)
+				std::abort();
+			return Addr | (Tag << s_ptrBits);
+		}
+		static _Node_base* ptr_of(tagged_type Val)
+		{
+			return reinterpret_cast<_Node_base*>(static_cast<uintptr_t>(Val & s_ptrMask));
+		}
+		static tagged_type tag_of(tagged_type Val) { return Val >> s_ptrBits; }
+#endif
+
+		// 以原子方式访问_M_next：其他线程可能正在读取过期栈顶结点的_M_next
+		static std::atomic<_Node_base*>& next_of(_Node_base* Node)
+		{
+			static_assert(sizeof(std::atomic<_Node_base*>) == sizeof(_Node_base*), "atomic pointer must match _M_next layout");
+			return *reinterpret_cast<std::atomic<_Node_base*>*>(&Node->_M_next);
+		}
+
+		// 以下三个函数同时用于栈本身(top_)与空闲链表(free_)
+		static void push_chain(_Head& Head, _Node_base* First, _Node_base* Last);
+		static _Node_base* pop_node(_Head& Head);
+		static _Node_base* detach_all(_Head& Head);
+
+		_Node* get_node();
+		void put_node(_Node_base* Node) { push_chain(free_, Node, Node); }
+
+		struct _Discard
+		{
+			void operator()(value_type&) const {}
+		};
+
+	private:
+		// 栈顶与空闲链表分处不同的cache line，避免push/pop与结点回收之间的伪共享
+		alignas(s_cacheLine) _Head    top_;
+		alignas(s_cacheLine) _Head    free_;
+		std::atomic<_Node_base*>      chunks_; // 已分配的块，只增不减
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	template<class T, class Alloc>
+	inline concurrent_stack<T, Alloc>::~concurrent_stack()
+	{
+		pop_all(_Discard());
+		_Node_base* Chunk = chunks_.load(std::memory_order_acquire);
+		while (Chunk != nullptr)
+		{
+			_Node_base* Next = Chunk->_M_next;
+			Alloc_type::deallocate((_Node*)Chunk, s_chunkNodes);
+			Chunk = Next;
+		}
+	}
+
+	template<class T, class Alloc>
+	inline void concurrent_stack<T, Alloc>::push_chain(_Head& Head, _Node_base* First, _Node_base* Last)
+	{	// 将已串好的[First, Last]整体压入
+		tagged_type Old = Head.load(std::memory_order_relaxed);
+		do
+		{
+			next_of(Last).store(ptr_of(Old), std::memory_order_relaxed);
+		} while (!Head.compare_exchange_weak(Old, pack(First, tag_of(Old) + 1), std::memory_order_release, std::memory_order_relaxed));
+	}
+
+	template<class T, class Alloc>
+	inline typename concurrent_stack<T, Alloc>::_Node_base*
+	concurrent_stack<T, Alloc>::pop_node(_Head& Head)
+	{
+		tagged_type Old = Head.load(std::memory_order_acquire);
+		for (;;)
+		{
+			_Node_base* Top = ptr_of(Old);
+			if (Top == nullptr)
+				return nullptr;
+			// Top可能已被其他线程弹出并复用，此时读到的Next是过期的，但tag保证下面的CAS必然失败
+			_Node_base* Next = next_of(Top).load(std::memory_order_relaxed);
+			if (Head.compare_exchange_weak(Old, pack(Next, tag_of(Old) + 1), std::memory_order_acquire, std::memory_order_acquire))
+				return Top;
+		}
+	}
+
+	template<class T, class Alloc>
+	inline typename concurrent_stack<T, Alloc>::_Node_base*
+	concurrent_stack<T, Alloc>::detach_all(_Head& Head)
+	{
+		tagged_type Old = Head.load(std::memory_order_acquire);
+		while (ptr_of(Old) != nullptr
+			&& !Head.compare_exchange_weak(Old, pack(nullptr, tag_of(Old) + 1), std::memory_order_acquire, std::memory_order_acquire))
+		{
+		}
+		return ptr_of(Old);
+	}
+
+	template<class T, class Alloc>
+	inline typename concurrent_stack<T, Alloc>::_Node* concurrent_stack<T, Alloc>::get_node()
+	{
+		_Node_base* Node = pop_node(free_);
+		if (Node != nullptr)
+			return (_Node*)Node;
+
+		// 空闲链表为空，分配新的一块
+		_Node* Chunk = Alloc_type::allocate(s_chunkNodes);
+		_Node_base* Head = chunks_.load(std::memory_order_relaxed);
+		do
+		{
+			Chunk->_M_next = Head;
+		} while (!chunks_.compare_exchange_weak(Head, Chunk, std::memory_order_release, std::memory_order_relaxed));
+
+		// Chunk[1]返回给调用者，Chunk[2..]串起来放入空闲链表
+		for (int Idx = 2; Idx < s_chunkNodes - 1; ++Idx)
+			next_of(Chunk + Idx).store(Chunk + Idx + 1, std::memory_order_relaxed);
+		push_chain(free_, Chunk + 2, Chunk + s_chunkNodes - 1);
+		return Chunk + 1;
+	}
+
+	template<class T, class Alloc>
+	inline void concurrent_stack<T, Alloc>::push(const value_type& Val)
+	{
+		_Node* Node = get_node();
+		try
+		{
+			TinySTL::construct(&Node->_M_data, Val);
+		}
+		catch (...)
+		{
+			put_node(Node);
+			throw;
+		}
+		push_chain(top_, Node, Node);
+	}
+
+	template<class T, class Alloc>
+	inline bool concurrent_stack<T, Alloc>::try_pop(value_type& Result)
+	{
+		_Node* Node = (_Node*)pop_node(top_);
+		if (Node == nullptr)
+			return false;
+		try
+		{
+			Result = Node->_M_data;
+		}
+		catch (...)
+		{
+			push_chain(top_, Node, Node); // 放回栈中
+			throw;
+		}
+		TinySTL::destroy(&Node->_M_data);
+		put_node(Node);
+		return true;
+	}
+
+	template<class T, class Alloc>
+	template<class Fn>
+	inline typename concurrent_stack<T, Alloc>::size_type concurrent_stack<T, Alloc>::pop_all(Fn Func)
+	{	// 摘下的链只属于当前线程，处理完后整条归还空闲链表，只需一次CAS
+		_Node_base* First = detach_all(top_);
+		_Node_base* Prev = nullptr;
+		_Node_base* Cur = First;
+		size_type Count = 0;
+		try
+		{
+			for (; Cur != nullptr; Prev = Cur, Cur = next_of(Cur).load(std::memory_order_relaxed))
+			{
+				_Node* Node = (_Node*)Cur;
+				Func(Node->_M_data);
+				TinySTL::destroy(&Node->_M_data);
+				++Count;
+			}
+		}
+		catch (...)
+		{	// [First, Cur)已处理，其余(含Cur)放回栈中
+			_Node_base* Last = Cur;
+			while (next_of(Last).load(std::memory_order_relaxed) != nullptr)
+				Last = next_of(Last).load(std::memory_order_relaxed);
+			push_chain(top_, Cur, Last);
+			if (Prev != nullptr)
+				push_chain(free_, First, Prev);
+			throw;
+		}
+		if (Prev != nullptr)
+			push_chain(free_, First, Prev);
+		return Count;
+	}
+}
+
+#endif // !_CONCURRENT_STACK_H_
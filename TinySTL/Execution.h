@@ -0,0 +1,557 @@
+﻿#ifndef _EXECUTION_H_
+#define _EXECUTION_H_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "Iterator.h"
+#include "TypeTraits.h"
+#include "Algorithm.h"
+#include "ThreadPool.h"
+
+namespace TinySTL
+{
+	namespace execution
+	{
+		/*
+		* ***********************************
+		* 执行策略
+		* ***********************************
+		* seq       : 在调用线程上依次执行，与不带策略的版本相同
+		* par       : 把区间二分为不长于粒度的块，在工作窃取线程池上以fork-join方式执行，元素操作可能在多个线程上同时进行
+		* par_unseq : 执行方式与par相同，另允许块内的循环被向量化，元素操作不得加锁
+		* 并行策略可以指定粒度(每块元素个数的上限)与线程池，如par.with_grain(1 << 16).on(Pool)；
+		* 粒度为0(默认)时取N / (8 * (线程数 + 1))且不小于s_minGrain，未指定线程池时使用thread_pool::default_pool()
+		* 迭代器不是随机访问迭代器，或者区间不长于粒度时，并行策略也在调用线程上依次执行
+		*/
+		class sequenced_policy {};
+
+		template<bool Unseq>
+		class basic_parallel_policy
+		{
+		public:
+			enum : size_t { s_minGrain = 2048 };
+
+			constexpr basic_parallel_policy() : grain_(0), pool_(nullptr) {}
+
+			// 同类策略，粒度为Grain
+			constexpr basic_parallel_policy with_grain(size_t Grain) const { return basic_parallel_policy(Grain, pool_); }
+			// 同类策略，在Pool上执行；Pool须在使用该策略的算法返回前一直存在
+			constexpr basic_parallel_policy on(thread_pool& Pool) const { return basic_parallel_policy(grain_, &Pool); }
+
+			constexpr size_t grain() const { return grain_; }
+			thread_pool& pool() const { return pool_ != nullptr ? *pool_ : thread_pool::default_pool(); }
+
+			// 区间有N个元素时实际使用的粒度
+			size_t grain_for(size_t N) const
+			{
+				if (grain_ != 0)
+					return grain_;
+				size_t Grain = N / (8 * (pool().size() + 1));
+				return Grain < s_minGrain ? static_cast<size_t>(s_minGrain) : Grain;
+			}
+
+		private:
+			constexpr basic_parallel_policy(size_t Grain, thread_pool* Pool) : grain_(Grain), pool_(Pool) {}
+
+		private:
+			size_t       grain_;
+			thread_pool* pool_;
+		};
+
+		using parallel_policy             = basic_parallel_policy<false>;
+		using parallel_unsequenced_policy = basic_parallel_policy<true>;
+
+		inline constexpr sequenced_policy            seq{};
+		inline constexpr parallel_policy             par{};
+		inline constexpr parallel_unsequenced_policy par_unseq{};
+	}
+
+	template <class>
+	inline constexpr bool is_execution_policy_v = false;
+
+	template <>
+	inline constexpr bool is_execution_policy_v<execution::sequenced_policy> = true;
+
+	template <bool Unseq>
+	inline constexpr bool is_execution_policy_v<execution::basic_parallel_policy<Unseq>> = true;
+
+	template <class T>
+	struct is_execution_policy : bool_constant<is_execution_policy_v<T>> {};
+
+	// 带策略的重载只在第一个实参是执行策略时参与重载决议，以免与不带策略、参数个数相同的版本(如二元transform)混淆
+	template <class ExPo>
+	using _Enable_if_execution_policy_t = enable_if_t<is_execution_policy_v<remove_cvref_t<ExPo>>, int>;
+
+	template <class ExPo>
+	inline constexpr bool _Is_parallel_policy_v = is_execution_policy_v<remove_cvref_t<ExPo>>
+		&& !is_same_v<remove_cvref_t<ExPo>, execution::sequenced_policy>;
+
+	/*
+	* ***********************************
+	* 并行执行的骨架
+	* ***********************************
+	* _Par_for    : 在[Begin, End)上执行Body(Begin, End)，区间长于Grain时二分，两半经thread_pool::invoke分头执行
+	* _Par_reduce : 同上，各块返回的结果以Combine两两合并；结果类型须能默认构造
+	* _Par_run    : 按策略选择并行或直接执行Body(0, N)
+	* 块内的函数对象以引用共享，交给不带策略的算法时按值复制，因此每块使用自己的副本
+	*/
+	template <class Fn>
+	inline void _Par_for(thread_pool& Pool, size_t Begin, size_t End, size_t Grain, Fn& Body)
+	{
+		if (End - Begin <= Grain)
+		{
+			Body(Begin, End);
+			return;
+		}
+		const size_t Mid = Begin + (End - Begin) / 2;
+		Pool.invoke([&] { TinySTL::_Par_for(Pool, Begin, Mid, Grain, Body); },
+			[&] { TinySTL::_Par_for(Pool, Mid, End, Grain, Body); });
+	}
+
+	template <class T, class Fn, class Op>
+	inline T _Par_reduce(thread_pool& Pool, size_t Begin, size_t End, size_t Grain, Fn& Body, Op& Combine)
+	{
+		if (End - Begin <= Grain)
+			return Body(Begin, End);
+		const size_t Mid = Begin + (End - Begin) / 2;
+		T Left{}, Right{};
+		Pool.invoke([&] { Left = TinySTL::_Par_reduce<T>(Pool, Begin, Mid, Grain, Body, Combine); },
+			[&] { Right = TinySTL::_Par_reduce<T>(Pool, Mid, End, Grain, Body, Combine); });
+		return Combine(Left, Right);
+	}
+
+	template <class ExPo, class Fn>
+	inline void _Par_run(const ExPo& Policy, size_t N, Fn Body)
+	{
+		if constexpr (_Is_parallel_policy_v<ExPo>)
+		{
+			const size_t Grain = Policy.grain_for(N);
+			if (N > Grain)
+			{
+				TinySTL::_Par_for(Policy.pool(), 0, N, Grain, Body);
+				return;
+			}
+		}
+		Body(static_cast<size_t>(0), N);
+	}
+
+	template <class T, class ExPo, class Fn, class Op>
+	inline T _Par_run_reduce(const ExPo& Policy, size_t N, Fn Body, Op Combine)
+	{
+		if constexpr (_Is_parallel_policy_v<ExPo>)
+		{
+			const size_t Grain = Policy.grain_for(N);
+			if (N > Grain)
+				return TinySTL::_Par_reduce<T>(Policy.pool(), 0, N, Grain, Body, Combine);
+		}
+		return Body(static_cast<size_t>(0), N);
+	}
+
+	/*
+	* ***********************************
+	* 带执行策略的算法
+	* ***********************************
+	* for_each / fill / copy / transform / generate : 各块处理区间的一段，输出区间也须是随机访问的才并行
+	* count_if                                      : 各块分别计数后相加
+	* find_if / any_of / all_of / none_of           : 各块从前向后查找，以原子变量记录已找到的最小下标，
+	*                                                 起点在其后的块跳过剩余部分；返回的仍是第一个满足条件的位置
+	* sort                                          : 样本排序，按样本选出的分割元素把元素分到各桶中，各桶再并行排序，
+	*                                                 见_Par_sample_sort
+	* stable_sort                                   : 归并排序，两半经invoke并行排序后并行归并，不长于粒度的部分用不带策略的stable_sort
+	* sort与stable_sort的临时区间是与区间等长的_Temp_buffer，取自::operator new，多个线程可以同时排序
+	* generate的每块使用生成器的一个副本，有状态的生成器在各块中从同一状态开始
+	* 元素操作抛出的异常在其所在的invoke两侧都结束后重新抛出
+	*/
+	template <class ExPo, class FwdIt, class Fn, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline void for_each(ExPo&& Policy, FwdIt First, FwdIt Last, Fn Func)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt>)
+			TinySTL::_Par_run(Policy, static_cast<size_t>(Last - First),
+				[&](size_t Begin, size_t End) { TinySTL::for_each(First + Begin, First + End, Func); });
+		else
+			TinySTL::for_each(First, Last, Func);
+	}
+
+	template <class ExPo, class FwdIt, class T, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline void fill(ExPo&& Policy, FwdIt First, FwdIt Last, const T& Val)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt>)
+			TinySTL::_Par_run(Policy, static_cast<size_t>(Last - First),
+				[&](size_t Begin, size_t End) { TinySTL::fill(First + Begin, First + End, Val); });
+		else
+			TinySTL::fill(First, Last, Val);
+	}
+
+	template <class ExPo, class FwdIt1, class FwdIt2, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline FwdIt2 copy(ExPo&& Policy, FwdIt1 First, FwdIt1 Last, FwdIt2 Dest)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt1> && TinySTL::is_random_iter_v<FwdIt2>)
+		{
+			const size_t N = static_cast<size_t>(Last - First);
+			TinySTL::_Par_run(Policy, N,
+				[&](size_t Begin, size_t End) { TinySTL::copy(First + Begin, First + End, Dest + Begin); });
+			return Dest + N;
+		}
+		else
+			return TinySTL::copy(First, Last, Dest);
+	}
+
+	template <class ExPo, class FwdIt1, class FwdIt2, class Fn, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline FwdIt2 transform(ExPo&& Policy, FwdIt1 First, FwdIt1 Last, FwdIt2 Dest, Fn Func)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt1> && TinySTL::is_random_iter_v<FwdIt2>)
+		{
+			const size_t N = static_cast<size_t>(Last - First);
+			TinySTL::_Par_run(Policy, N,
+				[&](size_t Begin, size_t End) { TinySTL::transform(First + Begin, First + End, Dest + Begin, Func); });
+			return Dest + N;
+		}
+		else
+			return TinySTL::transform(First, Last, Dest, Func);
+	}
+
+	template <class ExPo, class FwdIt1, class FwdIt2, class FwdIt3, class Fn, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline FwdIt3 transform(ExPo&& Policy, FwdIt1 First1, FwdIt1 Last1, FwdIt2 First2, FwdIt3 Dest, Fn Func)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt1> && TinySTL::is_random_iter_v<FwdIt2> && TinySTL::is_random_iter_v<FwdIt3>)
+		{
+			const size_t N = static_cast<size_t>(Last1 - First1);
+			TinySTL::_Par_run(Policy, N, [&](size_t Begin, size_t End)
+			{
+				TinySTL::transform(First1 + Begin, First1 + End, First2 + Begin, Dest + Begin, Func);
+			});
+			return Dest + N;
+		}
+		else
+			return TinySTL::transform(First1, Last1, First2, Dest, Func);
+	}
+
+	template <class ExPo, class FwdIt, class Fn, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline void generate(ExPo&& Policy, FwdIt First, FwdIt Last, Fn Func)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt>)
+			TinySTL::_Par_run(Policy, static_cast<size_t>(Last - First),
+				[&](size_t Begin, size_t End) { TinySTL::generate(First + Begin, First + End, Func); });
+		else
+			TinySTL::generate(First, Last, Func);
+	}
+
+	template <class ExPo, class FwdIt, class Pr, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline typename TinySTL::iterator_traits<FwdIt>::difference_type count_if(ExPo&& Policy, FwdIt First, FwdIt Last, Pr Pred)
+	{
+		using Diff = typename TinySTL::iterator_traits<FwdIt>::difference_type;
+		if constexpr (TinySTL::is_random_iter_v<FwdIt>)
+			return TinySTL::_Par_run_reduce<Diff>(Policy, static_cast<size_t>(Last - First),
+				[&](size_t Begin, size_t End) { return TinySTL::count_if(First + Begin, First + End, Pred); },
+				[](Diff Left, Diff Right) { return Left + Right; });
+		else
+			return TinySTL::count_if(First, Last, Pred);
+	}
+
+	// 每查找_Par_find_step个元素检查一次前面的块是否已经找到
+	inline constexpr size_t _Par_find_step = 1024;
+
+	template <class ExPo, class FwdIt, class Pr, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline FwdIt find_if(ExPo&& Policy, FwdIt First, FwdIt Last, Pr Pred)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt>)
+		{
+			const size_t N = static_cast<size_t>(Last - First);
+			std::atomic<size_t> Found(N);
+			TinySTL::_Par_run(Policy, N, [&](size_t Begin, size_t End)
+			{
+				for (size_t Step = Begin; Step < End; Step += _Par_find_step)
+				{
+					if (Found.load(std::memory_order_relaxed) < Step)
+						return;
+					const size_t Stop = End - Step < _Par_find_step ? End : Step + _Par_find_step;
+					const FwdIt It = TinySTL::find_if(First + Step, First + Stop, Pred);
+					if (It != First + Stop)
+					{
+						const size_t Idx = static_cast<size_t>(It - First);
+						size_t Cur = Found.load(std::memory_order_relaxed);
+						while (Idx < Cur && !Found.compare_exchange_weak(Cur, Idx, std::memory_order_relaxed))
+							;
+						return;
+					}
+				}
+			});
+			// invoke返回前已与各块同步，这里读到的就是最小下标
+			return First + Found.load(std::memory_order_relaxed);
+		}
+		else
+			return TinySTL::find_if(First, Last, Pred);
+	}
+
+	template <class ExPo, class FwdIt, class Pr, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline bool any_of(ExPo&& Policy, FwdIt First, FwdIt Last, Pr Pred)
+	{
+		return TinySTL::find_if(Policy, First, Last, Pred) != Last;
+	}
+
+	template <class ExPo, class FwdIt, class Pr, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline bool all_of(ExPo&& Policy, FwdIt First, FwdIt Last, Pr Pred)
+	{
+		return TinySTL::find_if(Policy, First, Last, [&Pred](auto&& Val) { return !Pred(Val); }) == Last;
+	}
+
+	template <class ExPo, class FwdIt, class Pr, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline bool none_of(ExPo&& Policy, FwdIt First, FwdIt Last, Pr Pred)
+	{
+		return TinySTL::find_if(Policy, First, Last, Pred) == Last;
+	}
+
+	template <class RanIt, class Pr>
+	inline void _Par_sort(thread_pool& Pool, RanIt First, RanIt Last, size_t Grain, Pr& Pred, int Depth)
+	{
+		using T = typename TinySTL::iterator_traits<RanIt>::value_type;
+		const size_t N = static_cast<size_t>(Last - First);
+		if (N <= Grain || Depth <= 0)
+		{
+			TinySTL::sort(First, Last, Pred);
+			return;
+		}
+		const T& A = *First;
+		const T& B = *(First + N / 2);
+		const T& C = *(Last - 1);
+		const T Pivot = Pred(A, B) ? (Pred(B, C) ? B : (Pred(A, C) ? C : A)) : (Pred(A, C) ? A : (Pred(B, C) ? C : B));
+		// [First, Mid1)小于枢轴，[Mid1, Mid2)等于枢轴，[Mid2, Last)大于枢轴；大量重复元素时中间一段不再参与递归
+		RanIt Mid1 = TinySTL::partition(First, Last, [&](const T& Val) { return Pred(Val, Pivot); });
+		RanIt Mid2 = TinySTL::partition(Mid1, Last, [&](const T& Val) { return !Pred(Pivot, Val); });
+		Pool.invoke([&] { TinySTL::_Par_sort(Pool, First, Mid1, Grain, Pred, Depth - 1); },
+			[&] { TinySTL::_Par_sort(Pool, Mid2, Last, Grain, Pred, Depth - 1); });
+	}
+
+	inline int _Par_sort_depth(size_t N)
+	{
+		int Depth = 0; // 约2*log2(N)层，枢轴一再选得很差时余下的部分依次排序
+		for (; N > 1; N >>= 1)
+			Depth += 2;
+		return Depth;
+	}
+
+	inline constexpr size_t _Sample_sort_max_buckets = 256;
+	inline constexpr size_t _Sample_sort_oversampling = 16;
+
+	/*
+	* 样本排序：
+	* 1. 随机取Buckets * _Sample_sort_oversampling个样本排序，每隔_Sample_sort_oversampling个取一个作分割元素，去掉相等的
+	* 2. 区间分为Buckets块，各块并行地以二分查找确定每个元素所属的桶并计数；
+	*    分割元素有重复时(某个值占了很大比例)，每个分割元素另有一个只放与它相等的元素的桶，这些桶不用排序
+	* 3. 按桶、块的顺序求计数的前缀和，各块并行地把元素移到临时区间中各自的位置
+	* 4. 各桶并行地移回原区间并排序，长于粒度的桶再用_Par_sort
+	* 除第3步的前缀和外每一步都是并行的，数据只在原区间与临时区间之间各移动一次
+	*/
+	template <class RanIt, class Pr>
+	inline void _Par_sample_sort(thread_pool& Pool, RanIt First, size_t N, size_t Grain, Pr& Pred)
+	{
+		using T = typename TinySTL::iterator_traits<RanIt>::value_type;
+		using Id = unsigned short;
+
+		if (N < 2 * _Sample_sort_oversampling)
+		{
+			TinySTL::sort(First, First + N, Pred);
+			return;
+		}
+		size_t Buckets = N / (Grain < _Sample_sort_oversampling ? _Sample_sort_oversampling : Grain);
+		Buckets = Buckets < 2 ? 2 : (Buckets > _Sample_sort_max_buckets ? _Sample_sort_max_buckets : Buckets);
+
+		// 1. 取样，样本所在的区间随后存放分割元素
+		const size_t SampleCount = Buckets * _Sample_sort_oversampling;
+		TinySTL::_Temp_buffer<T> SampleBuf(First, SampleCount);
+		T* const Splitters = SampleBuf._M_begin();
+		unsigned long long Seed = N;
+		for (size_t I = 0; I < SampleCount; ++I)
+		{
+			Seed = Seed * 6364136223846793005ull + 1442695040888963407ull;
+			Splitters[I] = First[static_cast<size_t>((Seed >> 33) % N)];
+		}
+		TinySTL::sort(Splitters, Splitters + SampleCount, Pred);
+		size_t SplitCount = 0;
+		bool Equal = false;
+		for (size_t I = _Sample_sort_oversampling; I < SampleCount; I += _Sample_sort_oversampling)
+		{
+			if (SplitCount != 0 && !Pred(Splitters[SplitCount - 1], Splitters[I]))
+				Equal = true;
+			else
+				Splitters[SplitCount++] = Splitters[I];
+		}
+
+		// 2. 分类与计数；第j个桶放不小于Splitters[j - 1]且小于Splitters[j]的元素，
+		// Equal为true时改为2j号，2j - 1号桶放等于Splitters[j - 1]的元素
+		const size_t BucketCount = Equal ? 2 * SplitCount + 1 : SplitCount + 1;
+		const size_t Blocks = Buckets;
+		const size_t BlockLen = (N + Blocks - 1) / Blocks;
+		TinySTL::_Temp_buffer<Id> Ids(N);
+		TinySTL::_Temp_buffer<size_t> Counts(Blocks * BucketCount); // 第B块的计数在[B * BucketCount, (B + 1) * BucketCount)
+		TinySTL::_Temp_buffer<size_t> BucketStart(BucketCount + 1);
+		Id* const IdOf = Ids._M_begin();
+		size_t* const Count = Counts._M_begin();
+		size_t* const Start = BucketStart._M_begin();
+		TinySTL::fill(Count, Count + Blocks * BucketCount, static_cast<size_t>(0));
+
+		auto ForEachBlock = [&](auto&& Fn)
+		{
+			auto Body = [&](size_t Begin, size_t End)
+			{
+				for (size_t B = Begin; B < End; ++B)
+				{
+					const size_t Lo = B * BlockLen;
+					if (Lo < N)
+						Fn(B, Lo, N - Lo < BlockLen ? N : Lo + BlockLen);
+				}
+			};
+			TinySTL::_Par_for(Pool, 0, Blocks, 1, Body);
+		};
+
+		ForEachBlock([&](size_t B, size_t Lo, size_t Hi)
+		{
+			size_t* const BlockCount = Count + B * BucketCount;
+			for (size_t I = Lo; I < Hi; ++I)
+			{
+				const T& Val = First[I];
+				size_t J = static_cast<size_t>(TinySTL::upper_bound(Splitters, Splitters + SplitCount, Val, Pred) - Splitters);
+				if (Equal)
+					J = (J != 0 && !Pred(Splitters[J - 1], Val)) ? 2 * J - 1 : 2 * J;
+				IdOf[I] = static_cast<Id>(J);
+				++BlockCount[J];
+			}
+		});
+
+		// 3. 前缀和：Count变为每块每桶的写入位置
+		size_t Sum = 0;
+		for (size_t J = 0; J < BucketCount; ++J)
+		{
+			Start[J] = Sum;
+			for (size_t B = 0; B < Blocks; ++B)
+			{
+				const size_t C = Count[B * BucketCount + J];
+				Count[B * BucketCount + J] = Sum;
+				Sum += C;
+			}
+		}
+		Start[BucketCount] = N;
+
+		TinySTL::_Temp_buffer<T> Buf(First, N);
+		T* const Tmp = Buf._M_begin();
+		ForEachBlock([&](size_t B, size_t Lo, size_t Hi)
+		{
+			size_t* const BlockPos = Count + B * BucketCount;
+			for (size_t I = Lo; I < Hi; ++I)
+				Tmp[BlockPos[IdOf[I]]++] = std::move(First[I]);
+		});
+
+		// 4. 各桶移回并排序
+		const int Depth = TinySTL::_Par_sort_depth(N);
+		auto SortBucket = [&](size_t Begin, size_t End)
+		{
+			for (size_t J = Begin; J < End; ++J)
+			{
+				TinySTL::_Move_range(Tmp + Start[J], Tmp + Start[J + 1], First + Start[J]);
+				if (!Equal || J % 2 == 0)
+					TinySTL::_Par_sort(Pool, First + Start[J], First + Start[J + 1], Grain, Pred, Depth);
+			}
+		};
+		TinySTL::_Par_for(Pool, 0, BucketCount, 1, SortBucket);
+	}
+
+	template <class ExPo, class RanIt, class Pr, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline void sort(ExPo&& Policy, RanIt First, RanIt Last, Pr Pred)
+	{
+		if constexpr (_Is_parallel_policy_v<ExPo>)
+		{
+			const size_t N = static_cast<size_t>(Last - First);
+			const size_t Grain = Policy.grain_for(N);
+			if (N > Grain)
+			{
+				TinySTL::_Par_sample_sort(Policy.pool(), First, N, Grain, Pred);
+				return;
+			}
+		}
+		TinySTL::sort(First, Last, Pred);
+	}
+
+	template <class ExPo, class RanIt, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline void sort(ExPo&& Policy, RanIt First, RanIt Last)
+	{
+		TinySTL::sort(Policy, First, Last, TinySTL::less<typename TinySTL::iterator_traits<RanIt>::value_type>());
+	}
+
+	// 把有序的[First1, Last1)与[First2, Last2)稳定地移动归并到Dest：较长一段的中点在另一段中二分，两部分经invoke并行归并
+	// 较长一段不短于2时中点两侧都至少有一个元素，两部分都比原问题小；两段都不长于1时直接归并，否则可能原样递归下去
+	template <class It1, class It2, class OutIt, class Pr>
+	inline void _Par_merge_move(thread_pool& Pool, It1 First1, It1 Last1, It2 First2, It2 Last2, OutIt Dest, size_t Grain, Pr& Pred)
+	{
+		const size_t N1 = static_cast<size_t>(Last1 - First1);
+		const size_t N2 = static_cast<size_t>(Last2 - First2);
+		if (N1 + N2 <= Grain || (N1 < 2 && N2 < 2))
+		{
+			TinySTL::_Merge_move(First1, Last1, First2, Last2, Dest, Pred);
+			return;
+		}
+		It1 Mid1 = First1;
+		It2 Mid2 = First2;
+		if (N1 >= N2)
+		{	// 第二段中与*Mid1相等的元素排在它之后
+			Mid1 = First1 + N1 / 2;
+			Mid2 = TinySTL::lower_bound(First2, Last2, *Mid1, Pred);
+		}
+		else
+		{	// 第一段中与*Mid2相等的元素排在它之前
+			Mid2 = First2 + N2 / 2;
+			Mid1 = TinySTL::upper_bound(First1, Last1, *Mid2, Pred);
+		}
+		const OutIt DestMid = Dest + ((Mid1 - First1) + (Mid2 - First2));
+		Pool.invoke([&] { TinySTL::_Par_merge_move(Pool, First1, Mid1, First2, Mid2, Dest, Grain, Pred); },
+			[&] { TinySTL::_Par_merge_move(Pool, Mid1, Last1, Mid2, Last2, DestMid, Grain, Pred); });
+	}
+
+	// 对[First, First + N)稳定排序，Buf是等长的临时区间；ToBuf为true时结果留在Buf中，否则在原区间中
+	template <class RanIt, class T, class Pr>
+	inline void _Par_stable_sort(thread_pool& Pool, RanIt First, T* Buf, size_t N, size_t Grain, Pr& Pred, bool ToBuf)
+	{
+		if (N <= Grain)
+		{
+			TinySTL::_Stable_sort_buffered(First, First + N, Buf, Pred);
+			if (ToBuf)
+				TinySTL::_Move_range(First, First + N, Buf);
+			return;
+		}
+		const size_t Half = N / 2;
+		// 两半的结果放在与本层相反的一侧，再归并到本层的一侧
+		Pool.invoke([&] { TinySTL::_Par_stable_sort(Pool, First, Buf, Half, Grain, Pred, !ToBuf); },
+			[&] { TinySTL::_Par_stable_sort(Pool, First + Half, Buf + Half, N - Half, Grain, Pred, !ToBuf); });
+		if (ToBuf)
+			TinySTL::_Par_merge_move(Pool, First, First + Half, First + Half, First + N, Buf, Grain, Pred);
+		else
+			TinySTL::_Par_merge_move(Pool, Buf, Buf + Half, Buf + Half, Buf + N, First, Grain, Pred);
+	}
+
+	template <class ExPo, class RanIt, class Pr, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline void stable_sort(ExPo&& Policy, RanIt First, RanIt Last, Pr Pred)
+	{
+		if constexpr (_Is_parallel_policy_v<ExPo>)
+		{
+			using T = typename TinySTL::iterator_traits<RanIt>::value_type;
+			const size_t N = static_cast<size_t>(Last - First);
+			const size_t Grain = Policy.grain_for(N);
+			if (N > Grain)
+			{
+				TinySTL::_Temp_buffer<T> Buf(First, N);
+				TinySTL::_Par_stable_sort(Policy.pool(), First, Buf._M_begin(), N, Grain, Pred, false);
+				return;
+			}
+		}
+		TinySTL::stable_sort(First, Last, Pred);
+	}
+
+	template <class ExPo, class RanIt, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline void stable_sort(ExPo&& Policy, RanIt First, RanIt Last)
+	{
+		TinySTL::stable_sort(Policy, First, Last, TinySTL::less<typename TinySTL::iterator_traits<RanIt>::value_type>());
+	}
+}
+
+#endif // !_EXECUTION_H_
@@ -0,0 +1,176 @@
+﻿#ifndef _FLAT_HASH_MAP_H_
+#define _FLAT_HASH_MAP_H_
+
+#include <new>
+#include <utility>
+#include <stdexcept>
+
+#include "FlatHashtable.h"
+#include "Functional.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* flat_hash_map : 以_Flat_hashtable为底层的无序关联容器
+	* ***********************************
+	* 元素pair<const Key, T>直接存放在表中，没有节点开销；查找时一次比较16个控制字节
+	* 插入可能引起重新哈希，使所有迭代器、指针与引用失效，这一点与unordered_map不同
+	* hasher与key_equal都定义了is_transparent时，find/count/contains/erase接受与键值可比较的任意类型
+	*
+	* operator[]/try_emplace/insert_or_assign只查找一次：未命中时直接在探测到的槽中构造元素
+	*/
+	template<class _Key, class _Tp, class _HashFcn = TinySTL::hash<_Key>, class _EqualKey = TinySTL::equal_to<_Key>, class _Alloc = TinySTL::alloc>
+	class flat_hash_map
+	{
+	public:
+		using key_type    = _Key;
+		using mapped_type = _Tp;
+		using value_type  = TinySTL::pair<const _Key, _Tp>;
+
+	private:
+		using _Ht = _Flat_hashtable<value_type, _Key, _HashFcn, TinySTL::select1st<value_type>, _EqualKey, _Alloc>;
+		_Ht _M_ht; // 底层的哈希表
+
+	public:
+		using hasher          = typename _Ht::hasher;
+		using key_equal       = typename _Ht::key_equal;
+
+		using size_type       = typename _Ht::size_type;
+		using difference_type = typename _Ht::difference_type;
+		using pointer         = typename _Ht::pointer;
+		using const_pointer   = typename _Ht::const_pointer;
+		using reference       = typename _Ht::reference;
+		using const_reference = typename _Ht::const_reference;
+		using iterator        = typename _Ht::iterator;
+		using const_iterator  = typename _Ht::const_iterator;
+		using allocator_type  = typename _Ht::allocator_type;
+
+	public:
+		flat_hash_map() : _M_ht() {}
+		explicit flat_hash_map(size_type __n, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& __a = allocator_type())
+			: _M_ht(__n, __hf, __eql, __a) {}
+
+		template<class InIt>
+		flat_hash_map(InIt __first, InIt __last, size_type __n = 0, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& __a = allocator_type())
+			: _M_ht(__n, __hf, __eql, __a)
+		{
+			_M_ht.insert_unique(__first, __last);
+		}
+
+	public:
+		hasher hash_function() const { return _M_ht.hash_funct(); }
+		key_equal key_eq() const { return _M_ht.key_eq(); }
+		allocator_type get_allocator() const { return _M_ht.get_allocator(); }
+
+		// Iterator:
+		iterator begin() { return _M_ht.begin(); }
+		const_iterator begin() const { return _M_ht.begin(); }
+		iterator end() { return _M_ht.end(); }
+		const_iterator end() const { return _M_ht.end(); }
+		const_iterator cbegin() const { return _M_ht.begin(); }
+		const_iterator cend() const { return _M_ht.end(); }
+
+		// Capacity:
+		bool empty() const { return _M_ht.empty(); }
+		size_type size() const { return _M_ht.size(); }
+		size_type max_size() const { return _M_ht.max_size(); }
+		size_type capacity() const { return _M_ht.capacity(); } // 槽的个数
+
+		// Element access:
+		mapped_type& operator[](const key_type& __k)
+		{
+			return (*_M_ht._M_find_or_insert(__k, [&__k](void* __p) { ::new (__p) value_type(__k, mapped_type()); }).first).second;
+		}
+		mapped_type& at(const key_type& __k)
+		{
+			iterator __i = find(__k);
+			if (__i == end())
+				throw std::out_of_range("flat_hash_map::at");
+			return (*__i).second;
+		}
+		const mapped_type& at(const key_type& __k) const
+		{
+			const_iterator __i = find(__k);
+			if (__i == end())
+				throw std::out_of_range("flat_hash_map::at");
+			return (*__i).second;
+		}
+
+		// Modifiers:
+		TinySTL::pair<iterator, bool> insert(const value_type& __x) { return _M_ht.insert_unique(__x); }
+		iterator insert(const_iterator, const value_type& __x) { return _M_ht.insert_unique(__x).first; }
+		// 前向迭代器的区间先按其长度预留空间
+		template<class InIt>
+		void insert(InIt __first, InIt __last) { _M_ht.insert_unique(__first, __last); }
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> emplace(_Args&&... __args)
+		{
+			return _M_ht.insert_unique(value_type(std::forward<_Args>(__args)...));
+		}
+
+		// 键值不存在时才以__args构造实值并插入
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> try_emplace(const key_type& __k, _Args&&... __args)
+		{
+			return _M_ht._M_find_or_insert(__k, [&](void* __p) { ::new (__p) value_type(__k, mapped_type(std::forward<_Args>(__args)...)); });
+		}
+
+		// 键值已存在时为其实值赋值，否则插入
+		template<class _Obj>
+		TinySTL::pair<iterator, bool> insert_or_assign(const key_type& __k, _Obj&& __obj)
+		{
+			bool __inserted = false;
+			TinySTL::pair<iterator, bool> __p = _M_ht._M_find_or_insert(__k, [&](void* __q)
+			{
+				::new (__q) value_type(__k, mapped_type(std::forward<_Obj>(__obj)));
+				__inserted = true;
+			});
+			if (!__inserted)
+				(*__p.first).second = std::forward<_Obj>(__obj);
+			return __p;
+		}
+
+		iterator erase(const_iterator __position) { return _M_ht.erase(__position); }
+		size_type erase(const key_type& __x) { return _M_ht.erase(__x); }
+		template<class _K2, class _H = _HashFcn, class _E = _EqualKey, class = typename _H::is_transparent, class = typename _E::is_transparent>
+		size_type erase(const _K2& __x) { return _M_ht.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last) { return _M_ht.erase(__first, __last); }
+		void clear() { _M_ht.clear(); }
+		void swap(flat_hash_map& __x) { _M_ht.swap(__x._M_ht); }
+
+		// Lookup:
+		iterator find(const key_type& __x) { return _M_ht.find(__x); }
+		const_iterator find(const key_type& __x) const { return _M_ht.find(__x); }
+		template<class _K2, class _H = _HashFcn, class _E = _EqualKey, class = typename _H::is_transparent, class = typename _E::is_transparent>
+		iterator find(const _K2& __x) { return _M_ht.find(__x); }
+		template<class _K2, class _H = _HashFcn, class _E = _EqualKey, class = typename _H::is_transparent, class = typename _E::is_transparent>
+		const_iterator find(const _K2& __x) const { return _M_ht.find(__x); }
+		size_type count(const key_type& __x) const { return _M_ht.count(__x); }
+		template<class _K2, class _H = _HashFcn, class _E = _EqualKey, class = typename _H::is_transparent, class = typename _E::is_transparent>
+		size_type count(const _K2& __x) const { return _M_ht.count(__x); }
+		bool contains(const key_type& __x) const { return _M_ht.count(__x) != 0; }
+		template<class _K2, class _H = _HashFcn, class _E = _EqualKey, class = typename _H::is_transparent, class = typename _E::is_transparent>
+		bool contains(const _K2& __x) const { return _M_ht.count(__x) != 0; }
+
+		// Hash policy:
+		float load_factor() const { return _M_ht.load_factor(); }
+		float max_load_factor() const { return _M_ht.max_load_factor(); }
+		void max_load_factor(float __z) { _M_ht.max_load_factor(__z); }
+		void rehash(size_type __n) { _M_ht.rehash(__n); }
+		void reserve(size_type __n) { _M_ht.reserve(__n); }
+
+		friend bool operator==(const flat_hash_map& __x, const flat_hash_map& __y) { return __x._M_ht._M_equal(__y._M_ht); }
+		friend bool operator!=(const flat_hash_map& __x, const flat_hash_map& __y) { return !(__x == __y); }
+	};
+
+	template<class _Key, class _Tp, class _HashFcn, class _EqualKey, class _Alloc>
+	inline void swap(flat_hash_map<_Key, _Tp, _HashFcn, _EqualKey, _Alloc>& __x, flat_hash_map<_Key, _Tp, _HashFcn, _EqualKey, _Alloc>& __y)
+	{
+		__x.swap(__y);
+	}
+}
+
+#endif // !_FLAT_HASH_MAP_H_
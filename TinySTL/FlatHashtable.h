@@ -0,0 +1,651 @@
+﻿#ifndef _FLAT_HASHTABLE_H_
+#define _FLAT_HASHTABLE_H_
+
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define _TINYSTL_FLAT_HASH_SSE2
+#include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "Iterator.h"
+#include "Allocator.h"
+#include "Construct.h"
+#include "Utility.h"
+#include "Algorithm.h"
+#include "Functional.h"
+
+namespace TinySTL
+{
+	/*
+	* 控制字节：每个槽对应一个字节
+	* 最高位为0表示槽中有元素，低7位为该元素哈希值的H2部分；最高位为1表示空槽、已删除的槽或哨兵
+	* 哨兵位于控制字节数组的末尾，迭代器向后跳过空槽时遇到哨兵即停止
+	*/
+	using _Flat_ctrl_t = signed char;
+	enum : _Flat_ctrl_t { _S_flat_empty = -128, _S_flat_deleted = -2, _S_flat_sentinel = -1 };
+	enum { _S_flat_group_width = 16 }; // 一组控制字节的个数，即一次SIMD比较覆盖的槽数
+
+	// 最低的置位，__x不为0
+	inline unsigned _Flat_ctz(unsigned __x)
+	{
+#ifdef _MSC_VER
+		unsigned long __r;
+		_BitScanForward(&__r, __x);
+		return static_cast<unsigned>(__r);
+#else
+		return static_cast<unsigned>(__builtin_ctz(__x));
+#endif
+	}
+
+	// 把哈希函数的结果与一个奇数常量相乘，取乘积的高低两半异或：输入的每一位都会影响结果的高位与低位
+	// 用户提供的哈希函数可能很弱(例如直接返回键值)，不经混合时相邻的键值会集中在同一组内
+	inline size_t _Flat_hash_mix(size_t __h)
+	{
+		return static_cast<size_t>(_Hash_mum(__h, 0x9E3779B97F4A7C15ull));
+	}
+
+	/*
+	* 一组(16个)控制字节，各个_M_match返回16位的掩码，第i位为1表示第i个控制字节满足条件
+	* 有SSE2时一条比较指令即可完成16个字节的比较，否则逐字节比较
+	*/
+	struct _Flat_group
+	{
+#ifdef _TINYSTL_FLAT_HASH_SSE2
+		__m128i _M_ctrl;
+
+		explicit _Flat_group(const _Flat_ctrl_t* __p) : _M_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(__p))) {}
+
+		unsigned _M_match(_Flat_ctrl_t __h2) const
+		{
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(__h2), _M_ctrl)));
+		}
+		unsigned _M_match_empty() const { return _M_match(_S_flat_empty); }
+		unsigned _M_match_empty_or_deleted() const
+		{	// 空槽与已删除的值都小于哨兵
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(_S_flat_sentinel), _M_ctrl)));
+		}
+#else
+		_Flat_ctrl_t _M_ctrl[_S_flat_group_width];
+
+		explicit _Flat_group(const _Flat_ctrl_t* __p) { memcpy(_M_ctrl, __p, sizeof(_M_ctrl)); }
+
+		unsigned _M_match(_Flat_ctrl_t __h2) const
+		{
+			unsigned __mask = 0;
+			for (int __i = 0; __i < _S_flat_group_width; ++__i)
+				__mask |= static_cast<unsigned>(_M_ctrl[__i] == __h2) << __i;
+			return __mask;
+		}
+		unsigned _M_match_empty() const { return _M_match(_S_flat_empty); }
+		unsigned _M_match_empty_or_deleted() const
+		{
+			unsigned __mask = 0;
+			for (int __i = 0; __i < _S_flat_group_width; ++__i)
+				__mask |= static_cast<unsigned>(_M_ctrl[__i] < _S_flat_sentinel) << __i;
+			return __mask;
+		}
+#endif
+		// 开头连续的空槽与已删除的槽的个数
+		unsigned _M_count_leading_empty_or_deleted() const
+		{
+			unsigned __mask = ~_M_match_empty_or_deleted() & 0xFFFFu;
+			return __mask == 0 ? static_cast<unsigned>(_S_flat_group_width) : _Flat_ctz(__mask);
+		}
+	};
+
+	/*
+	* _Flat_hashtable的迭代器(forward iterator)
+	* 同时指向控制字节与槽，前进时按组跳过空槽，停在下一个元素或哨兵上
+	*/
+	template<class _Val, class _Ref, class _Ptr>
+	struct _Flat_hashtable_iterator
+	{
+		using iterator_category = forward_iterator_tag;
+		using value_type        = _Val;
+		using difference_type   = ptrdiff_t;
+		using pointer           = _Ptr;
+		using reference         = _Ref;
+		using iterator          = _Flat_hashtable_iterator<_Val, _Val&, _Val*>;
+		using _Self             = _Flat_hashtable_iterator<_Val, _Ref, _Ptr>;
+
+		_Flat_ctrl_t* _M_ctrl;
+		_Val*         _M_slot;
+
+		_Flat_hashtable_iterator() : _M_ctrl(nullptr), _M_slot(nullptr) {}
+		_Flat_hashtable_iterator(_Flat_ctrl_t* __c, _Val* __s) : _M_ctrl(__c), _M_slot(__s) {}
+		_Flat_hashtable_iterator(const iterator& __it) : _M_ctrl(__it._M_ctrl), _M_slot(__it._M_slot) {}
+
+		reference operator*() const { return *_M_slot; }
+		pointer operator->() const { return _M_slot; }
+
+		_Self& operator++()
+		{
+			++_M_ctrl;
+			++_M_slot;
+			_M_skip_empty_or_deleted();
+			return *this;
+		}
+
+		_Self operator++(int)
+		{
+			_Self __tmp = *this;
+			++*this;
+			return __tmp;
+		}
+
+		void _M_skip_empty_or_deleted()
+		{
+			while (*_M_ctrl < _S_flat_sentinel)
+			{
+				unsigned __shift = _Flat_group(_M_ctrl)._M_count_leading_empty_or_deleted();
+				_M_ctrl += __shift;
+				_M_slot += __shift;
+			}
+		}
+	};
+
+	template<class _Val, class _Ref1, class _Ptr1, class _Ref2, class _Ptr2>
+	inline bool operator==(const _Flat_hashtable_iterator<_Val, _Ref1, _Ptr1>& __x, const _Flat_hashtable_iterator<_Val, _Ref2, _Ptr2>& __y)
+	{
+		return __x._M_ctrl == __y._M_ctrl;
+	}
+
+	template<class _Val, class _Ref1, class _Ptr1, class _Ref2, class _Ptr2>
+	inline bool operator!=(const _Flat_hashtable_iterator<_Val, _Ref1, _Ptr1>& __x, const _Flat_hashtable_iterator<_Val, _Ref2, _Ptr2>& __y)
+	{
+		return __x._M_ctrl != __y._M_ctrl;
+	}
+
+	/*
+	* ***********************************
+	* _Flat_hashtable : 开放寻址、SIMD探测的哈希表(Swiss table)
+	* ***********************************
+	* 元素直接存放在槽数组中，没有节点；槽数组与控制字节数组在同一块内存中，经由simple_alloc从_Alloc分配
+	* 槽的个数(容量)为16的整数倍且为2的幂，每16个槽为一组
+	*
+	* 键值的哈希值经_Flat_hash_mix混合后分为两部分：H1(高位)决定从哪一组开始探测，H2(低7位)存入控制字节
+	* 查找时一次比较一组中的16个控制字节，只有H2相同的槽才需要比较键值；组内有空槽即可断定键值不存在，
+	* 否则按二次探测(依次跳过1, 2, 3...组)检查下一组
+	*
+	* 删除时若所在组中还有空槽，说明从未有探测越过这一组，槽可以直接标记为空；否则才留下删除标记
+	* 元素个数加删除标记的个数达到 容量 * max_load_factor() 时重新哈希：元素较少(删除标记较多)时以相同的容量
+	* 重新哈希以清除删除标记，否则容量加倍
+	* 重新哈希会移动元素，使所有迭代器、指针与引用失效
+	*/
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc = TinySTL::alloc>
+	class _Flat_hashtable
+	{
+	public:
+		using key_type        = _Key;
+		using value_type      = _Val;
+		using hasher          = _HashFcn;
+		using key_equal       = _EqualKey;
+		using pointer         = value_type*;
+		using const_pointer   = const value_type*;
+		using reference       = value_type&;
+		using const_reference = const value_type&;
+		using size_type       = size_t;
+		using difference_type = ptrdiff_t;
+		using allocator_type  = _Alloc;
+
+		using iterator        = _Flat_hashtable_iterator<value_type, reference, pointer>;
+		using const_iterator  = _Flat_hashtable_iterator<value_type, const_reference, const_pointer>;
+
+	private:
+		using _Block_alloc = simple_alloc<char, _Alloc>;
+
+		_Flat_ctrl_t* _M_ctrl;        // _M_capacity个控制字节，其后为16个哨兵
+		value_type*   _M_slots;
+		size_type     _M_capacity;
+		size_type     _M_size;
+		size_type     _M_growth_left; // 还可以占用多少个空槽而不必重新哈希
+		float         _M_max_load_factor;
+		hasher        _M_hash;
+		key_equal     _M_equals;
+		_ExtractKey   _M_get_key;
+
+	private:
+		// 空表共用的控制字节：只有哨兵，没有槽
+		static _Flat_ctrl_t* _S_empty_ctrl()
+		{
+			static _Flat_ctrl_t __ctrl[_S_flat_group_width] =
+			{
+				_S_flat_sentinel, _S_flat_sentinel, _S_flat_sentinel, _S_flat_sentinel,
+				_S_flat_sentinel, _S_flat_sentinel, _S_flat_sentinel, _S_flat_sentinel,
+				_S_flat_sentinel, _S_flat_sentinel, _S_flat_sentinel, _S_flat_sentinel,
+				_S_flat_sentinel, _S_flat_sentinel, _S_flat_sentinel, _S_flat_sentinel
+			};
+			return __ctrl;
+		}
+
+		// 容量为__cap时整块内存的字节数：控制字节、哨兵、为对齐槽数组预留的空间、槽数组
+		static size_type _S_block_bytes(size_type __cap)
+		{
+			return __cap + _S_flat_group_width + alignof(value_type) - 1 + __cap * sizeof(value_type);
+		}
+		static value_type* _S_slots_of(_Flat_ctrl_t* __ctrl, size_type __cap)
+		{
+			uintptr_t __p = reinterpret_cast<uintptr_t>(__ctrl + __cap + _S_flat_group_width);
+			__p = (__p + alignof(value_type) - 1) & ~static_cast<uintptr_t>(alignof(value_type) - 1);
+			return reinterpret_cast<value_type*>(__p);
+		}
+		void _M_deallocate_block()
+		{
+			if (_M_capacity != 0)
+				_Block_alloc::deallocate(reinterpret_cast<char*>(_M_ctrl), _S_block_bytes(_M_capacity));
+		}
+
+		// 容量为__cap时最多占用的槽数，至少为1，否则空表也会被当作已满而永远无法插入
+		size_type _M_max_load(size_type __cap) const
+		{
+			size_type __n = static_cast<size_type>(static_cast<double>(__cap) * _M_max_load_factor);
+			return __n == 0 ? 1 : __n;
+		}
+		// 容纳__n个元素所需的最小容量
+		size_type _M_capacity_for(size_type __n) const
+		{
+			size_type __cap = _S_flat_group_width;
+			while (_M_max_load(__cap) < __n)
+				__cap *= 2;
+			return __cap;
+		}
+
+		static _Flat_ctrl_t _S_h2(size_t __h) { return static_cast<_Flat_ctrl_t>(__h & 0x7F); }
+		size_type _M_probe_start(size_t __h) const { return (__h >> 7) & (_M_capacity / _S_flat_group_width - 1); }
+
+		template<class _K2>
+		size_t _M_hash_of(const _K2& __k) const { return _Flat_hash_mix(_M_hash(__k)); }
+
+		// 键值为__k的元素所在的槽，不存在时返回_M_capacity
+		template<class _K2>
+		size_type _M_find_index(const _K2& __k, size_t __h) const;
+		// 沿__h的探测序列找到第一个空槽或已删除的槽
+		size_type _M_find_first_non_full(size_t __h) const;
+
+		// 为哈希值为__h的新元素找到槽，必要时先重新哈希
+		size_type _M_prepare_insert(size_t __h)
+		{
+			if (_M_capacity == 0)
+				_M_resize(_S_flat_group_width);
+			size_type __i = _M_find_first_non_full(__h);
+			if (_M_growth_left == 0 && _M_ctrl[__i] != _S_flat_deleted)
+			{	// 重用删除标记不占用新的空槽
+				_M_rehash_and_grow();
+				__i = _M_find_first_non_full(__h);
+			}
+			return __i;
+		}
+		// 元素已构造在槽__i中
+		void _M_commit_insert(size_type __i, size_t __h)
+		{
+			if (_M_ctrl[__i] == _S_flat_empty)
+				--_M_growth_left;
+			_M_ctrl[__i] = _S_h2(__h);
+			++_M_size;
+		}
+		void _M_rehash_and_grow()
+		{
+			if (_M_size * 2 <= _M_max_load(_M_capacity))
+				_M_resize(_M_capacity); // 大部分占用来自删除标记，容量不变
+			else
+				_M_resize(_M_capacity * 2);
+		}
+		// 把所有元素移入容量为__cap的新内存块
+		void _M_resize(size_type __cap);
+
+		void _M_destroy_slots()
+		{
+			for (size_type __i = 0; __i < _M_capacity; ++__i)
+				if (_M_ctrl[__i] >= 0)
+					destroy(_M_slots + __i);
+		}
+
+		iterator _M_iterator_at(size_type __i) { return iterator(_M_ctrl + __i, _M_slots + __i); }
+
+	public:
+		explicit _Flat_hashtable(size_type __n = 0, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& = allocator_type())
+			: _M_ctrl(_S_empty_ctrl()), _M_slots(nullptr), _M_capacity(0), _M_size(0), _M_growth_left(0),
+			_M_max_load_factor(0.875f), _M_hash(__hf), _M_equals(__eql), _M_get_key()
+		{
+			if (__n > 0)
+				rehash(__n);
+		}
+
+		_Flat_hashtable(const _Flat_hashtable& __x);
+
+		_Flat_hashtable& operator=(const _Flat_hashtable& __x)
+		{
+			if (&__x != this)
+			{
+				_Flat_hashtable __tmp(__x);
+				swap(__tmp);
+			}
+			return *this;
+		}
+
+		~_Flat_hashtable()
+		{
+			_M_destroy_slots();
+			_M_deallocate_block();
+		}
+
+	public:
+		hasher hash_funct() const { return _M_hash; }
+		key_equal key_eq() const { return _M_equals; }
+		allocator_type get_allocator() const { return allocator_type(); }
+
+		size_type size() const { return _M_size; }
+		size_type max_size() const { return size_type(-1) / sizeof(value_type); }
+		bool empty() const { return _M_size == 0; }
+		size_type capacity() const { return _M_capacity; }
+
+		void swap(_Flat_hashtable& __x)
+		{
+			TinySTL::swap(_M_ctrl, __x._M_ctrl);
+			TinySTL::swap(_M_slots, __x._M_slots);
+			TinySTL::swap(_M_capacity, __x._M_capacity);
+			TinySTL::swap(_M_size, __x._M_size);
+			TinySTL::swap(_M_growth_left, __x._M_growth_left);
+			TinySTL::swap(_M_max_load_factor, __x._M_max_load_factor);
+			TinySTL::swap(_M_hash, __x._M_hash);
+			TinySTL::swap(_M_equals, __x._M_equals);
+			TinySTL::swap(_M_get_key, __x._M_get_key);
+		}
+
+		iterator begin()
+		{
+			iterator __it(_M_ctrl, _M_slots);
+			__it._M_skip_empty_or_deleted();
+			return __it;
+		}
+		const_iterator begin() const { return const_cast<_Flat_hashtable*>(this)->begin(); }
+		iterator end() { return iterator(_M_ctrl + _M_capacity, _M_slots + _M_capacity); }
+		const_iterator end() const { return const_iterator(_M_ctrl + _M_capacity, _M_slots + _M_capacity); }
+
+	public:
+		// Hash policy:
+		float load_factor() const { return _M_capacity == 0 ? 0.0f : static_cast<float>(_M_size) / static_cast<float>(_M_capacity); }
+		float max_load_factor() const { return _M_max_load_factor; }
+		// 每组至少要留一个空槽才能保证查找终止，上限为0.875；
+		// 过小的值只会浪费内存(0或负数还会使_M_capacity_for无法终止)，下限为0.125，NaN按下限处理
+		void max_load_factor(float __z)
+		{
+			_M_max_load_factor = __z >= 0.125f ? TinySTL::min(__z, 0.875f) : 0.125f;
+			if (_M_capacity != 0)
+				_M_resize(_M_capacity_for(_M_size));
+		}
+		// 容量调整为不小于__n、且足以容纳现有元素的最小值，可以缩小
+		void rehash(size_type __n)
+		{
+			size_type __cap = _M_capacity_for(_M_size);
+			while (__cap < __n)
+				__cap *= 2;
+			if (_M_size == 0 && __n == 0)
+			{	// 归还全部内存
+				_M_deallocate_block();
+				_M_ctrl = _S_empty_ctrl();
+				_M_slots = nullptr;
+				_M_capacity = 0;
+				_M_growth_left = 0;
+			}
+			else if (__cap != _M_capacity)
+				_M_resize(__cap);
+		}
+		// 预留容纳__n个元素的空间，此后插入不超过__n个元素都不会重新哈希
+		void reserve(size_type __n)
+		{
+			if (__n > _M_size + _M_growth_left)
+				_M_resize(_M_capacity_for(__n));
+		}
+
+	public:
+		// 键值__k不存在时，调用__make(p)在p处构造新元素
+		template<class _K2, class _Make>
+		TinySTL::pair<iterator, bool> _M_find_or_insert(const _K2& __k, _Make __make)
+		{
+			size_t __h = _M_hash_of(__k);
+			size_type __i = _M_find_index(__k, __h);
+			if (__i != _M_capacity)
+				return TinySTL::pair<iterator, bool>(_M_iterator_at(__i), false);
+			__i = _M_prepare_insert(__h);
+			__make(static_cast<void*>(_M_slots + __i));
+			_M_commit_insert(__i, __h);
+			return TinySTL::pair<iterator, bool>(_M_iterator_at(__i), true);
+		}
+
+		// 插入新值，键值不允许重复，若重复则插入无效
+		TinySTL::pair<iterator, bool> insert_unique(const value_type& __v)
+		{
+			return _M_find_or_insert(_M_get_key(__v), [&__v](void* __p) { construct(static_cast<value_type*>(__p), __v); });
+		}
+		// 前向迭代器的区间先按其长度预留空间，插入过程中不会重新哈希
+		template<class InIt>
+		void insert_unique(InIt __first, InIt __last)
+		{
+			_M_insert_unique(__first, __last, iterator_category(__first));
+		}
+
+		template<class _K2>
+		iterator find(const _K2& __k)
+		{
+			size_type __i = _M_find_index(__k, _M_hash_of(__k));
+			return __i == _M_capacity ? end() : _M_iterator_at(__i);
+		}
+		template<class _K2>
+		const_iterator find(const _K2& __k) const { return const_cast<_Flat_hashtable*>(this)->find(__k); }
+		template<class _K2>
+		size_type count(const _K2& __k) const { return _M_find_index(__k, _M_hash_of(__k)) == _M_capacity ? 0 : 1; }
+
+		// 返回被删除元素的后继
+		iterator erase(const_iterator __it)
+		{
+			size_type __i = static_cast<size_type>(__it._M_ctrl - _M_ctrl);
+			_M_erase_at(__i);
+			iterator __next = _M_iterator_at(__i);
+			__next._M_skip_empty_or_deleted();
+			return __next;
+		}
+		iterator erase(const_iterator __first, const_iterator __last)
+		{
+			while (__first != __last)
+				__first = erase(__first);
+			return iterator(__last._M_ctrl, __last._M_slot);
+		}
+		template<class _K2>
+		size_type erase(const _K2& __k)
+		{
+			size_type __i = _M_find_index(__k, _M_hash_of(__k));
+			if (__i == _M_capacity)
+				return 0;
+			_M_erase_at(__i);
+			return 1;
+		}
+		void _M_erase_at(size_type __i);
+		void clear();
+
+		bool _M_equal(const _Flat_hashtable& __x) const
+		{
+			if (_M_size != __x._M_size)
+				return false;
+			for (const_iterator __it = begin(); __it != end(); ++__it)
+			{
+				const_iterator __j = __x.find(_M_get_key(*__it));
+				if (__j == __x.end() || !(*__j == *__it))
+					return false;
+			}
+			return true;
+		}
+
+	private:
+		template<class InIt>
+		void _M_insert_unique(InIt __first, InIt __last, input_iterator_tag)
+		{
+			for (; __first != __last; ++__first)
+				insert_unique(*__first);
+		}
+		template<class FwdIt>
+		void _M_insert_unique(FwdIt __first, FwdIt __last, forward_iterator_tag)
+		{
+			reserve(_M_size + static_cast<size_type>(TinySTL::distance(__first, __last)));
+			for (; __first != __last; ++__first)
+				insert_unique(*__first);
+		}
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline _Flat_hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_Flat_hashtable(const _Flat_hashtable& __x)
+		: _M_ctrl(_S_empty_ctrl()), _M_slots(nullptr), _M_capacity(0), _M_size(0), _M_growth_left(0),
+		_M_max_load_factor(__x._M_max_load_factor), _M_hash(__x._M_hash), _M_equals(__x._M_equals), _M_get_key(__x._M_get_key)
+	{	// 容量与__x相同，控制字节原样复制，元素复制到相同的槽中
+		if (__x._M_capacity == 0)
+			return;
+		_Flat_ctrl_t* __ctrl = reinterpret_cast<_Flat_ctrl_t*>(_Block_alloc::allocate(_S_block_bytes(__x._M_capacity)));
+		value_type* __slots = _S_slots_of(__ctrl, __x._M_capacity);
+		memcpy(__ctrl, __x._M_ctrl, __x._M_capacity + _S_flat_group_width);
+		size_type __i = 0;
+		try
+		{
+			for (; __i < __x._M_capacity; ++__i)
+				if (__ctrl[__i] >= 0)
+					construct(__slots + __i, __x._M_slots[__i]);
+		}
+		catch (...)
+		{
+			for (size_type __j = 0; __j < __i; ++__j)
+				if (__ctrl[__j] >= 0)
+					destroy(__slots + __j);
+			_Block_alloc::deallocate(reinterpret_cast<char*>(__ctrl), _S_block_bytes(__x._M_capacity));
+			throw;
+		}
+		_M_ctrl = __ctrl;
+		_M_slots = __slots;
+		_M_capacity = __x._M_capacity;
+		_M_size = __x._M_size;
+		_M_growth_left = __x._M_growth_left;
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	template<class _K2>
+	inline typename _Flat_hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::size_type
+	_Flat_hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_M_find_index(const _K2& __k, size_t __h) const
+	{
+		if (_M_size == 0)
+			return _M_capacity;
+		const size_type __mask = _M_capacity / _S_flat_group_width - 1;
+		const _Flat_ctrl_t __h2 = _S_h2(__h);
+		size_type __g = _M_probe_start(__h);
+		for (size_type __step = 1; ; ++__step)
+		{
+			_Flat_group __group(_M_ctrl + __g * _S_flat_group_width);
+			for (unsigned __m = __group._M_match(__h2); __m != 0; __m &= __m - 1)
+			{
+				size_type __i = __g * _S_flat_group_width + _Flat_ctz(__m);
+				if (_M_equals(_M_get_key(_M_slots[__i]), __k))
+					return __i;
+			}
+			if (__group._M_match_empty() != 0)
+				return _M_capacity;
+			__g = (__g + __step) & __mask; // 组数为2的幂，依次跳过1, 2, 3...组可以遍历所有组
+		}
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline typename _Flat_hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::size_type
+	_Flat_hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_M_find_first_non_full(size_t __h) const
+	{
+		const size_type __mask = _M_capacity / _S_flat_group_width - 1;
+		size_type __g = _M_probe_start(__h);
+		for (size_type __step = 1; ; ++__step)
+		{
+			unsigned __m = _Flat_group(_M_ctrl + __g * _S_flat_group_width)._M_match_empty_or_deleted();
+			if (__m != 0)
+				return __g * _S_flat_group_width + _Flat_ctz(__m);
+			__g = (__g + __step) & __mask;
+		}
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline void _Flat_hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_M_resize(size_type __cap)
+	{
+		_Flat_ctrl_t* __old_ctrl = _M_ctrl;
+		value_type* __old_slots = _M_slots;
+		size_type __old_cap = _M_capacity;
+
+		_M_ctrl = reinterpret_cast<_Flat_ctrl_t*>(_Block_alloc::allocate(_S_block_bytes(__cap)));
+		_M_slots = _S_slots_of(_M_ctrl, __cap);
+		_M_capacity = __cap;
+		memset(_M_ctrl, _S_flat_empty, __cap);
+		memset(_M_ctrl + __cap, _S_flat_sentinel, _S_flat_group_width);
+
+		// 先把所有元素复制到新的槽中，全部成功后再销毁旧元素，复制失败时恢复原状
+		size_type __i = 0;
+		try
+		{
+			for (; __i < __old_cap; ++__i)
+				if (__old_ctrl[__i] >= 0)
+				{
+					size_t __h = _M_hash_of(_M_get_key(__old_slots[__i]));
+					size_type __j = _M_find_first_non_full(__h);
+					construct(_M_slots + __j, __old_slots[__i]);
+					_M_ctrl[__j] = _S_h2(__h);
+				}
+		}
+		catch (...)
+		{
+			for (size_type __j = 0; __j < __cap; ++__j)
+				if (_M_ctrl[__j] >= 0)
+					destroy(_M_slots + __j);
+			_Block_alloc::deallocate(reinterpret_cast<char*>(_M_ctrl), _S_block_bytes(__cap));
+			_M_ctrl = __old_ctrl;
+			_M_slots = __old_slots;
+			_M_capacity = __old_cap;
+			throw;
+		}
+
+		for (__i = 0; __i < __old_cap; ++__i)
+			if (__old_ctrl[__i] >= 0)
+				destroy(__old_slots + __i);
+		if (__old_cap != 0)
+			_Block_alloc::deallocate(reinterpret_cast<char*>(__old_ctrl), _S_block_bytes(__old_cap));
+		_M_growth_left = _M_max_load(__cap) - _M_size;
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline void _Flat_hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_M_erase_at(size_type __i)
+	{
+		destroy(_M_slots + __i);
+		--_M_size;
+		// 组(按16对齐)内还有空槽时，插入从未因这一组已满而探测到后面的组，查找也总会在这一组停止，无需删除标记
+		size_type __g = __i / _S_flat_group_width * _S_flat_group_width;
+		if (_Flat_group(_M_ctrl + __g)._M_match_empty() != 0)
+		{
+			_M_ctrl[__i] = _S_flat_empty;
+			++_M_growth_left;
+		}
+		else
+			_M_ctrl[__i] = _S_flat_deleted;
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline void _Flat_hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::clear()
+	{	// 保留容量
+		if (_M_capacity == 0)
+			return;
+		_M_destroy_slots();
+		memset(_M_ctrl, _S_flat_empty, _M_capacity);
+		_M_size = 0;
+		_M_growth_left = _M_max_load(_M_capacity);
+	}
+}
+
+#endif // !_FLAT_HASHTABLE_H_
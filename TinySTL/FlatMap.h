@@ -0,0 +1,371 @@
+﻿#ifndef _FLAT_MAP_H_
+#define _FLAT_MAP_H_
+
+#include <utility>
+#include <stdexcept>
+
+#include "FlatSet.h"
+
+namespace TinySTL
+{
+	/*
+	* flat_map的迭代器：同时指向键值序列与实值序列中的同一位置
+	* 两个序列分开存放，不存在pair<const Key, T>对象，解引用得到的是由两个引用组成的pair，
+	* operator->返回暂存这个pair的代理对象
+	*/
+	template<class _KeyIt, class _ValueIt, class _Key, class _Tp, class _Ref>
+	struct _Flat_map_iterator
+	{
+		using iterator_category = random_access_iterator_tag;
+		using value_type        = TinySTL::pair<_Key, _Tp>;
+		using difference_type   = ptrdiff_t;
+		using reference         = _Ref;
+		using _Self             = _Flat_map_iterator<_KeyIt, _ValueIt, _Key, _Tp, _Ref>;
+
+		struct pointer
+		{
+			reference _M_ref;
+			explicit pointer(const reference& __r) : _M_ref(__r) {}
+			reference* operator->() { return &_M_ref; }
+		};
+
+		_KeyIt   _M_key;
+		_ValueIt _M_value;
+
+		_Flat_map_iterator() : _M_key(), _M_value() {}
+		_Flat_map_iterator(_KeyIt __k, _ValueIt __v) : _M_key(__k), _M_value(__v) {}
+		// iterator可以转换为const_iterator
+		template<class _OtherValueIt, class _OtherRef>
+		_Flat_map_iterator(const _Flat_map_iterator<_KeyIt, _OtherValueIt, _Key, _Tp, _OtherRef>& __it)
+			: _M_key(__it._M_key), _M_value(__it._M_value) {}
+
+		reference operator*() const { return reference(*_M_key, *_M_value); }
+		pointer operator->() const { return pointer(operator*()); }
+		reference operator[](difference_type __n) const { return *(*this + __n); }
+
+		_Self& operator++() { ++_M_key; ++_M_value; return *this; }
+		_Self operator++(int) { _Self __tmp = *this; ++*this; return __tmp; }
+		_Self& operator--() { --_M_key; --_M_value; return *this; }
+		_Self operator--(int) { _Self __tmp = *this; --*this; return __tmp; }
+		_Self& operator+=(difference_type __n) { _M_key += __n; _M_value += __n; return *this; }
+		_Self& operator-=(difference_type __n) { _M_key -= __n; _M_value -= __n; return *this; }
+		_Self operator+(difference_type __n) const { _Self __tmp = *this; return __tmp += __n; }
+		_Self operator-(difference_type __n) const { _Self __tmp = *this; return __tmp -= __n; }
+		difference_type operator-(const _Self& __x) const { return _M_key - __x._M_key; }
+
+		bool operator==(const _Self& __x) const { return _M_key == __x._M_key; }
+		bool operator!=(const _Self& __x) const { return _M_key != __x._M_key; }
+		bool operator<(const _Self& __x) const { return _M_key < __x._M_key; }
+		bool operator>(const _Self& __x) const { return __x < *this; }
+		bool operator<=(const _Self& __x) const { return !(__x < *this); }
+		bool operator>=(const _Self& __x) const { return !(*this < __x); }
+	};
+
+	/*
+	* ***********************************
+	* flat_map : 以两个有序vector为底层的关联容器
+	* ***********************************
+	* 键值与实值分别存放在两个序列中，二分查找只访问键值序列，每条cache line容纳尽可能多的键值
+	* 复杂度与flat_set相同：查找O(log n)，单个插入、删除O(n)，批量插入O(n + m log m)
+	* 与map不同，任何插入、删除都使所有迭代器与引用失效；批量插入时键值相同的新元素保留靠前的一个
+	*/
+	template<class _Key, class _Tp, class _Compare = TinySTL::less<_Key>,
+			 class _KeyContainer = TinySTL::vector<_Key>, class _MappedContainer = TinySTL::vector<_Tp>>
+	class flat_map
+	{
+	public:
+		using key_type               = _Key;
+		using mapped_type            = _Tp;
+		using value_type             = TinySTL::pair<_Key, _Tp>;
+		using key_compare            = _Compare;
+		using key_container_type     = _KeyContainer;
+		using mapped_container_type  = _MappedContainer;
+		using reference              = TinySTL::pair<const _Key&, _Tp&>;
+		using const_reference        = TinySTL::pair<const _Key&, const _Tp&>;
+		using size_type              = typename _KeyContainer::size_type;
+		using difference_type        = typename _KeyContainer::difference_type;
+		using iterator               = _Flat_map_iterator<typename _KeyContainer::const_iterator, typename _MappedContainer::iterator, _Key, _Tp, reference>;
+		using const_iterator         = _Flat_map_iterator<typename _KeyContainer::const_iterator, typename _MappedContainer::const_iterator, _Key, _Tp, const_reference>;
+		using reverse_iterator       = TinySTL::reverse_iterator<iterator>;
+		using const_reverse_iterator = TinySTL::reverse_iterator<const_iterator>;
+
+	private:
+		using _Branchless = typename __type_traits<_Key>::is_POD_type;
+
+		_KeyContainer    _M_keys;   // 按_M_key_compare严格递增
+		_MappedContainer _M_values; // _M_values[__i]为_M_keys[__i]对应的实值
+		_Compare         _M_key_compare;
+
+		size_type _M_index(const_iterator __it) const { return __it._M_key - _M_keys.begin(); }
+		iterator _M_at(size_type __i) { return iterator(_M_keys.begin() + __i, _M_values.begin() + __i); }
+		const_iterator _M_at(size_type __i) const { return const_iterator(_M_keys.begin() + __i, _M_values.begin() + __i); }
+		iterator _M_insert_at(size_type __i, const key_type& __k, const mapped_type& __v);
+		// [0, __n)为原有的元素，其后为追加的新元素：排序新元素，再与原有元素归并、去重
+		void _M_merge_tail(size_type __n);
+
+	public:
+		flat_map() : _M_keys(), _M_values(), _M_key_compare() {}
+		explicit flat_map(const _Compare& __comp) : _M_keys(), _M_values(), _M_key_compare(__comp) {}
+
+		template<class InIt>
+		flat_map(InIt __first, InIt __last, const _Compare& __comp = _Compare()) : _M_keys(), _M_values(), _M_key_compare(__comp)
+		{
+			insert(__first, __last);
+		}
+		flat_map(const flat_map& __x) : _M_keys(__x._M_keys), _M_values(__x._M_values), _M_key_compare(__x._M_key_compare) {}
+
+		flat_map& operator=(const flat_map& __x)
+		{
+			_M_keys = __x._M_keys;
+			_M_values = __x._M_values;
+			_M_key_compare = __x._M_key_compare;
+			return *this;
+		}
+
+	public:
+		key_compare key_comp() const { return _M_key_compare; }
+		// 底层的两个序列
+		const key_container_type& keys() const { return _M_keys; }
+		const mapped_container_type& values() const { return _M_values; }
+
+		// Iterator:
+		iterator begin() { return _M_at(0); }
+		const_iterator begin() const { return _M_at(0); }
+		iterator end() { return _M_at(size()); }
+		const_iterator end() const { return _M_at(size()); }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+		const_iterator cbegin() const { return begin(); }
+		const_iterator cend() const { return end(); }
+
+		// Capacity:
+		bool empty() const { return _M_keys.empty(); }
+		size_type size() const { return _M_keys.size(); }
+		size_type max_size() const { return _M_keys.max_size(); }
+		size_type capacity() const { return _M_keys.capacity(); }
+		void reserve(size_type __n)
+		{
+			_M_keys.reserve(__n);
+			_M_values.reserve(__n);
+		}
+
+		// Element access:
+		mapped_type& operator[](const key_type& __k)
+		{
+			size_type __i = _M_index(lower_bound(__k));
+			if (__i == size() || _M_key_compare(__k, _M_keys[__i]))
+				_M_insert_at(__i, __k, mapped_type());
+			return _M_values[__i];
+		}
+		mapped_type& at(const key_type& __k)
+		{
+			iterator __i = find(__k);
+			if (__i == end())
+				throw std::out_of_range("flat_map::at");
+			return *__i._M_value;
+		}
+		const mapped_type& at(const key_type& __k) const
+		{
+			const_iterator __i = find(__k);
+			if (__i == end())
+				throw std::out_of_range("flat_map::at");
+			return *__i._M_value;
+		}
+
+		// Modifiers:
+		TinySTL::pair<iterator, bool> insert(const value_type& __x)
+		{
+			size_type __i = _M_index(lower_bound(__x.first));
+			if (__i != size() && !_M_key_compare(__x.first, _M_keys[__i]))
+				return TinySTL::pair<iterator, bool>(_M_at(__i), false);
+			return TinySTL::pair<iterator, bool>(_M_insert_at(__i, __x.first, __x.second), true);
+		}
+		// 追加全部新元素后一次排序、归并、去重
+		template<class InIt>
+		void insert(InIt __first, InIt __last)
+		{
+			size_type __n = size();
+			for (; __first != __last; ++__first)
+			{
+				_M_keys.push_back((*__first).first);
+				_M_values.push_back((*__first).second);
+			}
+			_M_merge_tail(__n);
+		}
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> emplace(_Args&&... __args)
+		{
+			return insert(value_type(std::forward<_Args>(__args)...));
+		}
+
+		// 键值已存在时不构造实值，也不做任何修改
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> try_emplace(const key_type& __k, _Args&&... __args)
+		{
+			size_type __i = _M_index(lower_bound(__k));
+			if (__i != size() && !_M_key_compare(__k, _M_keys[__i]))
+				return TinySTL::pair<iterator, bool>(_M_at(__i), false);
+			return TinySTL::pair<iterator, bool>(_M_insert_at(__i, __k, mapped_type(std::forward<_Args>(__args)...)), true);
+		}
+
+		// 键值已存在时以__obj赋值实值，否则插入
+		template<class _Obj>
+		TinySTL::pair<iterator, bool> insert_or_assign(const key_type& __k, _Obj&& __obj)
+		{
+			size_type __i = _M_index(lower_bound(__k));
+			if (__i != size() && !_M_key_compare(__k, _M_keys[__i]))
+			{
+				_M_values[__i] = std::forward<_Obj>(__obj);
+				return TinySTL::pair<iterator, bool>(_M_at(__i), false);
+			}
+			return TinySTL::pair<iterator, bool>(_M_insert_at(__i, __k, mapped_type(std::forward<_Obj>(__obj))), true);
+		}
+
+		iterator erase(const_iterator __position) { return erase(__position, __position + 1); }
+		size_type erase(const key_type& __x)
+		{
+			const_iterator __i = find(__x);
+			if (__i == end())
+				return 0;
+			erase(__i);
+			return 1;
+		}
+		iterator erase(const_iterator __first, const_iterator __last)
+		{
+			size_type __i = _M_index(__first), __j = _M_index(__last);
+			_M_keys.erase(_M_keys.begin() + __i, _M_keys.begin() + __j);
+			_M_values.erase(_M_values.begin() + __i, _M_values.begin() + __j);
+			return _M_at(__i);
+		}
+		void clear()
+		{
+			_M_keys.clear();
+			_M_values.clear();
+		}
+		void swap(flat_map& __x)
+		{
+			_M_keys.swap(__x._M_keys);
+			_M_values.swap(__x._M_values);
+			TinySTL::swap(_M_key_compare, __x._M_key_compare);
+		}
+
+		// Lookup:
+		iterator find(const key_type& __x)
+		{
+			iterator __i = lower_bound(__x);
+			return __i == end() || _M_key_compare(__x, *__i._M_key) ? end() : __i;
+		}
+		const_iterator find(const key_type& __x) const
+		{
+			const_iterator __i = lower_bound(__x);
+			return __i == end() || _M_key_compare(__x, *__i._M_key) ? end() : __i;
+		}
+		size_type count(const key_type& __x) const { return find(__x) == end() ? 0 : 1; }
+		bool contains(const key_type& __x) const { return find(__x) != end(); }
+		iterator lower_bound(const key_type& __x)
+		{
+			return _M_at(_Flat_lower_bound(_M_keys.cbegin(), size(), __x, _M_key_compare, _Branchless()) - _M_keys.cbegin());
+		}
+		const_iterator lower_bound(const key_type& __x) const
+		{
+			return _M_at(_Flat_lower_bound(_M_keys.cbegin(), size(), __x, _M_key_compare, _Branchless()) - _M_keys.cbegin());
+		}
+		iterator upper_bound(const key_type& __x)
+		{
+			return _M_at(_Flat_upper_bound(_M_keys.cbegin(), size(), __x, _M_key_compare, _Branchless()) - _M_keys.cbegin());
+		}
+		const_iterator upper_bound(const key_type& __x) const
+		{
+			return _M_at(_Flat_upper_bound(_M_keys.cbegin(), size(), __x, _M_key_compare, _Branchless()) - _M_keys.cbegin());
+		}
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x)
+		{
+			iterator __i = lower_bound(__x);
+			return TinySTL::pair<iterator, iterator>(__i, __i == end() || _M_key_compare(__x, *__i._M_key) ? __i : __i + 1);
+		}
+		TinySTL::pair<const_iterator, const_iterator> equal_range(const key_type& __x) const
+		{
+			const_iterator __i = lower_bound(__x);
+			return TinySTL::pair<const_iterator, const_iterator>(__i, __i == end() || _M_key_compare(__x, *__i._M_key) ? __i : __i + 1);
+		}
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	template<class _Key, class _Tp, class _Compare, class _KeyContainer, class _MappedContainer>
+	inline typename flat_map<_Key, _Tp, _Compare, _KeyContainer, _MappedContainer>::iterator
+	flat_map<_Key, _Tp, _Compare, _KeyContainer, _MappedContainer>::_M_insert_at(size_type __i, const key_type& __k, const mapped_type& __v)
+	{
+		_M_keys.insert(_M_keys.begin() + __i, __k);
+		try
+		{
+			_M_values.insert(_M_values.begin() + __i, __v);
+		}
+		catch (...)
+		{	// 保持两个序列等长
+			_M_keys.erase(_M_keys.begin() + __i);
+			throw;
+		}
+		return _M_at(__i);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _KeyContainer, class _MappedContainer>
+	inline void flat_map<_Key, _Tp, _Compare, _KeyContainer, _MappedContainer>::_M_merge_tail(size_type __n)
+	{
+		// 对新元素的下标排序：键值相同时按下标，使靠前的新元素先被输出
+		size_type __m = size() - __n;
+		TinySTL::vector<size_type> __order(__m);
+		for (size_type __k = 0; __k < __m; ++__k)
+			__order[__k] = __n + __k;
+		const _KeyContainer& __keys = _M_keys;
+		const _Compare& __comp = _M_key_compare;
+		TinySTL::sort(__order.begin(), __order.end(), [&__keys, &__comp](size_type __a, size_type __b) {
+			return __comp(__keys[__a], __keys[__b]) || (!__comp(__keys[__b], __keys[__a]) && __a < __b);
+		});
+
+		// 归并时只接受大于已输出的最后一个键值的元素，从而一并去重；相等时先取原有的元素
+		_KeyContainer __result_keys;
+		_MappedContainer __result_values;
+		__result_keys.reserve(size());
+		__result_values.reserve(size());
+		size_type __i = 0, __j = 0;
+		while (__i < __n || __j < __m)
+		{
+			size_type __next = __j == __m || (__i < __n && !__comp(__keys[__order[__j]], __keys[__i])) ? __i++ : __order[__j++];
+			if (__result_keys.empty() || __comp(__result_keys.back(), __keys[__next]))
+			{
+				__result_keys.push_back(__keys[__next]);
+				__result_values.push_back(_M_values[__next]);
+			}
+		}
+		_M_keys.swap(__result_keys);
+		_M_values.swap(__result_values);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _KeyContainer, class _MappedContainer>
+	inline bool operator==(const flat_map<_Key, _Tp, _Compare, _KeyContainer, _MappedContainer>& __x,
+						   const flat_map<_Key, _Tp, _Compare, _KeyContainer, _MappedContainer>& __y)
+	{
+		return __x.size() == __y.size()
+			&& TinySTL::equal(__x.keys().begin(), __x.keys().end(), __y.keys().begin())
+			&& TinySTL::equal(__x.values().begin(), __x.values().end(), __y.values().begin());
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _KeyContainer, class _MappedContainer>
+	inline bool operator!=(const flat_map<_Key, _Tp, _Compare, _KeyContainer, _MappedContainer>& __x,
+						   const flat_map<_Key, _Tp, _Compare, _KeyContainer, _MappedContainer>& __y)
+	{
+		return !(__x == __y);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _KeyContainer, class _MappedContainer>
+	inline void swap(flat_map<_Key, _Tp, _Compare, _KeyContainer, _MappedContainer>& __x,
+					 flat_map<_Key, _Tp, _Compare, _KeyContainer, _MappedContainer>& __y)
+	{
+		__x.swap(__y);
+	}
+}
+
+#endif // !_FLAT_MAP_H_
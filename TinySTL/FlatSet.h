@@ -0,0 +1,301 @@
+﻿#ifndef _FLAT_SET_H_
+#define _FLAT_SET_H_
+
+#include <utility>
+
+#include "Vector.h"
+#include "Algorithm.h"
+#include "Functional.h"
+#include "TypeTraits.h"
+
+namespace TinySTL
+{
+	/*
+	* flat容器的二分查找，__n为区间长度
+	* 内建类型的键值(__type_traits::is_POD_type为真)比较代价极低，采用无分支的写法：每轮只根据比较结果
+	* 选择区间的起点，编译器生成条件传送而不是跳转，查找过程中不会因分支预测失败而清空流水线
+	* 其他键值沿用普通的二分，比较结果已知时可以提前结束
+	*/
+	template<class _RanIt, class _Key, class _Compare>
+	inline _RanIt _Flat_lower_bound(_RanIt __first, size_t __n, const _Key& __k, _Compare __comp, __true_type)
+	{
+		while (__n > 1)
+		{	// 答案始终位于[__first, __first + __n]
+			size_t __half = __n / 2;
+			__first = __comp(__first[__half], __k) ? __first + __half : __first;
+			__n -= __half;
+		}
+		return __first + (__n == 1 && __comp(*__first, __k) ? 1 : 0);
+	}
+
+	template<class _RanIt, class _Key, class _Compare>
+	inline _RanIt _Flat_lower_bound(_RanIt __first, size_t __n, const _Key& __k, _Compare __comp, __false_type)
+	{
+		while (__n > 0)
+		{
+			size_t __half = __n / 2;
+			if (__comp(__first[__half], __k))
+			{
+				__first += __half + 1;
+				__n -= __half + 1;
+			}
+			else
+				__n = __half;
+		}
+		return __first;
+	}
+
+	template<class _RanIt, class _Key, class _Compare>
+	inline _RanIt _Flat_upper_bound(_RanIt __first, size_t __n, const _Key& __k, _Compare __comp, __true_type)
+	{
+		while (__n > 1)
+		{
+			size_t __half = __n / 2;
+			__first = __comp(__k, __first[__half]) ? __first : __first + __half;
+			__n -= __half;
+		}
+		return __first + (__n == 1 && !__comp(__k, *__first) ? 1 : 0);
+	}
+
+	template<class _RanIt, class _Key, class _Compare>
+	inline _RanIt _Flat_upper_bound(_RanIt __first, size_t __n, const _Key& __k, _Compare __comp, __false_type)
+	{
+		while (__n > 0)
+		{
+			size_t __half = __n / 2;
+			if (__comp(__k, __first[__half]))
+				__n = __half;
+			else
+			{
+				__first += __half + 1;
+				__n -= __half + 1;
+			}
+		}
+		return __first;
+	}
+
+	/*
+	* ***********************************
+	* flat_set : 以有序vector为底层的集合
+	* ***********************************
+	* 元素连续存放，没有任何节点开销；查找为二分，遍历为顺序访问。适合一次建立、大量查找的场合
+	* 单个插入、删除需要移动其后的所有元素，为O(n)；批量插入insert(__first, __last)先把新元素追加到末尾，
+	* 对新元素排序后与原有元素一趟归并并去重，为O(n + m log m)
+	* 与set不同，任何插入、删除都使所有迭代器失效；键值相同时保留原有的元素，新元素之间保留哪一个不作保证
+	*/
+	template<class _Key, class _Compare = TinySTL::less<_Key>, class _Container = TinySTL::vector<_Key>>
+	class flat_set
+	{
+	public:
+		using key_type        = _Key;
+		using value_type      = _Key;
+		using key_compare     = _Compare;
+		using value_compare   = _Compare;
+		using container_type  = _Container;
+
+		using pointer                = const value_type*;
+		using const_pointer          = const value_type*;
+		using reference              = const value_type&;
+		using const_reference        = const value_type&;
+		using iterator               = typename _Container::const_iterator;
+		using const_iterator         = typename _Container::const_iterator;
+		using reverse_iterator       = typename _Container::const_reverse_iterator;
+		using const_reverse_iterator = typename _Container::const_reverse_iterator;
+		using size_type              = typename _Container::size_type;
+		using difference_type        = typename _Container::difference_type;
+
+	private:
+		using _Branchless = typename __type_traits<_Key>::is_POD_type;
+
+		_Container _M_keys;       // 按_M_key_compare严格递增
+		_Compare   _M_key_compare;
+
+		static typename _Container::iterator _S_unconst(_Container& __c, const_iterator __it)
+		{
+			return __c.begin() + (__it - __c.cbegin());
+		}
+
+		// [0, __n)为原有的元素，其后为追加的新元素：排序新元素，再与原有元素归并、去重
+		void _M_merge_tail(size_type __n);
+
+	public:
+		flat_set() : _M_keys(), _M_key_compare() {}
+		explicit flat_set(const _Compare& __comp) : _M_keys(), _M_key_compare(__comp) {}
+
+		template<class InIt>
+		flat_set(InIt __first, InIt __last, const _Compare& __comp = _Compare()) : _M_keys(), _M_key_compare(__comp)
+		{
+			insert(__first, __last);
+		}
+		flat_set(const flat_set& __x) : _M_keys(__x._M_keys), _M_key_compare(__x._M_key_compare) {}
+
+		flat_set& operator=(const flat_set& __x)
+		{
+			_M_keys = __x._M_keys;
+			_M_key_compare = __x._M_key_compare;
+			return *this;
+		}
+
+	public:
+		key_compare key_comp() const { return _M_key_compare; }
+		value_compare value_comp() const { return _M_key_compare; }
+		// 底层的有序序列
+		const container_type& keys() const { return _M_keys; }
+
+		// Iterator:
+		iterator begin() const { return _M_keys.begin(); }
+		iterator end() const { return _M_keys.end(); }
+		reverse_iterator rbegin() const { return _M_keys.rbegin(); }
+		reverse_iterator rend() const { return _M_keys.rend(); }
+		const_iterator cbegin() const { return _M_keys.begin(); }
+		const_iterator cend() const { return _M_keys.end(); }
+		const_reverse_iterator crbegin() const { return _M_keys.rbegin(); }
+		const_reverse_iterator crend() const { return _M_keys.rend(); }
+
+		// Capacity:
+		bool empty() const { return _M_keys.empty(); }
+		size_type size() const { return _M_keys.size(); }
+		size_type max_size() const { return _M_keys.max_size(); }
+		size_type capacity() const { return _M_keys.capacity(); }
+		void reserve(size_type __n) { _M_keys.reserve(__n); }
+
+		// Modifiers:
+		TinySTL::pair<iterator, bool> insert(const value_type& __x)
+		{
+			iterator __i = lower_bound(__x);
+			if (__i != end() && !_M_key_compare(__x, *__i))
+				return TinySTL::pair<iterator, bool>(__i, false);
+			return TinySTL::pair<iterator, bool>(_M_keys.insert(_S_unconst(_M_keys, __i), __x), true);
+		}
+		// __position为提示位置，若新元素恰好应位于其前，则无需查找
+		iterator insert(const_iterator __position, const value_type& __x)
+		{
+			if ((__position == end() || _M_key_compare(__x, *__position))
+				&& (__position == begin() || _M_key_compare(*(__position - 1), __x)))
+				return _M_keys.insert(_S_unconst(_M_keys, __position), __x);
+			return insert(__x).first;
+		}
+		template<class InIt>
+		void insert(InIt __first, InIt __last)
+		{
+			size_type __n = size();
+			for (; __first != __last; ++__first)
+				_M_keys.push_back(*__first);
+			_M_merge_tail(__n);
+		}
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> emplace(_Args&&... __args)
+		{
+			return insert(value_type(std::forward<_Args>(__args)...));
+		}
+
+		iterator erase(const_iterator __position) { return _M_keys.erase(_S_unconst(_M_keys, __position)); }
+		size_type erase(const key_type& __x)
+		{
+			iterator __i = find(__x);
+			if (__i == end())
+				return 0;
+			erase(__i);
+			return 1;
+		}
+		iterator erase(const_iterator __first, const_iterator __last)
+		{
+			return _M_keys.erase(_S_unconst(_M_keys, __first), _S_unconst(_M_keys, __last));
+		}
+		void clear() { _M_keys.clear(); }
+		void swap(flat_set& __x)
+		{
+			_M_keys.swap(__x._M_keys);
+			TinySTL::swap(_M_key_compare, __x._M_key_compare);
+		}
+
+		// Lookup:
+		iterator find(const key_type& __x) const
+		{
+			iterator __i = lower_bound(__x);
+			return __i == end() || _M_key_compare(__x, *__i) ? end() : __i;
+		}
+		size_type count(const key_type& __x) const { return find(__x) == end() ? 0 : 1; }
+		bool contains(const key_type& __x) const { return find(__x) != end(); }
+		iterator lower_bound(const key_type& __x) const
+		{
+			return _Flat_lower_bound(begin(), size(), __x, _M_key_compare, _Branchless());
+		}
+		iterator upper_bound(const key_type& __x) const
+		{
+			return _Flat_upper_bound(begin(), size(), __x, _M_key_compare, _Branchless());
+		}
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) const
+		{
+			iterator __i = lower_bound(__x);
+			return TinySTL::pair<iterator, iterator>(__i, __i == end() || _M_key_compare(__x, *__i) ? __i : __i + 1);
+		}
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	template<class _Key, class _Compare, class _Container>
+	inline void flat_set<_Key, _Compare, _Container>::_M_merge_tail(size_type __n)
+	{
+		typename _Container::iterator __first = _M_keys.begin();
+		typename _Container::iterator __mid = __first + __n;
+		typename _Container::iterator __last = _M_keys.end();
+		TinySTL::sort(__mid, __last, _M_key_compare);
+
+		// 归并时只接受大于已输出的最后一个元素的元素，从而一并去重；相等时先取原有的元素
+		_Container __result;
+		__result.reserve(_M_keys.size());
+		typename _Container::iterator __i = __first, __j = __mid;
+		while (__i != __mid || __j != __last)
+		{
+			typename _Container::iterator __next = __j == __last || (__i != __mid && !_M_key_compare(*__j, *__i)) ? __i++ : __j++;
+			if (__result.empty() || _M_key_compare(__result.back(), *__next))
+				__result.push_back(*__next);
+		}
+		_M_keys.swap(__result);
+	}
+
+	template<class _Key, class _Compare, class _Container>
+	inline bool operator==(const flat_set<_Key, _Compare, _Container>& __x, const flat_set<_Key, _Compare, _Container>& __y)
+	{
+		return __x.size() == __y.size() && TinySTL::equal(__x.begin(), __x.end(), __y.begin());
+	}
+
+	template<class _Key, class _Compare, class _Container>
+	inline bool operator!=(const flat_set<_Key, _Compare, _Container>& __x, const flat_set<_Key, _Compare, _Container>& __y)
+	{
+		return !(__x == __y);
+	}
+
+	template<class _Key, class _Compare, class _Container>
+	inline bool operator<(const flat_set<_Key, _Compare, _Container>& __x, const flat_set<_Key, _Compare, _Container>& __y)
+	{
+		return TinySTL::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end());
+	}
+
+	template<class _Key, class _Compare, class _Container>
+	inline bool operator>(const flat_set<_Key, _Compare, _Container>& __x, const flat_set<_Key, _Compare, _Container>& __y)
+	{
+		return __y < __x;
+	}
+
+	template<class _Key, class _Compare, class _Container>
+	inline bool operator<=(const flat_set<_Key, _Compare, _Container>& __x, const flat_set<_Key, _Compare, _Container>& __y)
+	{
+		return !(__y < __x);
+	}
+
+	template<class _Key, class _Compare, class _Container>
+	inline bool operator>=(const flat_set<_Key, _Compare, _Container>& __x, const flat_set<_Key, _Compare, _Container>& __y)
+	{
+		return !(__x < __y);
+	}
+
+	template<class _Key, class _Compare, class _Container>
+	inline void swap(flat_set<_Key, _Compare, _Container>& __x, flat_set<_Key, _Compare, _Container>& __y)
+	{
+		__x.swap(__y);
+	}
+}
+
+#endif // !_FLAT_SET_H_
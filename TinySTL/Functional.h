@@ -1,7 +1,11 @@
 ﻿#ifndef _FUNCTIONAL_H_
 #define _FUNCTIONAL_H_
 
+#include <cstring>
+#include <string>
+
 #include "TypeTraits.h"
+#include "Utility.h"
 
 namespace TinySTL
 {
@@ -134,6 +138,211 @@ namespace TinySTL
 		bool operator()(const T& x, const T& y) const { return x <= y; }
 	};
 
+	/*
+	* 哈希仿函数：hash<T>
+	* 供哈希表计算键值的哈希值，未特化的类型没有operator()
+	* 整数类型、指针与浮点数的位模式经_Hash_mix混合，输入的每一位都以约1/2的概率影响输出的每一位，
+	* 连续的键值与按8字节对齐的地址也能散布到所有的桶
+	* 浮点数+0.0与-0.0相等，二者的哈希值也相同
+	* 字节序列(std::string)采用wyhash的算法：每次读入16字节，以64位乘法的高低两半相异或(_Hash_mum)折叠进状态，
+	* 长于48字节时以三路独立的状态并行处理
+	* pair<T1, T2>以hash_combine合并两个成员的哈希值
+	*/
+	template<class T>
+	struct hash {};
+
+	// 64 x 64 -> 128位乘法，返回低64位，高64位存入__hi
+	inline constexpr unsigned long long _Hash_mul128(unsigned long long __a, unsigned long long __b, unsigned long long& __hi)
+	{
+#if defined(__SIZEOF_INT128__)
+		unsigned __int128 __r = static_cast<unsigned __int128>(__a) * __b;
+		__hi = static_cast<unsigned long long>(__r >> 64);
+		return static_cast<unsigned long long>(__r);
+#else
+		// 没有128位整数时以四个32位乘积拼出高低两半(MSVC的_umul128不能用于常量表达式)
+		unsigned long long __al = __a & 0xFFFFFFFFull, __ah = __a >> 32;
+		unsigned long long __bl = __b & 0xFFFFFFFFull, __bh = __b >> 32;
+		unsigned long long __ll = __al * __bl, __lh = __al * __bh, __hl = __ah * __bl;
+		unsigned long long __mid = (__ll >> 32) + (__lh & 0xFFFFFFFFull) + (__hl & 0xFFFFFFFFull);
+		__hi = __ah * __bh + (__lh >> 32) + (__hl >> 32) + (__mid >> 32);
+		return (__mid << 32) | (__ll & 0xFFFFFFFFull);
+#endif
+	}
+
+	// 64位乘法的高低两半相异或
+	inline constexpr unsigned long long _Hash_mum(unsigned long long __a, unsigned long long __b)
+	{
+		unsigned long long __hi = 0;
+		unsigned long long __lo = _Hash_mul128(__a, __b, __hi);
+		return __hi ^ __lo;
+	}
+
+	// 整数的混合函数(splitmix64的终结步骤)：两轮移位异或与乘法，是双射，0映射到0
+	inline constexpr unsigned long long _Hash_mix(unsigned long long __x)
+	{
+		__x ^= __x >> 30;
+		__x *= 0xBF58476D1CE4E5B9ull;
+		__x ^= __x >> 27;
+		__x *= 0x94D049BB133111EBull;
+		return __x ^ (__x >> 31);
+	}
+
+	// 把哈希值__h合并进__seed，结果与合并的先后次序有关
+	inline constexpr size_t _Hash_combine(size_t __seed, size_t __h)
+	{
+		return static_cast<size_t>(_Hash_mix(__seed + 0x9E3779B97F4A7C15ull + __h));
+	}
+
+	// wyhash的默认常量
+	static constexpr unsigned long long _Hash_secret[4] =
+	{
+		0x2D358DCCAA6C78A5ull, 0x8BB84B93962EACC9ull, 0x4B33A62ED433D4A3ull, 0x4D5A2DA51DE1AA47ull
+	};
+
+	// 按小端序读取，不要求对齐
+	inline unsigned long long _Hash_read8(const unsigned char* __p)
+	{
+		unsigned long long __v;
+		std::memcpy(&__v, __p, 8);
+		return __v;
+	}
+	inline unsigned long long _Hash_read4(const unsigned char* __p)
+	{
+		unsigned int __v;
+		std::memcpy(&__v, __p, 4);
+		return __v;
+	}
+
+	// 计算[__p, __p + __n)的哈希值
+	inline size_t _Hash_bytes(const void* __p, size_t __n, unsigned long long __seed = 0)
+	{
+		const unsigned char* __s = static_cast<const unsigned char*>(__p);
+		const unsigned long long* __k = _Hash_secret;
+		__seed ^= _Hash_mum(__seed ^ __k[0], __k[1]);
+		unsigned long long __a, __b;
+		if (__n <= 16)
+		{
+			if (__n >= 4)
+			{	// 4到16字节：首尾各取两个可能重叠的4字节
+				size_t __off = (__n >> 3) << 2;
+				__a = (_Hash_read4(__s) << 32) | _Hash_read4(__s + __off);
+				__b = (_Hash_read4(__s + __n - 4) << 32) | _Hash_read4(__s + __n - 4 - __off);
+			}
+			else if (__n > 0)
+			{
+				__a = (static_cast<unsigned long long>(__s[0]) << 16) | (static_cast<unsigned long long>(__s[__n >> 1]) << 8) | __s[__n - 1];
+				__b = 0;
+			}
+			else
+				__a = __b = 0;
+		}
+		else
+		{
+			size_t __i = __n;
+			if (__i > 48)
+			{	// 三路状态互不依赖，乘法可以并行执行
+				unsigned long long __see1 = __seed, __see2 = __seed;
+				do
+				{
+					__seed = _Hash_mum(_Hash_read8(__s) ^ __k[1], _Hash_read8(__s + 8) ^ __seed);
+					__see1 = _Hash_mum(_Hash_read8(__s + 16) ^ __k[2], _Hash_read8(__s + 24) ^ __see1);
+					__see2 = _Hash_mum(_Hash_read8(__s + 32) ^ __k[3], _Hash_read8(__s + 40) ^ __see2);
+					__s += 48;
+					__i -= 48;
+				} while (__i > 48);
+				__seed ^= __see1 ^ __see2;
+			}
+			for (; __i > 16; __i -= 16, __s += 16)
+				__seed = _Hash_mum(_Hash_read8(__s) ^ __k[1], _Hash_read8(__s + 8) ^ __seed);
+			// 最后16字节(可能与已处理的部分重叠)
+			__a = _Hash_read8(__s + __i - 16);
+			__b = _Hash_read8(__s + __i - 8);
+		}
+		__a ^= __k[1];
+		__b ^= __seed;
+		unsigned long long __hi = 0;
+		__a = _Hash_mul128(__a, __b, __hi);
+		__b = __hi;
+		return static_cast<size_t>(_Hash_mum(__a ^ __k[0] ^ __n, __b ^ __k[1]));
+	}
+
+	// 把__v的哈希值合并进__seed，用于为由多个成员组成的键值编写hash
+	template<class T>
+	inline void hash_combine(size_t& __seed, const T& __v)
+	{
+		__seed = _Hash_combine(__seed, hash<T>()(__v));
+	}
+
+#define _TINYSTL_INTEGRAL_HASH(_Type) \
+	template<> \
+	struct hash<_Type> : public unary_funciton<_Type, size_t> \
+	{ \
+		constexpr size_t operator()(_Type x) const { return static_cast<size_t>(_Hash_mix(static_cast<unsigned long long>(x))); } \
+	};
+
+	_TINYSTL_INTEGRAL_HASH(bool)
+	_TINYSTL_INTEGRAL_HASH(char)
+	_TINYSTL_INTEGRAL_HASH(signed char)
+	_TINYSTL_INTEGRAL_HASH(unsigned char)
+	_TINYSTL_INTEGRAL_HASH(wchar_t)
+	_TINYSTL_INTEGRAL_HASH(char16_t)
+	_TINYSTL_INTEGRAL_HASH(char32_t)
+	_TINYSTL_INTEGRAL_HASH(short)
+	_TINYSTL_INTEGRAL_HASH(unsigned short)
+	_TINYSTL_INTEGRAL_HASH(int)
+	_TINYSTL_INTEGRAL_HASH(unsigned int)
+	_TINYSTL_INTEGRAL_HASH(long)
+	_TINYSTL_INTEGRAL_HASH(unsigned long)
+	_TINYSTL_INTEGRAL_HASH(long long)
+	_TINYSTL_INTEGRAL_HASH(unsigned long long)
+
+#undef _TINYSTL_INTEGRAL_HASH
+
+	template<>
+	struct hash<float> : public unary_funciton<float, size_t>
+	{
+		size_t operator()(float x) const
+		{
+			unsigned int __bits = 0;
+			if (x != 0.0f)
+				std::memcpy(&__bits, &x, sizeof(x));
+			return static_cast<size_t>(_Hash_mix(__bits));
+		}
+	};
+
+	template<>
+	struct hash<double> : public unary_funciton<double, size_t>
+	{
+		size_t operator()(double x) const
+		{
+			unsigned long long __bits = 0;
+			if (x != 0.0)
+				std::memcpy(&__bits, &x, sizeof(x));
+			return static_cast<size_t>(_Hash_mix(__bits));
+		}
+	};
+
+	template<class T>
+	struct hash<T*> : public unary_funciton<T*, size_t>
+	{
+		size_t operator()(T* x) const { return static_cast<size_t>(_Hash_mix(reinterpret_cast<size_t>(x))); }
+	};
+
+	template<class T1, class T2>
+	struct hash<pair<T1, T2>> : public unary_funciton<pair<T1, T2>, size_t>
+	{
+		size_t operator()(const pair<T1, T2>& x) const
+		{
+			return _Hash_combine(_Hash_combine(0, hash<T1>()(x.first)), hash<T2>()(x.second));
+		}
+	};
+
+	template<>
+	struct hash<std::string> : public unary_funciton<std::string, size_t>
+	{
+		size_t operator()(const std::string& x) const { return _Hash_bytes(x.data(), x.size()); }
+	};
+
 	/*
 	* 逻辑运算类仿函数
 	* And：logical_and<T>
@@ -248,7 +457,8 @@ namespace TinySTL
 	template <class T>
 	inline T* _copy_t(const T* First, const T* Last, T* Dest, TinySTL::__true_type)
 	{
-		memmove(Dest, First, sizeof(T) * (Last - First));
+		if (First != Last) // 空区间的指针可能为空，不能传给memmove
+			memmove(Dest, First, sizeof(T) * (Last - First));
 		return Dest + (Last - First);
 	}
 
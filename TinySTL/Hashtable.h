@@ -0,0 +1,695 @@
+﻿#ifndef _HASHTABLE_H_
+#define _HASHTABLE_H_
+
+#include <cmath>
+#include <utility>
+
+#include "Iterator.h"
+#include "Allocator.h"
+#include "Construct.h"
+#include "Utility.h"
+#include "Algorithm.h"
+#include "Functional.h"
+
+namespace TinySTL
+{
+	/*
+	* 哈希表的节点，同一个桶内的节点以单向链表相连
+	*/
+	template<class _Val>
+	struct _Hashtable_node
+	{
+		_Hashtable_node* _M_next;
+		_Val _M_val;
+	};
+
+	/*
+	* 哈希表迭代器的基类
+	* 除当前节点外还记录其所在的桶：走到桶内链表的末尾时，顺序向后寻找下一个非空的桶，无需重新计算哈希值
+	* 桶数组的末尾多出一个哨兵桶，其内容为指向哨兵桶自身的非空指针，因此向后寻找时无需判断边界，
+	* 最终停在哨兵桶上的迭代器即为end()
+	*/
+	template<class _Val>
+	struct _Hashtable_iterator_base
+	{
+		using iterator_category = forward_iterator_tag;
+		using difference_type   = ptrdiff_t;
+		using _Node             = _Hashtable_node<_Val>;
+
+		_Node*  _M_cur;    // 当前节点，end()时为哨兵桶的内容
+		_Node** _M_bucket; // 当前节点所在的桶
+
+		_Hashtable_iterator_base() : _M_cur(nullptr), _M_bucket(nullptr) {}
+		_Hashtable_iterator_base(_Node* __n, _Node** __b) : _M_cur(__n), _M_bucket(__b) {}
+
+		void _M_incr()
+		{
+			_M_cur = _M_cur->_M_next;
+			while (_M_cur == nullptr)
+				_M_cur = *++_M_bucket;
+		}
+	};
+
+	template<class _Val>
+	inline bool operator==(const _Hashtable_iterator_base<_Val>& __x, const _Hashtable_iterator_base<_Val>& __y)
+	{
+		return __x._M_cur == __y._M_cur;
+	}
+
+	template<class _Val>
+	inline bool operator!=(const _Hashtable_iterator_base<_Val>& __x, const _Hashtable_iterator_base<_Val>& __y)
+	{
+		return __x._M_cur != __y._M_cur;
+	}
+
+	template<class _Val, class _Ref, class _Ptr>
+	struct _Hashtable_iterator : public _Hashtable_iterator_base<_Val>
+	{
+		using value_type     = _Val;
+		using reference      = _Ref;
+		using pointer        = _Ptr;
+		using iterator       = _Hashtable_iterator<_Val, _Val&, _Val*>;
+		using const_iterator = _Hashtable_iterator<_Val, const _Val&, const _Val*>;
+		using _Self          = _Hashtable_iterator<_Val, _Ref, _Ptr>;
+		using _Base          = _Hashtable_iterator_base<_Val>;
+		using _Node          = typename _Base::_Node;
+
+		_Hashtable_iterator() {}
+		_Hashtable_iterator(_Node* __n, _Node** __b) : _Base(__n, __b) {}
+		_Hashtable_iterator(const iterator& __it) : _Base(__it._M_cur, __it._M_bucket) {}
+
+		reference operator*() const { return this->_M_cur->_M_val; }
+		pointer operator->() const { return &(operator*()); }
+
+		_Self& operator++()
+		{
+			this->_M_incr();
+			return *this;
+		}
+
+		_Self operator++(int)
+		{
+			_Self __tmp = *this;
+			this->_M_incr();
+			return __tmp;
+		}
+	};
+
+	// 桶的个数取自以下质数表，相邻两项约为两倍关系
+	enum { _S_hashtable_num_primes = 31 };
+
+	inline size_t _Hashtable_next_prime(size_t __n)
+	{
+		static const unsigned long _S_prime_list[_S_hashtable_num_primes] =
+		{
+			5ul,          11ul,         23ul,         53ul,         97ul,
+			193ul,        389ul,        769ul,        1543ul,       3079ul,
+			6151ul,       12289ul,      24593ul,      49157ul,      98317ul,
+			196613ul,     393241ul,     786433ul,     1572869ul,    3145739ul,
+			6291469ul,    12582917ul,   25165843ul,   50331653ul,   100663319ul,
+			201326611ul,  402653189ul,  805306457ul,  1610612741ul, 3221225473ul,
+			4294967291ul
+		};
+		for (int __i = 0; __i < _S_hashtable_num_primes; ++__i)
+			if (_S_prime_list[__i] >= __n)
+				return _S_prime_list[__i];
+		return _S_prime_list[_S_hashtable_num_primes - 1];
+	}
+
+	/*
+	* ***********************************
+	* _Hashtable : 以开链法解决冲突的哈希表
+	* ***********************************
+	* 桶数组中的每个桶是一条单向链表，桶的个数为质数，键值的哈希值对桶的个数取模即为其所在的桶
+	* 元素个数超过 桶的个数 * max_load_factor() 时，桶的个数增长到下一个质数(约为两倍)，并把所有节点重新链接到新的桶中，
+	* 节点本身不移动，因此重新哈希不会使指针与引用失效，只使迭代器失效
+	* 键值相等的元素在桶内相邻存放，equal_range因而只需顺序扫描
+	* 节点与桶数组均经由simple_alloc从_Alloc分配；要求哈希函数不抛出异常
+	*
+	* 空表不分配桶数组，而是共用一个只含一个空桶的静态数组，第一次插入时才分配
+	*/
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc = TinySTL::alloc>
+	class _Hashtable
+	{
+	public:
+		using key_type        = _Key;
+		using value_type      = _Val;
+		using hasher          = _HashFcn;
+		using key_equal       = _EqualKey;
+		using pointer         = value_type*;
+		using const_pointer   = const value_type*;
+		using reference       = value_type&;
+		using const_reference = const value_type&;
+		using size_type       = size_t;
+		using difference_type = ptrdiff_t;
+		using allocator_type  = _Alloc;
+
+		using iterator        = _Hashtable_iterator<value_type, reference, pointer>;
+		using const_iterator  = _Hashtable_iterator<value_type, const_reference, const_pointer>;
+
+	private:
+		using _Node         = _Hashtable_node<_Val>;
+		using _Node_alloc   = simple_alloc<_Node, _Alloc>;
+		using _Bucket_alloc = simple_alloc<_Node*, _Alloc>;
+
+		_Node**   _M_buckets;         // _M_num_buckets个桶，外加末尾的哨兵桶
+		size_type _M_num_buckets;
+		size_type _M_num_elements;
+		size_type _M_next_resize;     // 元素个数超过此值时扩充桶数组
+		float     _M_max_load_factor;
+		hasher    _M_hash;
+		key_equal _M_equals;
+		_ExtractKey _M_get_key;
+
+	private:
+		// 空表共用的桶数组：一个空桶与哨兵桶
+		static _Node** _S_empty_buckets()
+		{
+			static _Node* __buckets[2] = { nullptr, reinterpret_cast<_Node*>(&__buckets[1]) };
+			return __buckets;
+		}
+
+		_Node* _M_new_node(const value_type& __v)
+		{
+			_Node* __n = _Node_alloc::allocate();
+			__n->_M_next = nullptr;
+			try
+			{
+				construct(&__n->_M_val, __v);
+			}
+			catch (...)
+			{
+				_Node_alloc::deallocate(__n);
+				throw;
+			}
+			return __n;
+		}
+		void _M_delete_node(_Node* __n)
+		{
+			destroy(&__n->_M_val);
+			_Node_alloc::deallocate(__n);
+		}
+
+		// 分配__n个空桶与哨兵桶
+		static _Node** _S_allocate_buckets(size_type __n)
+		{
+			_Node** __b = _Bucket_alloc::allocate(__n + 1);
+			for (size_type __i = 0; __i < __n; ++__i)
+				__b[__i] = nullptr;
+			__b[__n] = reinterpret_cast<_Node*>(&__b[__n]);
+			return __b;
+		}
+		void _M_deallocate_buckets()
+		{
+			if (_M_buckets != _S_empty_buckets())
+				_Bucket_alloc::deallocate(_M_buckets, _M_num_buckets + 1);
+		}
+
+		const key_type& _M_key(const _Node* __n) const { return _M_get_key(__n->_M_val); }
+		size_type _M_bkt_num_key(const key_type& __k) const { return _M_hash(__k) % _M_num_buckets; }
+		size_type _M_bkt_num(const value_type& __v) const { return _M_bkt_num_key(_M_get_key(__v)); }
+
+		// 容纳__n个元素所需的最少桶数
+		size_type _M_bkt_for_elements(size_type __n) const
+		{
+			return static_cast<size_type>(std::ceil(static_cast<double>(__n) / _M_max_load_factor));
+		}
+		void _M_update_next_resize()
+		{
+			_M_next_resize = _M_buckets == _S_empty_buckets() ? 0
+				: static_cast<size_type>(std::floor(static_cast<double>(_M_num_buckets) * _M_max_load_factor));
+		}
+		// 插入后元素个数将为__n，若超过上限则扩充桶数组
+		void _M_reserve_for(size_type __n)
+		{
+			if (__n > _M_next_resize)
+				_M_rehash_to(_Hashtable_next_prime(_M_bkt_for_elements(__n)));
+		}
+		// 把所有节点重新链接到__n个新桶中
+		void _M_rehash_to(size_type __n);
+
+		void _M_copy_from(const _Hashtable& __ht);
+
+	public:
+		explicit _Hashtable(size_type __n = 0, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& = allocator_type())
+			: _M_buckets(_S_empty_buckets()), _M_num_buckets(1), _M_num_elements(0), _M_next_resize(0),
+			_M_max_load_factor(1.0f), _M_hash(__hf), _M_equals(__eql), _M_get_key()
+		{
+			if (__n > 0)
+				rehash(__n);
+		}
+
+		_Hashtable(const _Hashtable& __ht)
+			: _M_buckets(_S_empty_buckets()), _M_num_buckets(1), _M_num_elements(0), _M_next_resize(0),
+			_M_max_load_factor(__ht._M_max_load_factor), _M_hash(__ht._M_hash), _M_equals(__ht._M_equals), _M_get_key(__ht._M_get_key)
+		{
+			_M_copy_from(__ht);
+		}
+
+		_Hashtable& operator=(const _Hashtable& __ht)
+		{
+			if (&__ht != this)
+			{
+				clear();
+				_M_deallocate_buckets();
+				_M_buckets = _S_empty_buckets();
+				_M_num_buckets = 1;
+				_M_max_load_factor = __ht._M_max_load_factor;
+				_M_update_next_resize();
+				_M_hash = __ht._M_hash;
+				_M_equals = __ht._M_equals;
+				_M_get_key = __ht._M_get_key;
+				_M_copy_from(__ht);
+			}
+			return *this;
+		}
+
+		~_Hashtable()
+		{
+			clear();
+			_M_deallocate_buckets();
+		}
+
+	public:
+		hasher hash_funct() const { return _M_hash; }
+		key_equal key_eq() const { return _M_equals; }
+		allocator_type get_allocator() const { return allocator_type(); }
+
+		size_type size() const { return _M_num_elements; }
+		size_type max_size() const { return size_type(-1); }
+		bool empty() const { return _M_num_elements == 0; }
+
+		void swap(_Hashtable& __ht)
+		{
+			TinySTL::swap(_M_buckets, __ht._M_buckets);
+			TinySTL::swap(_M_num_buckets, __ht._M_num_buckets);
+			TinySTL::swap(_M_num_elements, __ht._M_num_elements);
+			TinySTL::swap(_M_next_resize, __ht._M_next_resize);
+			TinySTL::swap(_M_max_load_factor, __ht._M_max_load_factor);
+			TinySTL::swap(_M_hash, __ht._M_hash);
+			TinySTL::swap(_M_equals, __ht._M_equals);
+			TinySTL::swap(_M_get_key, __ht._M_get_key);
+		}
+
+		iterator begin()
+		{
+			if (_M_num_elements == 0)
+				return end();
+			_Node** __b = _M_buckets;
+			while (*__b == nullptr)
+				++__b;
+			return iterator(*__b, __b);
+		}
+		const_iterator begin() const { return const_cast<_Hashtable*>(this)->begin(); }
+		iterator end() { return iterator(_M_buckets[_M_num_buckets], _M_buckets + _M_num_buckets); }
+		const_iterator end() const { return const_iterator(_M_buckets[_M_num_buckets], _M_buckets + _M_num_buckets); }
+
+	public:
+		// Bucket interface:
+		size_type bucket_count() const { return _M_num_buckets; }
+		size_type max_bucket_count() const { return _Hashtable_next_prime(size_type(-1)); }
+		size_type bucket_size(size_type __n) const
+		{
+			size_type __result = 0;
+			for (_Node* __cur = _M_buckets[__n]; __cur != nullptr; __cur = __cur->_M_next)
+				++__result;
+			return __result;
+		}
+		size_type bucket(const key_type& __k) const { return _M_bkt_num_key(__k); }
+
+		// Hash policy:
+		float load_factor() const { return static_cast<float>(_M_num_elements) / static_cast<float>(_M_num_buckets); }
+		float max_load_factor() const { return _M_max_load_factor; }
+		void max_load_factor(float __z)
+		{
+			_M_max_load_factor = __z;
+			_M_update_next_resize();
+			_M_reserve_for(_M_num_elements);
+		}
+		// 桶的个数调整为不小于__n、且足以容纳现有元素的最小质数，可以缩小
+		void rehash(size_type __n)
+		{
+			size_type __need = TinySTL::max(__n, _M_bkt_for_elements(_M_num_elements));
+			size_type __new = __need == 0 ? 0 : _Hashtable_next_prime(__need);
+			if (__new != 0 && __new != _M_num_buckets)
+				_M_rehash_to(__new);
+		}
+		// 预留容纳__n个元素的桶，此后插入不超过__n个元素都不会引起重新哈希
+		void reserve(size_type __n) { _M_reserve_for(__n); }
+
+	public:
+		// 插入新值，键值不允许重复，若重复则插入无效
+		TinySTL::pair<iterator, bool> insert_unique(const value_type& __v)
+		{
+			_M_reserve_for(_M_num_elements + 1);
+			return insert_unique_noresize(__v);
+		}
+		// 插入新值，键值可以重复，新元素紧随键值相等的元素之后
+		iterator insert_equal(const value_type& __v)
+		{
+			_M_reserve_for(_M_num_elements + 1);
+			return insert_equal_noresize(__v);
+		}
+
+		TinySTL::pair<iterator, bool> insert_unique_noresize(const value_type& __v);
+		iterator insert_equal_noresize(const value_type& __v);
+
+		template<class InIt>
+		void insert_unique(InIt __first, InIt __last)
+		{
+			_M_insert_unique(__first, __last, iterator_category(__first));
+		}
+		template<class InIt>
+		void insert_equal(InIt __first, InIt __last)
+		{
+			_M_insert_equal(__first, __last, iterator_category(__first));
+		}
+
+		// 调用者已确认键值为__k的元素不存在，__code为_M_hash(__k)，插入时无需再次查找与计算哈希值
+		iterator _M_insert_unique_node(size_type __code, const value_type& __v);
+		size_type _M_hash_code(const key_type& __k) const { return _M_hash(__k); }
+		iterator _M_find(const key_type& __k, size_type __code);
+
+		iterator find(const key_type& __k) { return _M_find(__k, _M_hash(__k)); }
+		const_iterator find(const key_type& __k) const { return const_cast<_Hashtable*>(this)->_M_find(__k, _M_hash(__k)); }
+		size_type count(const key_type& __k) const;
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __k);
+		TinySTL::pair<const_iterator, const_iterator> equal_range(const key_type& __k) const
+		{
+			TinySTL::pair<iterator, iterator> __p = const_cast<_Hashtable*>(this)->equal_range(__k);
+			return TinySTL::pair<const_iterator, const_iterator>(__p.first, __p.second);
+		}
+
+		// 返回被删除元素的后继
+		iterator erase(const_iterator __it);
+		iterator erase(const_iterator __first, const_iterator __last);
+		size_type erase(const key_type& __k);
+		void clear();
+
+		// 两表的元素相同(键值相等的元素可以以任意次序出现)
+		bool _M_equal_unique(const _Hashtable& __ht) const;
+		bool _M_equal_multi(const _Hashtable& __ht) const;
+
+	private:
+		template<class InIt>
+		void _M_insert_unique(InIt __first, InIt __last, input_iterator_tag)
+		{
+			for (; __first != __last; ++__first)
+				insert_unique(*__first);
+		}
+		template<class FwdIt>
+		void _M_insert_unique(FwdIt __first, FwdIt __last, forward_iterator_tag)
+		{
+			_M_reserve_for(_M_num_elements + static_cast<size_type>(TinySTL::distance(__first, __last)));
+			for (; __first != __last; ++__first)
+				insert_unique_noresize(*__first);
+		}
+		template<class InIt>
+		void _M_insert_equal(InIt __first, InIt __last, input_iterator_tag)
+		{
+			for (; __first != __last; ++__first)
+				insert_equal(*__first);
+		}
+		template<class FwdIt>
+		void _M_insert_equal(FwdIt __first, FwdIt __last, forward_iterator_tag)
+		{
+			_M_reserve_for(_M_num_elements + static_cast<size_type>(TinySTL::distance(__first, __last)));
+			for (; __first != __last; ++__first)
+				insert_equal_noresize(*__first);
+		}
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline void _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_M_rehash_to(size_type __n)
+	{
+		_Node** __tmp = _S_allocate_buckets(__n);
+		for (size_type __bucket = 0; __bucket < _M_num_buckets; ++__bucket)
+		{
+			_Node* __first = _M_buckets[__bucket];
+			while (__first != nullptr)
+			{	// 逐个摘下旧桶中的节点，插入新桶的头部；键值相等的元素依旧相邻，只是次序颠倒
+				size_type __new_bucket = _M_hash(_M_key(__first)) % __n;
+				_Node* __next = __first->_M_next;
+				__first->_M_next = __tmp[__new_bucket];
+				__tmp[__new_bucket] = __first;
+				__first = __next;
+			}
+		}
+		_M_deallocate_buckets();
+		_M_buckets = __tmp;
+		_M_num_buckets = __n;
+		_M_update_next_resize();
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline void _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_M_copy_from(const _Hashtable& __ht)
+	{	// 调用前*this为空表；桶的个数与__ht相同，各桶内的节点次序也与__ht相同
+		if (__ht._M_num_elements == 0)
+			return;
+		_M_buckets = _S_allocate_buckets(__ht._M_num_buckets);
+		_M_num_buckets = __ht._M_num_buckets;
+		_M_update_next_resize();
+		try
+		{
+			for (size_type __i = 0; __i < __ht._M_num_buckets; ++__i)
+			{
+				_Node** __link = &_M_buckets[__i];
+				for (const _Node* __cur = __ht._M_buckets[__i]; __cur != nullptr; __cur = __cur->_M_next)
+				{
+					*__link = _M_new_node(__cur->_M_val);
+					__link = &(*__link)->_M_next;
+					++_M_num_elements;
+				}
+			}
+		}
+		catch (...)
+		{
+			clear();
+			throw;
+		}
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline TinySTL::pair<typename _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::iterator, bool>
+	_Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::insert_unique_noresize(const value_type& __v)
+	{
+		const size_type __n = _M_bkt_num(__v);
+		_Node* __first = _M_buckets[__n];
+
+		for (_Node* __cur = __first; __cur != nullptr; __cur = __cur->_M_next)
+			if (_M_equals(_M_key(__cur), _M_get_key(__v)))
+				return TinySTL::pair<iterator, bool>(iterator(__cur, _M_buckets + __n), false);
+
+		_Node* __tmp = _M_new_node(__v);
+		__tmp->_M_next = __first;
+		_M_buckets[__n] = __tmp;
+		++_M_num_elements;
+		return TinySTL::pair<iterator, bool>(iterator(__tmp, _M_buckets + __n), true);
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline typename _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::iterator
+	_Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::insert_equal_noresize(const value_type& __v)
+	{
+		const size_type __n = _M_bkt_num(__v);
+		_Node* __first = _M_buckets[__n];
+
+		for (_Node* __cur = __first; __cur != nullptr; __cur = __cur->_M_next)
+			if (_M_equals(_M_key(__cur), _M_get_key(__v)))
+			{	// 插入在第一个键值相等的元素之后，使键值相等的元素保持相邻
+				_Node* __tmp = _M_new_node(__v);
+				__tmp->_M_next = __cur->_M_next;
+				__cur->_M_next = __tmp;
+				++_M_num_elements;
+				return iterator(__tmp, _M_buckets + __n);
+			}
+
+		_Node* __tmp = _M_new_node(__v);
+		__tmp->_M_next = __first;
+		_M_buckets[__n] = __tmp;
+		++_M_num_elements;
+		return iterator(__tmp, _M_buckets + __n);
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline typename _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::iterator
+	_Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_M_insert_unique_node(size_type __code, const value_type& __v)
+	{
+		_M_reserve_for(_M_num_elements + 1);
+		_Node* __tmp = _M_new_node(__v);
+		const size_type __n = __code % _M_num_buckets;
+		__tmp->_M_next = _M_buckets[__n];
+		_M_buckets[__n] = __tmp;
+		++_M_num_elements;
+		return iterator(__tmp, _M_buckets + __n);
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline typename _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::iterator
+	_Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_M_find(const key_type& __k, size_type __code)
+	{
+		const size_type __n = __code % _M_num_buckets;
+		for (_Node* __cur = _M_buckets[__n]; __cur != nullptr; __cur = __cur->_M_next)
+			if (_M_equals(_M_key(__cur), __k))
+				return iterator(__cur, _M_buckets + __n);
+		return end();
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline typename _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::size_type
+	_Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::count(const key_type& __k) const
+	{
+		const size_type __n = _M_bkt_num_key(__k);
+		size_type __result = 0;
+		for (const _Node* __cur = _M_buckets[__n]; __cur != nullptr; __cur = __cur->_M_next)
+			if (_M_equals(_M_key(__cur), __k))
+				++__result;
+			else if (__result != 0) // 键值相等的元素相邻，已经越过了这一组
+				break;
+		return __result;
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline TinySTL::pair<typename _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::iterator,
+		typename _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::iterator>
+	_Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::equal_range(const key_type& __k)
+	{
+		iterator __first = find(__k);
+		if (__first == end())
+			return TinySTL::pair<iterator, iterator>(__first, __first);
+		iterator __last = __first;
+		do
+			++__last;
+		while (__last._M_bucket == __first._M_bucket && _M_equals(_M_key(__last._M_cur), __k));
+		return TinySTL::pair<iterator, iterator>(__first, __last);
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline typename _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::iterator
+	_Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::erase(const_iterator __it)
+	{
+		iterator __next(__it._M_cur, __it._M_bucket);
+		++__next;
+
+		_Node** __link = __it._M_bucket; // 在桶内找到指向该节点的指针
+		while (*__link != __it._M_cur)
+			__link = &(*__link)->_M_next;
+		*__link = __it._M_cur->_M_next;
+		_M_delete_node(__it._M_cur);
+		--_M_num_elements;
+		return __next;
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline typename _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::iterator
+	_Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::erase(const_iterator __first, const_iterator __last)
+	{
+		if (__first == begin() && __last == end())
+		{
+			clear();
+			return end();
+		}
+		iterator __result(__first._M_cur, __first._M_bucket);
+		while (__result != __last)
+			__result = erase(__result);
+		return __result;
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline typename _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::size_type
+	_Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::erase(const key_type& __k)
+	{
+		// __k可能正是某个待删除元素的键值，因此先把这些节点摘下，比较结束后再统一销毁
+		_Node* __erased = nullptr;
+		size_type __count = 0;
+		_Node** __link = &_M_buckets[_M_bkt_num_key(__k)];
+		while (*__link != nullptr)
+		{
+			_Node* __cur = *__link;
+			if (_M_equals(_M_key(__cur), __k))
+			{
+				*__link = __cur->_M_next;
+				__cur->_M_next = __erased;
+				__erased = __cur;
+				++__count;
+			}
+			else if (__count != 0)
+				break;
+			else
+				__link = &__cur->_M_next;
+		}
+		while (__erased != nullptr)
+		{
+			_Node* __next = __erased->_M_next;
+			_M_delete_node(__erased);
+			__erased = __next;
+		}
+		_M_num_elements -= __count;
+		return __count;
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline void _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::clear()
+	{	// 保留桶数组
+		if (_M_num_elements == 0)
+			return;
+		for (size_type __i = 0; __i < _M_num_buckets; ++__i)
+		{
+			_Node* __cur = _M_buckets[__i];
+			while (__cur != nullptr)
+			{
+				_Node* __next = __cur->_M_next;
+				_M_delete_node(__cur);
+				__cur = __next;
+			}
+			_M_buckets[__i] = nullptr;
+		}
+		_M_num_elements = 0;
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline bool _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_M_equal_unique(const _Hashtable& __ht) const
+	{
+		if (_M_num_elements != __ht._M_num_elements)
+			return false;
+		for (const_iterator __it = begin(); __it != end(); ++__it)
+		{
+			const_iterator __j = __ht.find(_M_get_key(*__it));
+			if (__j == __ht.end() || !(*__j == *__it))
+				return false;
+		}
+		return true;
+	}
+
+	template<class _Val, class _Key, class _HashFcn, class _ExtractKey, class _EqualKey, class _Alloc>
+	inline bool _Hashtable<_Val, _Key, _HashFcn, _ExtractKey, _EqualKey, _Alloc>::_M_equal_multi(const _Hashtable& __ht) const
+	{
+		if (_M_num_elements != __ht._M_num_elements)
+			return false;
+		const_iterator __it = begin();
+		while (__it != end())
+		{	// 逐组比较：两组的元素个数相同，且每个元素在两组中出现的次数相同
+			TinySTL::pair<const_iterator, const_iterator> __x = equal_range(_M_get_key(*__it));
+			TinySTL::pair<const_iterator, const_iterator> __y = __ht.equal_range(_M_get_key(*__it));
+			if (TinySTL::distance(__x.first, __x.second) != TinySTL::distance(__y.first, __y.second))
+				return false;
+			for (const_iterator __i = __x.first; __i != __x.second; ++__i)
+			{
+				difference_type __cx = 0, __cy = 0;
+				for (const_iterator __j = __x.first; __j != __x.second; ++__j)
+					__cx += *__j == *__i ? 1 : 0;
+				for (const_iterator __j = __y.first; __j != __y.second; ++__j)
+					__cy += *__j == *__i ? 1 : 0;
+				if (__cx != __cy)
+					return false;
+			}
+			__it = __x.second;
+		}
+		return true;
+	}
+}
+
+#endif // !_HASHTABLE_H_
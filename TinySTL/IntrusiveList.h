@@ -0,0 +1,501 @@
+﻿#ifndef _INTRUSIVE_LIST_H_
+#define _INTRUSIVE_LIST_H_
+
+#include "List.h"
+#include "Slist.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* intrusive_list / intrusive_slist : 侵入式链表
+	* ***********************************
+	* 链接指针(hook)是元素的基类，容器只把已有对象串起来，从不分配内存也不复制元素
+	* 元素的生命周期由使用者管理：对象在被移出容器之前不得析构，容器析构时只解除链接
+	* hook与元素之间以static_cast换算，偏移量在编译期确定；元素可以有虚函数，也不要求是标准布局类型，
+	* 但hook必须是公有的非虚基类
+	* 一个对象可以以不同的标签(Tag)继承多个hook，从而同时位于多个容器中
+	*
+	* 用法：
+	*	struct Timer : public intrusive_list_hook<>
+	*	{
+	*		int expire;
+	*	};
+	*	intrusive_list<Timer> wheel;
+	*
+	*	struct LruTag;
+	*	struct FreeTag;
+	*	struct Entry : public intrusive_list_hook<LruTag>, public intrusive_slist_hook<FreeTag> { ... };
+	*	intrusive_list<Entry, LruTag>   lru;
+	*	intrusive_slist<Entry, FreeTag> freeList;
+	*/
+
+	// 双向链表的hook，与list_node_base布局相同；未链入任何容器时两个指针均为nullptr
+	template<class Tag = void>
+	struct intrusive_list_hook : public list_node_base
+	{
+		intrusive_list_hook() { next_ = prev_ = nullptr; }
+		// 复制对象时不复制链接关系
+		intrusive_list_hook(const intrusive_list_hook&) { next_ = prev_ = nullptr; }
+		intrusive_list_hook& operator=(const intrusive_list_hook&) { return *this; }
+
+		bool is_linked() const { return next_ != nullptr; }
+	};
+
+	// 单向链表的hook，与_slist_node_base布局相同
+	// 单向链表的结尾同样是nullptr，因此无法像双向hook那样仅凭指针判断是否已链入
+	template<class Tag = void>
+	struct intrusive_slist_hook : public _slist_node_base
+	{
+		intrusive_slist_hook() { _M_next = nullptr; }
+		intrusive_slist_hook(const intrusive_slist_hook&) { _M_next = nullptr; }
+		intrusive_slist_hook& operator=(const intrusive_slist_hook&) { return *this; }
+	};
+
+	// 在结点、hook与其所在对象之间换算，均为编译期确定偏移量的static_cast
+	template<class T, class Hook>
+	struct intrusive_hook_traits
+	{
+		static Hook* to_hook(T* Val) { return static_cast<Hook*>(Val); }
+		template<class Node>
+		static T* to_value(Node* N) { return static_cast<T*>(static_cast<Hook*>(N)); }
+	};
+
+	template<class T, class Tag, class Ref, class Ptr>
+	struct intrusive_list_iterator : public list_iterator_base
+	{
+		using iterator       = intrusive_list_iterator<T, Tag, T&, T*>;
+		using const_iterator = intrusive_list_iterator<T, Tag, const T&, const T*>;
+		using _Self          = intrusive_list_iterator<T, Tag, Ref, Ptr>;
+		using _Traits        = intrusive_hook_traits<T, intrusive_list_hook<Tag>>;
+
+		using value_type     = T;
+		using pointer        = Ptr;
+		using reference      = Ref;
+
+	public:
+		explicit intrusive_list_iterator(list_node_base* Node) : list_iterator_base(Node) {}
+		intrusive_list_iterator() {}
+		intrusive_list_iterator(const iterator& Iter) : list_iterator_base(Iter.node_) {}
+
+	public:
+		reference operator*() const { return *_Traits::to_value(node_); }
+		pointer operator->() const { return &(operator*()); }
+
+		_Self& operator++()
+		{
+			this->incr();
+			return *this;
+		}
+
+		_Self operator++(int)
+		{
+			_Self Tmp = *this;
+			this->incr();
+			return Tmp;
+		}
+
+		_Self& operator--()
+		{
+			this->decr();
+			return *this;
+		}
+
+		_Self operator--(int)
+		{
+			_Self Tmp = *this;
+			this->decr();
+			return Tmp;
+		}
+	};
+
+	template<class T, class Tag = void>
+	class intrusive_list
+	{
+	public:
+		using value_type      = T;
+		using pointer         = value_type*;
+		using const_pointer   = const value_type*;
+		using reference       = value_type&;
+		using const_reference = const value_type&;
+		using size_type       = size_t;
+		using difference_type = ptrdiff_t;
+
+		using iterator               = intrusive_list_iterator<T, Tag, T&, T*>;
+		using const_iterator         = intrusive_list_iterator<T, Tag, const T&, const T*>;
+		using const_reverse_iterator = TinySTL::reverse_iterator<const_iterator>;
+		using reverse_iterator       = TinySTL::reverse_iterator<iterator>;
+
+	protected:
+		using _Traits = intrusive_hook_traits<T, intrusive_list_hook<Tag>>;
+
+	public:
+		intrusive_list() : size_(0)
+		{	// 头结点直接内嵌于容器中
+			root_.next_ = &root_;
+			root_.prev_ = &root_;
+		}
+		intrusive_list(const intrusive_list&) = delete;
+		intrusive_list& operator=(const intrusive_list&) = delete;
+		~intrusive_list() { clear(); } // 只解除链接，不析构元素
+
+	protected:
+		// 将Node链入Where之前
+		static void link_before(list_node_base* Where, list_node_base* Node)
+		{
+			Node->next_ = Where;
+			Node->prev_ = Where->prev_;
+			Where->prev_->next_ = Node;
+			Where->prev_ = Node;
+		}
+		// 将Node从所在链表中摘下，并把hook恢复为未链入状态
+		static void unlink_node(list_node_base* Node)
+		{
+			Node->prev_->next_ = Node->next_;
+			Node->next_->prev_ = Node->prev_;
+			Node->next_ = Node->prev_ = nullptr;
+		}
+		// 将[First,Last)从原位置摘下来,插入到Where之前，与list::transfer相同
+		static void transfer(list_node_base* Where, list_node_base* First, list_node_base* Last);
+
+	public:
+		// Iterator:
+		iterator begin() { return iterator(root_.next_); }
+		const_iterator begin() const { return const_iterator(root_.next_); }
+		iterator end() { return iterator(&root_); }
+		const_iterator end() const { return const_iterator(const_cast<list_node_base*>(&root_)); }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+		const_iterator cbegin() const { return begin(); }
+		const_iterator cend() const { return end(); }
+
+		// 由元素引用得到其迭代器，O(1)
+		iterator iterator_to(reference Val) { return iterator(_Traits::to_hook(&Val)); }
+		const_iterator iterator_to(const_reference Val) const
+		{
+			return const_iterator(_Traits::to_hook(const_cast<pointer>(&Val)));
+		}
+
+		// Capacity:
+		bool empty() const { return root_.next_ == &root_; }
+		size_type size() const { return size_; }
+
+		// Element acces:
+		reference front() { return *begin(); }
+		const_reference front() const { return *begin(); }
+		reference back() { return *(--end()); }
+		const_reference back() const { return *(--end()); }
+
+		// Modifiers: 元素必须尚未链入其他使用同一hook的容器
+		void push_front(reference Val) { insert(begin(), Val); }
+		void pop_front() { erase(begin()); }
+		void push_back(reference Val) { insert(end(), Val); }
+		void pop_back() { erase(--end()); }
+		iterator insert(iterator Where, reference Val);
+		iterator erase(iterator Where);
+		iterator erase(iterator First, iterator Last);
+		// 按引用摘除元素，O(1)，元素必须位于本容器中
+		void unlink(reference Val) { erase(iterator_to(Val)); }
+		void swap(intrusive_list& Other);
+		void clear();
+
+	public:
+		void splice(iterator Where, intrusive_list& Right);
+		void splice(iterator Where, intrusive_list& Right, iterator First);
+		void splice(iterator Where, intrusive_list& Right, iterator First, iterator Last);
+		void reverse();
+
+	protected:
+		list_node_base root_; // 头结点
+		size_type      size_; // 元素个数
+	};
+
+	template<class T, class Tag, class Ref, class Ptr>
+	struct intrusive_slist_iterator : public _slist_iterator_base
+	{
+		using iterator       = intrusive_slist_iterator<T, Tag, T&, T*>;
+		using const_iterator = intrusive_slist_iterator<T, Tag, const T&, const T*>;
+		using _Self          = intrusive_slist_iterator<T, Tag, Ref, Ptr>;
+		using _Traits        = intrusive_hook_traits<T, intrusive_slist_hook<Tag>>;
+
+		using value_type      = T;
+		using pointer         = Ptr;
+		using reference       = Ref;
+		using difference_type = ptrdiff_t;
+
+	public:
+		explicit intrusive_slist_iterator(_slist_node_base* Node) : _slist_iterator_base(Node) {}
+		intrusive_slist_iterator() : _slist_iterator_base(nullptr) {}
+		intrusive_slist_iterator(const iterator& Iter) : _slist_iterator_base(Iter._M_node) {}
+
+	public:
+		reference operator*() const { return *_Traits::to_value(_M_node); }
+		pointer operator->() const { return &(operator*()); }
+
+		_Self& operator++()
+		{
+			incr();
+			return *this;
+		}
+
+		_Self operator++(int)
+		{
+			_Self Tmp = *this;
+			incr();
+			return Tmp;
+		}
+	};
+
+	template<class T, class Tag = void>
+	class intrusive_slist
+	{
+	public:
+		using value_type      = T;
+		using pointer         = value_type*;
+		using const_pointer   = const value_type*;
+		using reference       = value_type&;
+		using const_reference = const value_type&;
+		using size_type       = size_t;
+		using difference_type = ptrdiff_t;
+
+		using iterator        = intrusive_slist_iterator<T, Tag, T&, T*>;
+		using const_iterator  = intrusive_slist_iterator<T, Tag, const T&, const T*>;
+
+	protected:
+		using _Traits = intrusive_hook_traits<T, intrusive_slist_hook<Tag>>;
+
+	public:
+		intrusive_slist() : size_(0) { head_._M_next = nullptr; }
+		intrusive_slist(const intrusive_slist&) = delete;
+		intrusive_slist& operator=(const intrusive_slist&) = delete;
+		~intrusive_slist() { clear(); }
+
+	public:
+		// Iterator:
+		iterator before_begin() { return iterator(&head_); }
+		const_iterator before_begin() const { return const_iterator(const_cast<_slist_node_base*>(&head_)); }
+		iterator begin() { return iterator(head_._M_next); }
+		const_iterator begin() const { return const_iterator(head_._M_next); }
+		iterator end() { return iterator(nullptr); }
+		const_iterator end() const { return const_iterator(nullptr); }
+		const_iterator cbegin() const { return begin(); }
+		const_iterator cend() const { return end(); }
+
+		iterator iterator_to(reference Val) { return iterator(_Traits::to_hook(&Val)); }
+		const_iterator iterator_to(const_reference Val) const
+		{
+			return const_iterator(_Traits::to_hook(const_cast<pointer>(&Val)));
+		}
+		// 单向链表只能从头查找前驱，O(n)
+		iterator previous(const_iterator Where)
+		{
+			return iterator(__slist_previous(&head_, Where._M_node));
+		}
+
+		// Capacity:
+		bool empty() const { return head_._M_next == nullptr; }
+		size_type size() const { return size_; }
+
+		// Element acces:
+		reference front() { return *begin(); }
+		const_reference front() const { return *begin(); }
+
+		// Modifiers: 以下*_after操作均为O(1)
+		void push_front(reference Val) { insert_after(before_begin(), Val); }
+		void pop_front() { erase_after(before_begin()); }
+		iterator insert_after(iterator Where, reference Val)
+		{
+			++size_;
+			return iterator(__slit_make_link(Where._M_node, _Traits::to_hook(&Val)));
+		}
+		// 摘除Where之后的元素，返回被摘除元素的后一个位置
+		iterator erase_after(iterator Where)
+		{
+			_slist_node_base* Node = Where._M_node->_M_next;
+			Where._M_node->_M_next = Node->_M_next;
+			Node->_M_next = nullptr;
+			--size_;
+			return iterator(Where._M_node->_M_next);
+		}
+		// 摘除(BeforeFirst, Last)
+		iterator erase_after(iterator BeforeFirst, iterator Last)
+		{
+			while (BeforeFirst._M_node->_M_next != Last._M_node)
+				erase_after(BeforeFirst);
+			return Last;
+		}
+		// 按引用摘除元素，需要查找前驱，O(n)
+		void unlink(reference Val) { erase_after(previous(iterator_to(Val))); }
+		void swap(intrusive_slist& Other)
+		{
+			TinySTL::swap(head_._M_next, Other.head_._M_next);
+			TinySTL::swap(size_, Other.size_);
+		}
+		void clear() { erase_after(before_begin(), end()); }
+
+	public:
+		// 将Right中的全部元素接到Where之后
+		void splice_after(iterator Where, intrusive_slist& Right)
+		{
+			if (this != &Right && !Right.empty())
+			{
+				__slist_splice_after(Where._M_node, &Right.head_, __slist_previous(&Right.head_, nullptr));
+				size_ += Right.size_;
+				Right.size_ = 0;
+			}
+		}
+		// 将Right中BeforeFirst之后的一个元素接到Where之后
+		void splice_after(iterator Where, intrusive_slist& Right, iterator BeforeFirst)
+		{
+			_slist_node_base* Node = BeforeFirst._M_node->_M_next;
+			if (Where._M_node != BeforeFirst._M_node && Where._M_node != Node)
+			{
+				__slist_splice_after(Where._M_node, BeforeFirst._M_node, Node);
+				++size_;
+				--Right.size_;
+			}
+		}
+		void reverse()
+		{
+			if (head_._M_next)
+				head_._M_next = __slist_reverse(head_._M_next);
+		}
+
+	protected:
+		_slist_node_base head_; // 头结点，_M_next指向第一个元素
+		size_type        size_; // 元素个数
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	template<class T, class Tag>
+	inline void intrusive_list<T, Tag>::transfer(list_node_base* Where, list_node_base* First, list_node_base* Last)
+	{
+		if (Where != Last)
+		{	// Remove [First, Last) from its old Where
+			Last->prev_->next_ = Where;
+			First->prev_->next_ = Last;
+			Where->prev_->next_ = First;
+			// Splice [First, Last) into its new position
+			list_node_base* Tmp = Where->prev_;
+			Where->prev_ = Last->prev_;
+			Last->prev_ = First->prev_;
+			First->prev_ = Tmp;
+		}
+	}
+
+	template<class T, class Tag>
+	inline typename intrusive_list<T, Tag>::iterator
+	intrusive_list<T, Tag>::insert(iterator Where, reference Val)
+	{
+		list_node_base* Node = _Traits::to_hook(&Val);
+		link_before(Where.node_, Node);
+		++size_;
+		return iterator(Node);
+	}
+
+	template<class T, class Tag>
+	inline typename intrusive_list<T, Tag>::iterator
+	intrusive_list<T, Tag>::erase(iterator Where)
+	{
+		list_node_base* Next = Where.node_->next_;
+		unlink_node(Where.node_);
+		--size_;
+		return iterator(Next);
+	}
+
+	template<class T, class Tag>
+	inline typename intrusive_list<T, Tag>::iterator
+	intrusive_list<T, Tag>::erase(iterator First, iterator Last)
+	{
+		while (First != Last)
+			First = erase(First);
+		return Last;
+	}
+
+	template<class T, class Tag>
+	inline void intrusive_list<T, Tag>::swap(intrusive_list& Other)
+	{	// 头结点内嵌于容器，交换后需修正首尾元素指回头结点的指针
+		TinySTL::swap(root_.next_, Other.root_.next_);
+		TinySTL::swap(root_.prev_, Other.root_.prev_);
+		TinySTL::swap(size_, Other.size_);
+		if (root_.next_ == &Other.root_)
+			root_.next_ = root_.prev_ = &root_;
+		else
+			root_.next_->prev_ = root_.prev_->next_ = &root_;
+		if (Other.root_.next_ == &root_)
+			Other.root_.next_ = Other.root_.prev_ = &Other.root_;
+		else
+			Other.root_.next_->prev_ = Other.root_.prev_->next_ = &Other.root_;
+	}
+
+	template<class T, class Tag>
+	inline void intrusive_list<T, Tag>::clear()
+	{	// 逐个将hook恢复为未链入状态
+		list_node_base* Cur = root_.next_;
+		while (Cur != &root_)
+		{
+			list_node_base* Next = Cur->next_;
+			Cur->next_ = Cur->prev_ = nullptr;
+			Cur = Next;
+		}
+		root_.next_ = &root_;
+		root_.prev_ = &root_;
+		size_ = 0;
+	}
+
+	template<class T, class Tag>
+	inline void intrusive_list<T, Tag>::splice(iterator Where, intrusive_list& Right)
+	{
+		if (this != &Right && !Right.empty())
+		{
+			transfer(Where.node_, Right.root_.next_, &Right.root_);
+			size_ += Right.size_;
+			Right.size_ = 0;
+		}
+	}
+
+	template<class T, class Tag>
+	inline void intrusive_list<T, Tag>::splice(iterator Where, intrusive_list& Right, iterator First)
+	{
+		list_node_base* Last = First.node_->next_;
+		if (Where.node_ != First.node_ && Where.node_ != Last)
+		{
+			transfer(Where.node_, First.node_, Last);
+			++size_;
+			--Right.size_;
+		}
+	}
+
+	template<class T, class Tag>
+	inline void intrusive_list<T, Tag>::splice(iterator Where, intrusive_list& Right, iterator First, iterator Last)
+	{
+		if (First != Last)
+		{
+			if (this != &Right)
+			{	// 跨容器移动时需要数出元素个数以维护size_
+				size_type Count = 0;
+				for (iterator Iter = First; Iter != Last; ++Iter)
+					++Count;
+				size_ += Count;
+				Right.size_ -= Count;
+			}
+			transfer(Where.node_, First.node_, Last.node_);
+		}
+	}
+
+	template<class T, class Tag>
+	inline void intrusive_list<T, Tag>::reverse()
+	{	// 交换每个结点(含头结点)的前后指针
+		list_node_base* Cur = &root_;
+		do
+		{
+			TinySTL::swap(Cur->next_, Cur->prev_);
+			Cur = Cur->prev_;
+		} while (Cur != &root_);
+	}
+}
+
+#endif // !_INTRUSIVE_LIST_H_
@@ -115,27 +115,65 @@ namespace TinySTL
 		allocator_type get_allocator() const { return allocator_type(); }
 
 	public:
-		list_base(const allocator_type&)
+		list_base(const allocator_type&) : size_(0), free_(nullptr), freeCount_(0), freeMax_(0)
 		{	//唯一的构造函数,规定了list为空时的合法状态:头结点的前后指针均指向其自身
-			node_ = get_node();
+			node_ = Alloc_type::allocate(1);
 			node_->next_ = node_;
 			node_->prev_ = node_;
 		}
 		~list_base()
 		{
-			clear();         // 将每个结点清除
-			put_node(node_); // 将头结点归还
+			clear();                          // 将每个结点清除
+			release_cache();                  // 将缓存的空闲结点归还
+			Alloc_type::deallocate(node_, 1); // 将头结点归还
 		}
 
 		void clear();
 
 	protected:
 		using Alloc_type = simple_alloc<list_node<T>, Alloc>;
-		list_node<T>* get_node() { return Alloc_type::allocate(1); }
-		void put_node(list_node<T>* Ptr) { Alloc_type::deallocate(Ptr, 1); }
+
+		// 若结点缓存中有空闲结点则直接复用，否则向alloc申请
+		list_node<T>* get_node()
+		{
+			if (free_ != nullptr)
+			{
+				list_node<T>* Ptr = (list_node<T>*)free_;
+				free_ = free_->next_;
+				--freeCount_;
+				return Ptr;
+			}
+			return Alloc_type::allocate(1);
+		}
+		// 缓存未满时将结点挂入缓存(只用next_串成单链)，否则归还alloc
+		void put_node(list_node<T>* Ptr)
+		{
+			if (freeCount_ < freeMax_)
+			{
+				Ptr->next_ = free_;
+				free_ = Ptr;
+				++freeCount_;
+				return;
+			}
+			Alloc_type::deallocate(Ptr, 1);
+		}
+		void release_cache()
+		{
+			while (free_ != nullptr)
+			{
+				list_node<T>* Ptr = (list_node<T>*)free_;
+				free_ = free_->next_;
+				Alloc_type::deallocate(Ptr, 1);
+			}
+			freeCount_ = 0;
+		}
 
 	protected:
-		list_node<T>* node_; // 头结点指针，为实际指向结点的类型
+		list_node<T>*   node_;      // 头结点指针，为实际指向结点的类型
+		size_t          size_;      // 元素个数，由各修改操作维护，使size()为O(1)
+		list_node_base* free_;      // 本list私有的空闲结点缓存，erase后的结点可被之后的insert复用
+		size_t          freeCount_; // 缓存中的结点数
+		size_t          freeMax_;   // 缓存上限，默认为0即不缓存
 	};
 
 	template<class T, class Alloc>
@@ -153,6 +191,7 @@ namespace TinySTL
 		// 使链表恢复合法状态
 		node_->next_ = node_;
 		node_->prev_ = node_;
+		size_ = 0;
 	}
 	
 	template<class T, class Alloc = TinySTL::alloc>
@@ -181,8 +220,12 @@ namespace TinySTL
 
 	protected:
 		using base_::node_;
+		using base_::size_;
+		using base_::freeCount_;
+		using base_::freeMax_;
 		using base_::get_node;
 		using base_::put_node;
+		using base_::release_cache;
 
 	public:
 		explicit list(const allocator_type& Alloc = allocator_type()) : base_(Alloc) {}
@@ -253,6 +296,14 @@ namespace TinySTL
 		// 这个函数主要通过指针的修改来完成
 		void transfer(iterator Where, iterator First, iterator Last);
 
+		// sort的实现，直接在list_node_base指针上进行归并
+		template<class Pr2>
+		static void merge_chain(list_node_base*& First1, list_node_base*& First2, Pr2& Pred);
+		template<class Pr2>
+		void sort_chain(Pr2& Pred);
+		// 把以nullptr结尾的单链接回node_，补齐prev_并恢复环状结构
+		void relink_chain(list_node_base* First);
+
 	public:
 		// Iterator:
 		iterator begin();
@@ -273,6 +324,12 @@ namespace TinySTL
 		size_type size() const;
 		size_type max_size() const;
 
+		// 结点缓存:
+		// 最多缓存MaxNodes个被erase的结点供之后的insert复用，适用于LRU等先删后插的场景
+		// MaxNodes为0时关闭缓存并归还所有已缓存结点
+		void set_node_cache(size_type MaxNodes);
+		size_type node_cache_size() const;
+
 		// Element acces:
 		reference front();
 		const_reference front() const;
@@ -438,12 +495,11 @@ namespace TinySTL
 		return node_->next_ == node_;
 	}
 
-	//template<class T, class Alloc>
-	//inline typename list<T, Alloc>::size_type list<T, Alloc>::size() const
-	//{	// list的size函数需要遍历真个list
-	//	size_type Result = static_cast<size_type>(TinySTL::distance(begin(), end());
-	//	return Result;
-	//}
+	template<class T, class Alloc>
+	inline typename list<T, Alloc>::size_type list<T, Alloc>::size() const
+	{	// 元素个数由insert、erase、splice等操作维护，无需遍历整个list
+		return size_;
+	}
 
 	template<class T, class Alloc>
 	inline typename list<T, Alloc>::size_type list<T, Alloc>::max_size() const
@@ -451,6 +507,20 @@ namespace TinySTL
 		return size_type(-1) / sizeof(T);
 	}
 
+	template<class T, class Alloc>
+	inline void list<T, Alloc>::set_node_cache(size_type MaxNodes)
+	{
+		freeMax_ = MaxNodes;
+		if (MaxNodes == 0)
+			release_cache();
+	}
+
+	template<class T, class Alloc>
+	inline typename list<T, Alloc>::size_type list<T, Alloc>::node_cache_size() const
+	{
+		return freeCount_;
+	}
+
 	template<class T, class Alloc>
 	inline typename list<T, Alloc>::reference TinySTL::list<T, Alloc>::front()
 	{
@@ -593,6 +663,7 @@ namespace TinySTL
 		Tmp->prev_ = Where.node_->prev_;
 		Where.node_->prev_->next_ = Tmp;
 		Where.node_->prev_ = Tmp;
+		++size_;
 		return Tmp;
 	}
 
@@ -620,6 +691,7 @@ namespace TinySTL
 		Next_node->prev_ = Prev_node;
 		TinySTL::destroy(&Freenode->data_);
 		put_node(Freenode);
+		--size_;
 		return iterator((_Node*)Next_node);
 	}
 
@@ -637,6 +709,7 @@ namespace TinySTL
 	inline void list<T, Alloc>::swap(list<T, Alloc>& Other)
 	{
 		TinySTL::swap(node_, Other.node_);
+		TinySTL::swap(size_, Other.size_);
 	}
 
 	template<class T, class Alloc>
@@ -672,6 +745,8 @@ namespace TinySTL
 		if (!Right.empty())
 		{
 			this->transfer(Where, Right.begin(), Right.end());
+			size_ += Right.size_;
+			Right.size_ = 0;
 		}
 	}
 
@@ -682,6 +757,8 @@ namespace TinySTL
 		++Last;
 		if (Where == First || Where == Last) return;
 		this->transfer(Where, First, Last);
+		++size_;
+		--Right.size_;
 	}
 
 	template<class T, class Alloc>
@@ -689,6 +766,12 @@ namespace TinySTL
 	{
 		if (First != Last)
 		{
+			if (this != &Right)
+			{	// 跨list移动区间时需要计算区间长度，为O(n)
+				size_type Count = static_cast<size_type>(TinySTL::distance(First, Last));
+				size_ += Count;
+				Right.size_ -= Count;
+			}
 			this->transfer(Where, First, Last);
 		}
 	}
@@ -749,9 +832,9 @@ namespace TinySTL
 		iterator Last = end();
 		if (First == Last) return;
 		iterator Next = First;
-		while (++Next != *Last)
+		while (++Next != Last)
 		{
-			if (Pred(*First, *Last))
+			if (Pred(*First, *Next))
 				erase(Next);
 			else
 				First = Next;
@@ -779,6 +862,8 @@ namespace TinySTL
 		}
 		if (First2 != Last2)
 			transfer(Last1, First2, Last2);
+		size_ += Right.size_;
+		Right.size_ = 0;
 	}
 
 	template<class T, class Alloc>
@@ -802,40 +887,135 @@ namespace TinySTL
 		}
 		if (First2 != Last2)
 			transfer(Last1, First2, Last2);
+		size_ += Right.size_;
+		Right.size_ = 0;
+	}
+
+	// 将两条已排序、以nullptr结尾的单链(只使用next_)合并，结果存入First1，First2置为nullptr
+	// 键值相等时优先取First1中的结点，保证排序的稳定性
+	// 若Pred抛出异常，First1中仍保存两条链的全部结点(次序不定)，First2同样置为nullptr
+	template<class T, class Alloc>
+	template<class Pr2>
+	inline void list<T, Alloc>::merge_chain(list_node_base*& First1, list_node_base*& First2, Pr2& Pred)
+	{
+		list_node_base Head;
+		list_node_base* Tail = &Head;
+		try
+		{
+			while (First1 != nullptr && First2 != nullptr)
+			{
+				if (Pred(((_Node*)First2)->data_, ((_Node*)First1)->data_))
+				{
+					Tail->next_ = First2;
+					First2 = First2->next_;
+				}
+				else
+				{
+					Tail->next_ = First1;
+					First1 = First1->next_;
+				}
+				Tail = Tail->next_;
+			}
+		}
+		catch (...)
+		{
+			// 已合并的前缀之后接上First1的剩余部分，再接上First2的剩余部分
+			Tail->next_ = First1;
+			while (Tail->next_ != nullptr)
+				Tail = Tail->next_;
+			Tail->next_ = First2;
+			First1 = Head.next_;
+			First2 = nullptr;
+			throw;
+		}
+		Tail->next_ = First1 != nullptr ? First1 : First2;
+		First1 = Head.next_;
+		First2 = nullptr;
 	}
 
 	// 由于STL sort算法要求必须为随机迭代器,因此list实现了自己的专用sort算法
-	// 该算法采用的是归并排序的思想
+	// 该算法采用的是自底向上归并排序的思想：
+	// 先把环状双向链表拆成以nullptr结尾的单链，Bins[i]中存放长度为2^i的有序子链，
+	// 每取下一个结点就像二进制加法一样向高位进位合并。整个过程只改写next_，
+	// 不创建临时list，也不经过transfer，最后遍历一次补齐prev_并恢复环状结构
+	// 比较函数抛出异常时，把尚未合并的各条子链重新接起来再抛出，list保持有效，但元素次序不定
 	template<class T, class Alloc>
-	inline void list<T, Alloc>::sort()
-	{	// Do nothing if the list has length 0 or 1
-		if (node_->next_ == node_ || node_->next_->next_ == node_)
-			return;
-		// 一些新的list，作为中介数据存放区
-		list<T, Alloc> Carry;
-		list<T, Alloc> Counter[64];
-		/*
-		*其中对于counter[i]里面最多的存储数据为2^(i+1)个节点
-		*若超出则向高位进位即counter[i+1]
-		*/
+	template<class Pr2>
+	inline void list<T, Alloc>::sort_chain(Pr2& Pred)
+	{
+		list_node_base* Bins[64] = {};
 		int Fill = 0;
-		while (!empty())
+		list_node_base* Result = nullptr;
+		list_node_base* Cur = node_->next_;
+		node_->prev_->next_ = nullptr; // 断开环，使链表以nullptr结尾
+		try
 		{
-			Carry.splice(Carry.begin(), *this, begin()); // Carry得到list第一个元素,list的第一个元素消失
-			int Idx = 0;
-			// 此循环将Counter[Fill]之前所有非空链表合并为一个链表
-			while (Idx < Fill && !Counter[Idx].empty())
+			while (Cur != nullptr)
 			{
-				Counter[Idx].merge(Carry);  // 此时Carry为空
-				Carry.swap(Counter[Idx++]); // 此时Counter[Idx]为空，Idx = Idx + 1
+				list_node_base* Carry = Cur;
+				Cur = Cur->next_;
+				Carry->next_ = nullptr;
+				int Idx = 0;
+				// Bins[Idx]中的元素位于Carry之前，因此作为merge_chain的第一个参数
+				for (; Idx < Fill && Bins[Idx] != nullptr; ++Idx)
+				{
+					merge_chain(Bins[Idx], Carry, Pred);
+					Carry = Bins[Idx];
+					Bins[Idx] = nullptr;
+				}
+				Bins[Idx] = Carry;
+				if (Idx == Fill)
+					++Fill;
+			}
+			// 高位的子链包含更早的元素，由低位向高位依次合并
+			for (int Idx = 0; Idx < Fill; ++Idx)
+			{
+				if (Bins[Idx] == nullptr)
+					continue;
+				merge_chain(Bins[Idx], Result, Pred);
+				Result = Bins[Idx];
+				Bins[Idx] = nullptr;
 			}
-			Carry.swap(Counter[Idx]); // 至此处Idx之前的所有链表均被合并至Counter[Idx]
-			if (Idx == Fill)
-				++Fill;
 		}
-		for (int Idx = 1; Idx < Fill; ++Idx)
-			Counter[Idx].merge(Counter[Idx - 1]);
-		swap(Counter[Fill - 1]);
+		catch (...)
+		{
+			// 此时每个结点恰好位于Result、某个Bins[i]或Cur之一中
+			list_node_base Head;
+			list_node_base* Tail = &Head;
+			Tail->next_ = Result;
+			for (int Idx = 0; Idx <= Fill; ++Idx)
+			{
+				while (Tail->next_ != nullptr)
+					Tail = Tail->next_;
+				Tail->next_ = Idx < Fill ? Bins[Idx] : Cur;
+			}
+			relink_chain(Head.next_);
+			throw;
+		}
+		relink_chain(Result);
+	}
+
+	template<class T, class Alloc>
+	inline void list<T, Alloc>::relink_chain(list_node_base* First)
+	{
+		list_node_base* Prev = node_;
+		for (list_node_base* Cur = First; Cur != nullptr; Cur = Cur->next_)
+		{
+			Prev->next_ = Cur;
+			Cur->prev_ = Prev;
+			Prev = Cur;
+		}
+		Prev->next_ = node_;
+		node_->prev_ = Prev;
+	}
+
+	template<class T, class Alloc>
+	inline void list<T, Alloc>::sort()
+	{	// Do nothing if the list has length 0 or 1
+		if (node_->next_ == node_ || node_->next_->next_ == node_)
+			return;
+		TinySTL::less<T> Pred;
+		sort_chain(Pred);
 	}
 
 	template<class T, class Alloc>
@@ -844,27 +1024,7 @@ namespace TinySTL
 	{   // Do nothing if the list has length 0 or 1
 		if (node_->next_ == node_ || node_->next_->next_ == node_)
 			return;
-		// 一些新的list，作为中介数据存放区
-		list<T, Alloc> Carry;
-		list<T, Alloc> Counter[64];
-		int Fill = 0;
-		while (!empty())
-		{
-			Carry.splice(Carry.begin(), *this, begin()); // Carry得到list第一个元素,list的第一个元素消失
-			int Idx = 0;
-			// 此循环将Counter[Fill]之前所有非空链表合并为一个链表
-			while (Idx < Fill && !Counter[Idx].empty())
-			{
-				Counter[Idx].merge(Carry, Pred);  // 此时Carry为空
-				Carry.swap(Counter[Idx++]); // 此时Counter[Idx]为空，Idx = Idx + 1
-			}
-			Carry.swap(Counter[Idx]); // 至此处Idx之前的所有链表均被合并至Counter[Idx]
-			if (Idx == Fill)
-				++Fill;
-		}
-		for (int Idx = 1; Idx < Fill; ++Idx)
-			Counter[Idx].merge(Counter[Idx - 1], Pred);
-		swap(Counter[Fill - 1]);
+		sort_chain(Pred);
 	}
 
 	template<class T, class Alloc>
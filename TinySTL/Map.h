@@ -0,0 +1,531 @@
+﻿#ifndef _MAP_H_
+#define _MAP_H_
+
+#include <utility>
+#include <stdexcept>
+
+#include "Rbtree.h"
+#include "Functional.h"
+
+namespace TinySTL
+{
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	class multimap;
+
+	/*
+	* ***********************************
+	* map : 以_Rb_tree为底层的有序关联容器
+	* ***********************************
+	* 元素为pair<const Key, T>，按键值排序且键值不允许重复
+	* 键值为const，因此iterator可以修改实值而不会破坏排列规则
+	* _Augment为_Rb_tree_rank_augment时，额外提供O(log n)的select/rank/index_of
+	* union_/intersection/difference基于_Rb_tree的join/split，工作量为O(m log(n/m + 1))
+	*
+	* operator[]/try_emplace/insert_or_assign先以lower_bound定位，未命中时以该位置调用_M_insert_before，
+	* 整个操作只从根节点向下查找一次
+	*/
+	template<class _Key, class _Tp, class _Compare = TinySTL::less<_Key>, class _Alloc = TinySTL::alloc, class _Augment = _Rb_tree_no_augment>
+	class map
+	{
+	public:
+		using key_type    = _Key;
+		using mapped_type = _Tp;
+		using value_type  = TinySTL::pair<const _Key, _Tp>;
+		using key_compare = _Compare;
+
+		// 以键值比较两个元素
+		class value_compare : public binary_function<value_type, value_type, bool>
+		{
+			friend class map;
+		protected:
+			_Compare comp;
+			value_compare(_Compare __c) : comp(__c) {}
+		public:
+			bool operator()(const value_type& __x, const value_type& __y) const
+			{
+				return comp(__x.first, __y.first);
+			}
+		};
+
+	private:
+		using _Rep_type = _Rb_tree<key_type, value_type, TinySTL::select1st<value_type>, key_compare, _Alloc, _Augment>;
+
+		friend class multimap<_Key, _Tp, _Compare, _Alloc, _Augment>; // merge需要访问对方的_M_t
+
+		_Rep_type _M_t; // 底层的RB-tree
+
+	public:
+		using pointer                = typename _Rep_type::pointer;
+		using const_pointer          = typename _Rep_type::const_pointer;
+		using reference              = typename _Rep_type::reference;
+		using const_reference        = typename _Rep_type::const_reference;
+		using iterator               = typename _Rep_type::iterator;
+		using const_iterator         = typename _Rep_type::const_iterator;
+		using reverse_iterator       = typename _Rep_type::reverse_iterator;
+		using const_reverse_iterator = typename _Rep_type::const_reverse_iterator;
+		using size_type              = typename _Rep_type::size_type;
+		using difference_type        = typename _Rep_type::difference_type;
+		using allocator_type         = typename _Rep_type::allocator_type;
+		using node_type              = typename _Rep_type::node_type;
+		using insert_return_type     = typename _Rep_type::insert_return_type;
+
+	private:
+		static iterator _S_unconst(const_iterator __it)
+		{
+			return iterator((typename _Rep_type::_Link_type)__it._M_node);
+		}
+
+		// __position是否恰好为键值__k应插入的位置：前驱键值小于__k且__position的键值大于__k
+		bool _M_is_insert_position(const_iterator __position, const key_type& __k) const
+		{
+			if (__position != end() && !key_comp()(__k, (*__position).first))
+				return false;
+			if (__position == begin())
+				return true;
+			const_iterator __before = __position;
+			--__before;
+			return key_comp()((*__before).first, __k);
+		}
+
+	public:
+		map() : _M_t(_Compare(), allocator_type()) {}
+		explicit map(const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a) {}
+
+		template<class InIt>
+		map(InIt __first, InIt __last) : _M_t(_Compare(), allocator_type())
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		template<class InIt>
+		map(InIt __first, InIt __last, const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a)
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		map(const map& __x) : _M_t(__x._M_t) {}
+
+		map& operator=(const map& __x)
+		{
+			_M_t = __x._M_t;
+			return *this;
+		}
+
+	public:
+		key_compare key_comp() const { return _M_t.key_comp(); }
+		value_compare value_comp() const { return value_compare(_M_t.key_comp()); }
+		allocator_type get_allocator() const { return _M_t.get_allocator(); }
+
+		// Iterator:
+		iterator begin() { return _M_t.begin(); }
+		const_iterator begin() const { return _M_t.begin(); }
+		iterator end() { return _M_t.end(); }
+		const_iterator end() const { return _M_t.end(); }
+		reverse_iterator rbegin() { return _M_t.rbegin(); }
+		const_reverse_iterator rbegin() const { return _M_t.rbegin(); }
+		reverse_iterator rend() { return _M_t.rend(); }
+		const_reverse_iterator rend() const { return _M_t.rend(); }
+		const_iterator cbegin() const { return _M_t.begin(); }
+		const_iterator cend() const { return _M_t.end(); }
+		const_reverse_iterator crbegin() const { return _M_t.rbegin(); }
+		const_reverse_iterator crend() const { return _M_t.rend(); }
+
+		// Capacity:
+		bool empty() const { return _M_t.empty(); }
+		size_type size() const { return _M_t.size(); }
+		size_type max_size() const { return _M_t.max_size(); }
+
+		// Element access:
+		mapped_type& operator[](const key_type& __k)
+		{
+			iterator __i = lower_bound(__k);
+			// __i->first >= __k，若二者不等则__k不存在，且恰好应插入在__i之前
+			if (__i == end() || key_comp()(__k, (*__i).first))
+				__i = _M_t._M_insert_before(__i, value_type(__k, mapped_type()));
+			return (*__i).second;
+		}
+		mapped_type& at(const key_type& __k)
+		{
+			iterator __i = find(__k);
+			if (__i == end())
+				throw std::out_of_range("map::at");
+			return (*__i).second;
+		}
+		const mapped_type& at(const key_type& __k) const
+		{
+			const_iterator __i = find(__k);
+			if (__i == end())
+				throw std::out_of_range("map::at");
+			return (*__i).second;
+		}
+
+		// Modifiers:
+		TinySTL::pair<iterator, bool> insert(const value_type& __x) { return _M_t.insert_unique(__x); }
+		iterator insert(const_iterator __position, const value_type& __x)
+		{
+			return _M_t.insert_unique(_S_unconst(__position), __x);
+		}
+		template<class InIt>
+		void insert(InIt __first, InIt __last)
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> emplace(_Args&&... __args)
+		{
+			return insert(value_type(std::forward<_Args>(__args)...));
+		}
+		template<class... _Args>
+		iterator emplace_hint(const_iterator __position, _Args&&... __args)
+		{
+			return insert(__position, value_type(std::forward<_Args>(__args)...));
+		}
+
+		// 键值已存在时不构造实值，也不做任何修改
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> try_emplace(const key_type& __k, _Args&&... __args)
+		{
+			iterator __i = lower_bound(__k);
+			if (__i != end() && !key_comp()(__k, (*__i).first))
+				return TinySTL::pair<iterator, bool>(__i, false);
+			__i = _M_t._M_insert_before(__i, value_type(__k, mapped_type(std::forward<_Args>(__args)...)));
+			return TinySTL::pair<iterator, bool>(__i, true);
+		}
+		template<class... _Args>
+		iterator try_emplace(const_iterator __hint, const key_type& __k, _Args&&... __args)
+		{
+			if (_M_is_insert_position(__hint, __k))
+				return _M_t._M_insert_before(_S_unconst(__hint), value_type(__k, mapped_type(std::forward<_Args>(__args)...)));
+			return try_emplace(__k, std::forward<_Args>(__args)...).first;
+		}
+
+		// 键值已存在时以__obj赋值实值，否则插入
+		template<class _Obj>
+		TinySTL::pair<iterator, bool> insert_or_assign(const key_type& __k, _Obj&& __obj)
+		{
+			iterator __i = lower_bound(__k);
+			if (__i != end() && !key_comp()(__k, (*__i).first))
+			{
+				(*__i).second = std::forward<_Obj>(__obj);
+				return TinySTL::pair<iterator, bool>(__i, false);
+			}
+			__i = _M_t._M_insert_before(__i, value_type(__k, mapped_type(std::forward<_Obj>(__obj))));
+			return TinySTL::pair<iterator, bool>(__i, true);
+		}
+		template<class _Obj>
+		iterator insert_or_assign(const_iterator __hint, const key_type& __k, _Obj&& __obj)
+		{
+			if (_M_is_insert_position(__hint, __k))
+				return _M_t._M_insert_before(_S_unconst(__hint), value_type(__k, mapped_type(std::forward<_Obj>(__obj))));
+			return insert_or_assign(__k, std::forward<_Obj>(__obj)).first;
+		}
+
+		iterator erase(iterator __position) { return _M_t.erase(__position); }
+		iterator erase(const_iterator __position) { return _M_t.erase(_S_unconst(__position)); }
+		size_type erase(const key_type& __x) { return _M_t.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last)
+		{
+			_M_t.erase(_S_unconst(__first), _S_unconst(__last));
+			return _S_unconst(__last);
+		}
+		void clear() { _M_t.clear(); }
+		void swap(map& __x) { _M_t.swap(__x._M_t); }
+
+		// Node handles: 在容器间移动元素或修改键值而不重新分配节点
+		node_type extract(const_iterator __position) { return _M_t.extract(_S_unconst(__position)); }
+		node_type extract(const key_type& __x) { return _M_t.extract(__x); }
+		insert_return_type insert(node_type&& __nh) { return _M_t._M_reinsert_node_unique(std::move(__nh)); }
+		iterator insert(const_iterator __hint, node_type&& __nh)
+		{
+			return _M_t._M_reinsert_node_hint_unique(_S_unconst(__hint), std::move(__nh));
+		}
+		// 键值已存在的元素留在__src中
+		void merge(map& __src) { _M_t._M_merge_unique(__src._M_t); }
+		void merge(map&& __src) { _M_t._M_merge_unique(__src._M_t); }
+		void merge(multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __src) { _M_t._M_merge_unique(__src._M_t); }
+		void merge(multimap<_Key, _Tp, _Compare, _Alloc, _Augment>&& __src) { _M_t._M_merge_unique(__src._M_t); }
+
+		// Set operations: 结果存于*this，__x被置空，键值相同时保留*this中的元素；规模较大时在线程池上并行
+		void union_(map& __x) { _M_t.union_(__x._M_t); }
+		void union_(map& __x, thread_pool& __pool) { _M_t.union_(__x._M_t, __pool); }
+		void intersection(map& __x) { _M_t.intersection(__x._M_t); }
+		void intersection(map& __x, thread_pool& __pool) { _M_t.intersection(__x._M_t, __pool); }
+		void difference(map& __x) { _M_t.difference(__x._M_t); }
+		void difference(map& __x, thread_pool& __pool) { _M_t.difference(__x._M_t, __pool); }
+
+		// Lookup:
+		iterator find(const key_type& __x) { return _M_t.find(__x); }
+		const_iterator find(const key_type& __x) const { return _M_t.find(__x); }
+		size_type count(const key_type& __x) const { return _M_t.find(__x) == _M_t.end() ? 0 : 1; }
+		bool contains(const key_type& __x) const { return _M_t.find(__x) != _M_t.end(); }
+		iterator lower_bound(const key_type& __x) { return _M_t.lower_bound(__x); }
+		const_iterator lower_bound(const key_type& __x) const { return _M_t.lower_bound(__x); }
+		iterator upper_bound(const key_type& __x) { return _M_t.upper_bound(__x); }
+		const_iterator upper_bound(const key_type& __x) const { return _M_t.upper_bound(__x); }
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) { return _M_t.equal_range(__x); }
+		TinySTL::pair<const_iterator, const_iterator> equal_range(const key_type& __x) const { return _M_t.equal_range(__x); }
+
+		// Order statistics(需要_Rb_tree_rank_augment):
+		iterator select(size_type __k) { return _M_t.select(__k); }
+		const_iterator select(size_type __k) const { return _M_t.select(__k); }
+		size_type rank(const key_type& __x) const { return _M_t.rank(__x); }
+		size_type index_of(const_iterator __position) const { return _M_t.index_of(__position); }
+
+		// 验证底层RB-tree是否合法
+		bool __rb_verify() const { return _M_t.__rb_verify(); }
+	};
+
+	/*
+	* ***********************************
+	* multimap : 允许键值重复的map，所有插入均调用_Rb_tree::insert_equal
+	* ***********************************
+	* 键值可能对应多个实值，因此不提供operator[]/at/try_emplace/insert_or_assign
+	*/
+	template<class _Key, class _Tp, class _Compare = TinySTL::less<_Key>, class _Alloc = TinySTL::alloc, class _Augment = _Rb_tree_no_augment>
+	class multimap
+	{
+	public:
+		using key_type    = _Key;
+		using mapped_type = _Tp;
+		using value_type  = TinySTL::pair<const _Key, _Tp>;
+		using key_compare = _Compare;
+
+		class value_compare : public binary_function<value_type, value_type, bool>
+		{
+			friend class multimap;
+		protected:
+			_Compare comp;
+			value_compare(_Compare __c) : comp(__c) {}
+		public:
+			bool operator()(const value_type& __x, const value_type& __y) const
+			{
+				return comp(__x.first, __y.first);
+			}
+		};
+
+	private:
+		using _Rep_type = _Rb_tree<key_type, value_type, TinySTL::select1st<value_type>, key_compare, _Alloc, _Augment>;
+
+		friend class map<_Key, _Tp, _Compare, _Alloc, _Augment>;
+
+		_Rep_type _M_t; // 底层的RB-tree
+
+	public:
+		using pointer                = typename _Rep_type::pointer;
+		using const_pointer          = typename _Rep_type::const_pointer;
+		using reference              = typename _Rep_type::reference;
+		using const_reference        = typename _Rep_type::const_reference;
+		using iterator               = typename _Rep_type::iterator;
+		using const_iterator         = typename _Rep_type::const_iterator;
+		using reverse_iterator       = typename _Rep_type::reverse_iterator;
+		using const_reverse_iterator = typename _Rep_type::const_reverse_iterator;
+		using size_type              = typename _Rep_type::size_type;
+		using difference_type        = typename _Rep_type::difference_type;
+		using allocator_type         = typename _Rep_type::allocator_type;
+		using node_type              = typename _Rep_type::node_type;
+
+	private:
+		static iterator _S_unconst(const_iterator __it)
+		{
+			return iterator((typename _Rep_type::_Link_type)__it._M_node);
+		}
+
+	public:
+		multimap() : _M_t(_Compare(), allocator_type()) {}
+		explicit multimap(const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a) {}
+
+		template<class InIt>
+		multimap(InIt __first, InIt __last) : _M_t(_Compare(), allocator_type())
+		{
+			_M_t.insert_equal(__first, __last);
+		}
+		template<class InIt>
+		multimap(InIt __first, InIt __last, const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a)
+		{
+			_M_t.insert_equal(__first, __last);
+		}
+		multimap(const multimap& __x) : _M_t(__x._M_t) {}
+
+		multimap& operator=(const multimap& __x)
+		{
+			_M_t = __x._M_t;
+			return *this;
+		}
+
+	public:
+		key_compare key_comp() const { return _M_t.key_comp(); }
+		value_compare value_comp() const { return value_compare(_M_t.key_comp()); }
+		allocator_type get_allocator() const { return _M_t.get_allocator(); }
+
+		// Iterator:
+		iterator begin() { return _M_t.begin(); }
+		const_iterator begin() const { return _M_t.begin(); }
+		iterator end() { return _M_t.end(); }
+		const_iterator end() const { return _M_t.end(); }
+		reverse_iterator rbegin() { return _M_t.rbegin(); }
+		const_reverse_iterator rbegin() const { return _M_t.rbegin(); }
+		reverse_iterator rend() { return _M_t.rend(); }
+		const_reverse_iterator rend() const { return _M_t.rend(); }
+		const_iterator cbegin() const { return _M_t.begin(); }
+		const_iterator cend() const { return _M_t.end(); }
+		const_reverse_iterator crbegin() const { return _M_t.rbegin(); }
+		const_reverse_iterator crend() const { return _M_t.rend(); }
+
+		// Capacity:
+		bool empty() const { return _M_t.empty(); }
+		size_type size() const { return _M_t.size(); }
+		size_type max_size() const { return _M_t.max_size(); }
+
+		// Modifiers:
+		iterator insert(const value_type& __x) { return _M_t.insert_equal(__x); }
+		iterator insert(const_iterator __position, const value_type& __x)
+		{
+			return _M_t.insert_equal(_S_unconst(__position), __x);
+		}
+		template<class InIt>
+		void insert(InIt __first, InIt __last)
+		{
+			_M_t.insert_equal(__first, __last);
+		}
+		template<class... _Args>
+		iterator emplace(_Args&&... __args)
+		{
+			return insert(value_type(std::forward<_Args>(__args)...));
+		}
+		template<class... _Args>
+		iterator emplace_hint(const_iterator __position, _Args&&... __args)
+		{
+			return insert(__position, value_type(std::forward<_Args>(__args)...));
+		}
+
+		iterator erase(iterator __position) { return _M_t.erase(__position); }
+		iterator erase(const_iterator __position) { return _M_t.erase(_S_unconst(__position)); }
+		size_type erase(const key_type& __x) { return _M_t.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last)
+		{
+			_M_t.erase(_S_unconst(__first), _S_unconst(__last));
+			return _S_unconst(__last);
+		}
+		void clear() { _M_t.clear(); }
+		void swap(multimap& __x) { _M_t.swap(__x._M_t); }
+
+		// Node handles:
+		node_type extract(const_iterator __position) { return _M_t.extract(_S_unconst(__position)); }
+		node_type extract(const key_type& __x) { return _M_t.extract(__x); }
+		iterator insert(node_type&& __nh) { return _M_t._M_reinsert_node_equal(std::move(__nh)); }
+		iterator insert(const_iterator __hint, node_type&& __nh)
+		{
+			return _M_t._M_reinsert_node_hint_equal(_S_unconst(__hint), std::move(__nh));
+		}
+		void merge(multimap& __src) { _M_t._M_merge_equal(__src._M_t); }
+		void merge(multimap&& __src) { _M_t._M_merge_equal(__src._M_t); }
+		void merge(map<_Key, _Tp, _Compare, _Alloc, _Augment>& __src) { _M_t._M_merge_equal(__src._M_t); }
+		void merge(map<_Key, _Tp, _Compare, _Alloc, _Augment>&& __src) { _M_t._M_merge_equal(__src._M_t); }
+
+		// Lookup:
+		iterator find(const key_type& __x) { return _M_t.find(__x); }
+		const_iterator find(const key_type& __x) const { return _M_t.find(__x); }
+		size_type count(const key_type& __x) const { return _M_t.count(__x); }
+		bool contains(const key_type& __x) const { return _M_t.find(__x) != _M_t.end(); }
+		iterator lower_bound(const key_type& __x) { return _M_t.lower_bound(__x); }
+		const_iterator lower_bound(const key_type& __x) const { return _M_t.lower_bound(__x); }
+		iterator upper_bound(const key_type& __x) { return _M_t.upper_bound(__x); }
+		const_iterator upper_bound(const key_type& __x) const { return _M_t.upper_bound(__x); }
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) { return _M_t.equal_range(__x); }
+		TinySTL::pair<const_iterator, const_iterator> equal_range(const key_type& __x) const { return _M_t.equal_range(__x); }
+
+		// Order statistics(需要_Rb_tree_rank_augment):
+		iterator select(size_type __k) { return _M_t.select(__k); }
+		const_iterator select(size_type __k) const { return _M_t.select(__k); }
+		size_type rank(const key_type& __x) const { return _M_t.rank(__x); }
+		size_type index_of(const_iterator __position) const { return _M_t.index_of(__position); }
+
+		bool __rb_verify() const { return _M_t.__rb_verify(); }
+	};
+
+	//////////////////////////////////////////// 比较操作 //////////////////////////////////////////////////////////
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator==(const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return __x.size() == __y.size() && TinySTL::equal(__x.begin(), __x.end(), __y.begin());
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator!=(const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__x == __y);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator<(const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return TinySTL::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end());
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator>(const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return __y < __x;
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator<=(const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__y < __x);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator>=(const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const map<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__x < __y);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline void swap(map<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, map<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		__x.swap(__y);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator==(const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return __x.size() == __y.size() && TinySTL::equal(__x.begin(), __x.end(), __y.begin());
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator!=(const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__x == __y);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator<(const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return TinySTL::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end());
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator>(const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return __y < __x;
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator<=(const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__y < __x);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline bool operator>=(const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, const multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__x < __y);
+	}
+
+	template<class _Key, class _Tp, class _Compare, class _Alloc, class _Augment>
+	inline void swap(multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __x, multimap<_Key, _Tp, _Compare, _Alloc, _Augment>& __y)
+	{
+		__x.swap(__y);
+	}
+}
+
+#endif // !_MAP_H_
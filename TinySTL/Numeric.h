@@ -0,0 +1,473 @@
+﻿#ifndef _NUMERIC_H_
+#define _NUMERIC_H_
+
+#include <cstddef>
+#include <utility>
+
+#include "Iterator.h"
+#include "TypeTraits.h"
+#include "Functional.h"
+#include "Algorithm.h"
+#include "AlgorithmSimd.h"
+#include "Execution.h"
+
+namespace TinySTL
+{
+	/*
+	* 指针区间上可以用SIMD求和的情形：元素类型与初值类型相同，运算为plus
+	* accumulate要求依次相加，只对整数使用；reduce允许重排，浮点数也可以使用
+	*/
+	template <class InIt, class T, class Op>
+	inline constexpr bool _Simd_reduce_v = TinySTL::is_pointer_v<InIt>
+		&& TinySTL::is_same_v<TinySTL::remove_cv_t<typename TinySTL::iterator_traits<InIt>::value_type>, T>
+		&& TinySTL::_Simd_sum_element_v<T> && TinySTL::is_same_v<Op, TinySTL::plus<T>>;
+
+	template <class InIt1, class InIt2, class T, class Op1, class Op2>
+	inline constexpr bool _Simd_dot_v = TinySTL::is_pointer_v<InIt1> && TinySTL::is_pointer_v<InIt2>
+		&& TinySTL::is_same_v<TinySTL::remove_cv_t<typename TinySTL::iterator_traits<InIt1>::value_type>, T>
+		&& TinySTL::is_same_v<TinySTL::remove_cv_t<typename TinySTL::iterator_traits<InIt2>::value_type>, T>
+		&& TinySTL::_Simd_dot_element_v<T> && TinySTL::is_same_v<Op1, TinySTL::plus<T>> && TinySTL::is_same_v<Op2, TinySTL::multiplies<T>>;
+
+	/*
+	* ***********************************
+	* accumulate
+	* return sum of _Val and all in [_First, _Last), using _Func
+	* Algorithm Complexity: O(N)
+	* 按次序依次累加；整数以plus累加时改用SIMD(补码回绕相加与次序无关)
+	* ***********************************
+	*/
+	template <class InIt, class T, class Op>
+	inline T accumulate(InIt First, InIt Last, T Val, Op Func)
+	{
+		if constexpr (TinySTL::_Simd_reduce_v<InIt, T, Op> && TinySTL::is_integral_v<T>)
+			return TinySTL::_Simd_add_wrap(Val, TinySTL::_Simd_sum(static_cast<const T*>(First), static_cast<size_t>(Last - First)));
+		else
+		{
+			for (; First != Last; ++First)
+				Val = Func(std::move(Val), *First);
+			return Val;
+		}
+	}
+
+	template <class InIt, class T>
+	inline T accumulate(InIt First, InIt Last, T Val)
+	{
+		return TinySTL::accumulate(First, Last, Val, TinySTL::plus<T>());
+	}
+
+	/*
+	* ***********************************
+	* inner_product
+	* return inner product of sequences, using _Func1 and _Func2
+	* Algorithm Complexity: O(N)
+	* 与accumulate一样按次序累加；不要求次序时用transform_reduce
+	* ***********************************
+	*/
+	template <class InIt1, class InIt2, class T, class Op1, class Op2>
+	inline T inner_product(InIt1 First1, InIt1 Last1, InIt2 First2, T Val, Op1 Func1, Op2 Func2)
+	{
+		for (; First1 != Last1; ++First1, (void)++First2)
+			Val = Func1(std::move(Val), Func2(*First1, *First2));
+		return Val;
+	}
+
+	template <class InIt1, class InIt2, class T>
+	inline T inner_product(InIt1 First1, InIt1 Last1, InIt2 First2, T Val)
+	{
+		return TinySTL::inner_product(First1, Last1, First2, Val, TinySTL::plus<T>(), TinySTL::multiplies<T>());
+	}
+
+	/*
+	* ***********************************
+	* reduce transform_reduce
+	* return generalized sum of _Val and all in [_First, _Last)
+	* Algorithm Complexity: O(N)
+	* 运算须满足结合律与交换律，元素的累加次序不定：
+	* 随机访问区间用四个互不依赖的累加器，使有延迟的运算(如浮点加法)可以重叠执行；
+	* 指针区间上的整数与浮点数以plus求和、float与double以plus与multiplies求点积时用SIMD
+	* ***********************************
+	*/
+	// 以Reduce把Val与Elem(0), ..., Elem(N - 1)合并
+	template <class T, class Diff, class Op, class Fn>
+	inline T _Reduce_unrolled(Diff N, T Val, Op& Reduce, Fn Elem)
+	{
+		if (N < 8)
+		{
+			for (Diff I = 0; I < N; ++I)
+				Val = Reduce(std::move(Val), Elem(I));
+			return Val;
+		}
+		T Acc0 = Elem(0), Acc1 = Elem(1), Acc2 = Elem(2), Acc3 = Elem(3);
+		Diff I = 4;
+		for (; I + 4 <= N; I += 4)
+		{
+			Acc0 = Reduce(std::move(Acc0), Elem(I));
+			Acc1 = Reduce(std::move(Acc1), Elem(I + 1));
+			Acc2 = Reduce(std::move(Acc2), Elem(I + 2));
+			Acc3 = Reduce(std::move(Acc3), Elem(I + 3));
+		}
+		for (; I < N; ++I)
+			Acc0 = Reduce(std::move(Acc0), Elem(I));
+		return Reduce(std::move(Val), Reduce(Reduce(std::move(Acc0), std::move(Acc1)), Reduce(std::move(Acc2), std::move(Acc3))));
+	}
+
+	template <class InIt, class T, class Op>
+	inline T reduce(InIt First, InIt Last, T Val, Op Func)
+	{
+		if constexpr (TinySTL::_Simd_reduce_v<InIt, T, Op>)
+			return TinySTL::_Simd_add_wrap(Val, TinySTL::_Simd_sum(static_cast<const T*>(First), static_cast<size_t>(Last - First)));
+		else if constexpr (TinySTL::is_random_iter_v<InIt>)
+			return TinySTL::_Reduce_unrolled(Last - First, std::move(Val), Func, [&](auto I) -> decltype(auto) { return First[I]; });
+		else
+		{
+			for (; First != Last; ++First)
+				Val = Func(std::move(Val), *First);
+			return Val;
+		}
+	}
+
+	template <class InIt, class T>
+	inline T reduce(InIt First, InIt Last, T Val)
+	{
+		return TinySTL::reduce(First, Last, Val, TinySTL::plus<T>());
+	}
+
+	template <class InIt>
+	inline typename TinySTL::iterator_traits<InIt>::value_type reduce(InIt First, InIt Last)
+	{
+		using T = typename TinySTL::iterator_traits<InIt>::value_type;
+		return TinySTL::reduce(First, Last, T(), TinySTL::plus<T>());
+	}
+
+	template <class InIt1, class InIt2, class T, class Op1, class Op2>
+	inline T transform_reduce(InIt1 First1, InIt1 Last1, InIt2 First2, T Val, Op1 Reduce, Op2 Transform)
+	{
+		if constexpr (TinySTL::_Simd_dot_v<InIt1, InIt2, T, Op1, Op2>)
+			return Val + TinySTL::_Simd_dot(static_cast<const T*>(First1), static_cast<const T*>(First2), static_cast<size_t>(Last1 - First1));
+		else if constexpr (TinySTL::is_random_iter_v<InIt1> && TinySTL::is_random_iter_v<InIt2>)
+			return TinySTL::_Reduce_unrolled(Last1 - First1, std::move(Val), Reduce,
+				[&](auto I) -> decltype(auto) { return Transform(First1[I], First2[I]); });
+		else
+		{
+			for (; First1 != Last1; ++First1, (void)++First2)
+				Val = Reduce(std::move(Val), Transform(*First1, *First2));
+			return Val;
+		}
+	}
+
+	template <class InIt1, class InIt2, class T>
+	inline T transform_reduce(InIt1 First1, InIt1 Last1, InIt2 First2, T Val)
+	{
+		return TinySTL::transform_reduce(First1, Last1, First2, Val, TinySTL::plus<T>(), TinySTL::multiplies<T>());
+	}
+
+	template <class InIt, class T, class Op, class Fn>
+	inline T transform_reduce(InIt First, InIt Last, T Val, Op Reduce, Fn Transform)
+	{
+		if constexpr (TinySTL::is_random_iter_v<InIt>)
+			return TinySTL::_Reduce_unrolled(Last - First, std::move(Val), Reduce, [&](auto I) -> decltype(auto) { return Transform(First[I]); });
+		else
+		{
+			for (; First != Last; ++First)
+				Val = Reduce(std::move(Val), Transform(*First));
+			return Val;
+		}
+	}
+
+	/*
+	* ***********************************
+	* partial_sum inclusive_scan exclusive_scan
+	* compute partial sums into _Dest, using _Func
+	* Algorithm Complexity: O(N)
+	* 第i个输出为前i + 1个(exclusive_scan为前i个)元素与初值之和；输出区间可以与输入区间相同
+	* ***********************************
+	*/
+	template <class InIt, class OutIt, class Op>
+	inline OutIt partial_sum(InIt First, InIt Last, OutIt Dest, Op Func)
+	{
+		if (First == Last)
+			return Dest;
+		typename TinySTL::iterator_traits<InIt>::value_type Val = *First;
+		*Dest = Val;
+		while (++First != Last)
+		{
+			Val = Func(std::move(Val), *First);
+			*++Dest = Val;
+		}
+		return ++Dest;
+	}
+
+	template <class InIt, class OutIt>
+	inline OutIt partial_sum(InIt First, InIt Last, OutIt Dest)
+	{
+		return TinySTL::partial_sum(First, Last, Dest, TinySTL::plus<typename TinySTL::iterator_traits<InIt>::value_type>());
+	}
+
+	template <class InIt, class OutIt, class Op, class T>
+	inline OutIt inclusive_scan(InIt First, InIt Last, OutIt Dest, Op Func, T Val)
+	{
+		for (; First != Last; ++First, (void)++Dest)
+		{
+			Val = Func(std::move(Val), *First);
+			*Dest = Val;
+		}
+		return Dest;
+	}
+
+	template <class InIt, class OutIt, class Op>
+	inline OutIt inclusive_scan(InIt First, InIt Last, OutIt Dest, Op Func)
+	{
+		return TinySTL::partial_sum(First, Last, Dest, Func);
+	}
+
+	template <class InIt, class OutIt>
+	inline OutIt inclusive_scan(InIt First, InIt Last, OutIt Dest)
+	{
+		return TinySTL::partial_sum(First, Last, Dest);
+	}
+
+	template <class InIt, class OutIt, class T, class Op>
+	inline OutIt exclusive_scan(InIt First, InIt Last, OutIt Dest, T Val, Op Func)
+	{
+		for (; First != Last; ++First, (void)++Dest)
+		{
+			T Next = Func(Val, *First); // 先读*First，输出区间与输入区间相同时也正确
+			*Dest = std::move(Val);
+			Val = std::move(Next);
+		}
+		return Dest;
+	}
+
+	template <class InIt, class OutIt, class T>
+	inline OutIt exclusive_scan(InIt First, InIt Last, OutIt Dest, T Val)
+	{
+		return TinySTL::exclusive_scan(First, Last, Dest, Val, TinySTL::plus<T>());
+	}
+
+	/*
+	* ***********************************
+	* adjacent_difference
+	* compute adjacent differences into _Dest, using _Func
+	* Algorithm Complexity: O(N)
+	* ***********************************
+	*/
+	template <class InIt, class OutIt, class Op>
+	inline OutIt adjacent_difference(InIt First, InIt Last, OutIt Dest, Op Func)
+	{
+		if (First == Last)
+			return Dest;
+		typename TinySTL::iterator_traits<InIt>::value_type Prev = *First;
+		*Dest = Prev;
+		while (++First != Last)
+		{
+			typename TinySTL::iterator_traits<InIt>::value_type Val = *First;
+			*++Dest = Func(Val, Prev);
+			Prev = std::move(Val);
+		}
+		return ++Dest;
+	}
+
+	template <class InIt, class OutIt>
+	inline OutIt adjacent_difference(InIt First, InIt Last, OutIt Dest)
+	{
+		return TinySTL::adjacent_difference(First, Last, Dest, TinySTL::minus<typename TinySTL::iterator_traits<InIt>::value_type>());
+	}
+
+	/*
+	* ***********************************
+	* 带执行策略的数值算法
+	* ***********************************
+	* reduce / transform_reduce : 各块以不带策略的版本求出部分和(块内同样用SIMD或多个累加器)，再两两合并；
+	*                             初值只参与一次合并，结果类型须能默认构造
+	* inclusive_scan / exclusive_scan : 两遍的分块扫描：第一遍各块并行地按次序求和，依次求出各块之前的前缀后，
+	*                                   第二遍各块并行地以该前缀为初值扫描；运算只须满足结合律
+	* 迭代器不是随机访问迭代器时依次执行
+	*/
+	template <class ExPo, class FwdIt, class T, class Op, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline T reduce(ExPo&& Policy, FwdIt First, FwdIt Last, T Val, Op Func)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt>)
+		{
+			const size_t N = static_cast<size_t>(Last - First);
+			if (N == 0)
+				return Val;
+			return Func(std::move(Val), TinySTL::_Par_run_reduce<T>(Policy, N,
+				[&](size_t Begin, size_t End) { return TinySTL::reduce(First + (Begin + 1), First + End, T(First[Begin]), Func); },
+				[&](T Left, T Right) { return Func(std::move(Left), std::move(Right)); }));
+		}
+		else
+			return TinySTL::reduce(First, Last, Val, Func);
+	}
+
+	template <class ExPo, class FwdIt, class T, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline T reduce(ExPo&& Policy, FwdIt First, FwdIt Last, T Val)
+	{
+		return TinySTL::reduce(Policy, First, Last, Val, TinySTL::plus<T>());
+	}
+
+	template <class ExPo, class FwdIt, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline typename TinySTL::iterator_traits<FwdIt>::value_type reduce(ExPo&& Policy, FwdIt First, FwdIt Last)
+	{
+		using T = typename TinySTL::iterator_traits<FwdIt>::value_type;
+		return TinySTL::reduce(Policy, First, Last, T(), TinySTL::plus<T>());
+	}
+
+	template <class ExPo, class FwdIt1, class FwdIt2, class T, class Op1, class Op2, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline T transform_reduce(ExPo&& Policy, FwdIt1 First1, FwdIt1 Last1, FwdIt2 First2, T Val, Op1 Reduce, Op2 Transform)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt1> && TinySTL::is_random_iter_v<FwdIt2>)
+		{
+			const size_t N = static_cast<size_t>(Last1 - First1);
+			if (N == 0)
+				return Val;
+			return Reduce(std::move(Val), TinySTL::_Par_run_reduce<T>(Policy, N, [&](size_t Begin, size_t End)
+			{
+				return TinySTL::transform_reduce(First1 + (Begin + 1), First1 + End, First2 + (Begin + 1),
+					T(Transform(First1[Begin], First2[Begin])), Reduce, Transform);
+			},
+				[&](T Left, T Right) { return Reduce(std::move(Left), std::move(Right)); }));
+		}
+		else
+			return TinySTL::transform_reduce(First1, Last1, First2, Val, Reduce, Transform);
+	}
+
+	template <class ExPo, class FwdIt1, class FwdIt2, class T, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline T transform_reduce(ExPo&& Policy, FwdIt1 First1, FwdIt1 Last1, FwdIt2 First2, T Val)
+	{
+		return TinySTL::transform_reduce(Policy, First1, Last1, First2, Val, TinySTL::plus<T>(), TinySTL::multiplies<T>());
+	}
+
+	template <class ExPo, class FwdIt, class T, class Op, class Fn, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline T transform_reduce(ExPo&& Policy, FwdIt First, FwdIt Last, T Val, Op Reduce, Fn Transform)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt>)
+		{
+			const size_t N = static_cast<size_t>(Last - First);
+			if (N == 0)
+				return Val;
+			return Reduce(std::move(Val), TinySTL::_Par_run_reduce<T>(Policy, N, [&](size_t Begin, size_t End)
+			{
+				return TinySTL::transform_reduce(First + (Begin + 1), First + End, T(Transform(First[Begin])), Reduce, Transform);
+			},
+				[&](T Left, T Right) { return Reduce(std::move(Left), std::move(Right)); }));
+		}
+		else
+			return TinySTL::transform_reduce(First, Last, Val, Reduce, Transform);
+	}
+
+	// 两遍的分块扫描，Scan(Begin, End, Init)以Init为初值扫描一块
+	template <class RanIt, class T, class Op, class Fn>
+	inline void _Par_scan_blocks(thread_pool& Pool, RanIt First, size_t N, size_t Grain, T Val, Op& Func, Fn& Scan)
+	{
+		// 第一遍：各块的和，按次序累加
+		const size_t Blocks = (N + Grain - 1) / Grain;
+		TinySTL::_Temp_buffer<T> SumBuf(Blocks, Val); // 与输入的元素类型无关，随后被各块的和覆盖
+		T* const Sums = SumBuf._M_begin();
+		auto SumBlocks = [&](size_t Lo, size_t Hi)
+		{
+			for (size_t B = Lo; B < Hi; ++B)
+			{
+				const size_t Begin = B * Grain, End = N - Begin < Grain ? N : Begin + Grain;
+				Sums[B] = TinySTL::accumulate(First + (Begin + 1), First + End, T(First[Begin]), Func);
+			}
+		};
+		TinySTL::_Par_for(Pool, 0, Blocks, 1, SumBlocks);
+
+		// 各块之前的前缀
+		for (size_t B = 0; B < Blocks; ++B)
+		{
+			T Next = Func(Val, Sums[B]);
+			Sums[B] = std::move(Val);
+			Val = std::move(Next);
+		}
+
+		// 第二遍：各块以前缀为初值扫描
+		auto ScanBlocks = [&](size_t Lo, size_t Hi)
+		{
+			for (size_t B = Lo; B < Hi; ++B)
+			{
+				const size_t Begin = B * Grain;
+				Scan(Begin, N - Begin < Grain ? N : Begin + Grain, Sums[B]);
+			}
+		};
+		TinySTL::_Par_for(Pool, 0, Blocks, 1, ScanBlocks);
+	}
+
+	// 以Val为初值扫描[First, First + N)到Dest；Inclusive为false时是exclusive_scan
+	template <bool Inclusive, class ExPo, class RanIt1, class RanIt2, class T, class Op>
+	inline void _Par_scan(const ExPo& Policy, RanIt1 First, size_t N, RanIt2 Dest, T Val, Op& Func)
+	{
+		auto Scan = [&](size_t Begin, size_t End, T Init)
+		{
+			if constexpr (Inclusive)
+				TinySTL::inclusive_scan(First + Begin, First + End, Dest + Begin, Func, std::move(Init));
+			else
+				TinySTL::exclusive_scan(First + Begin, First + End, Dest + Begin, std::move(Init), Func);
+		};
+		if constexpr (_Is_parallel_policy_v<ExPo>)
+		{
+			const size_t Grain = Policy.grain_for(N);
+			if (N > Grain)
+			{
+				TinySTL::_Par_scan_blocks(Policy.pool(), First, N, Grain, std::move(Val), Func, Scan);
+				return;
+			}
+		}
+		Scan(0, N, std::move(Val));
+	}
+
+	template <class ExPo, class FwdIt1, class FwdIt2, class Op, class T, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline FwdIt2 inclusive_scan(ExPo&& Policy, FwdIt1 First, FwdIt1 Last, FwdIt2 Dest, Op Func, T Val)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt1> && TinySTL::is_random_iter_v<FwdIt2>)
+		{
+			const size_t N = static_cast<size_t>(Last - First);
+			TinySTL::_Par_scan<true>(Policy, First, N, Dest, std::move(Val), Func);
+			return Dest + N;
+		}
+		else
+			return TinySTL::inclusive_scan(First, Last, Dest, Func, Val);
+	}
+
+	template <class ExPo, class FwdIt1, class FwdIt2, class Op, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline FwdIt2 inclusive_scan(ExPo&& Policy, FwdIt1 First, FwdIt1 Last, FwdIt2 Dest, Op Func)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt1> && TinySTL::is_random_iter_v<FwdIt2>)
+		{
+			if (First == Last)
+				return Dest;
+			*Dest = *First; // 以第一个元素为初值扫描其余元素
+			return TinySTL::inclusive_scan(Policy, First + 1, Last, Dest + 1, Func,
+				typename TinySTL::iterator_traits<FwdIt1>::value_type(*First));
+		}
+		else
+			return TinySTL::inclusive_scan(First, Last, Dest, Func);
+	}
+
+	template <class ExPo, class FwdIt1, class FwdIt2, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline FwdIt2 inclusive_scan(ExPo&& Policy, FwdIt1 First, FwdIt1 Last, FwdIt2 Dest)
+	{
+		return TinySTL::inclusive_scan(Policy, First, Last, Dest, TinySTL::plus<typename TinySTL::iterator_traits<FwdIt1>::value_type>());
+	}
+
+	template <class ExPo, class FwdIt1, class FwdIt2, class T, class Op, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline FwdIt2 exclusive_scan(ExPo&& Policy, FwdIt1 First, FwdIt1 Last, FwdIt2 Dest, T Val, Op Func)
+	{
+		if constexpr (TinySTL::is_random_iter_v<FwdIt1> && TinySTL::is_random_iter_v<FwdIt2>)
+		{
+			const size_t N = static_cast<size_t>(Last - First);
+			TinySTL::_Par_scan<false>(Policy, First, N, Dest, std::move(Val), Func);
+			return Dest + N;
+		}
+		else
+			return TinySTL::exclusive_scan(First, Last, Dest, Val, Func);
+	}
+
+	template <class ExPo, class FwdIt1, class FwdIt2, class T, _Enable_if_execution_policy_t<ExPo> = 0>
+	inline FwdIt2 exclusive_scan(ExPo&& Policy, FwdIt1 First, FwdIt1 Last, FwdIt2 Dest, T Val)
+	{
+		return TinySTL::exclusive_scan(Policy, First, Last, Dest, Val, TinySTL::plus<T>());
+	}
+}
+
+#endif // !_NUMERIC_H_
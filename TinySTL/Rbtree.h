@@ -1,9 +1,15 @@
 ﻿#ifndef _RBTREE_H_
 #define _RBTREE_H_
 
+#include <cstdint>
+#include <utility>
+
 #include "Iterator.h"
+#include "TypeTraits.h"
+#include "Allocator.h"
 #include "Algorithm.h"
 #include "ReserverseIterator.h"
+#include "ThreadPool.h"
 
 namespace TinySTL
 {
@@ -12,16 +18,40 @@ namespace TinySTL
 	const _Rb_tree_color_type _S_rb_tree_red   = false; // 红色为0
 	const _Rb_tree_color_type _S_rb_tree_black = true;  // 黑色为1
 
+	/*
+	* 节点的颜色与父节点只能经由_M_get_color/_M_set_color/_M_get_parent/_M_set_parent访问，
+	* 以便在两种布局间切换：
+	*   默认布局       颜色单独占一个字段，因对齐实际占用一个指针的大小
+	*   紧凑布局       定义_TINYSTL_COMPACT_RB_TREE后启用，颜色存放在父节点指针的最低位，每个节点省下一个指针。
+	*                  节点至少按2字节对齐(alloc按8字节对齐)，最低位恒为0，可以挪作他用
+	* 两种布局的节点互不兼容，同一程序中的所有编译单元须一致地定义或不定义_TINYSTL_COMPACT_RB_TREE
+	*/
 	struct _Rb_tree_node_base
 	{
 		using _color_type = _Rb_tree_color_type;
 		using _Base_ptr   = _Rb_tree_node_base*;
 
+#ifdef _TINYSTL_COMPACT_RB_TREE
+		uintptr_t _M_parent_color; // 指向父节点的指针，最低位为节点颜色
+		_Base_ptr _M_left;         // 指向左节点
+		_Base_ptr _M_right;        // 指向右节点
+
+		_color_type _M_get_color() const { return (_M_parent_color & 1) != 0; }
+		void _M_set_color(_color_type __c) { _M_parent_color = (_M_parent_color & ~uintptr_t(1)) | uintptr_t(__c ? 1 : 0); }
+		_Base_ptr _M_get_parent() const { return reinterpret_cast<_Base_ptr>(_M_parent_color & ~uintptr_t(1)); }
+		void _M_set_parent(_Base_ptr __p) { _M_parent_color = reinterpret_cast<uintptr_t>(__p) | (_M_parent_color & 1); }
+#else
 		_color_type _M_color; // 节点颜色，非红即黑
 		_Base_ptr _M_parent;  // 指向父节点的指针
 		_Base_ptr _M_left;    // 指向左节点
 		_Base_ptr _M_right;	  // 指向右节点
 
+		_color_type _M_get_color() const { return _M_color; }
+		void _M_set_color(_color_type __c) { _M_color = __c; }
+		_Base_ptr _M_get_parent() const { return _M_parent; }
+		void _M_set_parent(_Base_ptr __p) { _M_parent = __p; }
+#endif
+
 		// 寻找以x为根节点的RB树的最小节点
 		static _Base_ptr _S_minimum(_Base_ptr __x)
 		{
@@ -39,10 +69,11 @@ namespace TinySTL
 		}
 	}; 
 
-	template<class _Value>
-	struct _Rb_tree_node : public _Rb_tree_node_base
+	// _NodeBase为_Rb_tree_node_base或其派生类(由_Rb_tree的_Augment策略决定，用于在节点上附加信息)
+	template<class _Value, class _NodeBase = _Rb_tree_node_base>
+	struct _Rb_tree_node : public _NodeBase
 	{
-		using _Link_type = _Rb_tree_node<_Value>*;
+		using _Link_type = _Rb_tree_node<_Value, _NodeBase>*;
 		_Value _M_value_field; // 节点值
 	};
 
@@ -67,11 +98,11 @@ namespace TinySTL
 			}
 			else // 右子树为空，状况（2）
 			{
-				_Base_ptr __y = _M_node->_M_parent; // 找出父节点
+				_Base_ptr __y = _M_node->_M_get_parent(); // 找出父节点
 				while (_M_node == __y->_M_right) // 如果现行节点本身是个右子节点
 				{	// 沿着父节点上溯，直到其为父节点的左孩子，或者达到根节点
 					_M_node = __y; 
-					__y = __y->_M_parent;
+					__y = __y->_M_get_parent();
 				}
 				if (_M_node->_M_right != __y) // 若此时的右子节点不等于此时的父节点
 					_M_node = __y; // 状况（3）此时的父节点即为解答
@@ -86,7 +117,7 @@ namespace TinySTL
 		void _M_decrement()
 		{
 			// 如果是红节点，且父节点的父节点等于自己，状况（1），右子节点即为解答
-			if (_M_node->_M_color == _S_rb_tree_red && _M_node->_M_parent->_M_parent == _M_node)
+			if (_M_node->_M_get_color() == _S_rb_tree_red && _M_node->_M_get_parent()->_M_get_parent() == _M_node)
 			{
 				_M_node = _M_node->_M_right;
 				// 以上情况发生于node为header时（即node为end()时）
@@ -101,11 +132,11 @@ namespace TinySTL
 			}
 			else // 既非根节点，亦无左子节点
 			{
-				_Base_ptr __y = _M_node->_M_parent; // 状况（3），找到父节点
+				_Base_ptr __y = _M_node->_M_get_parent(); // 状况（3），找到父节点
 				while (_M_node == __y->_M_left) // 当现行节点身为左子节点
 				{
 					_M_node = __y; // 一直交替往上走，直到现行节点不为左子节点
-					__y = __y->_M_parent;
+					__y = __y->_M_get_parent();
 				}
 
 				// 找到前驱，即为其父节点
@@ -115,16 +146,16 @@ namespace TinySTL
 	};
 
 	// RB-tree的正规迭代器
-	template<class _Value, class _Ref, class _Ptr>
+	template<class _Value, class _Ref, class _Ptr, class _NodeBase = _Rb_tree_node_base>
 	struct _Rb_tree_iterator : public _Rb_tree_base_iterator
 	{
 		using value_type     = _Value;
 		using reference      = _Ref;
 		using pointer        = _Ptr;
-		using iterator       = _Rb_tree_iterator<_Value, _Value&, _Value*>;
-		using const_iterator = _Rb_tree_iterator<_Value, const _Value&, const _Value*>;
-		using _Self          = _Rb_tree_iterator<_Value, _Ref, _Ptr>;
-		using _Link_type     = _Rb_tree_node<_Value>*;
+		using iterator       = _Rb_tree_iterator<_Value, _Value&, _Value*, _NodeBase>;
+		using const_iterator = _Rb_tree_iterator<_Value, const _Value&, const _Value*, _NodeBase>;
+		using _Self          = _Rb_tree_iterator<_Value, _Ref, _Ptr, _NodeBase>;
+		using _Link_type     = _Rb_tree_node<_Value, _NodeBase>*;
 
 		_Rb_tree_iterator() {}
 		_Rb_tree_iterator(_Link_type __x) { _M_node = __x; }
@@ -139,7 +170,7 @@ namespace TinySTL
 			return *this;
 		}
 
-		_Self& operator++(int)
+		_Self operator++(int)
 		{
 			_Self tmp = *this;
 			_M_increment();
@@ -152,7 +183,7 @@ namespace TinySTL
 			return* this;
 		}
 
-		_Self& operator--(int)
+		_Self operator--(int)
 		{
 			_Self tmp = *this;
 			_M_decrement();
@@ -170,107 +201,203 @@ namespace TinySTL
 		return !(__x._M_node == __y._M_node);
 	}
 
+	/*
+	* ***********************************
+	* _Augment : 节点附加信息的编译期策略
+	* ***********************************
+	* _Node_base为节点的基类；旋转、插入、删除时调用以下钩子维护附加信息：
+	*   _S_rotate(__x, __y)  旋转完成，__y取代了__x的位置，__x成为__y的孩子
+	*   _S_insert(__x, __root) 新节点__x已作为叶节点链接入树
+	*   _S_erase(__y, __root)  节点__y即将从其所在位置摘除(此时树的结构尚未改变)
+	*   _S_copy(__dst, __src)  __dst取代了__src的位置，或由__src复制而来
+	*   _S_update(__x)        由孩子重新计算__x
+	* 默认策略的钩子均为空操作，内联后不产生任何代码
+	*/
+	struct _Rb_tree_no_augment
+	{
+		using _Node_base = _Rb_tree_node_base;
+		static const bool _S_has_rank = false;
+
+		static void _S_rotate(_Rb_tree_node_base*, _Rb_tree_node_base*) {}
+		static void _S_insert(_Rb_tree_node_base*, _Rb_tree_node_base*) {}
+		static void _S_erase(_Rb_tree_node_base*, _Rb_tree_node_base*) {}
+		static void _S_copy(_Rb_tree_node_base*, _Rb_tree_node_base*) {}
+		static void _S_update(_Rb_tree_node_base*) {}
+	};
+
+	struct _Rb_tree_rank_node_base : public _Rb_tree_node_base
+	{
+		size_t _M_size; // 以该节点为根的子树的节点数
+	};
+
+	// 顺序统计策略：每个节点记录子树大小，_Rb_tree据此提供O(log n)的select/rank/index_of
+	struct _Rb_tree_rank_augment
+	{
+		using _Node_base = _Rb_tree_rank_node_base;
+		static const bool _S_has_rank = true;
+
+		static size_t _S_size(const _Rb_tree_node_base* __x)
+		{
+			return __x == nullptr ? 0 : static_cast<const _Rb_tree_rank_node_base*>(__x)->_M_size;
+		}
+		static size_t& _S_size_ref(_Rb_tree_node_base* __x)
+		{
+			return static_cast<_Rb_tree_rank_node_base*>(__x)->_M_size;
+		}
+
+		static void _S_update(_Rb_tree_node_base* __x)
+		{
+			_S_size_ref(__x) = 1 + _S_size(__x->_M_left) + _S_size(__x->_M_right);
+		}
+		static void _S_rotate(_Rb_tree_node_base* __x, _Rb_tree_node_base* __y)
+		{	// __y的子树即原__x的子树
+			_S_size_ref(__y) = _S_size_ref(__x);
+			_S_update(__x);
+		}
+		static void _S_insert(_Rb_tree_node_base* __x, _Rb_tree_node_base* __root)
+		{
+			_S_size_ref(__x) = 1;
+			while (__x != __root) // 所有祖先节点加一
+			{
+				__x = __x->_M_get_parent();
+				++_S_size_ref(__x);
+			}
+		}
+		static void _S_erase(_Rb_tree_node_base* __y, _Rb_tree_node_base* __root)
+		{
+			while (__y != __root) // 所有祖先节点减一
+			{
+				__y = __y->_M_get_parent();
+				--_S_size_ref(__y);
+			}
+		}
+		static void _S_copy(_Rb_tree_node_base* __dst, _Rb_tree_node_base* __src)
+		{
+			_S_size_ref(__dst) = _S_size_ref(__src);
+		}
+	};
+
 	// 全局函数
 	// 新节点必为红节点。如果插入处之父节点亦为红节点，就违反红黑树规则，需要做树形旋转
 	// 将以__x为根的子树左旋
+	template<class _Augment = _Rb_tree_no_augment>
 	inline void _Rb_tree_rotate_left(_Rb_tree_node_base* __x, _Rb_tree_node_base*& __root)
 	{
 		_Rb_tree_node_base* __y = __x->_M_right; // 令__y为旋转点的右子节点
 		__x->_M_right = __y->_M_left; // __x的右子节点指向__x->_M_right的左子节点
 		if (__y->_M_left != nullptr)
-			__y->_M_left->_M_parent = __x;
-		__y->_M_parent = __x->_M_parent;
+			__y->_M_left->_M_set_parent(__x);
+		__y->_M_set_parent(__x->_M_get_parent());
 
 		// 令__y完全顶替__x的地位，必须将__x对其父节点的关系完全接受过来
 		if (__x == __root) // __x为根节点
 			__root = __y;
-		else if (__x == __x->_M_parent->_M_left) // __x为其父节点的左子节点
-			__x->_M_parent->_M_left = __y;
+		else if (__x == __x->_M_get_parent()->_M_left) // __x为其父节点的左子节点
+			__x->_M_get_parent()->_M_left = __y;
 		else // __x为其父节点的右子节点
-			__x->_M_parent->_M_right = __y;
+			__x->_M_get_parent()->_M_right = __y;
 		__y->_M_left = __x;
-		__x->_M_parent = __y;
+		__x->_M_set_parent(__y);
+		_Augment::_S_rotate(__x, __y);
 	}
 
 	// 将以__x为根的子树右旋
+	template<class _Augment = _Rb_tree_no_augment>
 	inline void _Rb_tree_rotate_right(_Rb_tree_node_base* __x, _Rb_tree_node_base*& __root)
 	{
 		_Rb_tree_node_base* __y = __x->_M_left; // 令__y为旋转点的左子节点
 		__x->_M_left = __y->_M_right; // __x的左子节点指向__x->_M_left的右子节点
 		if (__y->_M_right != nullptr)
-			__y->_M_right->_M_parent = __x;
-		__y->_M_parent = __x->_M_parent;
+			__y->_M_right->_M_set_parent(__x);
+		__y->_M_set_parent(__x->_M_get_parent());
 
 		if (__x == __root)
 			__root = __y;
-		else if (__x == __x->_M_parent->_M_right)
-			__x->_M_parent->_M_right = __y;
+		else if (__x == __x->_M_get_parent()->_M_right)
+			__x->_M_get_parent()->_M_right = __y;
 		else
-			__x->_M_parent->_M_left = __y;
+			__x->_M_get_parent()->_M_left = __y;
 		__y->_M_right = __x;
-		__x->_M_parent = __y;
+		__x->_M_set_parent(__y);
+		_Augment::_S_rotate(__x, __y);
 	}
 
 	//插入结点__x之后的调整,使其符合RB树的定义,
 	//调整采用按子树逐层上溯处理,直至整棵树合法为止
+	template<class _Augment = _Rb_tree_no_augment>
+	inline bool _Rb_tree_insert_fixup(_Rb_tree_node_base* __x, _Rb_tree_node_base*& __root);
+
+	template<class _Augment = _Rb_tree_no_augment>
 	inline void _Rb_tree_rebalance(_Rb_tree_node_base* __x, _Rb_tree_node_base*& __root)
 	{
-		__x->_M_color = _S_rb_tree_red; // 新节点必为红
-		while (__x != __root && __x->_M_parent->_M_color == _S_rb_tree_red) // 父节点为红
+		_Augment::_S_insert(__x, __root);
+		__x->_M_set_color(_S_rb_tree_red); // 新节点必为红
+		_Rb_tree_insert_fixup<_Augment>(__x, __root);
+	}
+
+	// 红节点__x已链接入树(附加信息已更新)，消除它与父节点可能构成的连续红节点
+	// 返回整棵树的黑高是否因根节点由红染黑而加一
+	template<class _Augment>
+	inline bool _Rb_tree_insert_fixup(_Rb_tree_node_base* __x, _Rb_tree_node_base*& __root)
+	{
+		while (__x != __root && __x->_M_get_parent()->_M_get_color() == _S_rb_tree_red) // 父节点为红
 		{
-			if (__x->_M_parent == __x->_M_parent->_M_parent->_M_left) // 父节点为祖父节点的左节点
+			if (__x->_M_get_parent() == __x->_M_get_parent()->_M_get_parent()->_M_left) // 父节点为祖父节点的左节点
 			{
-				_Rb_tree_node_base* __y = __x->_M_parent->_M_parent->_M_right; // __y为伯父节点
-				if (__y && __y->_M_color == _S_rb_tree_red) // 伯父节点存在且为红
+				_Rb_tree_node_base* __y = __x->_M_get_parent()->_M_get_parent()->_M_right; // __y为伯父节点
+				if (__y && __y->_M_get_color() == _S_rb_tree_red) // 伯父节点存在且为红
 				{
-					__x->_M_parent->_M_color = _S_rb_tree_black; // 更改父节点为黑
-					__y->_M_color = _S_rb_tree_black; // 更改伯父节点为黑
-					__x->_M_parent->_M_parent->_M_color = _S_rb_tree_red; // 更改祖父节点为红
-					__x = __x->_M_parent->_M_parent; // 再次循环从其祖父节点开始
+					__x->_M_get_parent()->_M_set_color(_S_rb_tree_black); // 更改父节点为黑
+					__y->_M_set_color(_S_rb_tree_black); // 更改伯父节点为黑
+					__x->_M_get_parent()->_M_get_parent()->_M_set_color(_S_rb_tree_red); // 更改祖父节点为红
+					__x = __x->_M_get_parent()->_M_get_parent(); // 再次循环从其祖父节点开始
 				}
 				else // 无伯父节点，或伯父节点为黑
 				{	// 此时__x和__x的父节点都为红色，伯父节点为黑
-					if (__x == __x->_M_parent->_M_right) // 如果新节点为父节点的右子节点
+					if (__x == __x->_M_get_parent()->_M_right) // 如果新节点为父节点的右子节点
 					{									 // 调整，将__x调整为左孩子交由后面处理
-						__x = __x->_M_parent;
-						_Rb_tree_rotate_left(__x, __root);
+						__x = __x->_M_get_parent();
+						_Rb_tree_rotate_left<_Augment>(__x, __root);
 					}
 					// 此时__x必为左孩子，且__x，__x的父节点均为红色，__x伯父节点为黑
-					__x->_M_parent->_M_color = _S_rb_tree_black;
-					__x->_M_parent->_M_parent->_M_color = _S_rb_tree_red;
-					_Rb_tree_rotate_right(__x->_M_parent->_M_parent, __root);
+					__x->_M_get_parent()->_M_set_color(_S_rb_tree_black);
+					__x->_M_get_parent()->_M_get_parent()->_M_set_color(_S_rb_tree_red);
+					_Rb_tree_rotate_right<_Augment>(__x->_M_get_parent()->_M_get_parent(), __root);
 					// 此时__x的父节点已经为黑色，可保证整棵树符合RB树的定义，完全可以跳出循环
 				}
 			}
 			else // 父节点为祖父节点的右节点
 			{
-				_Rb_tree_node_base* __y = __x->_M_parent->_M_parent->_M_left; // __y为伯父节点
-				if (__y && __y->_M_color == _S_rb_tree_red) // 伯父节点存在且为红
+				_Rb_tree_node_base* __y = __x->_M_get_parent()->_M_get_parent()->_M_left; // __y为伯父节点
+				if (__y && __y->_M_get_color() == _S_rb_tree_red) // 伯父节点存在且为红
 				{
-					__x->_M_parent->_M_color = _S_rb_tree_black; // 更改父节点为黑
-					__y->_M_color = _S_rb_tree_black; // 更改伯父节点为黑
-					__x->_M_parent->_M_parent->_M_color = _S_rb_tree_red; // 更改祖父节点为红
-					__x = __x->_M_parent->_M_parent; // 再次循环从其祖父节点开始
+					__x->_M_get_parent()->_M_set_color(_S_rb_tree_black); // 更改父节点为黑
+					__y->_M_set_color(_S_rb_tree_black); // 更改伯父节点为黑
+					__x->_M_get_parent()->_M_get_parent()->_M_set_color(_S_rb_tree_red); // 更改祖父节点为红
+					__x = __x->_M_get_parent()->_M_get_parent(); // 再次循环从其祖父节点开始
 				}
 				else // 无伯父节点，或伯父节点为黑
 				{
-					if (__x == __x->_M_parent->_M_left) // 如果新节点为父节点的左子节点
+					if (__x == __x->_M_get_parent()->_M_left) // 如果新节点为父节点的左子节点
 					{
-						__x = __x->_M_parent;
-						_Rb_tree_rotate_right(__x, __root);
+						__x = __x->_M_get_parent();
+						_Rb_tree_rotate_right<_Augment>(__x, __root);
 					}
 					// 此时__x必为右孩子，且__x，__x的父节点均为红色，__x伯父节点为黑
-					__x->_M_parent->_M_color = _S_rb_tree_black;
-					__x->_M_parent->_M_parent->_M_color = _S_rb_tree_red;
-					_Rb_tree_rotate_left(__x->_M_parent->_M_parent, __root);
+					__x->_M_get_parent()->_M_set_color(_S_rb_tree_black);
+					__x->_M_get_parent()->_M_get_parent()->_M_set_color(_S_rb_tree_red);
+					_Rb_tree_rotate_left<_Augment>(__x->_M_get_parent()->_M_get_parent(), __root);
 				}
 			}
 		}
 		// while结束，根节点永远为黑
-		__root->_M_color = _S_rb_tree_black;
+		bool __grown = __root->_M_get_color() == _S_rb_tree_red;
+		__root->_M_set_color(_S_rb_tree_black);
+		return __grown;
 	}
 
 	// 删除节点z并调整该树，使其符合RB树的定义
+	template<class _Augment = _Rb_tree_no_augment>
 	inline _Rb_tree_node_base* _Rb_tree_rebalance_for_erase(_Rb_tree_node_base* __z,
 															_Rb_tree_node_base*& __root,
 															_Rb_tree_node_base*& __leftmost,
@@ -294,50 +421,54 @@ namespace TinySTL
 				__y = __y->_M_left;
 			__x = __y->_M_right;            // x可能为null
 		}
+		_Augment::_S_erase(__y, __root); // __y为实际从原位置摘除的节点
 
 		if (__y != __z) // __z具有双子节点
 		{  // 用y代替z
-			__z->_M_left->_M_parent = __y;
+			__z->_M_left->_M_set_parent(__y);
 			__y->_M_left = __z->_M_left;
 			if (__y != __z->_M_right)
 			{
-				__x_parent = __y->_M_parent;
+				__x_parent = __y->_M_get_parent();
 				if (__x) // x不为null
-					__x->_M_parent = __y->_M_parent;
-				__y->_M_parent->_M_left = __x;
+					__x->_M_set_parent(__y->_M_get_parent());
+				__y->_M_get_parent()->_M_left = __x;
 				__y->_M_right = __z->_M_right;
-				__z->_M_right->_M_parent = __y;
+				__z->_M_right->_M_set_parent(__y);
 			}
 			else
 				__x_parent = __y;
 
 			if (__root == __z)
 				__root = __y;
-			else if (__z->_M_parent->_M_left == __z)
-				__z->_M_parent->_M_left = __y;
+			else if (__z->_M_get_parent()->_M_left == __z)
+				__z->_M_get_parent()->_M_left = __y;
 			else
-				__z->_M_parent->_M_right = __y;
+				__z->_M_get_parent()->_M_right = __y;
 
-			__y->_M_parent = __z->_M_parent;
-			TinySTL::swap(__y->_M_color, __z->_M_color);
+			__y->_M_set_parent(__z->_M_get_parent());
+			_Rb_tree_color_type __c = __y->_M_get_color();
+			__y->_M_set_color(__z->_M_get_color());
+			__z->_M_set_color(__c);
+			_Augment::_S_copy(__y, __z);
 			__y = __z;
 		}
 		else  // __z不具有双子节点(具有一个或没有子节点)
 		{
-			__x_parent = __y->_M_parent;
+			__x_parent = __y->_M_get_parent();
 			if (__x)
-				__x->_M_parent = __y->_M_parent;
+				__x->_M_set_parent(__y->_M_get_parent());
 			if (__root == __z)
 				__root = __x;
-			else if (__z->_M_parent->_M_left == __z)
-				__z->_M_parent->_M_left = __x;
+			else if (__z->_M_get_parent()->_M_left == __z)
+				__z->_M_get_parent()->_M_left = __x;
 			else
-				__z->_M_parent->_M_right = __x;
+				__z->_M_get_parent()->_M_right = __x;
 
 			if (__leftmost == __z) // z已经是整棵树的最小值
 			{
 				if (__z->_M_right == nullptr) // z没有右子节点，即z没有子节点
-					__leftmost = __z->_M_parent;
+					__leftmost = __z->_M_get_parent();
 				else
 					__leftmost = _Rb_tree_node_base::_S_minimum(__x);
 			}
@@ -345,7 +476,7 @@ namespace TinySTL
 			if (__rightmost == __z) // z已经是整棵树的最大值
 			{
 				if (__z->_M_left == nullptr) // z没有左子节点，即z没有子节点
-					__rightmost = __z->_M_parent;
+					__rightmost = __z->_M_get_parent();
 				else
 					__rightmost = _Rb_tree_node_base::_S_maximum(__x);
 			}
@@ -353,54 +484,54 @@ namespace TinySTL
 		// 删除完毕,需要调整,和rebalance一样是按子树逐层上溯处理,直到整棵树合法为止
 
 		// 如果删除的结点为红色结点，不需要调整
-		if (__y->_M_color != _S_rb_tree_red)
+		if (__y->_M_get_color() != _S_rb_tree_red)
 		{
 			//如果x是根结点或者红色结点,只需最后调整结点颜色为黑色即可使整棵树满足RB树的定义
-			while (__x != __root && (__x == nullptr || __x->_M_color == _S_rb_tree_black))
+			while (__x != __root && (__x == nullptr || __x->_M_get_color() == _S_rb_tree_black))
 			{
 				if (__x == __x_parent->_M_left)
 				{
 					// w为被删节点的兄弟，由于删除操作，w子树比x子树多一个黑结点
 					_Rb_tree_node_base* __w = __x_parent->_M_right;
-					if (__w->_M_color == _S_rb_tree_red)
+					if (__w->_M_get_color() == _S_rb_tree_red)
 					{
 						// 通过调整将w变为黑色,交由下面处理
-						__w->_M_color = _S_rb_tree_black;
-						__x_parent->_M_color = _S_rb_tree_red;
-						_Rb_tree_rotate_left(__x_parent, __root);
+						__w->_M_set_color(_S_rb_tree_black);
+						__x_parent->_M_set_color(_S_rb_tree_red);
+						_Rb_tree_rotate_left<_Augment>(__x_parent, __root);
 						__w = __x_parent->_M_right;
 					}
 
 					// 此时w一定为黑色,而且仍然比x子树多一个黑结点
-					if ((__w->_M_left == nullptr || __w->_M_left->_M_color == _S_rb_tree_black) &&
-						(__w->_M_right == nullptr || __w->_M_right->_M_color == _S_rb_tree_black)) // w的两个子节点均为黑色
+					if ((__w->_M_left == nullptr || __w->_M_left->_M_get_color() == _S_rb_tree_black) &&
+						(__w->_M_right == nullptr || __w->_M_right->_M_get_color() == _S_rb_tree_black)) // w的两个子节点均为黑色
 					{
 						// 将w染成红色,此时w子树减少了一个黑结点,和x子树黑结点数目相同
 						// 但__x_parent子树比其兄弟子树少一个结点,因此令x=__x_parent,
 						// 交由下次循环处理
-						__w->_M_color = _S_rb_tree_red;
+						__w->_M_set_color(_S_rb_tree_red);
 						__x = __x_parent;
-						__x_parent = __x_parent->_M_parent;
+						__x_parent = __x_parent->_M_get_parent();
 					}
 					else // w为黑色,其孩子一红一黑或者同为红色
 					{
-						if (__w->_M_right == nullptr || __w->_M_right->_M_color == _S_rb_tree_black) // w孩子节点左红右黑
+						if (__w->_M_right == nullptr || __w->_M_right->_M_get_color() == _S_rb_tree_black) // w孩子节点左红右黑
 						{
 							if (__w->_M_left)
-								__w->_M_left->_M_color = _S_rb_tree_black;
+								__w->_M_left->_M_set_color(_S_rb_tree_black);
 
-							__w->_M_color = _S_rb_tree_red;
-							_Rb_tree_rotate_right(__w, __root);
+							__w->_M_set_color(_S_rb_tree_red);
+							_Rb_tree_rotate_right<_Augment>(__w, __root);
 							__w = __x_parent->_M_right;
 							// 此处w仍然为黑色,w子树的黑结点仍然比x子树多1,但w的孩子节点为左黑右红,交由下面处理
 						}
 
 						// 此时此处w一定为黑色,w子树的黑结点一定比x子树多1,w的右孩子节点一定为红色
-						__w->_M_color = __x_parent->_M_color;
-						__x_parent->_M_color = _S_rb_tree_black;
+						__w->_M_set_color(__x_parent->_M_get_color());
+						__x_parent->_M_set_color(_S_rb_tree_black);
 						if (__w->_M_right)
-							__w->_M_right->_M_color = _S_rb_tree_black;
-						_Rb_tree_rotate_left(__x_parent, __root);
+							__w->_M_right->_M_set_color(_S_rb_tree_black);
+						_Rb_tree_rotate_left<_Augment>(__x_parent, __root);
 						// 至此处可保证整棵树符合RB树的定义
 						break;
 					}
@@ -408,48 +539,128 @@ namespace TinySTL
 				else
 				{
 					_Rb_tree_node_base* __w = __x_parent->_M_left;
-					if (__w->_M_color == _S_rb_tree_red)
+					if (__w->_M_get_color() == _S_rb_tree_red)
 					{
-						__w->_M_color = _S_rb_tree_black;
-						__x_parent->_M_color = _S_rb_tree_red;
-						_Rb_tree_rotate_right(__x_parent, __root);
+						__w->_M_set_color(_S_rb_tree_black);
+						__x_parent->_M_set_color(_S_rb_tree_red);
+						_Rb_tree_rotate_right<_Augment>(__x_parent, __root);
 						__w = __x_parent->_M_left;
 					}
-					if ((__w->_M_right == 0 || __w->_M_right->_M_color == _S_rb_tree_black) &&
-						(__w->_M_left == 0 || __w->_M_left->_M_color == _S_rb_tree_black))
+					if ((__w->_M_right == 0 || __w->_M_right->_M_get_color() == _S_rb_tree_black) &&
+						(__w->_M_left == 0 || __w->_M_left->_M_get_color() == _S_rb_tree_black))
 					{
-						__w->_M_color = _S_rb_tree_red;
+						__w->_M_set_color(_S_rb_tree_red);
 						__x = __x_parent;
-						__x_parent = __x_parent->_M_parent;
+						__x_parent = __x_parent->_M_get_parent();
 					}
 					else
 					{
-						if (__w->_M_left == 0 || __w->_M_left->_M_color == _S_rb_tree_black)
+						if (__w->_M_left == 0 || __w->_M_left->_M_get_color() == _S_rb_tree_black)
 						{
 							if (__w->_M_right) 
-								__w->_M_right->_M_color = _S_rb_tree_black;
-							__w->_M_color = _S_rb_tree_red;
-							_Rb_tree_rotate_left(__w, __root);
+								__w->_M_right->_M_set_color(_S_rb_tree_black);
+							__w->_M_set_color(_S_rb_tree_red);
+							_Rb_tree_rotate_left<_Augment>(__w, __root);
 							__w = __x_parent->_M_left;
 						}
-						__w->_M_color = __x_parent->_M_color;
-						__x_parent->_M_color = _S_rb_tree_black;
+						__w->_M_set_color(__x_parent->_M_get_color());
+						__x_parent->_M_set_color(_S_rb_tree_black);
 						if (__w->_M_left)
-							__w->_M_left->_M_color = _S_rb_tree_black;
-						_Rb_tree_rotate_right(__x_parent, __root);
+							__w->_M_left->_M_set_color(_S_rb_tree_black);
+						_Rb_tree_rotate_right<_Augment>(__x_parent, __root);
 						break;
 					}
 				}
 			}
 			if (__x)
-				__x->_M_color = _S_rb_tree_black;
+				__x->_M_set_color(_S_rb_tree_black);
 		}
 		return __y;
 	}
 
+	// 黑高：从__x到任一空指针的路径上黑节点的个数(含__x自身)
+	inline size_t _Rb_tree_black_height(const _Rb_tree_node_base* __x)
+	{
+		size_t __h = 0;
+		for (; __x != nullptr; __x = __x->_M_left)
+			if (__x->_M_get_color() == _S_rb_tree_black)
+				++__h;
+		return __h;
+	}
+
+	// 以__k为分隔，连接两棵独立的子树__l与__r(__l中的键值均小于__k，__r中的均大于__k)，返回新树的根
+	// __hl、__hr为两棵子树的黑高，新树的黑高存入__h；子树的根的_M_parent均为null，__k原有的链接被忽略
+	// 矮的一棵挂到高的一棵的脊上黑高相等处，再按插入的方式消除连续红节点，O(|__hl - __hr| + 1)
+	template<class _Augment = _Rb_tree_no_augment>
+	inline _Rb_tree_node_base* _Rb_tree_join(_Rb_tree_node_base* __l, size_t __hl, _Rb_tree_node_base* __k,
+											 _Rb_tree_node_base* __r, size_t __hr, size_t& __h)
+	{
+		// 根染黑不破坏红黑树的性质，之后沿脊下降时父节点为红必有祖父节点
+		if (__l != nullptr && __l->_M_get_color() == _S_rb_tree_red)
+		{
+			__l->_M_set_color(_S_rb_tree_black);
+			++__hl;
+		}
+		if (__r != nullptr && __r->_M_get_color() == _S_rb_tree_red)
+		{
+			__r->_M_set_color(_S_rb_tree_black);
+			++__hr;
+		}
+
+		_Rb_tree_node_base* __root;
+		_Rb_tree_node_base* __p = nullptr; // __k的父节点
+		if (__hl > __hr) // 沿__l的右脊下降，找到第一个黑高为__hr的黑节点(或空指针)
+		{
+			__root = __l;
+			_Rb_tree_node_base* __c = __l;
+			for (size_t __hc = __hl; __c != nullptr && !(__c->_M_get_color() == _S_rb_tree_black && __hc == __hr); __c = __c->_M_right)
+			{
+				if (__c->_M_get_color() == _S_rb_tree_black)
+					--__hc;
+				__p = __c;
+			}
+			__p->_M_right = __k;
+			__l = __c;
+			__h = __hl;
+		}
+		else if (__hl < __hr) // 对称地沿__r的左脊下降
+		{
+			__root = __r;
+			_Rb_tree_node_base* __c = __r;
+			for (size_t __hc = __hr; __c != nullptr && !(__c->_M_get_color() == _S_rb_tree_black && __hc == __hl); __c = __c->_M_left)
+			{
+				if (__c->_M_get_color() == _S_rb_tree_black)
+					--__hc;
+				__p = __c;
+			}
+			__p->_M_left = __k;
+			__r = __c;
+			__h = __hr;
+		}
+		else
+		{
+			__root = __k;
+			__h = __hl;
+		}
+
+		__k->_M_set_parent(__p);
+		__k->_M_left = __l;
+		__k->_M_right = __r;
+		if (__l != nullptr)
+			__l->_M_set_parent(__k);
+		if (__r != nullptr)
+			__r->_M_set_parent(__k);
+		__k->_M_set_color(_S_rb_tree_red); // 两侧黑高相等，着红色不改变黑高
+		for (_Rb_tree_node_base* __x = __k; __x != nullptr; __x = __x->_M_get_parent())
+			_Augment::_S_update(__x);
+		if (__p != nullptr && _Rb_tree_insert_fixup<_Augment>(__k, __root))
+			++__h;
+		return __root;
+	}
+
 	// 为了避免基类为空，我们任意
 	// 将rbtree的一个数据成员移动到基类中
-	template<class _Tp, class _Alloc>
+	template<class _Tp, class _Alloc, class _NodeBase = _Rb_tree_node_base>
 	struct _Rb_tree_base
 	{
 		using allocator_type = _Alloc;
@@ -459,31 +670,130 @@ namespace TinySTL
 		~_Rb_tree_base() { _M_put_node(_M_header); }
 
 	protected:
-		_Rb_tree_node<_Tp>* _M_header; // 不存储数据元素,只存储指向根节点,最小节点和最大结点的指针
+		_Rb_tree_node<_Tp, _NodeBase>* _M_header; // 不存储数据元素,只存储指向根节点,最小节点和最大结点的指针
+
+		using _Alloc_type = simple_alloc<_Rb_tree_node<_Tp, _NodeBase>, _Alloc>;
+
+		_Rb_tree_node<_Tp, _NodeBase>* _M_get_node() { return _Alloc_type::allocate(1); }
+		void _M_put_node(_Rb_tree_node<_Tp, _NodeBase>* __p) { _Alloc_type::deallocate(__p, 1); }
+
+		// 一次批量分配__n个节点，以_S_chain_next串起
+		_Rb_tree_node<_Tp, _NodeBase>* _M_get_nodes(size_t __n) { return _Alloc_type::allocate_chain(__n); }
+		static _Rb_tree_node<_Tp, _NodeBase>* _S_chain_next(_Rb_tree_node<_Tp, _NodeBase>* __p) { return _Alloc_type::chain_next(__p); }
+		void _M_put_chain(_Rb_tree_node<_Tp, _NodeBase>* __p) // 逐个归还链表中未使用的节点
+		{
+			while (__p != nullptr)
+			{
+				_Rb_tree_node<_Tp, _NodeBase>* __next = _S_chain_next(__p);
+				_M_put_node(__p);
+				__p = __next;
+			}
+		}
+	};
+
+	/*
+	* ***********************************
+	* _Rb_tree_node_handle : 由extract取出的节点
+	* ***********************************
+	* 独占一个已从树中解除链接、但元素仍然有效的节点，只能移动不能复制；析构时销毁元素并归还节点
+	* 可以修改其中元素的键值后重新插入，整个过程不分配也不释放内存
+	*/
+	template<class _Value, class _Alloc, class _NodeBase = _Rb_tree_node_base>
+	class _Rb_tree_node_handle
+	{
+		template<class, class, class, class, class, class> friend class _Rb_tree;
+
+		using _Link_type  = _Rb_tree_node<_Value, _NodeBase>*;
+		using _Alloc_type = simple_alloc<_Rb_tree_node<_Value, _NodeBase>, _Alloc>;
+
+	public:
+		using value_type     = _Value;
+		using allocator_type = _Alloc;
+
+	public:
+		_Rb_tree_node_handle() : _M_ptr(nullptr) {}
+		_Rb_tree_node_handle(_Rb_tree_node_handle&& __x) : _M_ptr(__x._M_ptr) { __x._M_ptr = nullptr; }
+		_Rb_tree_node_handle& operator=(_Rb_tree_node_handle&& __x)
+		{
+			if (this != &__x)
+			{
+				_M_reset();
+				_M_ptr = __x._M_release();
+			}
+			return *this;
+		}
+		_Rb_tree_node_handle(const _Rb_tree_node_handle&) = delete;
+		_Rb_tree_node_handle& operator=(const _Rb_tree_node_handle&) = delete;
+		~_Rb_tree_node_handle() { _M_reset(); }
+
+	public:
+		bool empty() const { return _M_ptr == nullptr; }
+		explicit operator bool() const { return _M_ptr != nullptr; }
+		allocator_type get_allocator() const { return allocator_type(); }
+
+		// set使用：元素即键值
+		value_type& value() const { return _M_ptr->_M_value_field; }
+		// map使用：元素为pair<const Key, T>，节点已不在树中，因此允许修改键值
+		template<class _V = _Value>
+		typename TinySTL::remove_cv<typename _V::first_type>::type& key() const
+		{
+			return const_cast<typename TinySTL::remove_cv<typename _V::first_type>::type&>(_M_ptr->_M_value_field.first);
+		}
+		template<class _V = _Value>
+		typename _V::second_type& mapped() const { return _M_ptr->_M_value_field.second; }
+
+		void swap(_Rb_tree_node_handle& __x) { TinySTL::swap(_M_ptr, __x._M_ptr); }
+
+	private:
+		explicit _Rb_tree_node_handle(_Link_type __p) : _M_ptr(__p) {}
+
+		_Link_type _M_release()
+		{
+			_Link_type __p = _M_ptr;
+			_M_ptr = nullptr;
+			return __p;
+		}
+		void _M_reset()
+		{
+			if (_M_ptr != nullptr)
+			{
+				destroy(&_M_ptr->_M_value_field);
+				_Alloc_type::deallocate(_M_ptr, 1);
+				_M_ptr = nullptr;
+			}
+		}
 
-		using _Alloc_type = simple_alloc<_Rb_tree_node<_Tp>, _Alloc>;
+	private:
+		_Link_type _M_ptr;
+	};
 
-		_Rb_tree_node<_Tp>* _M_get_node() { return _Alloc_type::allocate(1); }
-		void _M_put_node(_Rb_tree_node<_Tp>* __p) { _Alloc_type::deallocate(__p, 1); }
+	// insert(node_type&&)的返回值：插入失败时node仍持有该节点，position指向键值重复的元素
+	template<class _Iterator, class _NodeHandle>
+	struct _Rb_tree_insert_return
+	{
+		_Iterator   position;
+		bool        inserted;
+		_NodeHandle node;
 	};
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc = TinySTL::alloc>
-	class _Rb_tree : protected _Rb_tree_base<_Value, _Alloc>
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc = TinySTL::alloc, class _Augment = _Rb_tree_no_augment>
+	class _Rb_tree : protected _Rb_tree_base<_Value, _Alloc, typename _Augment::_Node_base>
 	{
-		using _Base           = _Rb_tree_base<_Value, _Alloc>;
+		using _Node_base      = typename _Augment::_Node_base;
+		using _Base           = _Rb_tree_base<_Value, _Alloc, _Node_base>;
 
 	protected:
 		using _Base_ptr       = _Rb_tree_node_base*;
-		using _Rb_tree_node   = _Rb_tree_node<_Value>;
+		using _Rb_tree_node   = _Rb_tree_node<_Value, _Node_base>;
 		using _Color_type     = _Rb_tree_color_type;
 
 	public:
 		using key_type        = _Key;
 		using value_type      = _Value;
 		using pointer         = value_type*;
-		using const_pointer   = const pointer;
+		using const_pointer   = const value_type*;
 		using reference       = value_type&;
-		using const_reference = const reference;
+		using const_reference = const value_type&;
 		using _Link_type      = _Rb_tree_node*;
 		using size_type       = size_t;
 		using difference_type = ptrdiff_t;
@@ -494,6 +804,9 @@ namespace TinySTL
 	protected:
 		using _Base::_M_get_node;
 		using _Base::_M_put_node;
+		using _Base::_M_get_nodes;
+		using _Base::_S_chain_next;
+		using _Base::_M_put_chain;
 		using _Base::_M_header;
 
 	protected:
@@ -507,6 +820,7 @@ namespace TinySTL
 			catch (...)
 			{
 				_M_put_node(__tmp);
+				throw;
 			}
 
 			return __tmp;
@@ -515,9 +829,10 @@ namespace TinySTL
 		_Link_type _M_clone_node(_Link_type __x) // 克隆一个节点
 		{
 			_Link_type __tmp = _M_create_node(__x->_M_value_field);
-			__tmp->_M_color = __x->_M_color;
+			__tmp->_M_set_color(__x->_M_get_color());
 			__tmp->_M_left = nullptr;
 			__tmp->_M_right = nullptr;
+			_Augment::_S_copy(__tmp, __x); // 复制后的子树结构与原子树相同
 			return __tmp;
 		}
 
@@ -531,9 +846,14 @@ namespace TinySTL
 		size_type _M_node_count; // 追踪记录树的大小（节点数量）
 		_Compare _M_key_compare; // 节点间的键值大小比较标准 function object
 
-		_Link_type& _M_root() const // _M_header和_M_root互为父节点
+		_Link_type _M_root() const // _M_header和_M_root互为父节点
+		{
+			return (_Link_type)_M_header->_M_get_parent();
+		}
+
+		void _M_set_root(_Base_ptr __x)
 		{
-			return (_Link_type&)(_M_header->_M_parent);
+			_M_header->_M_set_parent(__x);
 		}
 
 		_Link_type& _M_leftmost() const // _M_header->_M_left指向最小值,即最左端结点
@@ -556,9 +876,9 @@ namespace TinySTL
 			return (_Link_type&)(__x->_M_right);
 		}
 
-		static _Link_type& _S_parent(_Link_type __x)
+		static _Link_type _S_parent(_Link_type __x)
 		{
-			return (_Link_type&)(__x->_M_parent);
+			return (_Link_type)__x->_M_get_parent();
 		}
 
 		static reference _S_value(_Link_type __x)
@@ -571,9 +891,9 @@ namespace TinySTL
 			return _KeyOfValue()(_S_value(__x));
 		}
 
-		static _Color_type& _S_color(_Link_type __x)
+		static _Color_type _S_color(_Link_type __x)
 		{
-			return (_Color_type&)(__x->_M_color);
+			return __x->_M_get_color();
 		}
 
 		static _Link_type& _S_left(_Base_ptr __x)
@@ -586,9 +906,9 @@ namespace TinySTL
 			return (_Link_type&)(__x->_M_right);
 		}
 
-		static _Link_type& _S_parent(_Base_ptr __x)
+		static _Link_type _S_parent(_Base_ptr __x)
 		{
-			return (_Link_type&)(__x->_M_parent);
+			return (_Link_type)__x->_M_get_parent();
 		}
 
 		static reference _S_value(_Base_ptr __x)
@@ -601,9 +921,9 @@ namespace TinySTL
 			return _KeyOfValue()(_S_value((_Link_type)__x));
 		}
 
-		static _Color_type& _S_color(_Base_ptr __x)
+		static _Color_type _S_color(_Base_ptr __x)
 		{
-			return (_Color_type&)(((_Link_type)__x)->_M_color);
+			return __x->_M_get_color();
 		}
 
 		static _Link_type _S_minimum(_Link_type __x)
@@ -617,17 +937,119 @@ namespace TinySTL
 		}
 
 	public:
-		using iterator               = _Rb_tree_iterator<value_type, reference, pointer>;
-		using const_iterator         = _Rb_tree_iterator<value_type, const_reference, const_pointer>;
-		using const_reverse_iterator = reverse_iterator<const_iterator>;
-		using reverse_iterator       = reverse_iterator<iterator>;
+		using iterator               = _Rb_tree_iterator<value_type, reference, pointer, _Node_base>;
+		using const_iterator         = _Rb_tree_iterator<value_type, const_reference, const_pointer, _Node_base>;
+		using const_reverse_iterator = TinySTL::reverse_iterator<const_iterator>;
+		using reverse_iterator       = TinySTL::reverse_iterator<iterator>;
+		using node_type              = _Rb_tree_node_handle<_Value, _Alloc, _Node_base>;
+		using insert_return_type     = _Rb_tree_insert_return<iterator, node_type>;
 
 	private:
 		// v为要插入的值，x为要插入的位置，y为x的父节点
 		iterator _M_insert(_Base_ptr __x, _Base_ptr __y, const value_type& __v);
+		// 同上，但链接已有的节点__z，不分配内存
+		iterator _M_link_node(_Base_ptr __x, _Base_ptr __y, _Link_type __z);
+		// 同_M_insert_before，但链接已有的节点__z
+		iterator _M_link_before(iterator __position, _Link_type __z);
+		// 键值为__k的新节点的插入位置(__x, __y)，含义同_M_insert的参数；__y为null表示键值已存在于节点__x
+		TinySTL::pair<_Base_ptr, _Base_ptr> _M_get_insert_unique_pos(const key_type& __k);
+		TinySTL::pair<_Base_ptr, _Base_ptr> _M_get_insert_equal_pos(const key_type& __k);
+		// __position是否恰好为键值__k应插入的位置
+		bool _M_is_unique_hint(iterator __position, const key_type& __k) const;
+		bool _M_is_equal_hint(iterator __position, const key_type& __k) const;
+		// 将节点__z从树中解除链接并调整，但不销毁
+		_Link_type _M_unlink_node(_Base_ptr __z);
 		_Link_type _M_copy(_Link_type __x, _Link_type __p); // 复制__x子树到__P子树
 		void _M_erase(_Link_type __x); // 删除节点x的子树，且不需要rebalance
 
+		template <class InIt>
+		void _M_insert_unique_range(InIt __first, InIt __last, input_iterator_tag);
+		template <class FwdIt>
+		void _M_insert_unique_range(FwdIt __first, FwdIt __last, forward_iterator_tag);
+		template <class InIt>
+		void _M_insert_equal_range(InIt __first, InIt __last, input_iterator_tag);
+		template <class FwdIt>
+		void _M_insert_equal_range(FwdIt __first, FwdIt __last, forward_iterator_tag);
+
+		template <class FwdIt>
+		bool _M_is_sorted(FwdIt __first, FwdIt __last) const; // 键值是否非递减
+		template <class FwdIt>
+		void _M_assign_sorted(FwdIt __first, FwdIt __last, bool __unique);
+		// 按中序消耗以_M_right串起的__n个节点，链接为完全平衡的子树并返回其根
+		// 深度为__red_depth(即未满的最底层)的节点着红色，其余为黑色
+		static _Link_type _S_link_balanced(_Link_type& __cur, size_type __n, size_type __depth, size_type __red_depth);
+
+		// join/split与集合运算均在独立的子树(根的_M_parent为null)上进行，只重新链接节点
+		// 运算中被丢弃的子树以根的_M_parent串起，全部完成后再统一销毁：alloc不是线程安全的
+		struct _Discard_list
+		{
+			_Base_ptr _M_head;
+			_Base_ptr _M_tail;
+			size_type _M_matched; // 两棵树中键值相同的元素对数
+
+			_Discard_list() : _M_head(nullptr), _M_tail(nullptr), _M_matched(0) {}
+			void _M_push(_Base_ptr __x)
+			{
+				__x->_M_set_parent(nullptr);
+				if (_M_tail == nullptr)
+					_M_head = __x;
+				else
+					_M_tail->_M_set_parent(__x);
+				_M_tail = __x;
+			}
+			void _M_splice(_Discard_list& __x)
+			{
+				if (__x._M_head != nullptr)
+				{
+					if (_M_tail == nullptr)
+						_M_head = __x._M_head;
+					else
+						_M_tail->_M_set_parent(__x._M_head);
+					_M_tail = __x._M_tail;
+				}
+				_M_matched += __x._M_matched;
+			}
+		};
+		enum _Set_operation { _S_set_union, _S_set_intersection, _S_set_difference };
+		// 较小一方不少于此规模时才在线程池上并行
+		enum { _S_parallel_threshold = 4096 };
+
+		// 独立子树及其黑高。黑高沿递归传递，使每次join为O(黑高之差 + 1)，不必沿脊重新计算
+		struct _Subtree
+		{
+			_Base_ptr _M_root;
+			size_type _M_bh;
+		};
+		static _Subtree _S_subtree(_Base_ptr __x)
+		{
+			_Subtree __t = { __x, _Rb_tree_black_height(__x) };
+			return __t;
+		}
+		static _Subtree _S_join(_Subtree __l, _Base_ptr __k, _Subtree __r)
+		{
+			_Subtree __t;
+			__t._M_root = _Rb_tree_join<_Augment>(__l._M_root, __l._M_bh, __k, __r._M_root, __r._M_bh, __t._M_bh);
+			return __t;
+		}
+		static _Subtree _S_join2(_Subtree __l, _Subtree __r);          // 无分隔节点的连接
+		static _Base_ptr _S_split_last(_Subtree __t, _Subtree& __rest); // 摘下最大节点，其余部分存入__rest
+		static void _S_expose(_Subtree __t, _Subtree& __l, _Subtree& __r); // 摘下根节点，两个孩子成为独立子树
+
+		_Base_ptr _M_detach_root(); // 取下整棵树并将本树置空
+		void _M_attach_root(_Base_ptr __root, size_type __n);
+		// 按__k把__t拆分为__l(小于__k)与__r(大于__k)，返回键值等于__k的节点(已摘下)或null
+		_Base_ptr _M_split(_Subtree __t, const key_type& __k, _Subtree& __l, _Subtree& __r) const;
+		static _Base_ptr _S_subtree_next(_Base_ptr __x); // 独立子树内的中序后继
+		static void _S_split_sizes(_Base_ptr __l, _Base_ptr __r, size_type __n, size_type& __nl, size_type& __nr, TinySTL::true_type);
+		static void _S_split_sizes(_Base_ptr __l, _Base_ptr __r, size_type __n, size_type& __nl, size_type& __nr, TinySTL::false_type);
+		// __depth为剩余的并行递归层数，为0时串行
+		template<class _F1, class _F2>
+		static void _S_fork(thread_pool* __pool, size_type __depth, _F1 __f1, _F2 __f2);
+		_Subtree _M_union(_Subtree __t1, _Subtree __t2, _Discard_list& __d, thread_pool* __pool, size_type __depth) const;
+		_Subtree _M_intersection(_Subtree __t1, _Subtree __t2, _Discard_list& __d, thread_pool* __pool, size_type __depth) const;
+		_Subtree _M_difference(_Subtree __t1, _Subtree __t2, _Discard_list& __d, thread_pool* __pool, size_type __depth) const;
+		void _M_set_operation(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x, _Set_operation __op, thread_pool* __pool);
+
 	public:
 		// 构造函数和析构函数
 		_Rb_tree() : _Base(allocator_type()), _M_node_count(0), _M_key_compare()  // base类构造时会创建_M_header
@@ -646,15 +1068,15 @@ namespace TinySTL
 		}
 
 		// 拷贝构造函数
-		_Rb_tree(const _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>& __x) :
+		_Rb_tree(const _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x) :
 			_Base(__x.get_allocator()), _M_node_count(__x._M_node_count), _M_key_compare(__x._M_key_compare)
 		{
 			if (__x._M_root() == nullptr)
 				_M_empty_initialize();
 			else
 			{
-				_S_color(_M_header) = _S_rb_tree_red;
-				_M_root() = _M_copy(__x._M_root(), _M_header);
+				_M_header->_M_set_color(_S_rb_tree_red);
+				_M_set_root(_M_copy(__x._M_root(), _M_header));
 				_M_leftmost() = _S_minimum(_M_root());
 				_M_rightmost() = _S_maximum(_M_root());
 			}
@@ -665,14 +1087,14 @@ namespace TinySTL
 			clear();
 		}
 
-		_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>&
-		operator=(const _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>& __x);
+		_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>&
+		operator=(const _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x);
 
 	private:
 		void _M_empty_initialize() // 空树的构建
 		{
-			_S_color(_M_header) = _S_rb_tree_red; // 令header为红色，用来区分header和root（在iterator.operator++中）
-			_M_root() = nullptr;
+			_M_header->_M_set_color(_S_rb_tree_red); // 令header为红色，用来区分header和root（在iterator.operator++中）
+			_M_set_root(nullptr);
 			_M_leftmost() = _M_header;  // 令header的左子节点为自己
 			_M_rightmost() = _M_header; // 令header的右子节点为自己
 		}
@@ -684,13 +1106,13 @@ namespace TinySTL
 		iterator end() { return _M_header; }
 		const_iterator end() const { return _M_header; }
 		reverse_iterator rbegin() { return reverse_iterator(end()); }
-		const_reverse_iterator rbegin() const { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
 		reverse_iterator rend() { return reverse_iterator(begin()); }
-		const_reverse_iterator rend() const { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
 		bool empty() const { return _M_node_count == 0; }
 		size_type size() const { return _M_node_count; }
 		size_type max_size() const { return size_type(-1); }
-		void swap(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>& __x)
+		void swap(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x)
 		{
 			TinySTL::swap(_M_header, __x._M_header);
 			TinySTL::swap(_M_node_count, __x._M_node_count);
@@ -719,17 +1141,64 @@ namespace TinySTL
 		template <class InIt>
 		void insert_equal(InIt __first, InIt __last);
 
-		void erase(iterator __position);
+		// [__first, __last)须已按键值非递减排序：清空后以O(n)建立一棵完全平衡的树，
+		// 节点一次批量分配，不做任何旋转。_unique版本对相邻的重复键值只保留第一个
+		// 空树上的区间插入若检测到前向迭代器区间已排序，也会走这条路径
+		template <class FwdIt>
+		void assign_sorted_unique(FwdIt __first, FwdIt __last) { _M_assign_sorted(__first, __last, true); }
+		template <class FwdIt>
+		void assign_sorted_equal(FwdIt __first, FwdIt __last) { _M_assign_sorted(__first, __last, false); }
+
+		// 调用者保证__v的键值恰好应位于__position之前(例如__position来自lower_bound)，
+		// 直接在__position左侧的空位或其前驱的右侧空位插入，不再从根节点查找
+		iterator _M_insert_before(iterator __position, const value_type& __v);
+
+		// 节点操作：extract解除节点与树的链接但不释放，_M_reinsert_*将其重新链接，
+		// _M_merge_*把__src中的节点直接移入本树(_unique版本跳过键值已存在的节点，它们留在__src中)
+		node_type extract(iterator __position);
+		node_type extract(const key_type& __k);
+		insert_return_type _M_reinsert_node_unique(node_type&& __nh);
+		iterator _M_reinsert_node_equal(node_type&& __nh);
+		iterator _M_reinsert_node_hint_unique(iterator __hint, node_type&& __nh);
+		iterator _M_reinsert_node_hint_equal(iterator __hint, node_type&& __nh);
+		void _M_merge_unique(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __src);
+		void _M_merge_equal(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __src);
+
+		// 以下join/split与集合运算要求键值唯一、比较函数不抛出异常，参与的树互不相同
+		// 它们只在树之间移动节点，不复制元素；除join需要为__v分配一个节点外，不分配内存
+		// 清空*this后，以__v连接__left与__right(__left的键值均小于__v，__right的均大于__v)，二者被置空。O(log n)
+		void join(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __left, const value_type& __v,
+				  _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __right);
+		// 同上，但没有分隔元素(__left的键值均小于__right)
+		void join(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __left,
+				  _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __right);
+		// 清空__left与__right后，把*this中键值小于__k的元素移入__left、大于__k的移入__right，*this被置空，
+		// 键值等于__k的元素以node_type返回。O(log n)；未启用顺序统计时，统计两侧大小另需O(较小一侧的大小)
+		node_type split(const key_type& __k, _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __left,
+						_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __right);
+
+		// *this与__x的并、交、差，结果存于*this，__x被置空；键值相同时保留*this中的元素
+		// 设m、n为两树中较小、较大一方的大小，工作量为O(m log(n/m + 1))
+		// 较小一方达到_S_parallel_threshold时，在__pool(默认为thread_pool::default_pool())上并行递归
+		void union_(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x) { _M_set_operation(__x, _S_set_union, nullptr); }
+		void union_(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x, thread_pool& __pool) { _M_set_operation(__x, _S_set_union, &__pool); }
+		void intersection(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x) { _M_set_operation(__x, _S_set_intersection, nullptr); }
+		void intersection(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x, thread_pool& __pool) { _M_set_operation(__x, _S_set_intersection, &__pool); }
+		void difference(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x) { _M_set_operation(__x, _S_set_difference, nullptr); }
+		void difference(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x, thread_pool& __pool) { _M_set_operation(__x, _S_set_difference, &__pool); }
+
+		// 返回被删除节点的后继
+		iterator erase(iterator __position);
 		size_type erase(const key_type& __x);
 		void erase(iterator __first, iterator __last);
-		void erase(const key_type& __first, const key_type& __last);
+		void erase(const key_type* __first, const key_type* __last);
 
 		void clear() // 将树清空
 		{
 			if (_M_node_count != 0)
 			{
 				_M_erase(_M_root());
-				_M_root() = nullptr;
+				_M_set_root(nullptr);
 				_M_leftmost() = _M_header;
 				_M_rightmost() = _M_header;
 				_M_node_count = 0;
@@ -747,30 +1216,54 @@ namespace TinySTL
 		pair<iterator,iterator> equal_range(const key_type& __k);
 		pair<const_iterator,const_iterator> equal_range(const key_type& __k) const;
 
+	public:
+		// 顺序统计，均为O(log n)，要求_Augment为_Rb_tree_rank_augment
+		iterator select(size_type __k);             // 第__k小(从0开始)的元素，__k >= size()时返回end()
+		const_iterator select(size_type __k) const;
+		size_type rank(const key_type& __k) const;  // 键值小于__k的元素个数，即lower_bound(__k)的位置
+		size_type index_of(const_iterator __position) const; // __position的位置，end()的位置为size()
+		difference_type distance(const_iterator __first, const_iterator __last) const
+		{
+			return static_cast<difference_type>(index_of(__last)) - static_cast<difference_type>(index_of(__first));
+		}
+
 	public:
 		// 验证该RB-tree是否合法
 		bool __rb_verify() const;
+
+	private:
+		static bool _M_verify_augment(_Link_type __x, TinySTL::true_type);
+		static bool _M_verify_augment(_Link_type, TinySTL::false_type) { return true; }
+		static bool _M_verify_augment(_Link_type __x)
+		{
+			return _M_verify_augment(__x, TinySTL::bool_constant<_Augment::_S_has_rank>());
+		}
 	};
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::iterator
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::_M_insert(_Base_ptr __x_, _Base_ptr __y_, const value_type& __v)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_insert(_Base_ptr __x, _Base_ptr __y, const value_type& __v)
+	{
+		return _M_link_node(__x, __y, _M_create_node(__v));
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_link_node(_Base_ptr __x_, _Base_ptr __y_, _Link_type __z)
 	{
 		_Link_type __x = (_Link_type)__x_; // x为要插入的位置
 		_Link_type __y = (_Link_type)__y_; // y为x的父节点
-		_Link_type __z;
 
 		// key_compare是键值大小比较准则，是个function object（仿函数）
 		// __y == _M_header：插入位置为root
 		// __x != nullptr： 插入位置为null节点
-		// _M_key_compare(_KeyOfValue()(__v), _S_key(__y))：插入点为其父节点的左子节点
-		if (__y == _M_header || __x != nullptr || _M_key_compare(_KeyOfValue()(__v), _S_key(__y)))
+		// _M_key_compare(_S_key(__z), _S_key(__y))：插入点为其父节点的左子节点
+		if (__y == _M_header || __x != nullptr || _M_key_compare(_S_key(__z), _S_key(__y)))
 		{
-			__z = _M_create_node(__v); // 产生一个新节点
 			_S_left(__y) = __z; // 这使得当y即为header时，leftmost() = z
 			if (__y == _M_header)
 			{
-				_M_root() = __z;
+				_M_set_root(__z);
 				_M_rightmost() = __z;
 			}
 			else if (__y == _M_leftmost()) // 如果y为最右节点
@@ -778,27 +1271,28 @@ namespace TinySTL
 		}
 		else
 		{
-			__z = _M_create_node(__v); // 产生一个新节点
 			_S_right(__y) = __z; // 令新节点成为插入点之父节点y的右子节点
 			if (__y == _M_rightmost())
 				_M_rightmost() = __z; // 维护rightmost()，使它永远指向最右节点
 		}
-		_S_parent(__z) = __y;    // 设定新节点的父节点
+		__z->_M_set_parent(__y); // 设定新节点的父节点
 		_S_left(__z) = nullptr;  // 设定新节点的左子节点
 		_S_right(__z) = nullptr; // 设定新节点的有子节点
-		_Rb_tree_rebalance(__z, _M_header->_M_parent);
+		_Base_ptr __root = _M_root();
+		_Rb_tree_rebalance<_Augment>(__z, __root);
+		_M_set_root(__root);
 		++_M_node_count;
 		return iterator(__z); // 返回一个迭代器，指向新增节点
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::_Link_type 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::_M_copy(_Link_type __x, _Link_type __p)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Link_type 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_copy(_Link_type __x, _Link_type __p)
 	{
 		// 整棵树所有的右子树都递归复制,所有的左子树都直接复制
 		// structural copy.  __x and __p must be non-null	
 		_Link_type __top = _M_clone_node(__x);
-		__top->_M_parent = __p;
+		__top->_M_set_parent(__p);
 		try
 		{
 			if (__x->_M_right)
@@ -810,7 +1304,7 @@ namespace TinySTL
 			{
 				_Link_type __y = _M_clone_node(__x);
 				__p->_M_left = __y;
-				__y->_M_parent = __p;
+				__y->_M_set_parent(__p);
 				if (__x->_M_right)
 					__y->_M_right = _M_copy(_S_right(__x), __y); // 继续递归复制右子树
 				__p = __y;
@@ -820,12 +1314,13 @@ namespace TinySTL
 		catch (...)
 		{
 			_M_erase(__top);
+			throw;
 		}
 		return __top;
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::_M_erase(_Link_type __x)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_erase(_Link_type __x)
 	{
 		while (__x != nullptr)
 		{
@@ -837,25 +1332,25 @@ namespace TinySTL
 		}
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>& 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::
-	operator=(const _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>& __x)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::
+	operator=(const _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x)
 	{
-		if (*this != __x)
+		if (this != &__x)
 		{
 			clear(); // 先将需要赋值的树清空
 			_M_node_count = 0;
 			_M_key_compare = __x._M_key_compare; // 比较函数赋值
 			if (__x._M_root() == nullptr)
 			{
-				_M_root() = nullptr;
+				_M_set_root(nullptr);
 				_M_leftmost() = _M_header;
 				_M_rightmost() = _M_header;
 			}
 			else
 			{
-				_M_root() = _M_copy(__x._M_root(), _M_header); // 复制整棵树
+				_M_set_root(_M_copy(__x._M_root(), _M_header)); // 复制整棵树
 				_M_leftmost() = _S_minimum(_M_root());
 				_M_rightmost() = _S_maximum(_M_root());
 				_M_node_count = __x._M_node_count;
@@ -864,9 +1359,28 @@ namespace TinySTL
 		return *this;
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline TinySTL::pair<typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::iterator, bool>
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::insert_unique(const value_type& __v)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline TinySTL::pair<typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator, bool>
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::insert_unique(const value_type& __v)
+	{
+		TinySTL::pair<_Base_ptr, _Base_ptr> __p = _M_get_insert_unique_pos(_KeyOfValue()(__v));
+		if (__p.second != nullptr)
+			return TinySTL::pair<iterator, bool>(_M_insert(__p.first, __p.second, __v), true);
+		// 到这里，表示新值一定与树中键值重复，不插入新值
+		return TinySTL::pair<iterator, bool>(iterator((_Link_type)__p.first), false);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::insert_equal(const value_type& __v)
+	{
+		TinySTL::pair<_Base_ptr, _Base_ptr> __p = _M_get_insert_equal_pos(_KeyOfValue()(__v));
+		return _M_insert(__p.first, __p.second, __v);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline TinySTL::pair<typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Base_ptr, typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Base_ptr>
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_get_insert_unique_pos(const key_type& __k)
 	{
 		_Link_type __y = _M_header;
 		_Link_type __x = _M_root(); // 从根节点开始
@@ -874,8 +1388,8 @@ namespace TinySTL
 		while (__x != nullptr) // 从根节点开始，往下寻找适当的插入点
 		{
 			__y = __x;
-			__comp = _M_key_compare(_KeyOfValue()(__v), _S_key(__x)); // v键值小于目前节点的键值
-			// v小于x的键值时向左子树移动,否则向右子树移动,因此,如果已有重复
+			__comp = _M_key_compare(__k, _S_key(__x)); // k小于目前节点的键值
+			// k小于x的键值时向左子树移动,否则向右子树移动,因此,如果已有重复
 			// 键值存在,x最终一定位于重复键值所在节点的右子树
 			__x = __comp ? _S_left(__x) : _S_right(__x);
 		}
@@ -884,35 +1398,34 @@ namespace TinySTL
 		if (__comp) // 如果离开while循环时comp为true，表示插入点是其父节点的左孩子
 		{
 			if (__j == begin()) // 如果插入点的父节点为最左节点
-				return TinySTL::pair<iterator, bool>(_M_insert(__x, __y, __v), true);
+				return TinySTL::pair<_Base_ptr, _Base_ptr>(__x, __y);
 			else // 否者，插入点的父节点不为最左节点
 				--__j; // 得到其父节点的直接前驱结点,若插入x,即x成为的直接前驱结点
 					   // 调整j，回头准备测试
 		}
-		if (_M_key_compare(_S_key(__j._M_node), _KeyOfValue()(__v))) // 插入点的父节点的直接前驱结点小于插入新值
-			return TinySTL::pair<iterator, bool>(_M_insert(__x, __y, __v), true); // 此时，j为插入x后，x的直接前驱结点
-		
-		// 到这里，表示新值一定与树中键值重复，不插入新值
-		return TinySTL::pair<iterator, bool>(__j, false);
+		if (_M_key_compare(_S_key(__j._M_node), __k)) // 插入点的父节点的直接前驱结点小于新键值
+			return TinySTL::pair<_Base_ptr, _Base_ptr>(__x, __y); // 此时，j为插入x后，x的直接前驱结点
+
+		return TinySTL::pair<_Base_ptr, _Base_ptr>(__j._M_node, nullptr);
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::iterator 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::insert_equal(const value_type& __v)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline TinySTL::pair<typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Base_ptr, typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Base_ptr>
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_get_insert_equal_pos(const key_type& __k)
 	{
 		_Link_type __y = _M_header;
 		_Link_type __x = _M_root(); // 从根节点开始
 		while (__x != nullptr) // 寻找合适的插入点（一定为null），同时记录插入点的父节点
 		{
 			__y = __x;
-			__x = _M_key_compare(_KeyOfValue()(__v), _S_key(__x)) ? _S_left(__x) : _S_right(__x);
+			__x = _M_key_compare(__k, _S_key(__x)) ? _S_left(__x) : _S_right(__x);
 		}
-		return _M_insert(__x, __y, __v);
+		return TinySTL::pair<_Base_ptr, _Base_ptr>(__x, __y);
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::iterator 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::insert_unique(iterator __position, const value_type& __v)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::insert_unique(iterator __position, const value_type& __v)
 	{
 		if (__position._M_node == _M_header->_M_left) // begin()，__position为最左端
 		{
@@ -926,8 +1439,8 @@ namespace TinySTL
 		else if (__position._M_node == _M_header) // end()
 		{
 			if (_M_key_compare(_S_key(_M_rightmost()), _KeyOfValue()(__v)))
-			{
-				return _M_insert(0, __position._M_node, __v);
+			{	// 成为最右节点的右孩子
+				return _M_insert(0, _M_rightmost(), __v);
 			}
 			else
 				return insert_unique(__v).first;
@@ -948,9 +1461,9 @@ namespace TinySTL
 				return insert_unique(__v).first;
 		}
 	}
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::iterator
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::insert_equal(iterator __position, const value_type& __v)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::insert_equal(iterator __position, const value_type& __v)
 	{
 		if (__position._M_node == _M_header->_M_left)   // begin()
 		{
@@ -985,20 +1498,169 @@ namespace TinySTL
 		}	
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::erase(iterator __position)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_insert_before(iterator __position, const value_type& __v)
+	{
+		return _M_link_before(__position, _M_create_node(__v));
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_link_before(iterator __position, _Link_type __z)
 	{
-		_Link_type __y = (_Link_type)_Rb_tree_rebalance_for_erase(__position._M_node,
-																  _M_header->_M_parent,
+		if (__position._M_node == _M_header) // end()：成为最右节点的右孩子(空树时成为根节点)
+			return _M_link_node(nullptr, _M_node_count == 0 ? _M_header : _M_rightmost(), __z);
+		if (__position._M_node->_M_left == nullptr) // 成为__position的左孩子，第一个参数只需非null
+			return _M_link_node(__position._M_node, __position._M_node, __z);
+		iterator __before = __position; // __position有左子树，其前驱必无右孩子
+		--__before;
+		return _M_link_node(nullptr, __before._M_node, __z);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline bool _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_is_unique_hint(iterator __position, const key_type& __k) const
+	{
+		if (__position._M_node != _M_header && !_M_key_compare(__k, _S_key(__position._M_node)))
+			return false;
+		if (__position._M_node == _M_header->_M_left) // begin()
+			return true;
+		iterator __before = __position;
+		--__before;
+		return _M_key_compare(_S_key(__before._M_node), __k);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline bool _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_is_equal_hint(iterator __position, const key_type& __k) const
+	{
+		if (__position._M_node != _M_header && _M_key_compare(_S_key(__position._M_node), __k))
+			return false;
+		if (__position._M_node == _M_header->_M_left) // begin()
+			return true;
+		iterator __before = __position;
+		--__before;
+		return !_M_key_compare(__k, _S_key(__before._M_node));
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::erase(iterator __position)
+	{
+		iterator __next = __position;
+		++__next;
+		destroy_node(_M_unlink_node(__position._M_node));
+		return __next;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Link_type
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_unlink_node(_Base_ptr __z)
+	{
+		_Base_ptr __root = _M_root();
+		_Link_type __y = (_Link_type)_Rb_tree_rebalance_for_erase<_Augment>(__z,
+																  __root,
 																  _M_header->_M_left,
 																  _M_header->_M_right);
-		destroy_node(__y);
+		_M_set_root(__root);
 		--_M_node_count;
+		return __y;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::node_type
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::extract(iterator __position)
+	{
+		return node_type(_M_unlink_node(__position._M_node));
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::node_type
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::extract(const key_type& __k)
+	{
+		iterator __position = find(__k);
+		if (__position == end())
+			return node_type();
+		return extract(__position);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::insert_return_type
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_reinsert_node_unique(node_type&& __nh)
+	{
+		if (__nh.empty())
+			return insert_return_type{ end(), false, node_type() };
+		TinySTL::pair<_Base_ptr, _Base_ptr> __p = _M_get_insert_unique_pos(_KeyOfValue()(__nh.value()));
+		if (__p.second == nullptr) // 键值已存在，节点留在__nh中返回
+			return insert_return_type{ iterator((_Link_type)__p.first), false, std::move(__nh) };
+		iterator __it = _M_link_node(__p.first, __p.second, __nh._M_release());
+		return insert_return_type{ __it, true, node_type() };
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::size_type 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::erase(const key_type& __x)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_reinsert_node_equal(node_type&& __nh)
+	{
+		if (__nh.empty())
+			return end();
+		TinySTL::pair<_Base_ptr, _Base_ptr> __p = _M_get_insert_equal_pos(_KeyOfValue()(__nh.value()));
+		return _M_link_node(__p.first, __p.second, __nh._M_release());
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_reinsert_node_hint_unique(iterator __hint, node_type&& __nh)
+	{
+		if (__nh.empty())
+			return end();
+		if (_M_is_unique_hint(__hint, _KeyOfValue()(__nh.value())))
+			return _M_link_before(__hint, __nh._M_release());
+		TinySTL::pair<_Base_ptr, _Base_ptr> __p = _M_get_insert_unique_pos(_KeyOfValue()(__nh.value()));
+		if (__p.second == nullptr) // 键值已存在，节点仍留在__nh中
+			return iterator((_Link_type)__p.first);
+		return _M_link_node(__p.first, __p.second, __nh._M_release());
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_reinsert_node_hint_equal(iterator __hint, node_type&& __nh)
+	{
+		if (__nh.empty())
+			return end();
+		if (_M_is_equal_hint(__hint, _KeyOfValue()(__nh.value())))
+			return _M_link_before(__hint, __nh._M_release());
+		return _M_reinsert_node_equal(std::move(__nh));
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_merge_unique(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __src)
+	{
+		if (this == &__src)
+			return;
+		for (iterator __i = __src.begin(); __i != __src.end(); )
+		{
+			iterator __cur = __i++;
+			TinySTL::pair<_Base_ptr, _Base_ptr> __p = _M_get_insert_unique_pos(_S_key(__cur._M_node));
+			if (__p.second != nullptr)
+				_M_link_node(__p.first, __p.second, __src._M_unlink_node(__cur._M_node));
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_merge_equal(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __src)
+	{
+		if (this == &__src)
+			return;
+		for (iterator __i = __src.begin(); __i != __src.end(); )
+		{
+			iterator __cur = __i++;
+			TinySTL::pair<_Base_ptr, _Base_ptr> __p = _M_get_insert_equal_pos(_S_key(__cur._M_node));
+			_M_link_node(__p.first, __p.second, __src._M_unlink_node(__cur._M_node));
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::size_type 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::erase(const key_type& __x)
 	{
 		TinySTL::pair<iterator, iterator> __p = equal_range(__x);
 		size_type __n = static_cast<size_type>(TinySTL::distance(__p.first, __p.second));
@@ -1006,32 +1668,29 @@ namespace TinySTL
 		return __n;
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::erase(iterator __first, iterator __last)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::erase(iterator __first, iterator __last)
 	{
 		if (__first == begin() && __last == end())
 			clear();
 		else
 			while (__first != __last)
-			{
-				erase(__first);
-				++__first;
-			}
+				__first = erase(__first); // 先取得后继再删除，避免使用已失效的迭代器
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::erase(const key_type& __first, const key_type& __last)
-	{
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::erase(const key_type* __first, const key_type* __last)
+	{	// 逐个删除[__first, __last)中的每个键值
 		while (__first != __last)
 			erase(*__first++);
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::iterator
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::find(const key_type& __k)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::find(const key_type& __k)
 	{
 		_Link_type __y = _M_header; // Last node which is not less than __k
-		_Link_type __x = _M_root;   // current node
+		_Link_type __x = _M_root(); // current node
 
 		while (__x != nullptr)
 		{
@@ -1050,12 +1709,12 @@ namespace TinySTL
 		return (__j == end() || _M_key_compare(__k, _S_key(__j._M_node))) ? end() : __j;
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::const_iterator 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::find(const key_type& __k) const
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::const_iterator 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::find(const key_type& __k) const
 	{
 		_Link_type __y = _M_header; // Last node which is not less than __k
-		_Link_type __x = _M_root;   // current node
+		_Link_type __x = _M_root(); // current node
 
 		while (__x != nullptr)
 		{
@@ -1074,19 +1733,19 @@ namespace TinySTL
 		return (__j == end() || _M_key_compare(__k, _S_key(__j._M_node))) ? end() : __j;
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::size_type
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::count(const key_type& __k) const
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::size_type
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::count(const key_type& __k) const
 	{
 		pair<const_iterator, const_iterator> __p = equal_range(__k);
-		size_type __n = static_cast<size_type>(distance(__p.first, __p.second));
+		size_type __n = static_cast<size_type>(TinySTL::distance(__p.first, __p.second));
 		
 		return __n;
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::iterator 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::lower_bound(const key_type& __k)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::lower_bound(const key_type& __k)
 	{
 		_Link_type __y = _M_header;
 		_Link_type __x = _M_root();
@@ -1105,9 +1764,9 @@ namespace TinySTL
 		return iterator(__y);
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::const_iterator
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::lower_bound(const key_type& __k) const
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::const_iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::lower_bound(const key_type& __k) const
 	{
 		_Link_type __y = _M_header;
 		_Link_type __x = _M_root();
@@ -1126,16 +1785,16 @@ namespace TinySTL
 		return const_iterator(__y);
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::iterator 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::upper_bound(const key_type& __k)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::upper_bound(const key_type& __k)
 	{
 		_Link_type __y = _M_header;
 		_Link_type __x = _M_root();
 
-		while (__k != nullptr)
+		while (__x != nullptr)
 		{
-			if (_M_key_compare(__k, _S_key())) // k小于x的键值
+			if (_M_key_compare(__k, _S_key(__x))) // k小于x的键值
 			{
 				__y = __x;
 				__x = _S_left(__x);
@@ -1147,16 +1806,16 @@ namespace TinySTL
 		return iterator(__y);
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::const_iterator 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::upper_bound(const key_type& __k) const
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::const_iterator 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::upper_bound(const key_type& __k) const
 	{
 		_Link_type __y = _M_header;
 		_Link_type __x = _M_root();
 
-		while (__k != nullptr)
+		while (__x != nullptr)
 		{
-			if (_M_key_compare(__k, _S_key())) // k小于x的键值
+			if (_M_key_compare(__k, _S_key(__x))) // k小于x的键值
 			{
 				__y = __x;
 				__x = _S_left(__x);
@@ -1168,38 +1827,577 @@ namespace TinySTL
 		return const_iterator(__y);
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline pair<typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::iterator,
-				typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::iterator> 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::equal_range(const key_type& __k)
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline pair<typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator,
+				typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator> 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::equal_range(const key_type& __k)
 	{
 		return pair<iterator, iterator>(lower_bound(__k), upper_bound(__k));
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline pair<typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::const_iterator, 
-				typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::const_iterator> 
-	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::equal_range(const key_type& __k) const
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline pair<typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::const_iterator, 
+				typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::const_iterator> 
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::equal_range(const key_type& __k) const
 	{
-		return pair<const_iterator, const_iterator>(lower_bound(__k), lower_bound(__k));
+		return pair<const_iterator, const_iterator>(lower_bound(__k), upper_bound(__k));
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
 	template<class InIt>
-	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::insert_unique(InIt __first, InIt __last)
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::insert_unique(InIt __first, InIt __last)
+	{
+		_M_insert_unique_range(__first, __last, TinySTL::iterator_category(__first));
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	template<class InIt>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::insert_equal(InIt __first, InIt __last)
+	{	
+		_M_insert_equal_range(__first, __last, TinySTL::iterator_category(__first));
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	template<class InIt>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_insert_unique_range(InIt __first, InIt __last, input_iterator_tag)
 	{
 		for (; __first != __last; ++__first)
 			insert_unique(*__first);
 	}
 
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	template<class FwdIt>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_insert_unique_range(FwdIt __first, FwdIt __last, forward_iterator_tag)
+	{
+		if (_M_node_count == 0 && _M_is_sorted(__first, __last))
+			assign_sorted_unique(__first, __last);
+		else
+		{
+			for (; __first != __last; ++__first)
+				insert_unique(*__first);
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
 	template<class InIt>
-	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::insert_equal(InIt __first, InIt __last)
-	{	
-		for ( ; __first != __last; ++__first)
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_insert_equal_range(InIt __first, InIt __last, input_iterator_tag)
+	{
+		for (; __first != __last; ++__first)
 			insert_equal(*__first);
 	}
 
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	template<class FwdIt>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_insert_equal_range(FwdIt __first, FwdIt __last, forward_iterator_tag)
+	{
+		if (_M_node_count == 0 && _M_is_sorted(__first, __last))
+			assign_sorted_equal(__first, __last);
+		else
+		{
+			for (; __first != __last; ++__first)
+				insert_equal(*__first);
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	template<class FwdIt>
+	inline bool _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_is_sorted(FwdIt __first, FwdIt __last) const
+	{
+		if (__first == __last)
+			return true;
+		FwdIt __next = __first;
+		for (++__next; __next != __last; __first = __next, ++__next)
+		{
+			if (_M_key_compare(_KeyOfValue()(*__next), _KeyOfValue()(*__first)))
+				return false;
+		}
+		return true;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	template<class FwdIt>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_assign_sorted(FwdIt __first, FwdIt __last, bool __unique)
+	{
+		clear();
+		size_type __n = TinySTL::distance(__first, __last);
+		if (__n == 0)
+			return;
+
+		// 第一遍：按顺序在批量分配的节点上构造元素，并改以_M_right串起(元素不会覆盖链表所用的首个字段)
+		_Link_type __head = _M_get_nodes(__n);
+		_Link_type __cur = __head;  // 下一个可用的节点
+		_Link_type __tail = nullptr; // 最后一个已构造的节点
+		size_type __m = 0;
+		try
+		{
+			for (; __first != __last; ++__first)
+			{
+				if (__unique && __tail != nullptr && !_M_key_compare(_S_key(__tail), _KeyOfValue()(*__first)))
+					continue; // 重复键值
+				_Link_type __next = _S_chain_next(__cur);
+				construct(&__cur->_M_value_field, *__first);
+				__cur->_M_right = __next;
+				__tail = __cur;
+				__cur = __next;
+				++__m;
+			}
+		}
+		catch (...)
+		{	// 前__m个节点以_M_right串起，__cur起的节点仍为原始链表
+			for (_Link_type __x = __head; __m > 0; --__m)
+			{
+				_Link_type __next = _S_right(__x);
+				destroy_node(__x);
+				__x = __next;
+			}
+			_M_put_chain(__cur);
+			throw;
+		}
+		_M_put_chain(__cur); // 因重复键值而未用到的节点
+
+		// 第二遍：链接为完全平衡的树。__m个节点时前floor(log2(__m + 1))层全满，
+		// 将其着黑色、未满的最底层着红色，则每条路径的黑色节点数相同且不存在相邻的红色节点
+		size_type __red_depth = 0;
+		for (size_type __k = __m + 1; __k > 1; __k >>= 1)
+			++__red_depth;
+		__cur = __head;
+		_M_set_root(_S_link_balanced(__cur, __m, 0, __red_depth));
+		_M_root()->_M_set_parent(_M_header);
+		_M_leftmost() = __head;
+		_M_rightmost() = __tail;
+		_M_node_count = __m;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Link_type
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_S_link_balanced(_Link_type& __cur, size_type __n, size_type __depth, size_type __red_depth)
+	{
+		if (__n == 0)
+			return nullptr;
+		size_type __left_n = (__n - 1) / 2; // 左右子树节点数至多相差1
+		_Link_type __left = _S_link_balanced(__cur, __left_n, __depth + 1, __red_depth);
+		_Link_type __x = __cur;
+		__cur = _S_right(__cur);
+		__x->_M_set_color(__depth == __red_depth ? _S_rb_tree_red : _S_rb_tree_black);
+		__x->_M_left = __left;
+		if (__left != nullptr)
+			__left->_M_set_parent(__x);
+		_Link_type __right = _S_link_balanced(__cur, __n - 1 - __left_n, __depth + 1, __red_depth);
+		__x->_M_right = __right;
+		if (__right != nullptr)
+			__right->_M_set_parent(__x);
+		_Augment::_S_update(__x);
+		return __x;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::const_iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::select(size_type __k) const
+	{
+		static_assert(_Augment::_S_has_rank, "select() requires _Rb_tree_rank_augment");
+		_Link_type __x = _M_root();
+		while (__x != nullptr)
+		{
+			size_type __left = _Augment::_S_size(__x->_M_left);
+			if (__k < __left)
+				__x = _S_left(__x);
+			else if (__k == __left)
+				return const_iterator(__x);
+			else
+			{	// 跳过左子树与__x本身
+				__k -= __left + 1;
+				__x = _S_right(__x);
+			}
+		}
+		return end();
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::iterator
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::select(size_type __k)
+	{
+		const_iterator __it = static_cast<const _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>&>(*this).select(__k);
+		return iterator((_Link_type)__it._M_node);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::size_type
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::rank(const key_type& __k) const
+	{
+		static_assert(_Augment::_S_has_rank, "rank() requires _Rb_tree_rank_augment");
+		size_type __r = 0;
+		_Link_type __x = _M_root();
+		while (__x != nullptr)
+		{
+			if (!_M_key_compare(_S_key(__x), __k)) // __x的键值不小于__k，向左
+				__x = _S_left(__x);
+			else
+			{	// __x及其左子树均小于__k
+				__r += _Augment::_S_size(__x->_M_left) + 1;
+				__x = _S_right(__x);
+			}
+		}
+		return __r;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::size_type
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::index_of(const_iterator __position) const
+	{
+		static_assert(_Augment::_S_has_rank, "index_of() requires _Rb_tree_rank_augment");
+		if (__position._M_node == _M_header)
+			return _M_node_count;
+		_Base_ptr __x = __position._M_node;
+		size_type __r = _Augment::_S_size(__x->_M_left);
+		while (__x != _M_root()) // 上溯至根，每次从右孩子上溯时加上父节点及其左子树
+		{
+			_Base_ptr __p = __x->_M_get_parent();
+			if (__x == __p->_M_right)
+				__r += _Augment::_S_size(__p->_M_left) + 1;
+			__x = __p;
+		}
+		return __r;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline bool _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_verify_augment(_Link_type __x, TinySTL::true_type)
+	{
+		return _Augment::_S_size(__x) == 1 + _Augment::_S_size(__x->_M_left) + _Augment::_S_size(__x->_M_right);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Base_ptr _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_detach_root()
+	{
+		_Base_ptr __root = _M_root();
+		if (__root != nullptr)
+			__root->_M_set_parent(nullptr);
+		_M_empty_initialize();
+		_M_node_count = 0;
+		return __root;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_attach_root(_Base_ptr __root, size_type __n)
+	{	// 本树须为空
+		if (__root == nullptr)
+			return;
+		__root->_M_set_parent(_M_header);
+		__root->_M_set_color(_S_rb_tree_black);
+		_M_set_root((_Link_type)__root);
+		_M_leftmost() = (_Link_type)_Rb_tree_node_base::_S_minimum(__root);
+		_M_rightmost() = (_Link_type)_Rb_tree_node_base::_S_maximum(__root);
+		_M_node_count = __n;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_S_expose(_Subtree __t, _Subtree& __l, _Subtree& __r)
+	{
+		_Base_ptr __x = __t._M_root;
+		size_type __bh = __t._M_bh - (__x->_M_get_color() == _S_rb_tree_black ? 1 : 0); // 两个孩子的黑高
+		__l._M_root = __x->_M_left;
+		__l._M_bh = __bh;
+		__r._M_root = __x->_M_right;
+		__r._M_bh = __bh;
+		if (__l._M_root != nullptr)
+			__l._M_root->_M_set_parent(nullptr);
+		if (__r._M_root != nullptr)
+			__r._M_root->_M_set_parent(nullptr);
+		__x->_M_left = __x->_M_right = nullptr;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Base_ptr _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_S_split_last(_Subtree __t, _Subtree& __rest)
+	{	// 沿右脊下降，回溯时把左侧逐层join起来，共O(log n)
+		_Subtree __tl, __tr;
+		_S_expose(__t, __tl, __tr);
+		if (__tr._M_root == nullptr)
+		{
+			__rest = __tl;
+			return __t._M_root;
+		}
+		_Base_ptr __last = _S_split_last(__tr, __rest);
+		__rest = _S_join(__tl, __t._M_root, __rest);
+		return __last;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Subtree _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_S_join2(_Subtree __l, _Subtree __r)
+	{	// 以__l的最大节点作为分隔
+		if (__l._M_root == nullptr)
+			return __r;
+		if (__r._M_root == nullptr)
+			return __l;
+		_Subtree __rest;
+		_Base_ptr __k = _S_split_last(__l, __rest);
+		return _S_join(__rest, __k, __r);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Base_ptr
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_split(_Subtree __t, const key_type& __k, _Subtree& __l, _Subtree& __r) const
+	{	// 沿查找路径下降，回溯时把路径两侧的子树逐层join起来，共O(log n)
+		if (__t._M_root == nullptr)
+		{
+			__l = __r = __t;
+			return nullptr;
+		}
+		_Base_ptr __x = __t._M_root;
+		_Subtree __tl, __tr;
+		_S_expose(__t, __tl, __tr);
+
+		if (_M_key_compare(__k, _S_key(__x)))
+		{
+			_Base_ptr __m = _M_split(__tl, __k, __l, __r);
+			__r = _S_join(__r, __x, __tr);
+			return __m;
+		}
+		if (_M_key_compare(_S_key(__x), __k))
+		{
+			_Base_ptr __m = _M_split(__tr, __k, __l, __r);
+			__l = _S_join(__tl, __x, __l);
+			return __m;
+		}
+		__l = __tl;
+		__r = __tr;
+		return __x;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Base_ptr _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_S_subtree_next(_Base_ptr __x)
+	{
+		if (__x->_M_right != nullptr)
+			return _Rb_tree_node_base::_S_minimum(__x->_M_right);
+		_Base_ptr __y = __x->_M_get_parent();
+		while (__y != nullptr && __x == __y->_M_right)
+		{
+			__x = __y;
+			__y = __y->_M_get_parent();
+		}
+		return __y;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_S_split_sizes(_Base_ptr __l, _Base_ptr, size_type __n, size_type& __nl, size_type& __nr, TinySTL::true_type)
+	{
+		__nl = _Augment::_S_size(__l);
+		__nr = __n - __nl;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_S_split_sizes(_Base_ptr __l, _Base_ptr __r, size_type __n, size_type& __nl, size_type& __nr, TinySTL::false_type)
+	{	// 两侧同步计数，先走完的一侧即较小的一侧
+		_Base_ptr __a = __l == nullptr ? nullptr : _Rb_tree_node_base::_S_minimum(__l);
+		_Base_ptr __b = __r == nullptr ? nullptr : _Rb_tree_node_base::_S_minimum(__r);
+		size_type __c = 0;
+		for (; __a != nullptr && __b != nullptr; ++__c)
+		{
+			__a = _S_subtree_next(__a);
+			__b = _S_subtree_next(__b);
+		}
+		__nl = __a == nullptr ? __c : __n - __c;
+		__nr = __n - __nl;
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::join(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __left, const value_type& __v, _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __right)
+	{
+		_Link_type __k = _M_create_node(__v);
+		size_type __n = __left._M_node_count + __right._M_node_count + 1;
+		_Subtree __l = _S_subtree(__left._M_detach_root());
+		_Subtree __r = _S_subtree(__right._M_detach_root());
+		clear();
+		_M_attach_root(_S_join(__l, __k, __r)._M_root, __n);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::join(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __left, _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __right)
+	{
+		size_type __n = __left._M_node_count + __right._M_node_count;
+		_Subtree __l = _S_subtree(__left._M_detach_root());
+		_Subtree __r = _S_subtree(__right._M_detach_root());
+		clear();
+		_M_attach_root(_S_join2(__l, __r)._M_root, __n);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::node_type _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::split(const key_type& __k, _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __left, _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __right)
+	{
+		__left.clear();
+		__right.clear();
+		size_type __n = _M_node_count;
+		_Subtree __l, __r;
+		_Base_ptr __m = _M_split(_S_subtree(_M_detach_root()), __k, __l, __r);
+		if (__m != nullptr)
+			--__n;
+		size_type __nl, __nr;
+		_S_split_sizes(__l._M_root, __r._M_root, __n, __nl, __nr, TinySTL::bool_constant<_Augment::_S_has_rank>());
+		__left._M_attach_root(__l._M_root, __nl);
+		__right._M_attach_root(__r._M_root, __nr);
+		return node_type((_Link_type)__m);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	template<class _F1, class _F2>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_S_fork(thread_pool* __pool, size_type __depth, _F1 __f1, _F2 __f2)
+	{
+		if (__depth != 0)
+			__pool->invoke(__f1, __f2);
+		else
+		{
+			__f1();
+			__f2();
+		}
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Subtree
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_union(_Subtree __t1, _Subtree __t2, _Discard_list& __d, thread_pool* __pool, size_type __depth) const
+	{	// 以__t1的根拆分__t2，两侧分别递归求并，再以__t1的根连接
+		if (__t1._M_root == nullptr)
+			return __t2;
+		if (__t2._M_root == nullptr)
+			return __t1;
+		_Base_ptr __k = __t1._M_root;
+		_Subtree __l1, __r1, __l2, __r2;
+		_S_expose(__t1, __l1, __r1);
+		_Base_ptr __m = _M_split(__t2, _S_key(__k), __l2, __r2);
+		if (__m != nullptr)
+		{
+			__d._M_push(__m);
+			++__d._M_matched;
+		}
+
+		_Subtree __l, __r;
+		_Discard_list __dr;
+		size_type __next = __depth == 0 ? 0 : __depth - 1;
+		_S_fork(__pool, __depth,
+			[&] { __l = _M_union(__l1, __l2, __d, __pool, __next); },
+			[&] { __r = _M_union(__r1, __r2, __dr, __pool, __next); });
+		__d._M_splice(__dr);
+		return _S_join(__l, __k, __r);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Subtree
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_intersection(_Subtree __t1, _Subtree __t2, _Discard_list& __d, thread_pool* __pool, size_type __depth) const
+	{
+		if (__t1._M_root == nullptr || __t2._M_root == nullptr)
+		{	// 另一侧为空，整棵子树都不在交集中
+			if (__t1._M_root != nullptr)
+				__d._M_push(__t1._M_root);
+			if (__t2._M_root != nullptr)
+				__d._M_push(__t2._M_root);
+			_Subtree __empty = { nullptr, 0 };
+			return __empty;
+		}
+		_Base_ptr __k = __t1._M_root;
+		_Subtree __l1, __r1, __l2, __r2;
+		_S_expose(__t1, __l1, __r1);
+		_Base_ptr __m = _M_split(__t2, _S_key(__k), __l2, __r2);
+
+		_Subtree __l, __r;
+		_Discard_list __dr;
+		size_type __next = __depth == 0 ? 0 : __depth - 1;
+		_S_fork(__pool, __depth,
+			[&] { __l = _M_intersection(__l1, __l2, __d, __pool, __next); },
+			[&] { __r = _M_intersection(__r1, __r2, __dr, __pool, __next); });
+		__d._M_splice(__dr);
+		if (__m != nullptr)
+		{
+			__d._M_push(__m);
+			++__d._M_matched;
+			return _S_join(__l, __k, __r);
+		}
+		__d._M_push(__k);
+		return _S_join2(__l, __r);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline typename _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_Subtree
+	_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_difference(_Subtree __t1, _Subtree __t2, _Discard_list& __d, thread_pool* __pool, size_type __depth) const
+	{	// 以__t2的根拆分__t1，两侧分别递归求差，再无分隔地连接
+		if (__t1._M_root == nullptr || __t2._M_root == nullptr)
+		{
+			if (__t2._M_root != nullptr)
+				__d._M_push(__t2._M_root);
+			return __t1;
+		}
+		_Base_ptr __k = __t2._M_root;
+		_Subtree __l1, __r1, __l2, __r2;
+		_S_expose(__t2, __l2, __r2);
+		_Base_ptr __m = _M_split(__t1, _S_key(__k), __l1, __r1);
+		__d._M_push(__k);
+		if (__m != nullptr)
+		{
+			__d._M_push(__m);
+			++__d._M_matched;
+		}
+
+		_Subtree __l, __r;
+		_Discard_list __dr;
+		size_type __next = __depth == 0 ? 0 : __depth - 1;
+		_S_fork(__pool, __depth,
+			[&] { __l = _M_difference(__l1, __l2, __d, __pool, __next); },
+			[&] { __r = _M_difference(__r1, __r2, __dr, __pool, __next); });
+		__d._M_splice(__dr);
+		return _S_join2(__l, __r);
+	}
+
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline void _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::_M_set_operation(_Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>& __x, _Set_operation __op, thread_pool* __pool)
+	{
+		if (&__x == this)
+		{
+			if (__op == _S_set_difference)
+				clear();
+			return;
+		}
+
+		size_type __n1 = _M_node_count;
+		size_type __n2 = __x._M_node_count;
+		size_type __depth = 0;
+		if (TinySTL::min(__n1, __n2) >= _S_parallel_threshold)
+		{	// 并行层数取log2(线程数) + 2，任务数约为线程数的4倍，便于负载均衡
+			if (__pool == nullptr)
+				__pool = &thread_pool::default_pool();
+			if (__pool->size() > 1)
+			{
+				for (size_type __t = __pool->size(); __t > 1; __t >>= 1)
+					++__depth;
+				__depth += 2;
+			}
+		}
+
+		_Subtree __t1 = _S_subtree(_M_detach_root());
+		_Subtree __t2 = _S_subtree(__x._M_detach_root());
+		_Discard_list __d;
+		_Subtree __t;
+		size_type __n;
+		switch (__op)
+		{
+		case _S_set_union:
+			__t = _M_union(__t1, __t2, __d, __pool, __depth);
+			__n = __n1 + __n2 - __d._M_matched;
+			break;
+		case _S_set_intersection:
+			__t = _M_intersection(__t1, __t2, __d, __pool, __depth);
+			__n = __d._M_matched;
+			break;
+		default:
+			__t = _M_difference(__t1, __t2, __d, __pool, __depth);
+			__n = __n1 - __d._M_matched;
+			break;
+		}
+		_M_attach_root(__t._M_root, __n);
+
+		for (_Base_ptr __p = __d._M_head; __p != nullptr; )
+		{
+			_Base_ptr __next = __p->_M_get_parent();
+			_M_erase((_Link_type)__p);
+			__p = __next;
+		}
+	}
+
 	// 计算[__node, __root]之间的黑色结点个数，采用递归上溯法
 	inline int __black_count(_Rb_tree_node_base* __node, _Rb_tree_node_base* __root)
 	{
@@ -1207,33 +2405,34 @@ namespace TinySTL
 			return 0;
 		else
 		{
-			int __bc = __node->_M_color == _S_rb_tree_black ? 1 : 0;
+			int __bc = __node->_M_get_color() == _S_rb_tree_black ? 1 : 0;
 
 			if (__node == __root)
 				return __bc;
 			else
-				return __bc + __black_count(__node->_M_parent, __root);
+				return __bc + __black_count(__node->_M_get_parent(), __root);
 		}
 	}
 	
-	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc>
-	inline bool _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc>::__rb_verify() const
+	template<class _Key, class _Value, class _KeyOfValue, class _Compare, class _Alloc, class _Augment>
+	inline bool _Rb_tree<_Key, _Value, _KeyOfValue, _Compare, _Alloc, _Augment>::__rb_verify() const
 	{
 		if (_M_node_count == 0 || begin() == end()) // 当结点个数为0，或header结点的left和right相等
 			return _M_node_count == 0 && begin() == end() &&
 		           _M_header->_M_left == _M_header && _M_header->_M_right == _M_header;
 		
-		int __len = __black_count(_M_leftmost, _M_root()); // 叶子节点到根节点路径的黑色结点数目
-		for (const_iterator __it = begin(); __it != end(); ++__it) // 遍历整棵树
+		int __len = __black_count(_M_leftmost(), _M_root()); // 叶子节点到根节点路径的黑色结点数目
+		size_type __n = 0;
+		for (const_iterator __it = begin(); __it != end(); ++__it, ++__n) // 遍历整棵树
 		{
 			_Link_type __x = (_Link_type)__it._M_node;
 			_Link_type __L = _S_left(__x);  // __x的左孩子
 			_Link_type __R = _S_right(__x); // __x的右孩子
 
 			// 检验红色结点是否有红色孩子
-			if (__x->_M_color == _S_rb_tree_red)
+			if (__x->_M_get_color() == _S_rb_tree_red)
 			{
-				if ((__L && __L->_M_color == _S_rb_tree_red) || (__R && __R->_M_color == _S_rb_tree_red))
+				if ((__L && __L->_M_get_color() == _S_rb_tree_red) || (__R && __R->_M_get_color() == _S_rb_tree_red))
 					return false;
 			}
 
@@ -1245,11 +2444,19 @@ namespace TinySTL
 			if (__R && _M_key_compare( _S_key(__R),_S_key(__x)))
 				return false;
 
+			// 检验节点上的附加信息
+			if (!_M_verify_augment(__x))
+				return false;
+
 			// 检验叶子节点到根结点路径的黑色结点数目是否等于__len
 			if (!__L && !__R && __black_count(__x, _M_root()) != __len)
 				return false;
 		}
 
+		// 检验遍历到的结点数目是否与_M_node_count一致
+		if (__n != _M_node_count)
+			return false;
+
 		// 检验最大、小值指针指向是否正确
 		if (_M_leftmost() != _Rb_tree_node_base::_S_minimum(_M_root()))
 			return false;
@@ -0,0 +1,205 @@
+﻿#ifndef _SEARCHER_H_
+#define _SEARCHER_H_
+
+#include <cstddef>
+
+#include "Iterator.h"
+#include "TypeTraits.h"
+#include "Utility.h"
+#include "Functional.h"
+#include "Algorithm.h"
+#include "FlatHashMap.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* 子串查找器：与search(First, Last, Searcher)一起使用
+	* ***********************************
+	* 查找器构造时预处理needle，之后可以在多个区间中重复查找，needle的区间在此期间必须有效
+	* operator()(First, Last)返回needle第一次出现的[起点, 终点)，没有找到时两者都是Last；needle为空时返回[First, First)
+	*
+	* default_searcher              : 逐个位置比较，只要求前向迭代器，O(N*M)
+	* boyer_moore_horspool_searcher : 失配时按窗口末元素查表跳过，文本上平均为次线性，最坏O(N*M)；
+	*                                 单字节元素以==比较时用256项的表，其他情况用flat_hash_map
+	* two_way_searcher              : Two-Way算法，最坏O(N)，只用O(1)额外空间；元素须能以<排序
+	* simd_byte_searcher            : 单字节元素的指针区间，以SIMD比较needle的首末字节过滤候选位置，适合较短的needle；
+	*                                 候选过多时从当前位置起改用Two-Way，最坏仍为O(N)
+	* 不带谓词的search在单字节元素的随机访问区间上已经自动选用后两者
+	*/
+	template <class FwdIt, class Pr = TinySTL::equal_to<typename TinySTL::iterator_traits<FwdIt>::value_type>>
+	class default_searcher
+	{
+	private:
+		FwdIt _M_first;
+		FwdIt _M_last;
+		Pr _M_pred;
+
+	public:
+		default_searcher(FwdIt __first, FwdIt __last, Pr __pred = Pr())
+			: _M_first(__first), _M_last(__last), _M_pred(__pred) {}
+
+		template <class FwdIt2>
+		TinySTL::pair<FwdIt2, FwdIt2> operator()(FwdIt2 __first, FwdIt2 __last) const
+		{
+			FwdIt2 __i = TinySTL::search(__first, __last, _M_first, _M_last, _M_pred);
+			if (__i == __last)
+				return TinySTL::make_pair(__last, __last);
+			FwdIt2 __j = __i;
+			for (FwdIt __k = _M_first; __k != _M_last; ++__k)
+				++__j;
+			return TinySTL::make_pair(__i, __j);
+		}
+	};
+
+	/*
+	* boyer_moore_horspool_searcher的跳转表：窗口末元素为__x时窗口可以右移的距离
+	* 不在needle的前M - 1个元素中的元素移动M
+	*/
+	template <class _Value, class _Diff, class _Hash, class _Pr, bool _Bytes>
+	class _Bmh_table
+	{
+	private:
+		TinySTL::flat_hash_map<_Value, _Diff, _Hash, _Pr> _M_map;
+		_Diff _M_default;
+
+	public:
+		_Bmh_table(_Diff __m, const _Hash& __hf, const _Pr& __pred) : _M_map(0, __hf, __pred), _M_default(__m) {}
+
+		void _M_set(const _Value& __x, _Diff __shift) { _M_map.insert_or_assign(__x, __shift); }
+		_Diff _M_get(const _Value& __x) const
+		{
+			auto __i = _M_map.find(__x);
+			return __i == _M_map.end() ? _M_default : (*__i).second;
+		}
+	};
+
+	template <class _Value, class _Diff, class _Hash, class _Pr>
+	class _Bmh_table<_Value, _Diff, _Hash, _Pr, true>
+	{
+	private:
+		_Diff _M_shift[256];
+
+	public:
+		_Bmh_table(_Diff __m, const _Hash&, const _Pr&)
+		{
+			for (int __i = 0; __i < 256; ++__i)
+				_M_shift[__i] = __m;
+		}
+
+		void _M_set(const _Value& __x, _Diff __shift) { _M_shift[static_cast<unsigned char>(__x)] = __shift; }
+		_Diff _M_get(const _Value& __x) const { return _M_shift[static_cast<unsigned char>(__x)]; }
+	};
+
+	template <class RanIt, class _Hash = TinySTL::hash<typename TinySTL::iterator_traits<RanIt>::value_type>,
+		class Pr = TinySTL::equal_to<typename TinySTL::iterator_traits<RanIt>::value_type>>
+	class boyer_moore_horspool_searcher
+	{
+	public:
+		using value_type      = typename TinySTL::iterator_traits<RanIt>::value_type;
+		using difference_type = typename TinySTL::iterator_traits<RanIt>::difference_type;
+
+	private:
+		using _Table = _Bmh_table<value_type, difference_type, _Hash, Pr,
+			TinySTL::is_integral_v<value_type> && sizeof(value_type) == 1 && TinySTL::is_same_v<Pr, TinySTL::equal_to<value_type>>>;
+
+		RanIt _M_first;
+		difference_type _M_len;
+		Pr _M_pred;
+		_Table _M_table;
+
+	public:
+		boyer_moore_horspool_searcher(RanIt __first, RanIt __last, _Hash __hf = _Hash(), Pr __pred = Pr())
+			: _M_first(__first), _M_len(__last - __first), _M_pred(__pred), _M_table(__last - __first, __hf, __pred)
+		{
+			for (difference_type __i = 0; __i + 1 < _M_len; ++__i)
+				_M_table._M_set(__first[__i], _M_len - 1 - __i);
+		}
+
+		template <class RanIt2>
+		TinySTL::pair<RanIt2, RanIt2> operator()(RanIt2 __first, RanIt2 __last) const
+		{
+			if (_M_len == 0)
+				return TinySTL::make_pair(__first, __first);
+			const difference_type __n = static_cast<difference_type>(__last - __first);
+			for (difference_type __pos = 0; __pos + _M_len <= __n;)
+			{	// 从窗口末尾向前比较
+				difference_type __j = _M_len - 1;
+				while (_M_pred(__first[__pos + __j], _M_first[__j]))
+				{
+					if (__j == 0)
+						return TinySTL::make_pair(__first + __pos, __first + (__pos + _M_len));
+					--__j;
+				}
+				__pos += _M_table._M_get(__first[__pos + _M_len - 1]);
+			}
+			return TinySTL::make_pair(__last, __last);
+		}
+	};
+
+	template <class RanIt>
+	class two_way_searcher
+	{
+	private:
+		RanIt _M_first;
+		size_t _M_len;
+		_Two_way_factor _M_factor;
+
+	public:
+		two_way_searcher(RanIt __first, RanIt __last)
+			: _M_first(__first), _M_len(static_cast<size_t>(__last - __first)), _M_factor()
+		{
+			if (_M_len != 0)
+				_M_factor = TinySTL::_Two_way_prepare(__first, _M_len);
+		}
+
+		template <class RanIt2>
+		TinySTL::pair<RanIt2, RanIt2> operator()(RanIt2 __first, RanIt2 __last) const
+		{
+			if (_M_len == 0)
+				return TinySTL::make_pair(__first, __first);
+			const size_t __n = static_cast<size_t>(__last - __first);
+			const size_t __r = __n < _M_len ? __n : TinySTL::_Two_way_search(__first, __n, _M_first, _M_len, _M_factor);
+			if (__r == __n)
+				return TinySTL::make_pair(__last, __last);
+			return TinySTL::make_pair(__first + __r, __first + (__r + _M_len));
+		}
+	};
+
+	template <class RanIt>
+	class simd_byte_searcher
+	{
+	public:
+		using value_type = typename TinySTL::iterator_traits<RanIt>::value_type;
+		static_assert(TinySTL::is_pointer_v<RanIt> && TinySTL::is_integral_v<value_type> && sizeof(value_type) == 1,
+			"simd_byte_searcher requires pointers to single-byte integers");
+
+	private:
+		const value_type* _M_first;
+		size_t _M_len;
+		_Two_way_factor _M_factor; // 过滤失效时使用
+
+	public:
+		simd_byte_searcher(RanIt __first, RanIt __last)
+			: _M_first(__first), _M_len(static_cast<size_t>(__last - __first)), _M_factor()
+		{
+			if (_M_len != 0)
+				_M_factor = TinySTL::_Two_way_prepare(_M_first, _M_len);
+		}
+
+		template <class RanIt2>
+		TinySTL::pair<RanIt2, RanIt2> operator()(RanIt2 __first, RanIt2 __last) const
+		{
+			static_assert(TinySTL::_Byte_ptr_search_v<RanIt2, RanIt>, "simd_byte_searcher requires a haystack of the same byte type");
+			if (_M_len == 0)
+				return TinySTL::make_pair(__first, __first);
+			const size_t __n = static_cast<size_t>(__last - __first);
+			const size_t __r = __n < _M_len ? __n : TinySTL::_Search_bytes(static_cast<const value_type*>(__first), __n, _M_first, _M_len, &_M_factor);
+			if (__r == __n)
+				return TinySTL::make_pair(__last, __last);
+			return TinySTL::make_pair(__first + __r, __first + (__r + _M_len));
+		}
+	};
+}
+
+#endif // !_SEARCHER_H_
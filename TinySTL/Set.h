@@ -0,0 +1,416 @@
+﻿#ifndef _SET_H_
+#define _SET_H_
+
+#include <utility>
+
+#include "Rbtree.h"
+#include "Functional.h"
+
+namespace TinySTL
+{
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	class multiset;
+
+	/*
+	* ***********************************
+	* set : 以_Rb_tree为底层的有序集合
+	* ***********************************
+	* 元素的键值即实值，键值不允许重复，所有插入均调用_Rb_tree::insert_unique
+	* set的元素不允许经由迭代器修改(否则会破坏排列规则)，因此iterator与const_iterator均为_Rb_tree的const_iterator
+	* _Augment为_Rb_tree_rank_augment时，额外提供O(log n)的select/rank/index_of
+	* union_/intersection/difference基于_Rb_tree的join/split，工作量为O(m log(n/m + 1))
+	*/
+	template<class _Key, class _Compare = TinySTL::less<_Key>, class _Alloc = TinySTL::alloc, class _Augment = _Rb_tree_no_augment>
+	class set
+	{
+	public:
+		using key_type        = _Key;
+		using value_type      = _Key;
+		using key_compare     = _Compare;
+		using value_compare   = _Compare;
+
+	private:
+		using _Rep_type       = _Rb_tree<key_type, value_type, TinySTL::identity<value_type>, key_compare, _Alloc, _Augment>;
+		using _Rep_iterator   = typename _Rep_type::iterator;
+
+		friend class multiset<_Key, _Compare, _Alloc, _Augment>; // merge需要访问对方的_M_t
+
+		_Rep_type _M_t; // 底层的RB-tree
+
+	public:
+		using pointer                = typename _Rep_type::const_pointer;
+		using const_pointer          = typename _Rep_type::const_pointer;
+		using reference              = typename _Rep_type::const_reference;
+		using const_reference        = typename _Rep_type::const_reference;
+		using iterator               = typename _Rep_type::const_iterator;
+		using const_iterator         = typename _Rep_type::const_iterator;
+		using reverse_iterator       = typename _Rep_type::const_reverse_iterator;
+		using const_reverse_iterator = typename _Rep_type::const_reverse_iterator;
+		using size_type              = typename _Rep_type::size_type;
+		using difference_type        = typename _Rep_type::difference_type;
+		using allocator_type         = typename _Rep_type::allocator_type;
+		using node_type              = typename _Rep_type::node_type;
+		using insert_return_type     = _Rb_tree_insert_return<iterator, node_type>;
+
+	private:
+		// _Rb_tree的erase/insert接受可修改的iterator
+		static _Rep_iterator _S_unconst(const_iterator __it)
+		{
+			return _Rep_iterator((typename _Rep_type::_Link_type)__it._M_node);
+		}
+
+	public:
+		set() : _M_t(_Compare(), allocator_type()) {}
+		explicit set(const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a) {}
+
+		template<class InIt>
+		set(InIt __first, InIt __last) : _M_t(_Compare(), allocator_type())
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		template<class InIt>
+		set(InIt __first, InIt __last, const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a)
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		set(const set& __x) : _M_t(__x._M_t) {}
+
+		set& operator=(const set& __x)
+		{
+			_M_t = __x._M_t;
+			return *this;
+		}
+
+	public:
+		key_compare key_comp() const { return _M_t.key_comp(); }
+		value_compare value_comp() const { return _M_t.key_comp(); }
+		allocator_type get_allocator() const { return _M_t.get_allocator(); }
+
+		// Iterator:
+		iterator begin() const { return _M_t.begin(); }
+		iterator end() const { return _M_t.end(); }
+		reverse_iterator rbegin() const { return _M_t.rbegin(); }
+		reverse_iterator rend() const { return _M_t.rend(); }
+		const_iterator cbegin() const { return _M_t.begin(); }
+		const_iterator cend() const { return _M_t.end(); }
+		const_reverse_iterator crbegin() const { return _M_t.rbegin(); }
+		const_reverse_iterator crend() const { return _M_t.rend(); }
+
+		// Capacity:
+		bool empty() const { return _M_t.empty(); }
+		size_type size() const { return _M_t.size(); }
+		size_type max_size() const { return _M_t.max_size(); }
+
+		// Modifiers:
+		TinySTL::pair<iterator, bool> insert(const value_type& __x)
+		{
+			TinySTL::pair<_Rep_iterator, bool> __p = _M_t.insert_unique(__x);
+			return TinySTL::pair<iterator, bool>(__p.first, __p.second);
+		}
+		// __position为提示位置，若新元素恰好应位于其前，则无需从根节点查找
+		iterator insert(const_iterator __position, const value_type& __x)
+		{
+			return _M_t.insert_unique(_S_unconst(__position), __x);
+		}
+		template<class InIt>
+		void insert(InIt __first, InIt __last)
+		{
+			_M_t.insert_unique(__first, __last);
+		}
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> emplace(_Args&&... __args)
+		{
+			return insert(value_type(std::forward<_Args>(__args)...));
+		}
+		template<class... _Args>
+		iterator emplace_hint(const_iterator __position, _Args&&... __args)
+		{
+			return insert(__position, value_type(std::forward<_Args>(__args)...));
+		}
+
+		iterator erase(const_iterator __position) { return _M_t.erase(_S_unconst(__position)); }
+		size_type erase(const key_type& __x) { return _M_t.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last)
+		{
+			_M_t.erase(_S_unconst(__first), _S_unconst(__last));
+			return __last;
+		}
+		void clear() { _M_t.clear(); }
+		void swap(set& __x) { _M_t.swap(__x._M_t); }
+
+		// Node handles: 在容器间移动元素而不重新分配节点
+		node_type extract(const_iterator __position) { return _M_t.extract(_S_unconst(__position)); }
+		node_type extract(const key_type& __x) { return _M_t.extract(__x); }
+		insert_return_type insert(node_type&& __nh)
+		{
+			typename _Rep_type::insert_return_type __r = _M_t._M_reinsert_node_unique(std::move(__nh));
+			return insert_return_type{ __r.position, __r.inserted, std::move(__r.node) };
+		}
+		iterator insert(const_iterator __hint, node_type&& __nh)
+		{
+			return _M_t._M_reinsert_node_hint_unique(_S_unconst(__hint), std::move(__nh));
+		}
+		// 键值已存在的元素留在__src中
+		void merge(set& __src) { _M_t._M_merge_unique(__src._M_t); }
+		void merge(set&& __src) { _M_t._M_merge_unique(__src._M_t); }
+		void merge(multiset<_Key, _Compare, _Alloc, _Augment>& __src) { _M_t._M_merge_unique(__src._M_t); }
+		void merge(multiset<_Key, _Compare, _Alloc, _Augment>&& __src) { _M_t._M_merge_unique(__src._M_t); }
+
+		// Set operations: 结果存于*this，__x被置空，键值相同时保留*this中的元素；规模较大时在线程池上并行
+		void union_(set& __x) { _M_t.union_(__x._M_t); }
+		void union_(set& __x, thread_pool& __pool) { _M_t.union_(__x._M_t, __pool); }
+		void intersection(set& __x) { _M_t.intersection(__x._M_t); }
+		void intersection(set& __x, thread_pool& __pool) { _M_t.intersection(__x._M_t, __pool); }
+		void difference(set& __x) { _M_t.difference(__x._M_t); }
+		void difference(set& __x, thread_pool& __pool) { _M_t.difference(__x._M_t, __pool); }
+
+		// Lookup:
+		iterator find(const key_type& __x) const { return _M_t.find(__x); }
+		size_type count(const key_type& __x) const { return _M_t.find(__x) == _M_t.end() ? 0 : 1; }
+		bool contains(const key_type& __x) const { return _M_t.find(__x) != _M_t.end(); }
+		iterator lower_bound(const key_type& __x) const { return _M_t.lower_bound(__x); }
+		iterator upper_bound(const key_type& __x) const { return _M_t.upper_bound(__x); }
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) const { return _M_t.equal_range(__x); }
+
+		// Order statistics(需要_Rb_tree_rank_augment):
+		iterator select(size_type __k) const { return _M_t.select(__k); }
+		size_type rank(const key_type& __x) const { return _M_t.rank(__x); }
+		size_type index_of(const_iterator __position) const { return _M_t.index_of(__position); }
+
+		// 验证底层RB-tree是否合法
+		bool __rb_verify() const { return _M_t.__rb_verify(); }
+	};
+
+	/*
+	* ***********************************
+	* multiset : 允许键值重复的set，所有插入均调用_Rb_tree::insert_equal
+	* ***********************************
+	*/
+	template<class _Key, class _Compare = TinySTL::less<_Key>, class _Alloc = TinySTL::alloc, class _Augment = _Rb_tree_no_augment>
+	class multiset
+	{
+	public:
+		using key_type        = _Key;
+		using value_type      = _Key;
+		using key_compare     = _Compare;
+		using value_compare   = _Compare;
+
+	private:
+		using _Rep_type       = _Rb_tree<key_type, value_type, TinySTL::identity<value_type>, key_compare, _Alloc, _Augment>;
+		using _Rep_iterator   = typename _Rep_type::iterator;
+
+		friend class set<_Key, _Compare, _Alloc, _Augment>;
+
+		_Rep_type _M_t; // 底层的RB-tree
+
+	public:
+		using pointer                = typename _Rep_type::const_pointer;
+		using const_pointer          = typename _Rep_type::const_pointer;
+		using reference              = typename _Rep_type::const_reference;
+		using const_reference        = typename _Rep_type::const_reference;
+		using iterator               = typename _Rep_type::const_iterator;
+		using const_iterator         = typename _Rep_type::const_iterator;
+		using reverse_iterator       = typename _Rep_type::const_reverse_iterator;
+		using const_reverse_iterator = typename _Rep_type::const_reverse_iterator;
+		using size_type              = typename _Rep_type::size_type;
+		using difference_type        = typename _Rep_type::difference_type;
+		using allocator_type         = typename _Rep_type::allocator_type;
+		using node_type              = typename _Rep_type::node_type;
+
+	private:
+		static _Rep_iterator _S_unconst(const_iterator __it)
+		{
+			return _Rep_iterator((typename _Rep_type::_Link_type)__it._M_node);
+		}
+
+	public:
+		multiset() : _M_t(_Compare(), allocator_type()) {}
+		explicit multiset(const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a) {}
+
+		template<class InIt>
+		multiset(InIt __first, InIt __last) : _M_t(_Compare(), allocator_type())
+		{
+			_M_t.insert_equal(__first, __last);
+		}
+		template<class InIt>
+		multiset(InIt __first, InIt __last, const _Compare& __comp, const allocator_type& __a = allocator_type()) : _M_t(__comp, __a)
+		{
+			_M_t.insert_equal(__first, __last);
+		}
+		multiset(const multiset& __x) : _M_t(__x._M_t) {}
+
+		multiset& operator=(const multiset& __x)
+		{
+			_M_t = __x._M_t;
+			return *this;
+		}
+
+	public:
+		key_compare key_comp() const { return _M_t.key_comp(); }
+		value_compare value_comp() const { return _M_t.key_comp(); }
+		allocator_type get_allocator() const { return _M_t.get_allocator(); }
+
+		// Iterator:
+		iterator begin() const { return _M_t.begin(); }
+		iterator end() const { return _M_t.end(); }
+		reverse_iterator rbegin() const { return _M_t.rbegin(); }
+		reverse_iterator rend() const { return _M_t.rend(); }
+		const_iterator cbegin() const { return _M_t.begin(); }
+		const_iterator cend() const { return _M_t.end(); }
+		const_reverse_iterator crbegin() const { return _M_t.rbegin(); }
+		const_reverse_iterator crend() const { return _M_t.rend(); }
+
+		// Capacity:
+		bool empty() const { return _M_t.empty(); }
+		size_type size() const { return _M_t.size(); }
+		size_type max_size() const { return _M_t.max_size(); }
+
+		// Modifiers:
+		iterator insert(const value_type& __x) { return _M_t.insert_equal(__x); }
+		iterator insert(const_iterator __position, const value_type& __x)
+		{
+			return _M_t.insert_equal(_S_unconst(__position), __x);
+		}
+		template<class InIt>
+		void insert(InIt __first, InIt __last)
+		{
+			_M_t.insert_equal(__first, __last);
+		}
+		template<class... _Args>
+		iterator emplace(_Args&&... __args)
+		{
+			return insert(value_type(std::forward<_Args>(__args)...));
+		}
+		template<class... _Args>
+		iterator emplace_hint(const_iterator __position, _Args&&... __args)
+		{
+			return insert(__position, value_type(std::forward<_Args>(__args)...));
+		}
+
+		iterator erase(const_iterator __position) { return _M_t.erase(_S_unconst(__position)); }
+		size_type erase(const key_type& __x) { return _M_t.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last)
+		{
+			_M_t.erase(_S_unconst(__first), _S_unconst(__last));
+			return __last;
+		}
+		void clear() { _M_t.clear(); }
+		void swap(multiset& __x) { _M_t.swap(__x._M_t); }
+
+		// Node handles:
+		node_type extract(const_iterator __position) { return _M_t.extract(_S_unconst(__position)); }
+		node_type extract(const key_type& __x) { return _M_t.extract(__x); }
+		iterator insert(node_type&& __nh) { return _M_t._M_reinsert_node_equal(std::move(__nh)); }
+		iterator insert(const_iterator __hint, node_type&& __nh)
+		{
+			return _M_t._M_reinsert_node_hint_equal(_S_unconst(__hint), std::move(__nh));
+		}
+		void merge(multiset& __src) { _M_t._M_merge_equal(__src._M_t); }
+		void merge(multiset&& __src) { _M_t._M_merge_equal(__src._M_t); }
+		void merge(set<_Key, _Compare, _Alloc, _Augment>& __src) { _M_t._M_merge_equal(__src._M_t); }
+		void merge(set<_Key, _Compare, _Alloc, _Augment>&& __src) { _M_t._M_merge_equal(__src._M_t); }
+
+		// Lookup:
+		iterator find(const key_type& __x) const { return _M_t.find(__x); }
+		size_type count(const key_type& __x) const { return _M_t.count(__x); }
+		bool contains(const key_type& __x) const { return _M_t.find(__x) != _M_t.end(); }
+		iterator lower_bound(const key_type& __x) const { return _M_t.lower_bound(__x); }
+		iterator upper_bound(const key_type& __x) const { return _M_t.upper_bound(__x); }
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) const { return _M_t.equal_range(__x); }
+
+		// Order statistics(需要_Rb_tree_rank_augment):
+		iterator select(size_type __k) const { return _M_t.select(__k); }
+		size_type rank(const key_type& __x) const { return _M_t.rank(__x); }
+		size_type index_of(const_iterator __position) const { return _M_t.index_of(__position); }
+
+		bool __rb_verify() const { return _M_t.__rb_verify(); }
+	};
+
+	//////////////////////////////////////////// 比较操作 //////////////////////////////////////////////////////////
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator==(const set<_Key, _Compare, _Alloc, _Augment>& __x, const set<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return __x.size() == __y.size() && TinySTL::equal(__x.begin(), __x.end(), __y.begin());
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator!=(const set<_Key, _Compare, _Alloc, _Augment>& __x, const set<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__x == __y);
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator<(const set<_Key, _Compare, _Alloc, _Augment>& __x, const set<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return TinySTL::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end());
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator>(const set<_Key, _Compare, _Alloc, _Augment>& __x, const set<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return __y < __x;
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator<=(const set<_Key, _Compare, _Alloc, _Augment>& __x, const set<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__y < __x);
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator>=(const set<_Key, _Compare, _Alloc, _Augment>& __x, const set<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__x < __y);
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline void swap(set<_Key, _Compare, _Alloc, _Augment>& __x, set<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		__x.swap(__y);
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator==(const multiset<_Key, _Compare, _Alloc, _Augment>& __x, const multiset<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return __x.size() == __y.size() && TinySTL::equal(__x.begin(), __x.end(), __y.begin());
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator!=(const multiset<_Key, _Compare, _Alloc, _Augment>& __x, const multiset<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__x == __y);
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator<(const multiset<_Key, _Compare, _Alloc, _Augment>& __x, const multiset<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return TinySTL::lexicographical_compare(__x.begin(), __x.end(), __y.begin(), __y.end());
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator>(const multiset<_Key, _Compare, _Alloc, _Augment>& __x, const multiset<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return __y < __x;
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator<=(const multiset<_Key, _Compare, _Alloc, _Augment>& __x, const multiset<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__y < __x);
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline bool operator>=(const multiset<_Key, _Compare, _Alloc, _Augment>& __x, const multiset<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		return !(__x < __y);
+	}
+
+	template<class _Key, class _Compare, class _Alloc, class _Augment>
+	inline void swap(multiset<_Key, _Compare, _Alloc, _Augment>& __x, multiset<_Key, _Compare, _Alloc, _Augment>& __y)
+	{
+		__x.swap(__y);
+	}
+}
+
+#endif // !_SET_H_
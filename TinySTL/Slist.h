@@ -98,7 +98,7 @@ namespace TinySTL
 	struct _slist_iterator_base
 	{
 		using size_type         = size_t;
-		using different_type    = ptrdiff_t;
+		using difference_type   = ptrdiff_t;
 		using iterator_category = forward_iterator_tag; // 单向
 
 		_slist_node_base* _M_node;  // 指向节点基本结构
@@ -140,11 +140,11 @@ namespace TinySTL
 			incr();
 			return *this;
 		}
-		self& operator++(int) // 后置
+		self operator++(int) // 后置
 		{
 			self tmp = *this;
 			incr();
-			return *this;
+			return tmp;
 		}
 	};
 
@@ -154,8 +154,8 @@ namespace TinySTL
 		using allocator_type = Alloc;
 		allocator_type get_allocator() const { return allocator_type(); }
 
-		_slist_base(const allocator_type&) { _M_head._M_next = nullptr; }
-		~_slist_base() {} // 清空链表
+		_slist_base(const allocator_type&) : _M_tail(&_M_head), _M_size(0) { _M_head._M_next = nullptr; }
+		~_slist_base() { _M_erase_after(&_M_head, nullptr); } // 清空链表
 
 	protected:
 		using Alloc_type = simple_alloc<_slist_node<T>, Alloc>;
@@ -163,21 +163,36 @@ namespace TinySTL
 		_slist_node<T>* _M_get_node() { return Alloc_type::allocate(1); }
 		void _M_put_node(_slist_node<T>* __p) { Alloc_type::deallocate(__p, 1); }
 
+		// 将__node链在__pos后面，并维护_M_tail与_M_size
+		_slist_node_base* _M_link_after(_slist_node_base* __pos, _slist_node_base* __node)
+		{
+			__slit_make_link(__pos, __node);
+			if (__pos == _M_tail)
+				_M_tail = __node;
+			++_M_size;
+			return __node;
+		}
+
 		// 删除__pos->_M_next
 		_slist_node_base* _M_erase_after(_slist_node_base* __pos)
 		{
 			_slist_node<T>* __next = (_slist_node<T>*)(__pos->_M_next);
 			_slist_node_base* __next_next = __next->_M_next;
 			__pos->_M_next = __next_next;
+			if (__next == _M_tail)
+				_M_tail = __pos;
 			destroy(&__next->_M_data );
 			_M_put_node(__next);
+			--_M_size;
 			return __next_next;
 		}
 		// 删除(__before_first,__last_node)
 		_slist_node_base* _M_erase_after(_slist_node_base* __before_first, _slist_node_base* __last_node);
 
 	protected:
-		_slist_node_base _M_head;
+		_slist_node_base  _M_head;
+		_slist_node_base* _M_tail; // 指向最后一个结点，链表为空时指向_M_head
+		size_t            _M_size; // 结点个数
 	};
 
 	template<class T, class Alloc>
@@ -190,23 +205,36 @@ namespace TinySTL
 			__cur = (_slist_node<T>*)(__cur->_M_next);
 			destroy(&__tmp->_M_data );
 			_M_put_node(__tmp);
+			--_M_size;
 		}
 		__before_first->_M_next = __last_node;
+		if (__last_node == nullptr)
+			_M_tail = __before_first;
 		return __last_node;
 	}
 
+	/*
+	* ***********************************
+	* slist : 单向链表
+	* ***********************************
+	* 容器维护结点个数与尾指针，因此size()、back()、push_back()以及在end()处的insert/splice均为O(1)
+	*
+	* 单向链表的快速路径是*_after系列操作：insert_after、erase_after、splice_after均为O(1)
+	* (整表splice_after也是O(1)，区间splice_after需要数出区间长度以维护size)
+	* insert、erase、splice需要从头查找前驱结点，为O(n)，位置为end()时除外
+	*/
 	template<class T, class Alloc = TinySTL::alloc>
-	class slist : private _slist_base<T, alloc>
+	class slist : private _slist_base<T, Alloc>
 	{
 	private:
-		using _Base = _slist_base<T, alloc>;
+		using _Base = _slist_base<T, Alloc>;
 
 	public:
 		using value_type      = T;
 		using pointer         = value_type*;
-		using const_pointer   = const pointer;
+		using const_pointer   = const value_type*;
 		using reference       = value_type&;
-		using const_reference = const reference;
+		using const_reference = const value_type&;
 		using size_type       = size_t;
 		using difference_type = ptrdiff_t;
 
@@ -272,7 +300,6 @@ namespace TinySTL
 		{
 			_M_insert_after_range(&this->_M_head, __first, __last);
 		}
-		template<class InIt>
 		slist(const slist& __x) : _Base(__x.get_allocator())
 		{
 			_M_insert_after_range(&this->_M_head, __x.begin(), __x.end());
@@ -308,53 +335,67 @@ namespace TinySTL
 
 		iterator before_begin() { return iterator((_Node*)&this->_M_head); }
 		const_iterator before_begin() const { return const_iterator((_Node*)&this->_M_head); }
+		// 指向最后一个元素(链表为空时等于before_begin())，可作为insert_after/splice_after的位置在尾部追加
+		iterator before_end() { return iterator((_Node*)this->_M_tail); }
+		const_iterator before_end() const { return const_iterator((_Node*)this->_M_tail); }
 
-		size_type size() const { return __slist_size(this->_M_head._M_next); }
+		size_type size() const { return this->_M_size; }
 
 		size_type max_size() const { return size_type(-1); }
 
 		bool empty() const { return this->_M_head._M_next == nullptr; }
 
-		void swap(slist& __x) { TinySTL::swap(this->_M_head._M_next, __x._M_head._M_next); }
+		void swap(slist& __x);
 
 	public:
 		reference front() { return ((_Node*)this->_M_head._M_next)->_M_data; }
 		const_reference front() const { return ((_Node*)this->_M_head._M_next)->_M_data; }
+		reference back() { return ((_Node*)this->_M_tail)->_M_data; }
+		const_reference back() const { return ((_Node*)this->_M_tail)->_M_data; }
 
 		void push_front(const value_type& __x)
 		{
-			__slit_make_link(&this->_M_head, _M_create_node(__x));
+			this->_M_link_after(&this->_M_head, _M_create_node(__x));
 		}
 		void push_front()
 		{
-			__slit_make_link(&this->_M_head, _M_create_node());
+			this->_M_link_after(&this->_M_head, _M_create_node());
+		}
+		void push_back(const value_type& __x)
+		{
+			this->_M_link_after(this->_M_tail, _M_create_node(__x));
 		}
 
 		void pop_front()
 		{
-			_Node* __node = (_Node*)this->_M_head._M_next;
-			this->_M_head._M_next = __node->_M_next;
-			destroy(&__node->_M_data);
-			this->_M_put_node(__node);
+			this->_M_erase_after(&this->_M_head);
 		}
 
 		iterator previous(const_iterator __pos)
 		{
-			return iterator((_Node*)__slist_previous(&this->_M_head, __pos._M_node));
+			return iterator((_Node*)_M_previous(__pos._M_node));
 		}
 		const_iterator previous(const_iterator __pos) const
 		{
-			return const_iterator((_Node*)__slist_previous(&this->_M_head, __pos._M_node));
+			return const_iterator((_Node*)_M_previous(__pos._M_node));
 		}
 
 	private:
+		// 查找__node的前驱，__node为end()时直接返回尾结点
+		_Node_base* _M_previous(const _Node_base* __node) const
+		{
+			if (__node == nullptr)
+				return this->_M_tail;
+			return __slist_previous(const_cast<_Node_base*>(&this->_M_head), __node);
+		}
+
 		_Node* _M_insert_after(_Node_base* __pos, const value_type& __x)
 		{
-			return (_Node*)(__slit_make_link(__pos, _M_create_node(__x)));
+			return (_Node*)(this->_M_link_after(__pos, _M_create_node(__x)));
 		}
 		_Node* _M_insert_after(_Node_base* __pos)
 		{
-			return (_Node*)(__slit_make_link(__pos, _M_create_node()));
+			return (_Node*)(this->_M_link_after(__pos, _M_create_node()));
 		}
 
 		// 在__pos之后插入__n个数据值为__x的结点
@@ -362,7 +403,7 @@ namespace TinySTL
 		{
 			for (size_t i = 0; i < __n; i++)
 			{
-				__pos = __slit_make_link(__pos, _M_create_node(__x));
+				__pos = this->_M_link_after(__pos, _M_create_node(__x));
 			}
 		}
 
@@ -382,11 +423,18 @@ namespace TinySTL
 		{
 			while (__first != __last)
 			{
-				__pos = __slit_make_link(__pos, _M_create_node(*__first));
+				__pos = this->_M_link_after(__pos, _M_create_node(*__first));
 				++__first;
 			}
 		}
 
+		// 将__x中的(__before_first, __before_last]移到__pos之后，__n为区间内的结点数
+		void _M_splice_after(_Node_base* __pos, slist& __x, _Node_base* __before_first, _Node_base* __before_last, size_type __n);
+
+		// 将有序单链__first1与__first2合并为一条有序单链并存入__first1，相等时__first1中的元素在前
+		template<class _StrictWeakOrdering>
+		static void _M_merge_chain(_Node_base*& __first1, _Node_base*& __first2, _StrictWeakOrdering& __comp);
+
 	public:
 		iterator insert_after(iterator __pos, const value_type& __x)
 		{
@@ -412,22 +460,22 @@ namespace TinySTL
 		// 提供的insert函数也实现找到插入位置的前驱结点,然后调用insert_after来实现的
 		iterator insert(iterator __pos, const value_type& __x)
 		{
-			return iterator(_M_insert_after(__slist_previous(&this->_M_head, __pos._M_node), __x));
+			return iterator(_M_insert_after(_M_previous(__pos._M_node), __x));
 		}
 		iterator insert(iterator __pos)
 		{
-			return iterator(_M_insert_after(__slist_previous(&this->_M_head, __pos._M_node), value_type()));
+			return iterator(_M_insert_after(_M_previous(__pos._M_node), value_type()));
 		}
 
 		void insert(iterator __pos, size_type __n, const value_type& __x)
 		{
-			_M_insert_after_fill(__slist_previous(&this->_M_head, __pos._M_node), __n, __x);
+			_M_insert_after_fill(_M_previous(__pos._M_node), __n, __x);
 		}
 
 		template<class InIt>
 		void insert(iterator __pos, InIt __first, InIt __last)
 		{
-			_M_insert_after_range(__slist_previous(&this->_M_head, __pos._M_node), __first, __last);
+			_M_insert_after_range(_M_previous(__pos._M_node), __first, __last);
 		}
 
 	public:
@@ -444,11 +492,11 @@ namespace TinySTL
 		//提供的erase函数也实现找到删除位置的前驱结点,然后调用erase_after来实现的
 		iterator erase(iterator __pos)
 		{
-			return (_Node*)this->_M_erase_after(__slist_previous(&this->_M_head, __pos._M_node));
+			return (_Node*)this->_M_erase_after(_M_previous(__pos._M_node));
 		}
 		iterator erase(iterator __first, iterator __last)
 		{
-			return (_Node*)this->_M_erase_after(__slist_previous(&this->_M_head, __first._M_node), __last._M_node);
+			return (_Node*)this->_M_erase_after(_M_previous(__first._M_node), __last._M_node);
 		}
 
 		void resize(size_type new_size, const T& __x);
@@ -457,53 +505,60 @@ namespace TinySTL
 		void clear() { this->_M_erase_after(&this->_M_head, nullptr); }
 
 	public:
-        // Moves the range (__before_first, __before_last ] to *this,
-        // inserting it immediately after __pos.  This is constant time.
-		void splice_after(iterator __pos, iterator __before_first, iterator __before_last)
+		// Moves the range (__before_first, __before_last] of __x to *this,
+		// inserting it immediately after __pos.  Linear in the length of the
+		// range when __x is not *this (the size must be recounted).
+		void splice_after(iterator __pos, slist& __x, iterator __before_first, iterator __before_last)
 		{
 			if (__before_first != __before_last)
-				__slist_splice_after(__pos._M_node, __before_first._M_node, __before_last._M_node);
+			{
+				size_type __n = 0;
+				if (this != &__x)
+				{
+					for (_Node_base* __cur = __before_first._M_node; __cur != __before_last._M_node; __cur = __cur->_M_next)
+						++__n;
+				}
+				_M_splice_after(__pos._M_node, __x, __before_first._M_node, __before_last._M_node, __n);
+			}
 		}
-        // Moves the element that follows __prev to *this, inserting it immediately
-        //  after __pos.  This is constant time.
-		void splice_after(iterator __pos, iterator __prev)
+		// Moves the element of __x that follows __prev to *this, inserting it
+		// immediately after __pos.  This is constant time.
+		void splice_after(iterator __pos, slist& __x, iterator __prev)
 		{
-			__slist_splice_after(__pos._M_node, __prev._M_node, __prev._M_node->_M_next);
+			if (__prev._M_node->_M_next)
+				_M_splice_after(__pos._M_node, __x, __prev._M_node, __prev._M_node->_M_next, 1);
 		}
-	    // Removes all of the elements from the list __x to *this, inserting
-	    // them immediately after __pos.  __x must not be *this.  Complexity:
-	    // linear in __x.size().
+		// Removes all of the elements from the list __x to *this, inserting
+		// them immediately after __pos.  __x must not be *this.  This is
+		// constant time.
 		void splice_after(iterator __pos, slist& __x)
 		{
-			__slist_splice_after(__pos._M_node, &__x._M_head);
+			if (this != &__x && !__x.empty())
+				_M_splice_after(__pos._M_node, __x, &__x._M_head, __x._M_tail, __x._M_size);
 		}
 
-		// Linear in distance(begin(), __pos), and linear in __x.size().
+		// Linear in distance(begin(), __pos), constant if __pos is end().
 		void splice(iterator __pos, slist& __x)
 		{
-			if (__x._M_head._M_next)
-			{
-				__slist_splice_after(__slist_previous(&this->_M_head, __pos._M_node),
-									 &__x._M_head,
-									 __slist_previous(&__x._M_head, nullptr));
-			}
+			if (this != &__x && !__x.empty())
+				_M_splice_after(_M_previous(__pos._M_node), __x, &__x._M_head, __x._M_tail, __x._M_size);
 		}
 		// Linear in distance(begin(), __pos), and linear in distance(__x.begin(), __i).
 		void splice(iterator __pos, slist& __x, iterator __i)
 		{
-			__slist_splice_after(__slist_previous(&this->_M_head, __pos._M_node),
-								 __slist_previous(&__x->_M_head, __i._M_node),
-								 __i._M_node);
+			_M_splice_after(_M_previous(__pos._M_node), __x, __x._M_previous(__i._M_node), __i._M_node, 1);
 		}
-        // Linear in distance(begin(), __pos), in distance(__x.begin(), __first),
-	    // and in distance(__first, __last).
+		// Linear in distance(begin(), __pos), in distance(__x.begin(), __first),
+		// and in distance(__first, __last).
 		void splice(iterator __pos, slist& __x, iterator __first, iterator __last)
 		{
 			if (__first != __last)
 			{
-				__slist_splice_after(__slist_previous(&this->_M_head, __pos._M_node),
-									 __slist_previous(&__x->_M_head, __first._M_node),
-									 __slist_previous(__first._M_node, __last._M_node));
+				size_type __n = 1;
+				_Node_base* __before_last = __first._M_node;
+				for (; __before_last->_M_next != __last._M_node; __before_last = __before_last->_M_next)
+					++__n;
+				_M_splice_after(_M_previous(__pos._M_node), __x, __x._M_previous(__first._M_node), __before_last, this == &__x ? 0 : __n);
 			}
 		}
 
@@ -511,7 +566,10 @@ namespace TinySTL
 		void reverse()
 		{
 			if (this->_M_head._M_next)
+			{
+				this->_M_tail = this->_M_head._M_next;
 				this->_M_head._M_next = __slist_reverse(this->_M_head._M_next);
+			}
 		}
 		void remove(const T& __val);
 		void unique();
@@ -552,7 +610,36 @@ namespace TinySTL
 			else
 				_M_insert_after_range(__p1, const_iterator((_Node*)__n2), const_iterator(nullptr));
 		}
+		return *this;
+	}
+
+	template<class T, class Alloc>
+	inline void slist<T, Alloc>::swap(slist& __x)
+	{	// 空链表的_M_tail指向自身的_M_head，交换后需要改指向新的_M_head
+		TinySTL::swap(this->_M_head._M_next, __x._M_head._M_next);
+		TinySTL::swap(this->_M_tail, __x._M_tail);
+		TinySTL::swap(this->_M_size, __x._M_size);
+		if (this->_M_head._M_next == nullptr)
+			this->_M_tail = &this->_M_head;
+		if (__x._M_head._M_next == nullptr)
+			__x._M_tail = &__x._M_head;
+	}
+
+	template<class T, class Alloc>
+	inline void slist<T, Alloc>::_M_splice_after(_Node_base* __pos, slist& __x, _Node_base* __before_first, _Node_base* __before_last, size_type __n)
+	{
+		if (__pos != __before_first && __pos != __before_last)
+		{	// 先修正源链表的尾指针，再修正目标链表的尾指针(二者可能是同一链表)
+			if (__before_last == __x._M_tail)
+				__x._M_tail = __before_first;
+			if (__pos == this->_M_tail)
+				this->_M_tail = __before_last;
+			__slist_splice_after(__pos, __before_first, __before_last);
+			__x._M_size -= __n;
+			this->_M_size += __n;
+		}
 	}
+
 	template<class T, class Alloc>
 	inline void slist<T, Alloc>::_M_fill_assign(size_type __n, const T& __val)
 	{
@@ -575,7 +662,7 @@ namespace TinySTL
 	template<class T, class Alloc>
 	inline void slist<T, Alloc>::resize(size_type new_size, const T& __x)
 	{
-		int __len = new_size;
+		size_type __len = new_size;
 		_Node_base* __cur = &this->_M_head;
 		while (__cur->_M_next != nullptr && __len > 0)
 		{
@@ -620,52 +707,55 @@ namespace TinySTL
 	template<class T, class Alloc>
 	inline void slist<T, Alloc>::merge(slist& __x)
 	{
-		_Node_base* __n1 = &this->_M_head;
-		while (__n1->_M_next && __x._M_head._M_next)
+		merge(__x, TinySTL::less<T>());
+	}
+
+	// 合并两条以nullptr结尾的有序子链，结果存入__first1，__first2置为nullptr；键值相等时优先取__first1中的结点
+	// 若__comp抛出异常，__first1中仍保存两条链的全部结点(次序不定)，__first2同样置为nullptr
+	template<class T, class Alloc>
+	template<class _StrictWeakOrdering>
+	inline void slist<T, Alloc>::_M_merge_chain(_Node_base*& __first1, _Node_base*& __first2, _StrictWeakOrdering& __comp)
+	{
+		_Node_base __head;
+		_Node_base* __tail = &__head;
+		try
 		{
-			if (((_Node*)__x._M_head._M_next)->_M_data < ((_Node*)__n1->_M_next)->_M_data)
+			while (__first1 != nullptr && __first2 != nullptr)
 			{
-				__slist_splice_after(__n1, &__x._M_head, __x._M_head._M_next);
+				if (__comp(((_Node*)__first2)->_M_data, ((_Node*)__first1)->_M_data))
+				{
+					__tail->_M_next = __first2;
+					__first2 = __first2->_M_next;
+				}
+				else
+				{
+					__tail->_M_next = __first1;
+					__first1 = __first1->_M_next;
+				}
+				__tail = __tail->_M_next;
 			}
-			__n1 = __n1->_M_next;
 		}
-
-		if (__x._M_head._M_next)
+		catch (...)
 		{
-			__n1->_M_next = __x._M_head._M_next;
-			__x._M_head._M_next = nullptr;
+			__tail->_M_next = __first1;
+			while (__tail->_M_next != nullptr)
+				__tail = __tail->_M_next;
+			__tail->_M_next = __first2;
+			__first1 = __head._M_next;
+			__first2 = nullptr;
+			throw;
 		}
+		__tail->_M_next = __first1 != nullptr ? __first1 : __first2;
+		__first1 = __head._M_next;
+		__first2 = nullptr;
 	}
 
 	// 由于STL sort算法要求必须为随机迭代器,因此slist实现了自己的专用sort算法
 	// 该算法采用的是归并排序的思想
 	template<class T, class Alloc>
 	inline void slist<T, Alloc>::sort()
-	{	// Do nothing if the slist has length 0 or 1
-		if (this->_M_head._M_next && this->_M_head._M_next->_M_next)
-		{
-			// 一些新的slist，作为中介数据存放区
-			slist __carry;
-			slist __counter[64];
-			int __fill = 0;
-			while (!empty())
-			{
-				__slist_splice_after(&__carry._M_head, &this->_M_head, this->_M_head._M_next);
-				int __i = 0;
-				while (__i < __fill && !__counter[__i].empty())
-				{
-					__counter[__i].merge(__carry);
-					__carry.swap(__counter[__i]);
-					++__i;
-				}
-				__carry.swap(__counter[__i]);
-				if (__i == __fill)
-					++__fill;
-			}
-			for (int __i = 1; __i < __fill; ++__i)
-				__counter[__i].merge(__counter[__i - 1]);
-			this->swap(__counter[__fill - 1]);
-		}
+	{
+		sort(TinySTL::less<T>());
 	}
 
 	template<class T, class Alloc>
@@ -711,7 +801,7 @@ namespace TinySTL
 		{
 			while (__cur->_M_next)
 			{
-				if (((_Node*)__cur)->_M_data == ((_Node*)(__cur->_M_next))->_M_data)
+				if (__pred(((_Node*)__cur)->_M_data, ((_Node*)(__cur->_M_next))->_M_data))
 					this->_M_erase_after(__cur);
 				else
 					__cur = __cur->_M_next;
@@ -722,50 +812,85 @@ namespace TinySTL
 	template<class _StrictWeakOrdering>
 	inline void slist<T, Alloc>::merge(slist& __x, _StrictWeakOrdering __comp)
 	{
+		if (this == &__x || __x.empty())
+			return;
 		_Node_base* __n1 = &this->_M_head;
 		while (__n1->_M_next && __x._M_head._M_next)
 		{
 			if (__comp(((_Node*)__x._M_head._M_next)->_M_data, ((_Node*)__n1->_M_next)->_M_data))
 			{
-				__slist_splice_after(__n1, &__x._M_head, &__x._M_head._M_next);
+				__slist_splice_after(__n1, &__x._M_head, __x._M_head._M_next);
 			}
 			__n1 = __n1->_M_next;
 		}
+		// __x中剩余的元素都不小于*this的最后一个元素，整体接到尾部
 		if (__x._M_head._M_next)
 		{
 			__n1->_M_next = __x._M_head._M_next;
-			__x._M_head._M_next = nullptr;
+			this->_M_tail = __x._M_tail;
 		}
+		this->_M_size += __x._M_size;
+		__x._M_head._M_next = nullptr;
+		__x._M_tail = &__x._M_head;
+		__x._M_size = 0;
 	}
+	// 自底向上归并：__bins[i]中存放长度为2^i的有序子链，每取下一个结点就像二进制加法一样向高位进位合并
+	// 整个过程只改写_M_next，不创建临时slist，最后遍历一次找到新的尾结点
+	// 比较函数抛出异常时，把各条子链与尚未处理的部分重新接起来再抛出，元素不丢失，但次序不定
 	template<class T, class Alloc>
 	template<class _StrictWeakOrdering>
 	inline void slist<T, Alloc>::sort(_StrictWeakOrdering __comp)
-	{
+	{	// Do nothing if the slist has length 0 or 1
 		if (this->_M_head._M_next && this->_M_head._M_next->_M_next)
 		{
-			slist __carry;
-			slist __counter[64];
+			_Node_base* __bins[64] = {};
 			int __fill = 0;
-			while (!empty())
+			_Node_base* __result = nullptr;
+			_Node_base* __cur = this->_M_head._M_next;
+			try
 			{
-				__slist_splice_after(&__carry._M_head, &this->_M_head, &this->_M_head._M_next);
-				int __i = 0;
-				while (__i < __fill && !__counter[__i].empty())
+				while (__cur != nullptr)
 				{
-					__counter[__i].merge(__carry, __comp);
-					__carry.swap(__counter[__i]);
-					++__i;
+					_Node_base* __carry = __cur;
+					__cur = __cur->_M_next;
+					__carry->_M_next = nullptr;
+					int __i = 0;
+					for (; __i < __fill && __bins[__i] != nullptr; ++__i)
+					{
+						_M_merge_chain(__bins[__i], __carry, __comp);
+						__carry = __bins[__i];
+						__bins[__i] = nullptr;
+					}
+					__bins[__i] = __carry;
+					if (__i == __fill)
+						++__fill;
+				}
+				for (int __i = 0; __i < __fill; ++__i)
+				{
+					if (__bins[__i] == nullptr)
+						continue;
+					_M_merge_chain(__bins[__i], __result, __comp);
+					__result = __bins[__i];
+					__bins[__i] = nullptr;
 				}
-				__carry.swap(__counter[__i]);
-				if (__i == __fill)
-					++__fill;
 			}
-			for (int __i = 1; __i < __fill; ++__i)
-				__counter[__i].merge(__counter[__i - 1], __comp);
-			this->swap(__counter[__fill - 1]);
+			catch (...)
+			{	// 此时每个结点恰好位于__result、某个__bins[i]或__cur之一中
+				_Node_base* __tail = &this->_M_head;
+				__tail->_M_next = __result;
+				for (int __i = 0; __i <= __fill; ++__i)
+				{
+					while (__tail->_M_next != nullptr)
+						__tail = __tail->_M_next;
+					__tail->_M_next = __i < __fill ? __bins[__i] : __cur;
+				}
+				this->_M_tail = __slist_previous(&this->_M_head, nullptr);
+				throw;
+			}
+			this->_M_head._M_next = __result;
+			this->_M_tail = __slist_previous(&this->_M_head, nullptr);
 		}
 	}
 }
 
 #endif // !_SLIST_H_
-
@@ -0,0 +1,343 @@
+﻿#ifndef _THREAD_POOL_H_
+#define _THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "WorkStealingDeque.h"
+
+namespace TinySTL
+{
+	// 线程池中的任务。任务对象由发起者持有(通常位于其栈上)，线程池只传递指针
+	struct thread_pool_task
+	{
+		void               (*run_)(thread_pool_task*); // 执行任务体，异常存入error_
+		thread_pool_task*  next_;                      // 外部提交队列中的链接
+		std::exception_ptr error_;
+		std::atomic<bool>  done_;
+
+		explicit thread_pool_task(void (*Run)(thread_pool_task*)) : run_(Run), next_(nullptr), error_(), done_(false) {}
+	};
+
+	/*
+	* ***********************************
+	* thread_pool : fork-join工作窃取线程池
+	* ***********************************
+	* 每个工作线程拥有一个ws_deque<thread_pool_task*>，空闲时随机窃取其他线程的任务
+	* invoke(Left, Right)：把Right压入当前线程的队列后立即执行Left；之后若Right未被窃取则就地执行，
+	*      否则一边窃取执行其他任务一边等待Right完成。invoke返回前两个函数必已执行完毕，
+	*      因此任务对象直接放在调用者的栈上，整个过程不分配内存
+	* 非工作线程调用invoke时，整个调用作为根任务提交给线程池，调用者阻塞至其完成
+	* Left或Right抛出的异常在两者都结束后重新抛出(都抛出时保留Left的异常)
+	*/
+	class thread_pool
+	{
+	public:
+		using size_type = size_t;
+
+	private:
+		struct worker_type
+		{
+			thread_pool*                  pool_;
+			ws_deque<thread_pool_task*>   deque_;
+			std::thread                   thread_;
+			unsigned                      seed_;   // 选择窃取对象的随机数状态
+		};
+
+		template<class Fn>
+		struct closure_task : public thread_pool_task
+		{
+			Fn& fn_;
+
+			explicit closure_task(Fn& Func) : thread_pool_task(&run), fn_(Func) {}
+
+			static void run(thread_pool_task* Task)
+			{
+				closure_task* Self = static_cast<closure_task*>(Task);
+				try
+				{
+					Self->fn_();
+				}
+				catch (...)
+				{
+					Self->error_ = std::current_exception();
+				}
+			}
+		};
+
+		// 空闲的工作线程先自旋若干轮再休眠
+		enum { s_spinRounds = 64 };
+
+	public:
+		// Threads为工作线程数；为0时invoke退化为依次调用
+		explicit thread_pool(size_type Threads = default_concurrency());
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+		~thread_pool();
+
+	public:
+		template<class F1, class F2>
+		void invoke(F1&& Left, F2&& Right);
+
+		size_type size() const { return count_; }
+		// 当前线程是否为本线程池的工作线程
+		bool is_worker() const { return current() != nullptr && current()->pool_ == this; }
+
+		static size_type default_concurrency()
+		{
+			unsigned Count = std::thread::hardware_concurrency();
+			return Count == 0 ? 1 : Count;
+		}
+
+		// 进程内共享的线程池，首次使用时创建，线程数为default_concurrency()
+		static thread_pool& default_pool()
+		{
+			static thread_pool Pool;
+			return Pool;
+		}
+
+	private:
+		static worker_type*& current()
+		{
+			static thread_local worker_type* Worker = nullptr;
+			return Worker;
+		}
+
+		static void execute(thread_pool_task* Task)
+		{	// done_是最后一次访问Task，之后其所有者随时可能销毁它
+			Task->run_(Task);
+			Task->done_.store(true, std::memory_order_release);
+		}
+
+		void worker_loop(worker_type* Self);
+		thread_pool_task* steal_task(worker_type* Self);
+		thread_pool_task* take_submitted();
+		void wait_for(worker_type* Self, thread_pool_task* Task);
+		void run_external(thread_pool_task* Task);
+		void notify();
+		void shutdown(); // 停止并回收所有工作线程
+
+	private:
+		worker_type*                 workers_;
+		size_type                    count_;
+		std::mutex                   mutex_;
+		std::condition_variable      wake_;      // 唤醒休眠的工作线程
+		std::condition_variable      finished_;  // 通知外部线程其根任务已完成
+		thread_pool_task*            submitted_; // 外部线程提交的根任务，由mutex_保护
+		bool                         stop_;      // 由mutex_保护
+		std::atomic<unsigned>        epoch_;     // 每次有新任务可取时递增
+		std::atomic<size_type>       sleepers_;  // 正在休眠的工作线程数
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	inline thread_pool::thread_pool(size_type Threads)
+		: workers_(nullptr), count_(0), submitted_(nullptr), stop_(false), epoch_(0), sleepers_(0)
+	{
+		if (Threads == 0)
+			return;
+		// ws_deque按cache line对齐，超出了malloc保证的对齐，因此用new[]而不是alloc
+		workers_ = new worker_type[Threads];
+		for (size_type Idx = 0; Idx < Threads; ++Idx)
+		{
+			workers_[Idx].pool_ = this;
+			workers_[Idx].seed_ = static_cast<unsigned>(Idx * 2654435761u + 1);
+		}
+		count_ = Threads;
+		try
+		{
+			for (size_type Idx = 0; Idx < Threads; ++Idx)
+			{
+				worker_type* Worker = workers_ + Idx;
+				Worker->thread_ = std::thread([this, Worker] { worker_loop(Worker); });
+			}
+		}
+		catch (...)
+		{
+			shutdown();
+			throw;
+		}
+	}
+
+	inline thread_pool::~thread_pool()
+	{
+		shutdown();
+	}
+
+	inline void thread_pool::shutdown()
+	{
+		if (workers_ == nullptr)
+			return;
+		{
+			std::lock_guard<std::mutex> Lock(mutex_);
+			stop_ = true;
+		}
+		wake_.notify_all();
+		for (size_type Idx = 0; Idx < count_; ++Idx)
+		{
+			if (workers_[Idx].thread_.joinable())
+				workers_[Idx].thread_.join();
+		}
+		delete[] workers_;
+		workers_ = nullptr;
+	}
+
+	template<class F1, class F2>
+	inline void thread_pool::invoke(F1&& Left, F2&& Right)
+	{
+		if (count_ == 0)
+		{
+			Left();
+			Right();
+			return;
+		}
+
+		worker_type* Self = current();
+		if (Self == nullptr || Self->pool_ != this)
+		{	// 外部线程：把整个invoke交给工作线程执行
+			auto Body = [this, &Left, &Right] { invoke(Left, Right); };
+			closure_task<decltype(Body)> Root(Body);
+			run_external(&Root);
+			if (Root.error_)
+				std::rethrow_exception(Root.error_);
+			return;
+		}
+
+		closure_task<F2> Task(Right);
+		Self->deque_.push(&Task);
+		notify();
+
+		std::exception_ptr Error;
+		try
+		{
+			Left();
+		}
+		catch (...)
+		{
+			Error = std::current_exception();
+		}
+
+		// Left中嵌套的invoke均已配平，队列底部若还有任务，必然就是Task
+		thread_pool_task* Back;
+		if (Self->deque_.pop(Back))
+			execute(Back);
+		else
+			wait_for(Self, &Task);
+
+		if (Error)
+			std::rethrow_exception(Error);
+		if (Task.error_)
+			std::rethrow_exception(Task.error_);
+	}
+
+	inline void thread_pool::notify()
+	{
+		epoch_.fetch_add(1, std::memory_order_seq_cst);
+		// 与worker_loop中先增加sleepers_再检查epoch_的顺序配对，不会丢失唤醒
+		if (sleepers_.load(std::memory_order_seq_cst) != 0)
+		{
+			{
+				std::lock_guard<std::mutex> Lock(mutex_);
+			}
+			wake_.notify_one();
+		}
+	}
+
+	inline thread_pool_task* thread_pool::steal_task(worker_type* Self)
+	{	// 从随机位置开始依次尝试窃取其他工作线程的任务
+		Self->seed_ ^= Self->seed_ << 13;
+		Self->seed_ ^= Self->seed_ >> 17;
+		Self->seed_ ^= Self->seed_ << 5;
+		size_type Start = Self->seed_ % count_;
+		for (size_type Idx = 0; Idx < count_; ++Idx)
+		{
+			worker_type* Victim = workers_ + (Start + Idx) % count_;
+			thread_pool_task* Task;
+			if (Victim != Self && Victim->deque_.steal(Task))
+				return Task;
+		}
+		return nullptr;
+	}
+
+	inline thread_pool_task* thread_pool::take_submitted()
+	{
+		std::lock_guard<std::mutex> Lock(mutex_);
+		thread_pool_task* Task = submitted_;
+		if (Task != nullptr)
+			submitted_ = Task->next_;
+		return Task;
+	}
+
+	inline void thread_pool::wait_for(worker_type* Self, thread_pool_task* Task)
+	{	// Task已被窃取：协助执行其他任务直到它完成。此时自己的队列必为空，只需窃取
+		while (!Task->done_.load(std::memory_order_acquire))
+		{
+			thread_pool_task* Other = steal_task(Self);
+			if (Other != nullptr)
+				execute(Other);
+			else
+				std::this_thread::yield();
+		}
+	}
+
+	inline void thread_pool::run_external(thread_pool_task* Task)
+	{
+		{
+			std::lock_guard<std::mutex> Lock(mutex_);
+			Task->next_ = submitted_;
+			submitted_ = Task;
+		}
+		notify();
+
+		std::unique_lock<std::mutex> Lock(mutex_);
+		finished_.wait(Lock, [Task] { return Task->done_.load(std::memory_order_acquire); });
+	}
+
+	inline void thread_pool::worker_loop(worker_type* Self)
+	{
+		current() = Self;
+		for (;;)
+		{
+			unsigned Epoch = epoch_.load(std::memory_order_seq_cst);
+			thread_pool_task* Task = nullptr;
+			bool Submitted = false;
+			for (int Round = 0; Task == nullptr && Round < s_spinRounds; ++Round)
+			{
+				if (!Self->deque_.pop(Task) && (Task = steal_task(Self)) == nullptr)
+				{
+					Task = take_submitted();
+					Submitted = Task != nullptr;
+				}
+				if (Task == nullptr)
+					std::this_thread::yield();
+			}
+
+			if (Task != nullptr)
+			{
+				execute(Task);
+				if (Submitted)
+				{	// 外部线程在finished_上等待，加锁保证其检查done_与休眠之间不会错过通知
+					{
+						std::lock_guard<std::mutex> Lock(mutex_);
+					}
+					finished_.notify_all();
+				}
+				continue;
+			}
+
+			std::unique_lock<std::mutex> Lock(mutex_);
+			if (stop_ && submitted_ == nullptr)
+				return;
+			sleepers_.fetch_add(1, std::memory_order_seq_cst);
+			wake_.wait(Lock, [this, Epoch] {
+				return stop_ || submitted_ != nullptr || epoch_.load(std::memory_order_seq_cst) != Epoch;
+			});
+			sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+		}
+	}
+}
+
+#endif // !_THREAD_POOL_H_
@@ -457,6 +457,64 @@ namespace TinySTL
 
 	template <class T>
 	struct is_integral : bool_constant<is_integral_v<T>> {};
+
+	/*
+	* ***********************************
+	* C++17
+	* type_traits
+	* is_trivially_copyable_v
+	* ***********************************
+	*/
+	template <class T>
+	inline constexpr bool is_trivially_copyable_v = __is_trivially_copyable(T);
+
+	template <class T>
+	struct is_trivially_copyable : bool_constant<is_trivially_copyable_v<T>> {};
+
+	/*
+	* ***********************************
+	* C++17
+	* type_traits
+	* remove_reference_t
+	* remove_cvref_t
+	* enable_if_t
+	* ***********************************
+	*/
+	template <class T>
+	struct remove_reference
+	{
+		using type = T;
+	};
+
+	template <class T>
+	struct remove_reference<T&>
+	{
+		using type = T;
+	};
+
+	template <class T>
+	struct remove_reference<T&&>
+	{
+		using type = T;
+	};
+
+	template <class T>
+	using remove_reference_t = typename remove_reference<T>::type;
+
+	template <class T>
+	using remove_cvref_t = remove_cv_t<remove_reference_t<T>>;
+
+	template <bool Test, class T = void>
+	struct enable_if {}; // Test为false时没有type，使用它的模板在重载决议中被排除
+
+	template <class T>
+	struct enable_if<true, T>
+	{
+		using type = T;
+	};
+
+	template <bool Test, class T = void>
+	using enable_if_t = typename enable_if<Test, T>::type;
 }
 
 #endif
\ No newline at end of file
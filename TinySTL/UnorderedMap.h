@@ -0,0 +1,291 @@
+﻿#ifndef _UNORDERED_MAP_H_
+#define _UNORDERED_MAP_H_
+
+#include <utility>
+#include <stdexcept>
+
+#include "Hashtable.h"
+#include "Functional.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* unordered_map : 以_Hashtable为底层的无序关联容器
+	* ***********************************
+	* 元素为pair<const Key, T>，键值不允许重复；查找、插入、删除的平均复杂度为O(1)
+	* 插入可能引起重新哈希，使所有迭代器失效，但不使指针与引用失效
+	*
+	* operator[]/try_emplace/insert_or_assign只计算一次哈希值：未命中时以同一哈希值直接链接新节点，不再重复查找
+	*/
+	template<class _Key, class _Tp, class _HashFcn = TinySTL::hash<_Key>, class _EqualKey = TinySTL::equal_to<_Key>, class _Alloc = TinySTL::alloc>
+	class unordered_map
+	{
+	public:
+		using key_type    = _Key;
+		using mapped_type = _Tp;
+		using value_type  = TinySTL::pair<const _Key, _Tp>;
+
+	private:
+		using _Ht = _Hashtable<value_type, _Key, _HashFcn, TinySTL::select1st<value_type>, _EqualKey, _Alloc>;
+		_Ht _M_ht; // 底层的哈希表
+
+	public:
+		using hasher          = typename _Ht::hasher;
+		using key_equal       = typename _Ht::key_equal;
+
+		using size_type       = typename _Ht::size_type;
+		using difference_type = typename _Ht::difference_type;
+		using pointer         = typename _Ht::pointer;
+		using const_pointer   = typename _Ht::const_pointer;
+		using reference       = typename _Ht::reference;
+		using const_reference = typename _Ht::const_reference;
+		using iterator        = typename _Ht::iterator;
+		using const_iterator  = typename _Ht::const_iterator;
+		using allocator_type  = typename _Ht::allocator_type;
+
+	public:
+		unordered_map() : _M_ht() {}
+		explicit unordered_map(size_type __n, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& __a = allocator_type())
+			: _M_ht(__n, __hf, __eql, __a) {}
+
+		template<class InIt>
+		unordered_map(InIt __first, InIt __last, size_type __n = 0, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& __a = allocator_type())
+			: _M_ht(__n, __hf, __eql, __a)
+		{
+			_M_ht.insert_unique(__first, __last);
+		}
+
+	public:
+		hasher hash_function() const { return _M_ht.hash_funct(); }
+		key_equal key_eq() const { return _M_ht.key_eq(); }
+		allocator_type get_allocator() const { return _M_ht.get_allocator(); }
+
+		// Iterator:
+		iterator begin() { return _M_ht.begin(); }
+		const_iterator begin() const { return _M_ht.begin(); }
+		iterator end() { return _M_ht.end(); }
+		const_iterator end() const { return _M_ht.end(); }
+		const_iterator cbegin() const { return _M_ht.begin(); }
+		const_iterator cend() const { return _M_ht.end(); }
+
+		// Capacity:
+		bool empty() const { return _M_ht.empty(); }
+		size_type size() const { return _M_ht.size(); }
+		size_type max_size() const { return _M_ht.max_size(); }
+
+		// Element access:
+		mapped_type& operator[](const key_type& __k)
+		{
+			size_type __code = _M_ht._M_hash_code(__k);
+			iterator __i = _M_ht._M_find(__k, __code);
+			if (__i == end())
+				__i = _M_ht._M_insert_unique_node(__code, value_type(__k, mapped_type()));
+			return (*__i).second;
+		}
+		mapped_type& at(const key_type& __k)
+		{
+			iterator __i = find(__k);
+			if (__i == end())
+				throw std::out_of_range("unordered_map::at");
+			return (*__i).second;
+		}
+		const mapped_type& at(const key_type& __k) const
+		{
+			const_iterator __i = find(__k);
+			if (__i == end())
+				throw std::out_of_range("unordered_map::at");
+			return (*__i).second;
+		}
+
+		// Modifiers:
+		TinySTL::pair<iterator, bool> insert(const value_type& __x) { return _M_ht.insert_unique(__x); }
+		iterator insert(const_iterator, const value_type& __x) { return _M_ht.insert_unique(__x).first; }
+		template<class InIt>
+		void insert(InIt __first, InIt __last) { _M_ht.insert_unique(__first, __last); }
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> emplace(_Args&&... __args)
+		{
+			return _M_ht.insert_unique(value_type(std::forward<_Args>(__args)...));
+		}
+
+		// 键值不存在时才以__args构造实值并插入
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> try_emplace(const key_type& __k, _Args&&... __args)
+		{
+			size_type __code = _M_ht._M_hash_code(__k);
+			iterator __i = _M_ht._M_find(__k, __code);
+			if (__i != end())
+				return TinySTL::pair<iterator, bool>(__i, false);
+			__i = _M_ht._M_insert_unique_node(__code, value_type(__k, mapped_type(std::forward<_Args>(__args)...)));
+			return TinySTL::pair<iterator, bool>(__i, true);
+		}
+
+		// 键值已存在时为其实值赋值，否则插入
+		template<class _Obj>
+		TinySTL::pair<iterator, bool> insert_or_assign(const key_type& __k, _Obj&& __obj)
+		{
+			size_type __code = _M_ht._M_hash_code(__k);
+			iterator __i = _M_ht._M_find(__k, __code);
+			if (__i != end())
+			{
+				(*__i).second = std::forward<_Obj>(__obj);
+				return TinySTL::pair<iterator, bool>(__i, false);
+			}
+			__i = _M_ht._M_insert_unique_node(__code, value_type(__k, mapped_type(std::forward<_Obj>(__obj))));
+			return TinySTL::pair<iterator, bool>(__i, true);
+		}
+
+		iterator erase(const_iterator __position) { return _M_ht.erase(__position); }
+		size_type erase(const key_type& __x) { return _M_ht.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last) { return _M_ht.erase(__first, __last); }
+		void clear() { _M_ht.clear(); }
+		void swap(unordered_map& __x) { _M_ht.swap(__x._M_ht); }
+
+		// Lookup:
+		iterator find(const key_type& __x) { return _M_ht.find(__x); }
+		const_iterator find(const key_type& __x) const { return _M_ht.find(__x); }
+		size_type count(const key_type& __x) const { return _M_ht.count(__x); }
+		bool contains(const key_type& __x) const { return _M_ht.find(__x) != _M_ht.end(); }
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) { return _M_ht.equal_range(__x); }
+		TinySTL::pair<const_iterator, const_iterator> equal_range(const key_type& __x) const { return _M_ht.equal_range(__x); }
+
+		// Bucket interface:
+		size_type bucket_count() const { return _M_ht.bucket_count(); }
+		size_type max_bucket_count() const { return _M_ht.max_bucket_count(); }
+		size_type bucket_size(size_type __n) const { return _M_ht.bucket_size(__n); }
+		size_type bucket(const key_type& __x) const { return _M_ht.bucket(__x); }
+
+		// Hash policy:
+		float load_factor() const { return _M_ht.load_factor(); }
+		float max_load_factor() const { return _M_ht.max_load_factor(); }
+		void max_load_factor(float __z) { _M_ht.max_load_factor(__z); }
+		void rehash(size_type __n) { _M_ht.rehash(__n); }
+		void reserve(size_type __n) { _M_ht.reserve(__n); }
+
+		friend bool operator==(const unordered_map& __x, const unordered_map& __y) { return __x._M_ht._M_equal_unique(__y._M_ht); }
+		friend bool operator!=(const unordered_map& __x, const unordered_map& __y) { return !(__x == __y); }
+	};
+
+	template<class _Key, class _Tp, class _HashFcn, class _EqualKey, class _Alloc>
+	inline void swap(unordered_map<_Key, _Tp, _HashFcn, _EqualKey, _Alloc>& __x, unordered_map<_Key, _Tp, _HashFcn, _EqualKey, _Alloc>& __y)
+	{
+		__x.swap(__y);
+	}
+
+	/*
+	* ***********************************
+	* unordered_multimap : 键值可以重复的unordered_map
+	* ***********************************
+	* 键值相等的元素相邻存放，equal_range返回的区间即为它们
+	*/
+	template<class _Key, class _Tp, class _HashFcn = TinySTL::hash<_Key>, class _EqualKey = TinySTL::equal_to<_Key>, class _Alloc = TinySTL::alloc>
+	class unordered_multimap
+	{
+	public:
+		using key_type    = _Key;
+		using mapped_type = _Tp;
+		using value_type  = TinySTL::pair<const _Key, _Tp>;
+
+	private:
+		using _Ht = _Hashtable<value_type, _Key, _HashFcn, TinySTL::select1st<value_type>, _EqualKey, _Alloc>;
+		_Ht _M_ht; // 底层的哈希表
+
+	public:
+		using hasher          = typename _Ht::hasher;
+		using key_equal       = typename _Ht::key_equal;
+
+		using size_type       = typename _Ht::size_type;
+		using difference_type = typename _Ht::difference_type;
+		using pointer         = typename _Ht::pointer;
+		using const_pointer   = typename _Ht::const_pointer;
+		using reference       = typename _Ht::reference;
+		using const_reference = typename _Ht::const_reference;
+		using iterator        = typename _Ht::iterator;
+		using const_iterator  = typename _Ht::const_iterator;
+		using allocator_type  = typename _Ht::allocator_type;
+
+	public:
+		unordered_multimap() : _M_ht() {}
+		explicit unordered_multimap(size_type __n, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& __a = allocator_type())
+			: _M_ht(__n, __hf, __eql, __a) {}
+
+		template<class InIt>
+		unordered_multimap(InIt __first, InIt __last, size_type __n = 0, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& __a = allocator_type())
+			: _M_ht(__n, __hf, __eql, __a)
+		{
+			_M_ht.insert_equal(__first, __last);
+		}
+
+	public:
+		hasher hash_function() const { return _M_ht.hash_funct(); }
+		key_equal key_eq() const { return _M_ht.key_eq(); }
+		allocator_type get_allocator() const { return _M_ht.get_allocator(); }
+
+		// Iterator:
+		iterator begin() { return _M_ht.begin(); }
+		const_iterator begin() const { return _M_ht.begin(); }
+		iterator end() { return _M_ht.end(); }
+		const_iterator end() const { return _M_ht.end(); }
+		const_iterator cbegin() const { return _M_ht.begin(); }
+		const_iterator cend() const { return _M_ht.end(); }
+
+		// Capacity:
+		bool empty() const { return _M_ht.empty(); }
+		size_type size() const { return _M_ht.size(); }
+		size_type max_size() const { return _M_ht.max_size(); }
+
+		// Modifiers:
+		iterator insert(const value_type& __x) { return _M_ht.insert_equal(__x); }
+		iterator insert(const_iterator, const value_type& __x) { return _M_ht.insert_equal(__x); }
+		template<class InIt>
+		void insert(InIt __first, InIt __last) { _M_ht.insert_equal(__first, __last); }
+		template<class... _Args>
+		iterator emplace(_Args&&... __args)
+		{
+			return _M_ht.insert_equal(value_type(std::forward<_Args>(__args)...));
+		}
+
+		iterator erase(const_iterator __position) { return _M_ht.erase(__position); }
+		size_type erase(const key_type& __x) { return _M_ht.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last) { return _M_ht.erase(__first, __last); }
+		void clear() { _M_ht.clear(); }
+		void swap(unordered_multimap& __x) { _M_ht.swap(__x._M_ht); }
+
+		// Lookup:
+		iterator find(const key_type& __x) { return _M_ht.find(__x); }
+		const_iterator find(const key_type& __x) const { return _M_ht.find(__x); }
+		size_type count(const key_type& __x) const { return _M_ht.count(__x); }
+		bool contains(const key_type& __x) const { return _M_ht.find(__x) != _M_ht.end(); }
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) { return _M_ht.equal_range(__x); }
+		TinySTL::pair<const_iterator, const_iterator> equal_range(const key_type& __x) const { return _M_ht.equal_range(__x); }
+
+		// Bucket interface:
+		size_type bucket_count() const { return _M_ht.bucket_count(); }
+		size_type max_bucket_count() const { return _M_ht.max_bucket_count(); }
+		size_type bucket_size(size_type __n) const { return _M_ht.bucket_size(__n); }
+		size_type bucket(const key_type& __x) const { return _M_ht.bucket(__x); }
+
+		// Hash policy:
+		float load_factor() const { return _M_ht.load_factor(); }
+		float max_load_factor() const { return _M_ht.max_load_factor(); }
+		void max_load_factor(float __z) { _M_ht.max_load_factor(__z); }
+		void rehash(size_type __n) { _M_ht.rehash(__n); }
+		void reserve(size_type __n) { _M_ht.reserve(__n); }
+
+		friend bool operator==(const unordered_multimap& __x, const unordered_multimap& __y) { return __x._M_ht._M_equal_multi(__y._M_ht); }
+		friend bool operator!=(const unordered_multimap& __x, const unordered_multimap& __y) { return !(__x == __y); }
+	};
+
+	template<class _Key, class _Tp, class _HashFcn, class _EqualKey, class _Alloc>
+	inline void swap(unordered_multimap<_Key, _Tp, _HashFcn, _EqualKey, _Alloc>& __x, unordered_multimap<_Key, _Tp, _HashFcn, _EqualKey, _Alloc>& __y)
+	{
+		__x.swap(__y);
+	}
+}
+
+#endif // !_UNORDERED_MAP_H_
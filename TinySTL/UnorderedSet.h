@@ -0,0 +1,227 @@
+﻿#ifndef _UNORDERED_SET_H_
+#define _UNORDERED_SET_H_
+
+#include <utility>
+
+#include "Hashtable.h"
+#include "Functional.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* unordered_set : 以_Hashtable为底层的无序集合
+	* ***********************************
+	* 查找、插入、删除的平均复杂度为O(1)，元素不按任何次序排列
+	* 插入可能引起重新哈希，使所有迭代器失效，但不使指针与引用失效
+	*/
+	template<class _Value, class _HashFcn = TinySTL::hash<_Value>, class _EqualKey = TinySTL::equal_to<_Value>, class _Alloc = TinySTL::alloc>
+	class unordered_set
+	{
+	private:
+		using _Ht = _Hashtable<_Value, _Value, _HashFcn, TinySTL::identity<_Value>, _EqualKey, _Alloc>;
+		_Ht _M_ht; // 底层的哈希表
+
+	public:
+		using key_type        = typename _Ht::key_type;
+		using value_type      = typename _Ht::value_type;
+		using hasher          = typename _Ht::hasher;
+		using key_equal       = typename _Ht::key_equal;
+
+		using size_type       = typename _Ht::size_type;
+		using difference_type = typename _Ht::difference_type;
+		using pointer         = typename _Ht::const_pointer;
+		using const_pointer   = typename _Ht::const_pointer;
+		using reference       = typename _Ht::const_reference;
+		using const_reference = typename _Ht::const_reference;
+		using iterator        = typename _Ht::const_iterator; // 元素即键值，不允许修改
+		using const_iterator  = typename _Ht::const_iterator;
+		using allocator_type  = typename _Ht::allocator_type;
+
+	public:
+		unordered_set() : _M_ht() {}
+		explicit unordered_set(size_type __n, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& __a = allocator_type())
+			: _M_ht(__n, __hf, __eql, __a) {}
+
+		template<class InIt>
+		unordered_set(InIt __first, InIt __last, size_type __n = 0, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& __a = allocator_type())
+			: _M_ht(__n, __hf, __eql, __a)
+		{
+			_M_ht.insert_unique(__first, __last);
+		}
+
+	public:
+		hasher hash_function() const { return _M_ht.hash_funct(); }
+		key_equal key_eq() const { return _M_ht.key_eq(); }
+		allocator_type get_allocator() const { return _M_ht.get_allocator(); }
+
+		// Iterator:
+		iterator begin() const { return _M_ht.begin(); }
+		iterator end() const { return _M_ht.end(); }
+		const_iterator cbegin() const { return _M_ht.begin(); }
+		const_iterator cend() const { return _M_ht.end(); }
+
+		// Capacity:
+		bool empty() const { return _M_ht.empty(); }
+		size_type size() const { return _M_ht.size(); }
+		size_type max_size() const { return _M_ht.max_size(); }
+
+		// Modifiers:
+		TinySTL::pair<iterator, bool> insert(const value_type& __x)
+		{
+			TinySTL::pair<typename _Ht::iterator, bool> __p = _M_ht.insert_unique(__x);
+			return TinySTL::pair<iterator, bool>(__p.first, __p.second);
+		}
+		iterator insert(const_iterator, const value_type& __x) { return insert(__x).first; }
+		template<class InIt>
+		void insert(InIt __first, InIt __last) { _M_ht.insert_unique(__first, __last); }
+		template<class... _Args>
+		TinySTL::pair<iterator, bool> emplace(_Args&&... __args)
+		{
+			return insert(value_type(std::forward<_Args>(__args)...));
+		}
+
+		iterator erase(const_iterator __position) { return _M_ht.erase(__position); }
+		size_type erase(const key_type& __x) { return _M_ht.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last) { return _M_ht.erase(__first, __last); }
+		void clear() { _M_ht.clear(); }
+		void swap(unordered_set& __x) { _M_ht.swap(__x._M_ht); }
+
+		// Lookup:
+		iterator find(const key_type& __x) const { return _M_ht.find(__x); }
+		size_type count(const key_type& __x) const { return _M_ht.count(__x); }
+		bool contains(const key_type& __x) const { return _M_ht.find(__x) != _M_ht.end(); }
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) const { return _M_ht.equal_range(__x); }
+
+		// Bucket interface:
+		size_type bucket_count() const { return _M_ht.bucket_count(); }
+		size_type max_bucket_count() const { return _M_ht.max_bucket_count(); }
+		size_type bucket_size(size_type __n) const { return _M_ht.bucket_size(__n); }
+		size_type bucket(const key_type& __x) const { return _M_ht.bucket(__x); }
+
+		// Hash policy:
+		float load_factor() const { return _M_ht.load_factor(); }
+		float max_load_factor() const { return _M_ht.max_load_factor(); }
+		void max_load_factor(float __z) { _M_ht.max_load_factor(__z); }
+		void rehash(size_type __n) { _M_ht.rehash(__n); }
+		void reserve(size_type __n) { _M_ht.reserve(__n); }
+
+		friend bool operator==(const unordered_set& __x, const unordered_set& __y) { return __x._M_ht._M_equal_unique(__y._M_ht); }
+		friend bool operator!=(const unordered_set& __x, const unordered_set& __y) { return !(__x == __y); }
+	};
+
+	template<class _Value, class _HashFcn, class _EqualKey, class _Alloc>
+	inline void swap(unordered_set<_Value, _HashFcn, _EqualKey, _Alloc>& __x, unordered_set<_Value, _HashFcn, _EqualKey, _Alloc>& __y)
+	{
+		__x.swap(__y);
+	}
+
+	/*
+	* ***********************************
+	* unordered_multiset : 键值可以重复的unordered_set
+	* ***********************************
+	* 键值相等的元素相邻存放，equal_range返回的区间即为它们
+	*/
+	template<class _Value, class _HashFcn = TinySTL::hash<_Value>, class _EqualKey = TinySTL::equal_to<_Value>, class _Alloc = TinySTL::alloc>
+	class unordered_multiset
+	{
+	private:
+		using _Ht = _Hashtable<_Value, _Value, _HashFcn, TinySTL::identity<_Value>, _EqualKey, _Alloc>;
+		_Ht _M_ht; // 底层的哈希表
+
+	public:
+		using key_type        = typename _Ht::key_type;
+		using value_type      = typename _Ht::value_type;
+		using hasher          = typename _Ht::hasher;
+		using key_equal       = typename _Ht::key_equal;
+
+		using size_type       = typename _Ht::size_type;
+		using difference_type = typename _Ht::difference_type;
+		using pointer         = typename _Ht::const_pointer;
+		using const_pointer   = typename _Ht::const_pointer;
+		using reference       = typename _Ht::const_reference;
+		using const_reference = typename _Ht::const_reference;
+		using iterator        = typename _Ht::const_iterator;
+		using const_iterator  = typename _Ht::const_iterator;
+		using allocator_type  = typename _Ht::allocator_type;
+
+	public:
+		unordered_multiset() : _M_ht() {}
+		explicit unordered_multiset(size_type __n, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& __a = allocator_type())
+			: _M_ht(__n, __hf, __eql, __a) {}
+
+		template<class InIt>
+		unordered_multiset(InIt __first, InIt __last, size_type __n = 0, const hasher& __hf = hasher(), const key_equal& __eql = key_equal(),
+			const allocator_type& __a = allocator_type())
+			: _M_ht(__n, __hf, __eql, __a)
+		{
+			_M_ht.insert_equal(__first, __last);
+		}
+
+	public:
+		hasher hash_function() const { return _M_ht.hash_funct(); }
+		key_equal key_eq() const { return _M_ht.key_eq(); }
+		allocator_type get_allocator() const { return _M_ht.get_allocator(); }
+
+		// Iterator:
+		iterator begin() const { return _M_ht.begin(); }
+		iterator end() const { return _M_ht.end(); }
+		const_iterator cbegin() const { return _M_ht.begin(); }
+		const_iterator cend() const { return _M_ht.end(); }
+
+		// Capacity:
+		bool empty() const { return _M_ht.empty(); }
+		size_type size() const { return _M_ht.size(); }
+		size_type max_size() const { return _M_ht.max_size(); }
+
+		// Modifiers:
+		iterator insert(const value_type& __x) { return _M_ht.insert_equal(__x); }
+		iterator insert(const_iterator, const value_type& __x) { return _M_ht.insert_equal(__x); }
+		template<class InIt>
+		void insert(InIt __first, InIt __last) { _M_ht.insert_equal(__first, __last); }
+		template<class... _Args>
+		iterator emplace(_Args&&... __args)
+		{
+			return insert(value_type(std::forward<_Args>(__args)...));
+		}
+
+		iterator erase(const_iterator __position) { return _M_ht.erase(__position); }
+		size_type erase(const key_type& __x) { return _M_ht.erase(__x); }
+		iterator erase(const_iterator __first, const_iterator __last) { return _M_ht.erase(__first, __last); }
+		void clear() { _M_ht.clear(); }
+		void swap(unordered_multiset& __x) { _M_ht.swap(__x._M_ht); }
+
+		// Lookup:
+		iterator find(const key_type& __x) const { return _M_ht.find(__x); }
+		size_type count(const key_type& __x) const { return _M_ht.count(__x); }
+		bool contains(const key_type& __x) const { return _M_ht.find(__x) != _M_ht.end(); }
+		TinySTL::pair<iterator, iterator> equal_range(const key_type& __x) const { return _M_ht.equal_range(__x); }
+
+		// Bucket interface:
+		size_type bucket_count() const { return _M_ht.bucket_count(); }
+		size_type max_bucket_count() const { return _M_ht.max_bucket_count(); }
+		size_type bucket_size(size_type __n) const { return _M_ht.bucket_size(__n); }
+		size_type bucket(const key_type& __x) const { return _M_ht.bucket(__x); }
+
+		// Hash policy:
+		float load_factor() const { return _M_ht.load_factor(); }
+		float max_load_factor() const { return _M_ht.max_load_factor(); }
+		void max_load_factor(float __z) { _M_ht.max_load_factor(__z); }
+		void rehash(size_type __n) { _M_ht.rehash(__n); }
+		void reserve(size_type __n) { _M_ht.reserve(__n); }
+
+		friend bool operator==(const unordered_multiset& __x, const unordered_multiset& __y) { return __x._M_ht._M_equal_multi(__y._M_ht); }
+		friend bool operator!=(const unordered_multiset& __x, const unordered_multiset& __y) { return !(__x == __y); }
+	};
+
+	template<class _Value, class _HashFcn, class _EqualKey, class _Alloc>
+	inline void swap(unordered_multiset<_Value, _HashFcn, _EqualKey, _Alloc>& __x, unordered_multiset<_Value, _HashFcn, _EqualKey, _Alloc>& __y)
+	{
+		__x.swap(__y);
+	}
+}
+
+#endif // !_UNORDERED_SET_H_
@@ -0,0 +1,525 @@
+﻿#ifndef _UNROLLED_LIST_H_
+#define _UNROLLED_LIST_H_
+
+#include "List.h"
+#include "UninitializedFunctions.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* unrolled_list : 展开链表
+	* ***********************************
+	* 每个结点保存一段连续的元素数组(最多NodeCapacity个)，结点之间沿用list_node_base的双向循环链接
+	* 中间插入只移动单个结点内的元素，结点满时一分为二；删除后结点过空时与后继结点合并
+	* 遍历时绝大多数步进只是结点内下标加一，比list逐元素追指针更快
+	*
+	* 注意：插入与删除会在结点间搬移元素，因此除被操作位置外，同一结点(及分裂/合并所涉结点)上的迭代器均会失效
+	*/
+	template<class T, size_t NodeCapacity>
+	struct unrolled_list_node : public list_node_base
+	{
+		size_t count_; // 结点中的元素个数，除头结点外恒大于0
+		alignas(T) unsigned char buf_[sizeof(T) * NodeCapacity];
+
+		T* data() { return reinterpret_cast<T*>(buf_); }
+	};
+
+	// 默认使每个结点的数据区约为256字节，且至少容纳2个元素
+	template<class T>
+	struct unrolled_list_default_capacity
+	{
+		enum : size_t { value = sizeof(T) * 2 > 256 ? 2 : 256 / sizeof(T) };
+	};
+
+	template<class T, size_t NodeCapacity, class Ref, class Ptr>
+	struct unrolled_list_iterator
+	{
+		using iterator          = unrolled_list_iterator<T, NodeCapacity, T&, T*>;
+		using const_iterator    = unrolled_list_iterator<T, NodeCapacity, const T&, const T*>;
+		using _Self             = unrolled_list_iterator<T, NodeCapacity, Ref, Ptr>;
+
+		using value_type        = T;
+		using pointer           = Ptr;
+		using reference         = Ref;
+		using size_type         = size_t;
+		using difference_type   = ptrdiff_t;
+		using iterator_category = bidirectional_iterator_tag; // 迭代器为双向迭代器
+		using _Node             = unrolled_list_node<T, NodeCapacity>;
+
+	public:
+		unrolled_list_iterator(list_node_base* Node, size_type Idx) : node_(Node), idx_(Idx) {}
+		unrolled_list_iterator() {}
+		unrolled_list_iterator(const iterator& Iter) : node_(Iter.node_), idx_(Iter.idx_) {}
+
+	public:
+		reference operator*() const { return ((_Node*)node_)->data()[idx_]; }
+		pointer operator->() const { return &(operator*()); }
+
+		_Self& operator++()
+		{	// 到达结点末尾时才转到下一个结点
+			if (++idx_ == ((_Node*)node_)->count_)
+			{
+				node_ = node_->next_;
+				idx_ = 0;
+			}
+			return *this;
+		}
+
+		_Self operator++(int)
+		{
+			_Self Tmp = *this;
+			++*this;
+			return Tmp;
+		}
+
+		_Self& operator--()
+		{
+			if (idx_ == 0)
+			{
+				node_ = node_->prev_;
+				idx_ = ((_Node*)node_)->count_;
+			}
+			--idx_;
+			return *this;
+		}
+
+		_Self operator--(int)
+		{
+			_Self Tmp = *this;
+			--*this;
+			return Tmp;
+		}
+
+		bool operator==(const _Self& Iter) const { return node_ == Iter.node_ && idx_ == Iter.idx_; }
+		bool operator!=(const _Self& Iter) const { return !(*this == Iter); }
+
+	public:
+		list_node_base* node_ = nullptr; // 所在结点，end()为头结点
+		size_type       idx_ = 0;        // 在结点数组中的下标
+	};
+
+	template<class T, size_t NodeCapacity = unrolled_list_default_capacity<T>::value, class Alloc = TinySTL::alloc>
+	class unrolled_list
+	{
+		static_assert(NodeCapacity >= 2, "unrolled_list requires NodeCapacity >= 2");
+
+	public:
+		using value_type      = T;
+		using pointer         = value_type*;
+		using const_pointer   = const value_type*;
+		using reference       = value_type&;
+		using const_reference = const value_type&;
+		using size_type       = size_t;
+		using difference_type = ptrdiff_t;
+
+		using allocator_type  = Alloc;
+		allocator_type get_allocator() const { return allocator_type(); }
+
+		using iterator               = unrolled_list_iterator<T, NodeCapacity, T&, T*>;
+		using const_iterator         = unrolled_list_iterator<T, NodeCapacity, const T&, const T*>;
+		using const_reverse_iterator = TinySTL::reverse_iterator<const_iterator>;
+		using reverse_iterator       = TinySTL::reverse_iterator<iterator>;
+
+	protected:
+		using _Node      = unrolled_list_node<T, NodeCapacity>;
+		using Alloc_type = simple_alloc<_Node, Alloc>;
+
+		// 删除后相邻两结点元素总数不超过该值时合并，留出余量以免在分裂与合并之间来回抖动
+		enum : size_t { s_mergeLimit = NodeCapacity * 3 / 4 };
+
+	public:
+		explicit unrolled_list(const allocator_type& = allocator_type()) : size_(0)
+		{
+			empty_initialize();
+		}
+		explicit unrolled_list(size_type Count, const value_type& Val = value_type()) : size_(0)
+		{
+			empty_initialize();
+			fill_insert(end(), Count, Val);
+		}
+		template<class InIt>
+		unrolled_list(InIt First, InIt Last) : size_(0)
+		{
+			empty_initialize();
+			insert(end(), First, Last);
+		}
+		unrolled_list(const unrolled_list& Other) : size_(0)
+		{
+			empty_initialize();
+			insert(end(), Other.begin(), Other.end());
+		}
+		~unrolled_list()
+		{
+			clear();
+			Alloc_type::deallocate(node_);
+		}
+
+		unrolled_list& operator=(const unrolled_list& Right);
+
+	protected:
+		void empty_initialize()
+		{	// 头结点的前后指针均指向其自身，count_为0
+			node_ = Alloc_type::allocate();
+			node_->next_ = node_;
+			node_->prev_ = node_;
+			node_->count_ = 0;
+		}
+
+		// 分配一个空结点并链入Next之前
+		_Node* create_node(list_node_base* Next)
+		{
+			_Node* Ptr = Alloc_type::allocate();
+			Ptr->count_ = 0;
+			Ptr->next_ = Next;
+			Ptr->prev_ = Next->prev_;
+			Next->prev_->next_ = Ptr;
+			Next->prev_ = Ptr;
+			return Ptr;
+		}
+
+		// 将已无元素的结点摘下并归还
+		void destroy_node(_Node* Ptr)
+		{
+			Ptr->prev_->next_ = Ptr->next_;
+			Ptr->next_->prev_ = Ptr->prev_;
+			Alloc_type::deallocate(Ptr);
+		}
+
+		// 结点内操作，调用者保证容量足够/范围合法
+		static void insert_in_node(_Node* Node, size_type Idx, const value_type& Val);
+		static void erase_in_node(_Node* Node, size_type Idx, size_type Count);
+		// 将Node的前一半元素留下，后一半搬到新建的后继结点中
+		_Node* split_node(_Node* Node);
+		// 若Node与其后继结点可以合并，则把后继的元素搬入Node并释放后继
+		bool merge_next(_Node* Node);
+
+		template<class Integer>
+		void insert_dispatch(iterator Where, Integer Count, Integer Val, true_type);
+		template<class InIt>
+		void insert_dispatch(iterator Where, InIt First, InIt Last, false_type);
+		void fill_insert(iterator Where, size_type Count, const value_type& Val);
+
+	public:
+		// Iterator:
+		iterator begin() { return iterator(node_->next_, 0); }
+		const_iterator begin() const { return const_iterator(node_->next_, 0); }
+		iterator end() { return iterator(node_, 0); }
+		const_iterator end() const { return const_iterator(node_, 0); }
+		reverse_iterator rbegin() { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+		reverse_iterator rend() { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+		const_iterator cbegin() const { return begin(); }
+		const_iterator cend() const { return end(); }
+
+		// Capacity:
+		bool empty() const { return size_ == 0; }
+		size_type size() const { return size_; }
+		size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+		// Element acces:
+		reference front() { return ((_Node*)node_->next_)->data()[0]; }
+		const_reference front() const { return ((_Node*)node_->next_)->data()[0]; }
+		reference back() { _Node* Last = (_Node*)node_->prev_; return Last->data()[Last->count_ - 1]; }
+		const_reference back() const { _Node* Last = (_Node*)node_->prev_; return Last->data()[Last->count_ - 1]; }
+
+		// Modifiers:
+		void push_front(const value_type& Val) { insert(begin(), Val); }
+		void pop_front() { erase(begin()); }
+		void push_back(const value_type& Val) { insert(end(), Val); }
+		void pop_back() { erase(--end()); }
+		iterator insert(iterator Where, const value_type& Val);
+		void insert(iterator Where, size_type Count, const value_type& Val);
+		template<class InIt>
+		void insert(iterator Where, InIt First, InIt Last);
+		iterator erase(iterator Where);
+		iterator erase(iterator First, iterator Last);
+		void swap(unrolled_list& Other);
+		void clear();
+
+		// 按结点逐段调用Func，内层为连续数组上的循环，是顺序扫描的快速路径
+		template<class Fn>
+		Fn for_each(Fn Func);
+		template<class Fn>
+		Fn for_each(Fn Func) const;
+
+	protected:
+		_Node*    node_; // 头结点
+		size_type size_; // 元素个数
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline unrolled_list<T, NodeCapacity, Alloc>& unrolled_list<T, NodeCapacity, Alloc>::operator=(const unrolled_list& Right)
+	{
+		if (this != &Right)
+		{
+			clear();
+			insert(end(), Right.begin(), Right.end());
+		}
+		return *this;
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline void unrolled_list<T, NodeCapacity, Alloc>::insert_in_node(_Node* Node, size_type Idx, const value_type& Val)
+	{
+		T* Data = Node->data();
+		size_type Count = Node->count_;
+		if (Idx == Count)
+		{
+			TinySTL::construct(Data + Count, Val);
+		}
+		else
+		{	// 末元素向后构造一份，其余[Idx, Count - 1)整体后移一位
+			TinySTL::construct(Data + Count, Data[Count - 1]);
+			TinySTL::copy_backward(Data + Idx, Data + Count - 1, Data + Count);
+			Data[Idx] = Val;
+		}
+		++Node->count_;
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline void unrolled_list<T, NodeCapacity, Alloc>::erase_in_node(_Node* Node, size_type Idx, size_type Count)
+	{
+		T* Data = Node->data();
+		T* NewEnd = TinySTL::copy(Data + Idx + Count, Data + Node->count_, Data + Idx);
+		TinySTL::destroy(NewEnd, Data + Node->count_);
+		Node->count_ -= Count;
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline typename unrolled_list<T, NodeCapacity, Alloc>::_Node*
+	unrolled_list<T, NodeCapacity, Alloc>::split_node(_Node* Node)
+	{
+		const size_type Half = Node->count_ / 2;
+		_Node* New = create_node(Node->next_);
+		T* Data = Node->data();
+		try
+		{
+			TinySTL::uninitialized_copy(Data + Half, Data + Node->count_, New->data());
+		}
+		catch (...)
+		{
+			destroy_node(New);
+			throw;
+		}
+		TinySTL::destroy(Data + Half, Data + Node->count_);
+		New->count_ = Node->count_ - Half;
+		Node->count_ = Half;
+		return New;
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline bool unrolled_list<T, NodeCapacity, Alloc>::merge_next(_Node* Node)
+	{
+		_Node* Next = (_Node*)Node->next_;
+		if (Next == node_ || Node->count_ + Next->count_ > s_mergeLimit)
+			return false;
+		TinySTL::uninitialized_copy(Next->data(), Next->data() + Next->count_, Node->data() + Node->count_);
+		TinySTL::destroy(Next->data(), Next->data() + Next->count_);
+		Node->count_ += Next->count_;
+		destroy_node(Next);
+		return true;
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline typename unrolled_list<T, NodeCapacity, Alloc>::iterator
+	unrolled_list<T, NodeCapacity, Alloc>::insert(iterator Where, const value_type& Val)
+	{
+		_Node* Node = (_Node*)Where.node_;
+		size_type Idx = Where.idx_;
+		if (Idx == 0)
+		{	// 插入位置为某结点开头或end()时，优先追加到前一结点末尾，不必移动任何元素
+			_Node* Prev = (_Node*)Node->prev_;
+			if (Prev != node_ && Prev->count_ < NodeCapacity)
+			{
+				insert_in_node(Prev, Prev->count_, Val);
+				++size_;
+				return iterator(Prev, Prev->count_ - 1);
+			}
+			if (Node == node_)
+			{	// 空表或最后一个结点已满，在末尾新建结点
+				Node = create_node(node_);
+				try
+				{
+					insert_in_node(Node, 0, Val);
+				}
+				catch (...)
+				{
+					destroy_node(Node);
+					throw;
+				}
+				++size_;
+				return iterator(Node, 0);
+			}
+		}
+
+		// Val可能引用本结点中的元素，分裂或移动前先复制一份
+		value_type Tmp(Val);
+		if (Node->count_ == NodeCapacity)
+		{
+			_Node* New = split_node(Node);
+			if (Idx > Node->count_)
+			{
+				Idx -= Node->count_;
+				Node = New;
+			}
+		}
+		insert_in_node(Node, Idx, Tmp);
+		++size_;
+		return iterator(Node, Idx);
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline void unrolled_list<T, NodeCapacity, Alloc>::fill_insert(iterator Where, size_type Count, const value_type& Val)
+	{	// 每次插入后Where前进到原位置的元素上，保持插入顺序
+		for (; Count > 0; --Count)
+		{
+			Where = insert(Where, Val);
+			++Where;
+		}
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	template<class Integer>
+	inline void unrolled_list<T, NodeCapacity, Alloc>::insert_dispatch(iterator Where, Integer Count, Integer Val, true_type)
+	{
+		fill_insert(Where, static_cast<size_type>(Count), static_cast<value_type>(Val));
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	template<class InIt>
+	inline void unrolled_list<T, NodeCapacity, Alloc>::insert_dispatch(iterator Where, InIt First, InIt Last, false_type)
+	{
+		for (; First != Last; ++First)
+		{
+			Where = insert(Where, *First);
+			++Where;
+		}
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline void unrolled_list<T, NodeCapacity, Alloc>::insert(iterator Where, size_type Count, const value_type& Val)
+	{
+		fill_insert(Where, Count, Val);
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	template<class InIt>
+	inline void unrolled_list<T, NodeCapacity, Alloc>::insert(iterator Where, InIt First, InIt Last)
+	{
+		using Integral = typename TinySTL::is_integral<InIt>::type;
+		insert_dispatch(Where, First, Last, Integral());
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline typename unrolled_list<T, NodeCapacity, Alloc>::iterator
+	unrolled_list<T, NodeCapacity, Alloc>::erase(iterator Where)
+	{
+		iterator Next = Where;
+		return erase(Where, ++Next);
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline typename unrolled_list<T, NodeCapacity, Alloc>::iterator
+	unrolled_list<T, NodeCapacity, Alloc>::erase(iterator First, iterator Last)
+	{
+		if (First == Last)
+			return Last;
+
+		// 合并结点会使Last失效，因此先数出要删除的元素个数，再逐结点成段删除
+		size_type Count = 0;
+		for (iterator Iter = First; Iter != Last; ++Iter)
+			++Count;
+		size_ -= Count;
+
+		_Node* Node = (_Node*)First.node_;
+		size_type Idx = First.idx_;
+		while (Count > 0)
+		{
+			size_type Num = TinySTL::min(Count, Node->count_ - Idx);
+			erase_in_node(Node, Idx, Num);
+			Count -= Num;
+			if (Idx == Node->count_)
+			{	// 本结点中Idx之后已无元素，转到下一个结点，空结点直接释放
+				_Node* Next = (_Node*)Node->next_;
+				if (Node->count_ == 0)
+					destroy_node(Node);
+				Node = Next;
+				Idx = 0;
+			}
+		}
+
+		// (Node, Idx)即被删区间之后的元素。尝试把它所在结点与相邻结点合并
+		_Node* Prev = Idx > 0 ? Node : (_Node*)Node->prev_;
+		if (Prev != node_)
+		{
+			size_type Offset = Prev->count_;
+			if (merge_next(Prev) && Prev != Node)
+			{
+				Node = Prev;
+				Idx = Offset;
+			}
+		}
+		return iterator(Node, Idx);
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline void unrolled_list<T, NodeCapacity, Alloc>::swap(unrolled_list& Other)
+	{
+		TinySTL::swap(node_, Other.node_);
+		TinySTL::swap(size_, Other.size_);
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline void unrolled_list<T, NodeCapacity, Alloc>::clear()
+	{
+		_Node* Cur = (_Node*)node_->next_;
+		while (Cur != node_)
+		{
+			_Node* Tmp = Cur;
+			Cur = (_Node*)Cur->next_;
+			TinySTL::destroy(Tmp->data(), Tmp->data() + Tmp->count_);
+			Alloc_type::deallocate(Tmp);
+		}
+		node_->next_ = node_;
+		node_->prev_ = node_;
+		size_ = 0;
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	template<class Fn>
+	inline Fn unrolled_list<T, NodeCapacity, Alloc>::for_each(Fn Func)
+	{
+		for (_Node* Cur = (_Node*)node_->next_; Cur != node_; Cur = (_Node*)Cur->next_)
+		{
+			T* Data = Cur->data();
+			for (size_type Idx = 0, Count = Cur->count_; Idx != Count; ++Idx)
+				Func(Data[Idx]);
+		}
+		return Func;
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	template<class Fn>
+	inline Fn unrolled_list<T, NodeCapacity, Alloc>::for_each(Fn Func) const
+	{
+		for (_Node* Cur = (_Node*)node_->next_; Cur != node_; Cur = (_Node*)Cur->next_)
+		{
+			const T* Data = Cur->data();
+			for (size_type Idx = 0, Count = Cur->count_; Idx != Count; ++Idx)
+				Func(Data[Idx]);
+		}
+		return Func;
+	}
+
+	template<class T, size_t NodeCapacity, class Alloc>
+	inline void swap(unrolled_list<T, NodeCapacity, Alloc>& Left, unrolled_list<T, NodeCapacity, Alloc>& Right)
+	{
+		Left.swap(Right);
+	}
+}
+
+#endif // !_UNROLLED_LIST_H_
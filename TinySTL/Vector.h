@@ -66,7 +66,7 @@ namespace TinySTL
 		using difference_type = ptrdiff_t;
 
 		using allocator_type  = typename base_::allocator_type;
-		allocator_type get_allocator() const { return base_::allocator_type(); }
+		allocator_type get_allocator() const { return allocator_type(); }
 
 		// 先定义const_reverse_iterator,再定义reverse_iterator,否则先定义的reverse_iterator
 		// 会将全局空间内的reverse_iterator覆盖掉,从而在定义const_reverse_iterator时,出现错误
@@ -673,13 +673,13 @@ namespace TinySTL
 	template<class T, class Alloc>
 	inline typename vector<T, Alloc>::reference vector<T, Alloc>::back()
 	{
-		return *end();
+		return *(end() - 1);
 	}
 
 	template<class T, class Alloc>
 	inline typename vector<T, Alloc>::const_reference vector<T, Alloc>::back() const
 	{
-		return *end();
+		return *(end() - 1);
 	}
 
 	template<class T, class Alloc>
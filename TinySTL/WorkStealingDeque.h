@@ -0,0 +1,207 @@
+﻿#ifndef _WORK_STEALING_DEQUE_H_
+#define _WORK_STEALING_DEQUE_H_
+
+#include <atomic>
+#include <new>
+
+#include "Alloc.h"
+#include "TypeTraits.h"
+
+namespace TinySTL
+{
+	/*
+	* ***********************************
+	* ws_deque : Chase-Lev work-stealing deque
+	* ***********************************
+	* 所有者(owner)线程在底部(bottom_)push/pop，其他线程(thief)从顶部(top_)steal
+	* 底层为可动态扩容的环形数组，扩容只由所有者线程完成
+	* 内存序参考 Lê, Pop, Cohen, Nardelli《Correct and Efficient Work-Stealing for Weak Memory Models》
+	*
+	* 元素类型要求为可平凡复制且不超过一个指针大小(通常存放任务指针)，以便使用无锁的std::atomic<T>
+	*/
+	template <class T>
+	struct ws_deque_array
+	{
+		using index_type = ptrdiff_t;
+
+		index_type          capacity_; // 容量，必为2的幂
+		index_type          mask_;     // capacity_ - 1，用于取模
+		ws_deque_array*     prev_;     // 扩容前的旧数组，thief可能仍在读取，延迟到析构时回收
+		std::atomic<T>*     buffer_;   // 环形缓冲区
+
+		T get(index_type Idx) const
+		{
+			return buffer_[Idx & mask_].load(std::memory_order_relaxed);
+		}
+
+		void put(index_type Idx, T Val)
+		{
+			buffer_[Idx & mask_].store(Val, std::memory_order_relaxed);
+		}
+	};
+
+	template <class T, class Alloc = TinySTL::alloc>
+	class ws_deque
+	{
+		static_assert(is_trivially_copyable_v<T>, "ws_deque<T> requires a trivially copyable T");
+		static_assert(sizeof(T) <= sizeof(void*), "ws_deque<T> requires a pointer-sized T");
+
+	public:
+		using value_type = T;
+		using size_type  = size_t;
+
+	private:
+		using array_type = ws_deque_array<T>;
+		using index_type = typename array_type::index_type;
+
+		// 数组头与缓冲区一次分配。最小容量保证整块内存大于alloc的小区块上限(128 bytes)，
+		// 从而直接走malloc，不会与其他线程争用alloc的free_list
+		enum { s_minCapacity = 32 };
+		enum { s_cacheLine = 64 };
+
+	public:
+		explicit ws_deque(size_type Capacity = s_minCapacity) : top_(0), bottom_(0), array_(nullptr)
+		{
+			index_type Cap = s_minCapacity;
+			while (Cap < static_cast<index_type>(Capacity))
+				Cap <<= 1;
+			array_.store(allocateArray(Cap, nullptr), std::memory_order_relaxed);
+		}
+		ws_deque(const ws_deque&) = delete;
+		ws_deque& operator=(const ws_deque&) = delete;
+		~ws_deque()
+		{
+			array_type* Cur = array_.load(std::memory_order_relaxed);
+			while (Cur)
+			{
+				array_type* Prev = Cur->prev_;
+				deallocateArray(Cur);
+				Cur = Prev;
+			}
+		}
+
+	public:
+		// 以下两个函数只允许所有者线程调用
+		void push(T Val);
+		bool pop(T& Result);
+
+		// 任意线程均可调用；队列为空或与其他线程竞争失败时返回false
+		bool steal(T& Result);
+
+		// 以下为近似值，仅供调度参考
+		bool empty() const { return size() == 0; }
+		size_type size() const
+		{
+			index_type Bottom = bottom_.load(std::memory_order_relaxed);
+			index_type Top = top_.load(std::memory_order_relaxed);
+			return Bottom > Top ? static_cast<size_type>(Bottom - Top) : 0;
+		}
+		size_type capacity() const
+		{
+			return static_cast<size_type>(array_.load(std::memory_order_relaxed)->capacity_);
+		}
+
+	private:
+		array_type* grow(array_type* Old, index_type Bottom, index_type Top);
+
+		static array_type* allocateArray(index_type Cap, array_type* Prev)
+		{
+			size_t Bytes = sizeof(array_type) + sizeof(std::atomic<T>) * static_cast<size_t>(Cap);
+			array_type* Arr = static_cast<array_type*>(Alloc::allocate(Bytes));
+			Arr->capacity_ = Cap;
+			Arr->mask_ = Cap - 1;
+			Arr->prev_ = Prev;
+			Arr->buffer_ = reinterpret_cast<std::atomic<T>*>(Arr + 1);
+			for (index_type Idx = 0; Idx < Cap; ++Idx)
+				new (static_cast<void*>(Arr->buffer_ + Idx)) std::atomic<T>();
+			return Arr;
+		}
+
+		static void deallocateArray(array_type* Arr)
+		{
+			Alloc::deallocate(Arr, sizeof(array_type) + sizeof(std::atomic<T>) * static_cast<size_t>(Arr->capacity_));
+		}
+
+	private:
+		// top_和bottom_分处不同的cache line，避免所有者与thief之间的伪共享
+		alignas(s_cacheLine) std::atomic<index_type> top_;
+		alignas(s_cacheLine) std::atomic<index_type> bottom_;
+		std::atomic<array_type*> array_;
+	};
+
+	//////////////////////////////////////////// 实现 //////////////////////////////////////////////////////////
+
+	template <class T, class Alloc>
+	inline typename ws_deque<T, Alloc>::array_type*
+	ws_deque<T, Alloc>::grow(array_type* Old, index_type Bottom, index_type Top)
+	{	// 容量翻倍，并把[Top, Bottom)复制到新数组的相同逻辑下标处
+		array_type* New = allocateArray(Old->capacity_ << 1, Old);
+		for (index_type Idx = Top; Idx != Bottom; ++Idx)
+			New->put(Idx, Old->get(Idx));
+		// 旧数组挂在新数组的prev_上，析构时统一回收
+		array_.store(New, std::memory_order_release);
+		return New;
+	}
+
+	template <class T, class Alloc>
+	inline void ws_deque<T, Alloc>::push(T Val)
+	{
+		index_type Bottom = bottom_.load(std::memory_order_relaxed);
+		index_type Top = top_.load(std::memory_order_acquire);
+		array_type* Arr = array_.load(std::memory_order_relaxed);
+		if (Bottom - Top > Arr->capacity_ - 1) // 已满
+			Arr = grow(Arr, Bottom, Top);
+		Arr->put(Bottom, Val);
+		// release保证元素(以及元素所指向的数据)的写入先于bottom_的更新对thief可见
+		bottom_.store(Bottom + 1, std::memory_order_release);
+	}
+
+	template <class T, class Alloc>
+	inline bool ws_deque<T, Alloc>::pop(T& Result)
+	{
+		index_type Bottom = bottom_.load(std::memory_order_relaxed) - 1;
+		array_type* Arr = array_.load(std::memory_order_relaxed);
+		bottom_.store(Bottom, std::memory_order_relaxed);
+		// 先"预定"底部元素，再读取top_，二者之间需要全序屏障
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		index_type Top = top_.load(std::memory_order_relaxed);
+
+		if (Top > Bottom) // 队列为空，恢复bottom_
+		{
+			bottom_.store(Bottom + 1, std::memory_order_relaxed);
+			return false;
+		}
+
+		T Val = Arr->get(Bottom);
+		if (Top == Bottom)
+		{	// 只剩最后一个元素，与thief通过CAS top_竞争
+			bool Won = top_.compare_exchange_strong(Top, Top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom_.store(Bottom + 1, std::memory_order_relaxed);
+			if (!Won)
+				return false;
+		}
+		Result = Val;
+		return true;
+	}
+
+	template <class T, class Alloc>
+	inline bool ws_deque<T, Alloc>::steal(T& Result)
+	{
+		index_type Top = top_.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		index_type Bottom = bottom_.load(std::memory_order_acquire);
+
+		if (Top >= Bottom) // 队列为空
+			return false;
+
+		// 用acquire代替consume，保证看到grow()中写入的新数组内容
+		array_type* Arr = array_.load(std::memory_order_acquire);
+		T Val = Arr->get(Top);
+		if (!top_.compare_exchange_strong(Top, Top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return false; // 被其他thief或所有者抢先
+		Result = Val;
+		return true;
+	}
+}
+
+#endif // !_WORK_STEALING_DEQUE_H_
@@ -63,7 +63,7 @@ int main()
 	//for (; iter1 != iter2; ++iter1)
 	//{
 	//	rbtite = TinySTL::_Rb_tree_base_iterator(iter1); // 向上转型没问题
-	//	std::cout << *iter1 << '(' << rbtite._M_node->_M_color << ") ";
+	//	std::cout << *iter1 << '(' << rbtite._M_node->_M_get_color() << ") ";
 	//}
 	//std::cout << std::endl;
 
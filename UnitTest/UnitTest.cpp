@@ -5,11 +5,42 @@
 #include "../TinySTL/Algorithm.h"
 #include "../TinySTL/UninitializedFunctions.h"
 #include "../TinySTL/Deque.h"
+#include "../TinySTL/WorkStealingDeque.h"
+#include "../TinySTL/List.h"
+#include "../TinySTL/UnrolledList.h"
+#include "../TinySTL/IntrusiveList.h"
+#include "../TinySTL/Slist.h"
+#include "../TinySTL/ConcurrentStack.h"
+#include "../TinySTL/Set.h"
+#include "../TinySTL/Map.h"
+#include "../TinySTL/ThreadPool.h"
+#include "../TinySTL/BtreeSet.h"
+#include "../TinySTL/BtreeMap.h"
+#include "../TinySTL/FlatSet.h"
+#include "../TinySTL/FlatMap.h"
+#include "../TinySTL/UnorderedSet.h"
+#include "../TinySTL/UnorderedMap.h"
+#include "../TinySTL/FlatHashSet.h"
+#include "../TinySTL/FlatHashMap.h"
+#include "../TinySTL/ConcurrentHashMap.h"
+#include "../TinySTL/Searcher.h"
+#include "../TinySTL/Execution.h"
+#include "../TinySTL/Numeric.h"
 
 #include <vector>
 #include <iostream>
 #include <algorithm>
+#include <numeric>
 #include <string>
+#include <thread>
+#include <atomic>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <functional>
+#include <cstring>
+#include <cmath>
+#include <stdexcept>
 
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
@@ -191,5 +222,1874 @@ namespace UnitTest
 			TinySTL::deque<int> d2(std::begin(arr2), std::end(arr2));
 			Assert::IsTrue(d1 == d2, L"Deque错误");
 		}
+
+		TEST_METHOD(TestWsDeque)
+		{
+			/*
+			* ********************************************************************
+			* test ws_deque
+			* ********************************************************************
+			*/
+			TinySTL::ws_deque<int> wsd;
+			for (int i = 0; i < 100; ++i) // 超过初始容量，触发扩容
+				wsd.push(i);
+			int Val = -1;
+			Assert::IsTrue(wsd.pop(Val) && Val == 99, L"ws_deque::pop()应从底部取出");
+			Assert::IsTrue(wsd.steal(Val) && Val == 0, L"ws_deque::steal()应从顶部取出");
+			Assert::IsTrue(wsd.size() == 98, L"ws_deque::size()错误");
+
+			// 压力测试：所有者push/pop的同时多个thief进行steal，每个元素必须恰好被取出一次
+			const int Count = 200000;
+			TinySTL::ws_deque<int> stress;
+			std::vector<std::atomic<int>> taken(Count);
+			std::atomic<bool> done(false);
+			auto thief = [&]() {
+				int x;
+				while (!done.load())
+					if (stress.steal(x))
+						taken[x].fetch_add(1);
+			};
+			std::vector<std::thread> thieves;
+			for (int i = 0; i < 3; ++i)
+				thieves.emplace_back(thief);
+			for (int i = 0; i < Count; ++i)
+			{
+				stress.push(i);
+				if (i % 3 == 0 && stress.pop(Val))
+					taken[Val].fetch_add(1);
+			}
+			while (stress.pop(Val))
+				taken[Val].fetch_add(1);
+			done.store(true);
+			for (auto& t : thieves)
+				t.join();
+			bool once = true;
+			for (int i = 0; i < Count; ++i)
+				once = once && taken[i].load() == 1;
+			Assert::IsTrue(once, L"ws_deque并发取出的元素有重复或丢失");
+		}
+
+		TEST_METHOD(TestList)
+		{
+			/*
+			* ********************************************************************
+			* test list::size() & node cache
+			* ********************************************************************
+			*/
+			int arr1[] = { 1, 4, 3, 2, 4, 6, 2, 1, 7, 2 };
+			TinySTL::list<int> list1(std::begin(arr1), std::end(arr1));
+			Assert::IsTrue(list1.size() == 10, L"list::size()错误");
+			list1.remove(2);
+			Assert::IsTrue(list1.size() == 7, L"remove()后size()错误");
+			list1.sort();
+			list1.unique();
+			Assert::IsTrue(list1.size() == 5, L"unique()后size()错误");
+
+			TinySTL::list<int> list2(3, 9);
+			list1.merge(list2);
+			Assert::IsTrue(list1.size() == 8 && list2.size() == 0, L"merge()后size()错误");
+			list2.splice(list2.end(), list1, list1.begin());
+			Assert::IsTrue(list1.size() == 7 && list2.size() == 1, L"splice()单个元素后size()错误");
+			TinySTL::list<int>::iterator it = list1.begin();
+			++it; ++it; ++it;
+			list2.splice(list2.begin(), list1, list1.begin(), it);
+			Assert::IsTrue(list1.size() == 4 && list2.size() == 4, L"splice()区间后size()错误");
+			list2.splice(list2.end(), list1);
+			Assert::IsTrue(list1.size() == 0 && list2.size() == 8, L"splice()整个list后size()错误");
+
+			// 先删后插的结点复用
+			TinySTL::list<int> lru;
+			lru.set_node_cache(4);
+			for (int i = 0; i < 8; ++i)
+				lru.push_back(i);
+			for (int i = 0; i < 6; ++i)
+				lru.pop_front();
+			Assert::IsTrue(lru.node_cache_size() == 4 && lru.size() == 2, L"结点缓存上限错误");
+			lru.push_back(8);
+			lru.push_front(9);
+			Assert::IsTrue(lru.node_cache_size() == 2 && lru.size() == 4, L"结点缓存未被复用");
+			Assert::IsTrue(lru.front() == 9 && lru.back() == 8, L"复用结点的数据错误");
+			lru.set_node_cache(0);
+			Assert::IsTrue(lru.node_cache_size() == 0, L"关闭结点缓存后未归还结点");
+		}
+
+		TEST_METHOD(TestListSort)
+		{
+			/*
+			* ********************************************************************
+			* test list::sort()
+			* ********************************************************************
+			*/
+			std::vector<int> vec1;
+			unsigned int seed = 12345;
+			for (int i = 0; i < 10007; ++i)
+			{
+				seed = seed * 1103515245u + 12345u;
+				vec1.push_back(static_cast<int>((seed >> 8) % 1000));
+			}
+			TinySTL::list<int> list1(vec1.begin(), vec1.end());
+			list1.sort();
+			std::sort(vec1.begin(), vec1.end());
+			Assert::IsTrue(list1.size() == vec1.size() && std::equal(vec1.begin(), vec1.end(), list1.begin()), L"list::sort()错误");
+
+			// 反向遍历可检验prev_是否被正确修复
+			std::vector<int> rev(vec1.rbegin(), vec1.rend());
+			std::vector<int> back;
+			for (TinySTL::list<int>::iterator it = list1.end(); it != list1.begin();)
+				back.push_back(*--it);
+			Assert::IsTrue(back == rev, L"list::sort()后prev_指针错误");
+
+			// 稳定性：按十位排序后，十位相同的元素保持原有的相对顺序
+			int arr1[] = { 31, 12, 35, 14, 33, 11, 22, 38, 17, 21 };
+			TinySTL::list<int> list2(std::begin(arr1), std::end(arr1));
+			list2.sort([](int a, int b) { return a / 10 < b / 10; });
+			std::vector<int> vec2(std::begin(arr1), std::end(arr1));
+			std::stable_sort(vec2.begin(), vec2.end(), [](int a, int b) { return a / 10 < b / 10; });
+			Assert::IsTrue(std::equal(vec2.begin(), vec2.end(), list2.begin()), L"list::sort(Pred)不稳定");
+
+			// 比较函数抛出异常后list仍然有效：元素不丢失，正反向遍历一致
+			for (int limit : { 0, 1, 5, 100, 5000 })
+			{
+				TinySTL::list<int> list3(vec1.begin(), vec1.end());
+				int calls = 0;
+				bool thrown = false;
+				try
+				{
+					list3.sort([&](int a, int b) { if (++calls > limit) throw std::runtime_error("cmp"); return a < b; });
+				}
+				catch (const std::runtime_error&)
+				{
+					thrown = true;
+				}
+				Assert::IsTrue(thrown && list3.size() == vec1.size(), L"list::sort(Pred)异常后size错误");
+				std::vector<int> fwd, bwd;
+				for (TinySTL::list<int>::iterator it = list3.begin(); it != list3.end(); ++it)
+					fwd.push_back(*it);
+				for (TinySTL::list<int>::iterator it = list3.end(); it != list3.begin();)
+					bwd.push_back(*--it);
+				Assert::IsTrue(std::equal(fwd.rbegin(), fwd.rend(), bwd.begin()) && bwd.size() == fwd.size(), L"list::sort(Pred)异常后链表损坏");
+				std::sort(fwd.begin(), fwd.end());
+				Assert::IsTrue(fwd == vec1, L"list::sort(Pred)异常后元素丢失");
+			}
+		}
+
+		TEST_METHOD(TestUnrolledList)
+		{
+			/*
+			* ********************************************************************
+			* test unrolled_list
+			* ********************************************************************
+			*/
+			// 结点容量取4，使插入/删除频繁触发结点分裂与合并
+			TinySTL::unrolled_list<std::string, 4> ulist1;
+			std::vector<std::string> vec1;
+			unsigned int seed = 2024;
+			for (int i = 0; i < 3000; ++i)
+			{
+				seed = seed * 1103515245u + 12345u;
+				size_t pos = vec1.empty() ? 0 : (seed >> 8) % (vec1.size() + 1);
+				TinySTL::unrolled_list<std::string, 4>::iterator it = ulist1.begin();
+				for (size_t k = 0; k < pos; ++k)
+					++it;
+				if ((seed >> 4) % 3 != 0 || vec1.empty())
+				{
+					std::string val = std::to_string(i);
+					it = ulist1.insert(it, val);
+					vec1.insert(vec1.begin() + pos, val);
+					Assert::IsTrue(*it == val, L"unrolled_list::insert()返回值错误");
+				}
+				else
+				{
+					if (pos == vec1.size())
+						--pos, --it;
+					size_t num = TinySTL::min<size_t>((seed >> 12) % 6 + 1, vec1.size() - pos);
+					TinySTL::unrolled_list<std::string, 4>::iterator last = it;
+					for (size_t k = 0; k < num; ++k)
+						++last;
+					it = ulist1.erase(it, last);
+					vec1.erase(vec1.begin() + pos, vec1.begin() + pos + num);
+					Assert::IsTrue(pos == vec1.size() ? it == ulist1.end() : *it == vec1[pos], L"unrolled_list::erase()返回值错误");
+				}
+				Assert::IsTrue(ulist1.size() == vec1.size(), L"unrolled_list::size()错误");
+			}
+			Assert::IsTrue(std::equal(vec1.begin(), vec1.end(), ulist1.begin()), L"unrolled_list元素顺序错误");
+			Assert::IsTrue(std::equal(vec1.rbegin(), vec1.rend(), ulist1.rbegin()), L"unrolled_list反向遍历错误");
+
+			// 插入自身元素的引用
+			ulist1.push_front(ulist1.back());
+			Assert::IsTrue(ulist1.front() == vec1.back(), L"unrolled_list插入自身元素错误");
+
+			// 拷贝、赋值与顺序扫描
+			TinySTL::unrolled_list<int> ulist2(100, 7);
+			TinySTL::unrolled_list<int> ulist3(ulist2);
+			ulist3.pop_back();
+			ulist3.pop_front();
+			int sum = 0;
+			ulist3.for_each([&sum](int v) { sum += v; });
+			Assert::IsTrue(ulist3.size() == 98 && sum == 98 * 7, L"unrolled_list::for_each()错误");
+			ulist2 = ulist3;
+			ulist2.erase(ulist2.begin(), ulist2.end());
+			Assert::IsTrue(ulist2.empty() && ulist2.begin() == ulist2.end(), L"unrolled_list::erase()全部删除错误");
+			ulist2.swap(ulist3);
+			Assert::IsTrue(ulist2.size() == 98 && ulist3.empty(), L"unrolled_list::swap()错误");
+		}
+
+		/*
+		* ********************************************************************
+		* test intrusive_list / intrusive_slist
+		* ********************************************************************
+		*/
+		struct LruTag;
+		struct FreeTag;
+		using LruHook  = TinySTL::intrusive_list_hook<LruTag>;
+		using FreeHook = TinySTL::intrusive_slist_hook<FreeTag>;
+		// 有虚函数、不是标准布局类型，两个hook都不在对象起始处
+		struct IntrusiveItem : public LruHook, public FreeHook
+		{
+			int key = 0;
+			virtual ~IntrusiveItem() {}
+			virtual int get() const { return key; }
+		};
+
+		TEST_METHOD(TestIntrusiveList)
+		{
+			IntrusiveItem items[8];
+			for (int i = 0; i < 8; ++i)
+				items[i].key = i;
+
+			// 同一对象通过不同hook同时位于两个容器中
+			TinySTL::intrusive_list<IntrusiveItem, LruTag> lru;
+			TinySTL::intrusive_slist<IntrusiveItem, FreeTag> freeList;
+			for (int i = 0; i < 8; ++i)
+			{
+				lru.push_back(items[i]);
+				freeList.push_front(items[i]);
+			}
+			Assert::IsTrue(lru.size() == 8 && freeList.size() == 8, L"intrusive_list::size()错误");
+			Assert::IsTrue(&lru.front() == &items[0] && &lru.back() == &items[7], L"intrusive_list::push_back()错误");
+			Assert::IsTrue(&freeList.front() == &items[7], L"intrusive_slist::push_front()错误");
+
+			// 按引用O(1)摘除，再移到尾部(LRU的访问操作)
+			lru.unlink(items[3]);
+			Assert::IsTrue(!items[3].LruHook::is_linked() && lru.size() == 7, L"intrusive_list::unlink()错误");
+			lru.push_back(items[3]);
+			lru.splice(lru.end(), lru, lru.iterator_to(items[0]));
+			int expect1[] = { 1, 2, 4, 5, 6, 7, 3, 0 };
+			int idx = 0;
+			for (TinySTL::intrusive_list<IntrusiveItem, LruTag>::iterator it = lru.begin(); it != lru.end(); ++it)
+				Assert::IsTrue(it->key == expect1[idx++], L"intrusive_list顺序错误");
+			Assert::IsTrue(idx == 8 && (--lru.end())->key == 0, L"intrusive_list反向链接错误");
+
+			// 跨容器splice与swap
+			TinySTL::intrusive_list<IntrusiveItem, LruTag> lru2;
+			lru2.splice(lru2.begin(), lru, lru.begin(), lru.iterator_to(items[6]));
+			Assert::IsTrue(lru.size() == 4 && lru2.size() == 4 && lru2.front().key == 1, L"intrusive_list::splice()错误");
+			lru.swap(lru2);
+			Assert::IsTrue(lru.front().key == 1 && lru2.front().key == 6 && lru2.back().key == 0, L"intrusive_list::swap()错误");
+			lru.reverse();
+			Assert::IsTrue(lru.front().key == 5 && lru.back().key == 1, L"intrusive_list::reverse()错误");
+			lru.clear();
+			Assert::IsTrue(lru.empty() && !items[1].LruHook::is_linked() && items[6].LruHook::is_linked(), L"intrusive_list::clear()错误");
+
+			// intrusive_slist
+			freeList.unlink(items[4]);
+			freeList.pop_front();
+			Assert::IsTrue(freeList.size() == 6 && freeList.front().key == 6, L"intrusive_slist::unlink()错误");
+			TinySTL::intrusive_slist<IntrusiveItem, FreeTag> freeList2;
+			freeList2.push_front(items[4]);
+			freeList2.splice_after(freeList2.begin(), freeList);
+			freeList2.reverse();
+			int expect2[] = { 0, 1, 2, 3, 5, 6, 4 };
+			idx = 0;
+			for (TinySTL::intrusive_slist<IntrusiveItem, FreeTag>::iterator it = freeList2.begin(); it != freeList2.end(); ++it)
+				Assert::IsTrue(it->key == expect2[idx++], L"intrusive_slist顺序错误");
+			Assert::IsTrue(idx == 7 && freeList2.size() == 7 && freeList.empty(), L"intrusive_slist::splice_after()错误");
+
+			// 从const引用得到迭代器，不依赖之前的插入
+			const TinySTL::intrusive_slist<IntrusiveItem, FreeTag>& cfree = freeList2;
+			Assert::IsTrue(cfree.iterator_to(items[5])->get() == 5 && &*cfree.begin() == &items[0], L"intrusive_slist::iterator_to()错误");
+		}
+
+		TEST_METHOD(TestSlist)
+		{
+			/*
+			* ********************************************************************
+			* test slist size()/back()/push_back()
+			* ********************************************************************
+			*/
+			// 作为FIFO使用：尾部追加，头部弹出
+			TinySTL::slist<int> fifo;
+			for (int i = 0; i < 100; ++i)
+			{
+				fifo.push_back(i);
+				Assert::IsTrue(fifo.back() == i && fifo.size() == static_cast<size_t>(i + 1), L"slist::push_back()错误");
+			}
+			for (int i = 0; i < 99; ++i)
+			{
+				Assert::IsTrue(fifo.front() == i, L"slist::pop_front()错误");
+				fifo.pop_front();
+			}
+			Assert::IsTrue(fifo.size() == 1 && fifo.front() == 99 && fifo.back() == 99, L"slist尾指针错误");
+			fifo.pop_front();
+			Assert::IsTrue(fifo.empty() && fifo.before_end() == fifo.before_begin(), L"slist清空后尾指针错误");
+
+			// 各种修改操作后尾指针与元素个数保持正确
+			int arr1[] = { 5, 3, 9, 1, 7 };
+			TinySTL::slist<int> slist1(std::begin(arr1), std::end(arr1));
+			slist1.insert(slist1.end(), 4);
+			Assert::IsTrue(slist1.back() == 4 && &*slist1.previous(slist1.end()) == &slist1.back(), L"slist::insert()尾部插入错误");
+			slist1.erase_after(slist1.previous(slist1.previous(slist1.end())));
+			Assert::IsTrue(slist1.size() == 5 && slist1.back() == 7, L"slist::erase_after()尾元素错误");
+			slist1.sort();
+			Assert::IsTrue(slist1.front() == 1 && slist1.back() == 9 && slist1.size() == 5, L"slist::sort()错误");
+			slist1.reverse();
+			Assert::IsTrue(slist1.front() == 9 && slist1.back() == 1, L"slist::reverse()错误");
+
+			TinySTL::slist<int> slist2(3, 0);
+			slist2.splice_after(slist2.before_end(), slist1);
+			Assert::IsTrue(slist1.empty() && slist1.size() == 0 && slist2.size() == 8 && slist2.back() == 1, L"slist::splice_after()错误");
+			slist1.push_back(42);
+			Assert::IsTrue(slist1.front() == 42 && slist1.back() == 42, L"slist splice后源链表尾指针错误");
+
+			slist2.splice(slist2.end(), slist1, slist1.begin());
+			Assert::IsTrue(slist1.empty() && slist2.back() == 42 && slist2.size() == 9, L"slist::splice()错误");
+			slist2.remove(0);
+			slist2.resize(3);
+			Assert::IsTrue(slist2.size() == 3 && slist2.back() == 5, L"slist::resize()错误");
+
+			TinySTL::slist<int> slist3;
+			slist3.push_back(2);
+			slist3.push_back(6);
+			slist3.push_back(10);
+			slist2.sort();
+			slist2.merge(slist3);
+			int expect1[] = { 2, 5, 6, 7, 9, 10 };
+			Assert::IsTrue(slist2.size() == 6 && slist3.empty() && std::equal(std::begin(expect1), std::end(expect1), slist2.begin()), L"slist::merge()错误");
+			Assert::IsTrue(slist2.back() == 10, L"slist::merge()尾指针错误");
+
+			slist2.swap(slist3);
+			slist2.push_back(1);
+			Assert::IsTrue(slist2.size() == 1 && slist3.back() == 10 && slist3.size() == 6, L"slist::swap()错误");
+			TinySTL::slist<int> slist4(slist3);
+			slist4.clear();
+			slist4.push_back(3);
+			Assert::IsTrue(slist4.size() == 1 && slist4.front() == 3, L"slist::clear()错误");
+
+			// 比较函数抛出异常后slist仍然有效：元素不丢失，size与尾指针正确
+			std::vector<int> vals;
+			for (int i = 0; i < 1000; ++i)
+				vals.push_back((i * 7919) % 1000);
+			for (int limit : { 0, 1, 5, 100, 3000 })
+			{
+				TinySTL::slist<int> slist5;
+				for (int x : vals)
+					slist5.push_back(x);
+				int calls = 0;
+				bool thrown = false;
+				try
+				{
+					slist5.sort([&](int a, int b) { if (++calls > limit) throw std::runtime_error("cmp"); return a < b; });
+				}
+				catch (const std::runtime_error&)
+				{
+					thrown = true;
+				}
+				std::vector<int> got;
+				for (TinySTL::slist<int>::iterator it = slist5.begin(); it != slist5.end(); ++it)
+					got.push_back(*it);
+				Assert::IsTrue(thrown && slist5.size() == vals.size() && got.size() == vals.size(), L"slist::sort()异常后size错误");
+				Assert::IsTrue(slist5.back() == got.back(), L"slist::sort()异常后尾指针错误");
+				slist5.push_back(-1);
+				std::sort(got.begin(), got.end());
+				std::vector<int> sortedVals(vals);
+				std::sort(sortedVals.begin(), sortedVals.end());
+				Assert::IsTrue(got == sortedVals && slist5.back() == -1 && slist5.size() == vals.size() + 1, L"slist::sort()异常后元素丢失");
+			}
+		}
+
+		TEST_METHOD(TestConcurrentStack)
+		{
+			/*
+			* ********************************************************************
+			* test concurrent_stack
+			* ********************************************************************
+			*/
+			TinySTL::concurrent_stack<std::string> stack1;
+			int val = 0;
+			Assert::IsTrue(stack1.empty(), L"concurrent_stack初始不为空");
+			for (int i = 0; i < 100; ++i)
+				stack1.push(std::to_string(i));
+			std::string str;
+			Assert::IsTrue(stack1.try_pop(str) && str == "99", L"concurrent_stack::try_pop()不是后进先出");
+			std::vector<std::string> batch;
+			size_t num = stack1.pop_all([&batch](std::string& s) { batch.push_back(s); });
+			Assert::IsTrue(num == 99 && batch.front() == "98" && batch.back() == "0" && stack1.empty(), L"concurrent_stack::pop_all()错误");
+			Assert::IsTrue(!stack1.try_pop(str), L"concurrent_stack为空时try_pop()应返回false");
+			stack1.push("left"); // 析构时应销毁未弹出的元素
+
+			// 多线程压力测试：每个值恰好被取出一次
+			const int producers = 4, consumers = 4, perProducer = 50000;
+			const int total = producers * perProducer;
+			TinySTL::concurrent_stack<int> stack2;
+			std::vector<std::atomic<int>> seen(total);
+			for (auto& s : seen)
+				s.store(0);
+			std::atomic<int> taken(0);
+			std::vector<std::thread> threads;
+			for (int p = 0; p < producers; ++p)
+			{
+				threads.emplace_back([&stack2, p, perProducer]() {
+					for (int i = 0; i < perProducer; ++i)
+						stack2.push(p * perProducer + i);
+				});
+			}
+			for (int c = 0; c < consumers; ++c)
+			{
+				threads.emplace_back([&stack2, &seen, &taken, c, total]() {
+					int v, iter = 0;
+					while (taken.load() < total)
+					{
+						if (c == 0 && (++iter & 63) == 0)
+						{
+							taken += static_cast<int>(stack2.pop_all([&seen](int& x) { seen[x].fetch_add(1); }));
+						}
+						else if (stack2.try_pop(v))
+						{
+							seen[v].fetch_add(1);
+							++taken;
+						}
+					}
+				});
+			}
+			for (auto& t : threads)
+				t.join();
+			for (int i = 0; i < total; ++i)
+				val += seen[i].load() == 1 ? 1 : 0;
+			Assert::IsTrue(val == total && stack2.empty(), L"concurrent_stack多线程下元素丢失或重复");
+		}
+
+		TEST_METHOD(TestSetMap)
+		{
+			/*
+			* ********************************************************************
+			* test set/multiset
+			* ********************************************************************
+			*/
+			TinySTL::set<int> set1;
+			TinySTL::multiset<int> mset1;
+			std::set<int> stdSet;
+			std::multiset<int> stdMset;
+			for (int i = 0; i < 2000; ++i)
+			{
+				int val = (i * 7919) % 613;
+				Assert::IsTrue(set1.insert(val).second == stdSet.insert(val).second, L"set::insert()返回值错误");
+				mset1.insert(val);
+				stdMset.insert(val);
+			}
+			Assert::IsTrue(set1.size() == stdSet.size() && std::equal(set1.begin(), set1.end(), stdSet.begin()), L"set插入后元素错误");
+			Assert::IsTrue(mset1.size() == stdMset.size() && std::equal(mset1.begin(), mset1.end(), stdMset.begin()), L"multiset插入后元素错误");
+			Assert::IsTrue(set1.__rb_verify() && mset1.__rb_verify(), L"set/multiset红黑树性质被破坏");
+			Assert::IsTrue(mset1.count(5) == stdMset.count(5) && set1.count(5) == 1 && set1.contains(612) && !set1.contains(613), L"set::count()/contains()错误");
+
+			// 按键值、单个位置与区间删除
+			for (int i = 0; i < 613; i += 3)
+			{
+				Assert::IsTrue(set1.erase(i) == stdSet.erase(i), L"set::erase(key)返回值错误");
+				mset1.erase(mset1.find(i));
+				stdMset.erase(stdMset.find(i));
+			}
+			set1.erase(set1.lower_bound(100), set1.upper_bound(200));
+			stdSet.erase(stdSet.lower_bound(100), stdSet.upper_bound(200));
+			Assert::IsTrue(set1.size() == stdSet.size() && std::equal(set1.begin(), set1.end(), stdSet.begin()), L"set::erase()后元素错误");
+			Assert::IsTrue(mset1.size() == stdMset.size() && std::equal(mset1.begin(), mset1.end(), stdMset.begin()), L"multiset::erase()后元素错误");
+			Assert::IsTrue(set1.__rb_verify() && mset1.__rb_verify(), L"删除后红黑树性质被破坏");
+
+			// 提示位置正确时插入于其前
+			TinySTL::set<int> set2;
+			for (int i = 0; i < 100; ++i)
+				set2.insert(set2.end(), i);
+			TinySTL::set<int>::iterator it = set2.insert(set2.find(50), 50);
+			Assert::IsTrue(set2.size() == 100 && *it == 50 && set2.__rb_verify(), L"set带提示插入错误");
+			TinySTL::set<int> set3(set2);
+			Assert::IsTrue(set3 == set2 && !(set3 < set2), L"set比较错误");
+			set3.erase(99);
+			Assert::IsTrue(set3 != set2 && set3 < set2, L"set比较错误");
+
+			/*
+			* ********************************************************************
+			* test map/multimap
+			* ********************************************************************
+			*/
+			TinySTL::map<int, int> map1;
+			std::map<int, int> stdMap;
+			for (int i = 0; i < 3000; ++i)
+			{
+				int key = (i * 104729) % 1021;
+				map1[key] += i;
+				stdMap[key] += i;
+			}
+			Assert::IsTrue(map1.size() == stdMap.size() && map1.__rb_verify(), L"map::operator[]错误");
+			bool same = true;
+			std::map<int, int>::iterator stdIt = stdMap.begin();
+			for (TinySTL::map<int, int>::iterator mapIt = map1.begin(); mapIt != map1.end(); ++mapIt, ++stdIt)
+				same = same && (*mapIt).first == stdIt->first && (*mapIt).second == stdIt->second;
+			Assert::IsTrue(same, L"map::operator[]元素错误");
+
+			TinySTL::map<int, std::string> map2;
+			Assert::IsTrue(map2.try_emplace(1, 3, 'a').second && map2.at(1) == "aaa", L"map::try_emplace()错误");
+			Assert::IsTrue(!map2.try_emplace(1, 3, 'b').second && map2.at(1) == "aaa", L"map::try_emplace()不应修改已有元素");
+			Assert::IsTrue(!map2.insert_or_assign(1, std::string("x")).second && map2.at(1) == "x", L"map::insert_or_assign()赋值错误");
+			Assert::IsTrue(map2.insert_or_assign(0, std::string("y")).second && map2.begin()->second == "y", L"map::insert_or_assign()插入错误");
+			map2.try_emplace(map2.end(), 5, "z");
+			map2.try_emplace(map2.begin(), 3, "w"); // 错误的提示位置
+			Assert::IsTrue(map2.size() == 4 && map2.__rb_verify() && map2.rbegin()->first == 5, L"map带提示try_emplace()错误");
+			bool thrown = false;
+			try
+			{
+				map2.at(42);
+			}
+			catch (const std::out_of_range&)
+			{
+				thrown = true;
+			}
+			Assert::IsTrue(thrown && map2.size() == 4, L"map::at()未抛出异常");
+
+			TinySTL::multimap<int, int> mmap1;
+			for (int i = 0; i < 100; ++i)
+				mmap1.insert(TinySTL::pair<const int, int>(i % 10, i));
+			Assert::IsTrue(mmap1.count(3) == 10 && mmap1.__rb_verify(), L"multimap::count()错误");
+			TinySTL::pair<TinySTL::multimap<int, int>::iterator, TinySTL::multimap<int, int>::iterator> range = mmap1.equal_range(3);
+			int order = 3;
+			for (; range.first != range.second; ++range.first, order += 10)
+				Assert::IsTrue((*range.first).second == order, L"multimap相同键值的元素应保持插入顺序");
+			Assert::IsTrue(mmap1.erase(3) == 10 && mmap1.size() == 90 && mmap1.__rb_verify(), L"multimap::erase()错误");
+		}
+
+		TEST_METHOD(TestRbtreeAssignSorted)
+		{
+			using IntTree = TinySTL::_Rb_tree<int, int, TinySTL::identity<int>, TinySTL::less<int>>;
+
+			// 各种规模下线性建树的结果均为合法的红黑树
+			std::vector<int> sorted;
+			for (int n = 0; n < 300; ++n)
+			{
+				IntTree tree1;
+				tree1.assign_sorted_equal(sorted.data(), sorted.data() + sorted.size());
+				Assert::IsTrue(tree1.size() == sorted.size() && tree1.__rb_verify(), L"assign_sorted_equal()建树不合法");
+				Assert::IsTrue(std::equal(tree1.begin(), tree1.end(), sorted.begin()), L"assign_sorted_equal()元素顺序错误");
+				sorted.push_back(n / 3); // 含重复键值
+			}
+
+			// unique版本丢弃相邻的重复键值，且会清除原有元素
+			IntTree tree2;
+			tree2.insert_unique(1000);
+			tree2.assign_sorted_unique(sorted.data(), sorted.data() + sorted.size());
+			Assert::IsTrue(tree2.size() == 100 && tree2.__rb_verify() && *tree2.begin() == 0 && *tree2.rbegin() == 99, L"assign_sorted_unique()错误");
+
+			// 建树后继续插入、删除仍保持红黑树性质
+			for (int i = 0; i < 200; i += 2)
+				tree2.insert_unique(i);
+			for (int i = 0; i < 150; i += 3)
+				tree2.erase(i);
+			Assert::IsTrue(tree2.size() == 108 && tree2.__rb_verify(), L"批量建树后插入/删除错误");
+
+			// 空容器上已排序的区间插入自动走线性路径，未排序时逐个插入
+			TinySTL::set<int> set1(sorted.data(), sorted.data() + sorted.size());
+			TinySTL::multiset<int> mset1(sorted.data(), sorted.data() + sorted.size());
+			Assert::IsTrue(set1.size() == 100 && mset1.size() == 300 && set1.__rb_verify() && mset1.__rb_verify(), L"已排序区间构造错误");
+			int arr[] = { 5, 1, 4, 1, 3 };
+			TinySTL::set<int> set2(std::begin(arr), std::end(arr));
+			Assert::IsTrue(set2.size() == 4 && *set2.begin() == 1 && set2.__rb_verify(), L"未排序区间构造错误");
+		}
+
+		TEST_METHOD(TestRbtreeNodeHandle)
+		{
+			using StrMap = TinySTL::map<int, std::string>;
+
+			StrMap map1, map2;
+			for (int i = 0; i < 100; ++i)
+				map1[i] = std::to_string(i);
+			const std::string* addr = &map1.find(42)->second;
+
+			// extract只解除链接，节点与元素保持不变
+			StrMap::node_type nh = map1.extract(42);
+			Assert::IsTrue(!nh.empty() && nh.key() == 42 && nh.mapped() == "42", L"map::extract()错误");
+			Assert::IsTrue(map1.size() == 99 && !map1.contains(42) && map1.__rb_verify(), L"map::extract()后树不合法");
+			Assert::IsTrue(map1.extract(42).empty(), L"extract()不存在的键值应返回空节点");
+
+			// 修改键值后重新插入，仍是同一个节点
+			nh.key() = 1000;
+			StrMap::insert_return_type ret = map1.insert(std::move(nh));
+			Assert::IsTrue(ret.inserted && nh.empty() && &ret.position->second == addr, L"map::insert(node_type)未复用节点");
+			Assert::IsTrue(map1.rbegin()->first == 1000 && map1.__rb_verify(), L"map::insert(node_type)错误");
+
+			// 键值重复时节点留在返回值中
+			StrMap::node_type nh2 = map1.extract(1);
+			nh2.key() = 2;
+			StrMap::insert_return_type ret2 = map1.insert(std::move(nh2));
+			Assert::IsTrue(!ret2.inserted && !ret2.node.empty() && ret2.position->first == 2 && map1.size() == 99, L"map::insert(node_type)键值重复时错误");
+			ret2.node.key() = 1;
+			StrMap::iterator it = map1.insert(map1.find(2), std::move(ret2.node));
+			Assert::IsTrue(it->first == 1 && it->second == "1" && map1.size() == 100 && map1.__rb_verify(), L"map带提示insert(node_type)错误");
+
+			// merge：键值已存在的元素留在源容器中
+			for (int i = 50; i < 150; ++i)
+				map2[i] = "x";
+			map1.merge(map2);
+			Assert::IsTrue(map1.size() == 150 && map2.size() == 50 && map2.begin()->first == 50 && map2.rbegin()->first == 99, L"map::merge()错误");
+			Assert::IsTrue(map1.at(120) == "x" && map1.at(60) == "60" && map1.__rb_verify() && map2.__rb_verify(), L"map::merge()后树不合法");
+
+			// set与multiset之间的merge
+			int arr[] = { 3, 1, 4, 1, 5, 9, 2, 6 };
+			TinySTL::multiset<int> mset1(std::begin(arr), std::end(arr));
+			TinySTL::set<int> set1(std::begin(arr), std::end(arr));
+			mset1.merge(set1);
+			Assert::IsTrue(mset1.size() == 15 && set1.empty() && mset1.count(1) == 3 && mset1.__rb_verify(), L"multiset::merge()错误");
+			set1.merge(mset1);
+			Assert::IsTrue(set1.size() == 7 && mset1.size() == 8 && set1.__rb_verify() && mset1.__rb_verify(), L"set::merge()错误");
+			TinySTL::multiset<int>::node_type nh3 = mset1.extract(mset1.find(1));
+			nh3.value() = 7;
+			Assert::IsTrue(*mset1.insert(std::move(nh3)) == 7 && mset1.size() == 8 && mset1.__rb_verify(), L"multiset::insert(node_type)错误");
+		}
+
+		TEST_METHOD(TestRbtreeRank)
+		{
+			using RankSet = TinySTL::set<int, TinySTL::less<int>, TinySTL::alloc, TinySTL::_Rb_tree_rank_augment>;
+			using RankMultimap = TinySTL::multimap<int, int, TinySTL::less<int>, TinySTL::alloc, TinySTL::_Rb_tree_rank_augment>;
+
+			// 随机插入、删除后子树大小保持正确(__rb_verify会逐个节点检验)
+			RankSet set1;
+			std::set<int> stdSet;
+			for (int i = 0; i < 3000; ++i)
+			{
+				int val = (i * 7919) % 1543;
+				if (i % 3 == 2)
+				{
+					set1.erase(val);
+					stdSet.erase(val);
+				}
+				else
+				{
+					set1.insert(val);
+					stdSet.insert(val);
+				}
+			}
+			Assert::IsTrue(set1.size() == stdSet.size() && set1.__rb_verify(), L"rank树插入/删除后子树大小错误");
+
+			std::vector<int> sorted(stdSet.begin(), stdSet.end());
+			bool same = true;
+			for (size_t k = 0; k < sorted.size(); ++k)
+			{
+				RankSet::iterator it = set1.select(k);
+				same = same && *it == sorted[k] && set1.index_of(it) == k;
+			}
+			Assert::IsTrue(same && set1.select(sorted.size()) == set1.end() && set1.index_of(set1.end()) == set1.size(), L"select()/index_of()错误");
+			for (int key = -1; key < 1545; key += 7)
+				same = same && set1.rank(key) == static_cast<size_t>(std::lower_bound(sorted.begin(), sorted.end(), key) - sorted.begin());
+			Assert::IsTrue(same, L"rank()错误");
+
+			// 批量建树、复制、merge后同样维护子树大小
+			RankSet set2(sorted.data(), sorted.data() + sorted.size());
+			RankSet set3(set2);
+			Assert::IsTrue(set2.__rb_verify() && set3.__rb_verify() && *set3.select(10) == sorted[10], L"rank树批量建树/复制错误");
+			RankSet set4;
+			for (int i = 0; i < 2000; i += 2)
+				set4.insert(i);
+			set4.merge(set3); // 奇数移入set4，偶数留在set3
+			size_t oddBelow = static_cast<size_t>(std::count_if(sorted.begin(), sorted.end(), [](int v) { return v < 1000 && v % 2 != 0; }));
+			Assert::IsTrue(set4.size() + set3.size() == 1000 + sorted.size() && set4.rank(1000) == 500 + oddBelow, L"rank树merge错误");
+			Assert::IsTrue(set4.__rb_verify() && set3.__rb_verify(), L"rank树merge后子树大小错误");
+
+			RankMultimap mmap1;
+			for (int i = 0; i < 100; ++i)
+				mmap1.insert(TinySTL::pair<const int, int>(i % 10, i));
+			TinySTL::pair<RankMultimap::iterator, RankMultimap::iterator> range = mmap1.equal_range(5);
+			Assert::IsTrue(mmap1.rank(5) == 50 && mmap1.index_of(range.second) == 60 && (*mmap1.select(55)).first == 5, L"multimap顺序统计错误");
+		}
+
+		TEST_METHOD(TestRbtreeSetOperations)
+		{
+			using IntTree = TinySTL::_Rb_tree<int, int, TinySTL::identity<int>, TinySTL::less<int>>;
+			using RankSet = TinySTL::set<int, TinySTL::less<int>, TinySTL::alloc, TinySTL::_Rb_tree_rank_augment>;
+			TinySTL::thread_pool pool(4);
+
+			// split/join：拆分后两侧及中间元素正确，再连接回原树
+			IntTree tree1, left, right;
+			for (int i = 0; i < 1000; ++i)
+				tree1.insert_unique(i * 3);
+			IntTree::node_type mid = tree1.split(300, left, right);
+			Assert::IsTrue(tree1.empty() && !mid.empty() && mid.value() == 300, L"split()中间元素错误");
+			Assert::IsTrue(left.size() == 100 && right.size() == 899 && *left.rbegin() == 297 && *right.begin() == 303, L"split()两侧错误");
+			Assert::IsTrue(left.__rb_verify() && right.__rb_verify(), L"split()后RB树不合法");
+			mid = tree1.split(301, left, right); // 不存在的键值拆分空树
+			Assert::IsTrue(mid.empty() && left.empty() && right.empty(), L"split()空树错误");
+			IntTree small1, small2;
+			small2.insert_unique(5000);
+			tree1.join(left, 300, right);
+			tree1.join(small1, 4000, small2); // 高度悬殊的两侧
+			Assert::IsTrue(tree1.size() == 2 && tree1.__rb_verify(), L"join()错误");
+			for (int i = 0; i < 1000; ++i)
+				left.insert_unique(i);
+			for (int i = 1001; i < 1010; ++i)
+				right.insert_unique(i);
+			tree1.join(left, 1000, right);
+			Assert::IsTrue(tree1.size() == 1010 && tree1.__rb_verify() && tree1.find(1000) != tree1.end() && left.empty(), L"join()错误");
+			left.insert_unique(-2);
+			right.join(left, tree1);
+			Assert::IsTrue(right.size() == 1011 && *right.begin() == -2 && right.__rb_verify(), L"无分隔元素的join()错误");
+
+			// 并、交、差与std算法的结果一致；包括规模悬殊的情形，以及超过并行阈值后在线程池上执行的情形
+			const int sizes[][2] = { { 0, 100 }, { 100, 0 }, { 50, 20000 }, { 20000, 50 }, { 3000, 3000 }, { 30000, 50000 } };
+			bool same = true;
+			for (auto& size : sizes)
+			{
+				std::vector<int> va, vb;
+				for (int i = 0; i < size[0]; ++i)
+					va.push_back(static_cast<int>(i * 7919LL % 100003));
+				for (int i = 0; i < size[1]; ++i)
+					vb.push_back(static_cast<int>(i * 104729LL % 100003));
+				std::sort(va.begin(), va.end());
+				std::sort(vb.begin(), vb.end());
+
+				for (int op = 0; op < 3; ++op)
+				{
+					RankSet a(va.data(), va.data() + va.size()), b(vb.data(), vb.data() + vb.size());
+					std::vector<int> expected;
+					if (op == 0)
+					{
+						std::set_union(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(expected));
+						a.union_(b, pool);
+					}
+					else if (op == 1)
+					{
+						std::set_intersection(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(expected));
+						a.intersection(b, pool);
+					}
+					else
+					{
+						std::set_difference(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(expected));
+						a.difference(b, pool);
+					}
+					same = same && b.empty() && a.size() == expected.size() && a.__rb_verify()
+						&& std::equal(expected.begin(), expected.end(), a.begin());
+				}
+			}
+			Assert::IsTrue(same, L"union_()/intersection()/difference()错误");
+
+			// 键值相同时保留*this中的元素
+			TinySTL::map<int, int> map1, map2;
+			for (int i = 0; i < 10; ++i)
+			{
+				map1[i] = 1;
+				map2[i + 5] = 2;
+			}
+			map1.union_(map2);
+			Assert::IsTrue(map1.size() == 15 && map1[7] == 1 && map1[12] == 2 && map2.empty(), L"map::union_()错误");
+			map1.difference(map1);
+			Assert::IsTrue(map1.empty(), L"与自身求差错误");
+		}
+
+		TEST_METHOD(TestRbtreeNodeLayout)
+		{
+			using TinySTL::_Rb_tree_node_base;
+#ifdef _TINYSTL_COMPACT_RB_TREE
+			Assert::IsTrue(sizeof(_Rb_tree_node_base) == 3 * sizeof(void*), L"紧凑布局节点大小错误");
+#else
+			Assert::IsTrue(sizeof(_Rb_tree_node_base) == 4 * sizeof(void*), L"默认布局节点大小错误");
+#endif
+			// 设置颜色不影响父节点，设置父节点不影响颜色
+			_Rb_tree_node_base parent, node;
+			node._M_set_parent(&parent);
+			node._M_set_color(TinySTL::_S_rb_tree_black);
+			Assert::IsTrue(node._M_get_parent() == &parent && node._M_get_color() == TinySTL::_S_rb_tree_black, L"颜色/父节点访问错误");
+			node._M_set_color(TinySTL::_S_rb_tree_red);
+			Assert::IsTrue(node._M_get_parent() == &parent && node._M_get_color() == TinySTL::_S_rb_tree_red, L"颜色/父节点访问错误");
+			node._M_set_color(TinySTL::_S_rb_tree_black);
+			node._M_set_parent(nullptr);
+			Assert::IsTrue(node._M_get_parent() == nullptr && node._M_get_color() == TinySTL::_S_rb_tree_black, L"颜色/父节点访问错误");
+
+			// 插入删除后树依然合法
+			TinySTL::set<int> set1;
+			for (int i = 0; i < 1000; ++i)
+				set1.insert(i * 7919 % 1000);
+			for (int i = 0; i < 1000; i += 3)
+				set1.erase(i);
+			bool same = set1.size() == 666 && set1.__rb_verify();
+			int expected = 1;
+			for (auto it = set1.begin(); it != set1.end(); ++it, ++expected)
+			{
+				if (expected % 3 == 0)
+					++expected;
+				same = same && *it == expected;
+			}
+			Assert::IsTrue(same, L"插入/删除错误");
+		}
+
+		TEST_METHOD(TestBtree)
+		{
+			// 每个节点只有3个元素，树很深，分裂、合并、借入元素都会频繁发生
+			using SmallSet = TinySTL::btree_set<int, TinySTL::less<int>, TinySTL::alloc, 16>;
+			SmallSet set1;
+			std::set<int> expected;
+			bool same = true;
+			for (int i = 0; i < 3000; ++i)
+			{
+				int key = static_cast<int>(i * 7919LL % 1009);
+				if (i % 3 == 2)
+				{
+					auto it = set1.lower_bound(key);
+					auto ex = expected.lower_bound(key);
+					if (ex != expected.end())
+					{	// erase返回被删除元素的后继
+						auto next = set1.erase(it);
+						ex = expected.erase(ex);
+						same = same && (ex == expected.end() ? next == set1.end() : *next == *ex);
+					}
+				}
+				else
+				{
+					same = same && set1.insert(key).second == expected.insert(key).second;
+				}
+				if (i % 100 == 0)
+					same = same && set1.__btree_verify() && set1.size() == expected.size()
+						&& std::equal(expected.begin(), expected.end(), set1.begin());
+			}
+			Assert::IsTrue(same && set1.__btree_verify(), L"insert()/erase()错误");
+			Assert::IsTrue(std::equal(expected.rbegin(), expected.rend(), set1.rbegin()), L"反向遍历错误");
+			for (int key = -1; key <= 1010; ++key)
+			{
+				auto lb = set1.lower_bound(key);
+				auto ub = set1.upper_bound(key);
+				auto elb = expected.lower_bound(key);
+				auto eub = expected.upper_bound(key);
+				same = same && (elb == expected.end() ? lb == set1.end() : *lb == *elb)
+					&& (eub == expected.end() ? ub == set1.end() : *ub == *eub)
+					&& set1.contains(key) == (expected.count(key) == 1);
+			}
+			Assert::IsTrue(same, L"lower_bound()/upper_bound()/find()错误");
+
+			SmallSet set2(set1);
+			Assert::IsTrue(set2 == set1 && set2.__btree_verify(), L"复制错误");
+			set2.erase(set2.lower_bound(100), set2.lower_bound(900));
+			expected.erase(expected.lower_bound(100), expected.lower_bound(900));
+			Assert::IsTrue(set2.__btree_verify() && std::equal(expected.begin(), expected.end(), set2.begin()) && set2.size() == expected.size(), L"区间erase()错误");
+			while (!set2.empty())
+				set2.erase(set2.begin());
+			Assert::IsTrue(set2.__btree_verify() && set2.begin() == set2.end(), L"逐个删除错误");
+
+			// 顺序插入使节点几乎全满；insert_equal把重复键值放在相等元素之后
+			TinySTL::_Btree<int, int, TinySTL::identity<int>, TinySTL::less<int>, TinySTL::alloc, 16> multi;
+			for (int i = 0; i < 500; ++i)
+				multi.insert_equal(multi.end(), i / 5);
+			for (int i = 0; i < 500; ++i)
+				multi.insert_equal(i % 100);
+			same = multi.__btree_verify() && multi.size() == 1000 && multi.count(7) == 10 && multi.erase(7) == 10 && multi.__btree_verify();
+			Assert::IsTrue(same && multi.count(7) == 0 && *multi.lower_bound(7) == 8, L"insert_equal()错误");
+
+			// btree_map，默认节点大小
+			TinySTL::btree_map<int, std::string> map1;
+			std::map<int, std::string> expectedMap;
+			for (int i = 0; i < 20000; ++i)
+			{
+				int key = static_cast<int>(i * 7919LL % 10007);
+				map1[key] += "a";
+				expectedMap[key] += "a";
+			}
+			same = map1.__btree_verify() && map1.size() == expectedMap.size();
+			auto it = map1.begin();
+			for (auto ex = expectedMap.begin(); same && ex != expectedMap.end(); ++ex, ++it)
+				same = (*it).first == ex->first && (*it).second == ex->second;
+			Assert::IsTrue(same && it == map1.end(), L"btree_map::operator[]错误");
+			Assert::IsTrue(map1.at(5) == expectedMap.at(5) && !map1.try_emplace(5, "b").second && map1.insert_or_assign(5, "c").first->second == "c", L"btree_map修改错误");
+			for (int key = 0; key < 10007; key += 2)
+				map1.erase(key);
+			Assert::IsTrue(map1.__btree_verify() && map1.size() == 5003 && map1.find(4) == map1.end() && map1.find(5) != map1.end(), L"btree_map::erase()错误");
+		}
+
+		TEST_METHOD(TestFlatSetMap)
+		{
+			// 无分支与普通二分的结果一致
+			std::vector<int> sorted;
+			for (int i = 0; i < 100; ++i)
+				sorted.push_back(i / 3 * 2);
+			bool same = true;
+			for (size_t n = 0; n <= sorted.size(); ++n)
+			{
+				for (int key = -1; key <= 70; ++key)
+				{
+					const int* first = sorted.data();
+					same = same
+						&& TinySTL::_Flat_lower_bound(first, n, key, TinySTL::less<int>(), TinySTL::__true_type()) == std::lower_bound(first, first + n, key)
+						&& TinySTL::_Flat_lower_bound(first, n, key, TinySTL::less<int>(), TinySTL::__false_type()) == std::lower_bound(first, first + n, key)
+						&& TinySTL::_Flat_upper_bound(first, n, key, TinySTL::less<int>(), TinySTL::__true_type()) == std::upper_bound(first, first + n, key)
+						&& TinySTL::_Flat_upper_bound(first, n, key, TinySTL::less<int>(), TinySTL::__false_type()) == std::upper_bound(first, first + n, key);
+				}
+			}
+			Assert::IsTrue(same, L"_Flat_lower_bound()/_Flat_upper_bound()错误");
+
+			// 批量插入：追加、排序、归并、去重
+			std::vector<int> input;
+			for (int i = 0; i < 5000; ++i)
+				input.push_back(static_cast<int>(i * 7919LL % 3001));
+			TinySTL::flat_set<int> set1(input.begin(), input.begin() + 2500);
+			set1.insert(input.begin() + 2500, input.end());
+			std::set<int> expected(input.begin(), input.end());
+			Assert::IsTrue(set1.size() == expected.size() && std::equal(expected.begin(), expected.end(), set1.begin()), L"flat_set::insert(first, last)错误");
+			same = !set1.insert(5).second && set1.erase(5) == 1 && set1.insert(5).second && set1.erase(-1) == 0;
+			for (int key = -1; key <= 3002; ++key)
+				same = same && set1.contains(key) == (expected.count(key) == 1)
+					&& (set1.lower_bound(key) == set1.end() ? expected.lower_bound(key) == expected.end() : *set1.lower_bound(key) == *expected.lower_bound(key));
+			Assert::IsTrue(same, L"flat_set查找错误");
+
+			// 键值与实值分开存放；键值相同时保留原有的元素，新元素之间保留靠前的一个
+			TinySTL::flat_map<int, std::string> map1;
+			map1[3] = "three";
+			map1[1] = "one";
+			TinySTL::pair<int, std::string> pairs[] = {
+				TinySTL::pair<int, std::string>(2, "two"), TinySTL::pair<int, std::string>(3, "x"),
+				TinySTL::pair<int, std::string>(0, "zero"), TinySTL::pair<int, std::string>(2, "y")
+			};
+			map1.insert(pairs, pairs + 4);
+			Assert::IsTrue(map1.size() == 4 && map1[0] == "zero" && map1[2] == "two" && map1[3] == "three", L"flat_map::insert(first, last)错误");
+			Assert::IsTrue(map1.keys()[0] == 0 && map1.keys()[3] == 3 && map1.values()[1] == "one", L"flat_map::keys()/values()错误");
+
+			int sum = 0;
+			for (auto it = map1.begin(); it != map1.end(); ++it)
+			{
+				sum += it->first;
+				it->second += "!";
+			}
+			Assert::IsTrue(sum == 6 && map1.at(1) == "one!" && (*map1.rbegin()).first == 3, L"flat_map迭代器错误");
+			Assert::IsTrue(!map1.try_emplace(1, "1").second && map1.insert_or_assign(1, "uno").first->second == "uno"
+				&& map1.erase(2) == 1 && map1.find(2) == map1.end() && map1.count(3) == 1, L"flat_map修改错误");
+			TinySTL::flat_map<int, std::string> map2(map1);
+			Assert::IsTrue(map2 == map1, L"flat_map::operator==()错误");
+			TinySTL::flat_map<int, std::string>::iterator it2 = map2.erase(map2.begin(), map2.end());
+			Assert::IsTrue(it2 == map2.end() && map2.empty(), L"flat_map::erase()错误");
+		}
+
+		TEST_METHOD(TestUnorderedContainers)
+		{
+			// 随机插入、删除，与std::unordered_map对照
+			TinySTL::unordered_map<int, int> map1;
+			std::unordered_map<int, int> ref;
+			unsigned seed = 12345;
+			for (int i = 0; i < 20000; ++i)
+			{
+				seed = seed * 1103515245 + 12345;
+				int key = static_cast<int>((seed >> 8) % 5000);
+				if (i % 3 == 2)
+					Assert::IsTrue(map1.erase(key) == ref.erase(key), L"unordered_map::erase()错误");
+				else
+				{
+					map1[key] += i;
+					ref[key] += i;
+				}
+			}
+			Assert::IsTrue(map1.size() == ref.size(), L"unordered_map::size()错误");
+			Assert::IsTrue(map1.load_factor() <= map1.max_load_factor(), L"unordered_map负载因子超过上限");
+			size_t visited = 0;
+			for (TinySTL::unordered_map<int, int>::iterator it = map1.begin(); it != map1.end(); ++it, ++visited)
+				Assert::IsTrue(ref.count((*it).first) == 1 && ref[(*it).first] == (*it).second, L"unordered_map遍历错误");
+			Assert::IsTrue(visited == ref.size(), L"unordered_map遍历元素个数错误");
+			for (int key = 0; key < 5000; ++key)
+				Assert::IsTrue(map1.count(key) == ref.count(key), L"unordered_map::count()错误");
+
+			// reserve之后的插入不会重新哈希
+			TinySTL::unordered_map<std::string, int> map2;
+			map2.reserve(1000);
+			size_t buckets = map2.bucket_count();
+			for (int i = 0; i < 1000; ++i)
+				Assert::IsTrue(map2.try_emplace(std::to_string(i), i).second, L"unordered_map::try_emplace()错误");
+			Assert::IsTrue(map2.bucket_count() == buckets, L"unordered_map::reserve()后发生了重新哈希");
+			Assert::IsTrue(!map2.try_emplace("7", 0).second && map2.at("7") == 7, L"unordered_map::try_emplace()覆盖了已有的值");
+			Assert::IsTrue(!map2.insert_or_assign("7", 70).second && map2.at("7") == 70, L"unordered_map::insert_or_assign()错误");
+			map2.rehash(5000);
+			Assert::IsTrue(map2.bucket_count() >= 5000 && map2.size() == 1000 && map2.at("999") == 999, L"unordered_map::rehash()错误");
+			TinySTL::unordered_map<std::string, int> map3(map2);
+			Assert::IsTrue(map3 == map2, L"unordered_map复制错误");
+			map3["7"] = 7;
+			Assert::IsTrue(map3 != map2, L"unordered_map::operator==()错误");
+			for (TinySTL::unordered_map<std::string, int>::iterator it = map3.begin(); it != map3.end();)
+				it = (*it).second % 2 == 0 ? map3.erase(it) : ++it;
+			Assert::IsTrue(map3.size() == 500 && !map3.contains("8") && map3.contains("9"), L"unordered_map::erase(iterator)错误");
+
+			// unordered_multimap：键值相等的元素相邻
+			TinySTL::unordered_multimap<int, int> mmap;
+			for (int i = 0; i < 300; ++i)
+				mmap.insert(TinySTL::pair<const int, int>(i % 7, i));
+			Assert::IsTrue(mmap.count(3) == 43 && mmap.count(6) == 42, L"unordered_multimap::count()错误");
+			TinySTL::pair<TinySTL::unordered_multimap<int, int>::iterator, TinySTL::unordered_multimap<int, int>::iterator> range = mmap.equal_range(3);
+			int sum = 0, n = 0;
+			for (; range.first != range.second; ++range.first, ++n)
+				sum += (*range.first).second;
+			Assert::IsTrue(n == 43 && sum == 43 * 3 + 7 * (42 * 43 / 2), L"unordered_multimap::equal_range()错误");
+			Assert::IsTrue(mmap.erase(3) == 43 && mmap.size() == 257 && mmap.find(3) == mmap.end(), L"unordered_multimap::erase()错误");
+
+			// unordered_set
+			int arr[] = { 5, 1, 9, 1, 5, 7, 3, 9 };
+			TinySTL::unordered_set<int> set1(std::begin(arr), std::end(arr));
+			TinySTL::unordered_multiset<int> set2(std::begin(arr), std::end(arr));
+			Assert::IsTrue(set1.size() == 5 && set2.size() == 8 && set2.count(9) == 2, L"unordered_set插入错误");
+			Assert::IsTrue(set1.contains(7) && !set1.contains(2) && !set1.insert(3).second, L"unordered_set查找错误");
+			int arr2[] = { 9, 3, 7, 5, 1, 9, 1, 5 };
+			TinySTL::unordered_multiset<int> set3(std::begin(arr2), std::end(arr2));
+			Assert::IsTrue(set2 == set3, L"unordered_multiset::operator==()错误");
+		}
+
+		// 可以用const char*直接查找std::string键值
+		struct TransparentStringHash
+		{
+			using is_transparent = void;
+			size_t operator()(const std::string& s) const { return TinySTL::hash<std::string>()(s); }
+			size_t operator()(const char* s) const { return TinySTL::hash<std::string>()(std::string(s)); }
+		};
+		struct TransparentStringEqual
+		{
+			using is_transparent = void;
+			bool operator()(const std::string& x, const std::string& y) const { return x == y; }
+			bool operator()(const std::string& x, const char* y) const { return x == y; }
+		};
+
+		TEST_METHOD(TestFlatHashContainers)
+		{
+			// 随机插入、删除(产生删除标记并触发同容量的重新哈希)，与std::unordered_map对照
+			TinySTL::flat_hash_map<int, int> map1;
+			std::unordered_map<int, int> ref;
+			unsigned seed = 54321;
+			for (int i = 0; i < 50000; ++i)
+			{
+				seed = seed * 1103515245 + 12345;
+				int key = static_cast<int>((seed >> 8) % 3000);
+				if (i % 2 == 1)
+					Assert::IsTrue(map1.erase(key) == ref.erase(key), L"flat_hash_map::erase()错误");
+				else
+				{
+					map1[key] += i;
+					ref[key] += i;
+				}
+			}
+			Assert::IsTrue(map1.size() == ref.size(), L"flat_hash_map::size()错误");
+			Assert::IsTrue(map1.load_factor() <= map1.max_load_factor(), L"flat_hash_map负载因子超过上限");
+			size_t visited = 0;
+			for (TinySTL::flat_hash_map<int, int>::iterator it = map1.begin(); it != map1.end(); ++it, ++visited)
+				Assert::IsTrue(ref.count(it->first) == 1 && ref[it->first] == it->second, L"flat_hash_map遍历错误");
+			Assert::IsTrue(visited == ref.size(), L"flat_hash_map遍历元素个数错误");
+			for (int key = 0; key < 3000; ++key)
+				Assert::IsTrue(map1.count(key) == ref.count(key), L"flat_hash_map::count()错误");
+
+			// 批量插入先预留空间，与reserve之后的容量相同
+			int keys[1000];
+			for (int i = 0; i < 1000; ++i)
+				keys[i] = i * 7919;
+			TinySTL::flat_hash_set<int> set1(std::begin(keys), std::end(keys));
+			TinySTL::flat_hash_set<int> set2;
+			set2.reserve(1000);
+			Assert::IsTrue(set1.size() == 1000 && set1.capacity() == set2.capacity(), L"flat_hash_set批量插入未预留空间");
+			for (int i = 999; i >= 0; --i)
+				set2.insert(keys[i]);
+			Assert::IsTrue(set1 == set2 && set2.contains(7919 * 999) && !set2.contains(1), L"flat_hash_set插入错误");
+			for (TinySTL::flat_hash_set<int>::iterator it = set2.begin(); it != set2.end();)
+				it = *it % 2 == 0 ? set2.erase(it) : ++it;
+			Assert::IsTrue(set2.size() == 500 && !set2.contains(7919 * 2) && set2.contains(7919), L"flat_hash_set::erase(iterator)错误");
+
+			// 较低的负载因子
+			TinySTL::flat_hash_set<int> set3;
+			set3.max_load_factor(0.5f);
+			set3.insert(std::begin(keys), std::end(keys));
+			Assert::IsTrue(set3.load_factor() <= 0.5f && set3 == set1, L"flat_hash_set::max_load_factor()错误");
+
+			// 过小的负载因子被限制在下限，表仍能正常增长
+			TinySTL::flat_hash_map<int, int> map4;
+			map4.max_load_factor(0.05f);
+			for (int i = 0; i < 40; ++i)
+				map4[i] = i;
+			Assert::IsTrue(map4.size() == 40 && map4.max_load_factor() == 0.125f && map4.load_factor() <= 0.125f, L"flat_hash_map::max_load_factor()下限错误");
+			map4.max_load_factor(0.0f);
+			map4.max_load_factor(-1.0f);
+			for (int i = 0; i < 40; ++i)
+				Assert::IsTrue(map4.erase(i) == 1 && map4.insert(TinySTL::make_pair(i + 40, i)).second, L"flat_hash_map::max_load_factor(0)后插入错误");
+			Assert::IsTrue(map4.size() == 40 && map4.count(79) == 1 && map4.count(0) == 0, L"flat_hash_map::max_load_factor(0)后查找错误");
+
+			// std::string键值与异构查找
+			TinySTL::flat_hash_map<std::string, int, TransparentStringHash, TransparentStringEqual> map2;
+			for (int i = 0; i < 200; ++i)
+				Assert::IsTrue(map2.try_emplace(std::to_string(i), i).second, L"flat_hash_map::try_emplace()错误");
+			Assert::IsTrue(map2.find("150") != map2.end() && map2.find("150")->second == 150 && !map2.contains("200"), L"flat_hash_map异构查找错误");
+			Assert::IsTrue(!map2.insert_or_assign("7", 70).second && map2.at("7") == 70, L"flat_hash_map::insert_or_assign()错误");
+			Assert::IsTrue(map2.erase("7") == 1 && map2.size() == 199, L"flat_hash_map异构删除错误");
+			TinySTL::flat_hash_map<std::string, int, TransparentStringHash, TransparentStringEqual> map3(map2);
+			Assert::IsTrue(map3 == map2, L"flat_hash_map复制错误");
+			map3.clear();
+			Assert::IsTrue(map3.empty() && map3.begin() == map3.end() && map3 != map2, L"flat_hash_map::clear()错误");
+		}
+
+		// 复制构造在倒数到0时抛出异常
+		struct ThrowingCopy
+		{
+			static inline int countdown = 0;
+			int value;
+			explicit ThrowingCopy(int v) : value(v) {}
+			ThrowingCopy(const ThrowingCopy& x) : value(x.value)
+			{
+				if (countdown > 0 && --countdown == 0)
+					throw std::runtime_error("copy");
+			}
+			ThrowingCopy& operator=(const ThrowingCopy& x) { value = x.value; return *this; }
+		};
+
+		TEST_METHOD(TestConcurrentHashMap)
+		{
+			/*
+			* ********************************************************************
+			* test concurrent_hash_map
+			* ********************************************************************
+			*/
+			TinySTL::concurrent_hash_map<std::string, int> map1;
+			int val = 0;
+			Assert::IsTrue(map1.empty() && !map1.find("a", val), L"concurrent_hash_map初始不为空");
+			Assert::IsTrue(map1.insert("a", 1) && !map1.insert("a", 2) && map1.find("a", val) && val == 1, L"concurrent_hash_map::insert()错误");
+			Assert::IsTrue(!map1.insert_or_assign("a", 3) && map1.find("a", val) && val == 3, L"concurrent_hash_map::insert_or_assign()错误");
+			Assert::IsTrue(map1.update_fn("a", [](int& v) { v += 10; }) && map1.find("a", val) && val == 13, L"concurrent_hash_map::update_fn()错误");
+			Assert::IsTrue(!map1.update_fn("b", [](int& v) { v = 0; }), L"concurrent_hash_map::update_fn()不应插入");
+			Assert::IsTrue(map1.erase("a") && !map1.erase("a") && !map1.contains("a") && map1.empty(), L"concurrent_hash_map::erase()错误");
+			for (int i = 0; i < 1000; ++i)
+				map1.insert_or_assign(std::to_string(i), i); // 析构时应销毁剩余元素
+			Assert::IsTrue(map1.size() == 1000 && map1.bucket_count() >= 512, L"concurrent_hash_map扩容错误");
+
+			// 多线程：各写线程修改自己的键值段，读线程同时检查读到的值总与键值一致
+			const int writers = 4, readers = 4, perWriter = 20000;
+			TinySTL::concurrent_hash_map<int, int> map2;
+			std::atomic<bool> stop(false);
+			std::atomic<int> torn(0);
+			std::vector<std::thread> threads;
+			for (int w = 0; w < writers; ++w)
+			{
+				threads.emplace_back([&map2, w, perWriter]() {
+					int base = w * perWriter;
+					for (int i = 0; i < perWriter; ++i)
+						map2.insert(base + i, (base + i) * 4);
+					for (int i = 0; i < perWriter; ++i)
+						map2.update_fn(base + i, [](int& v) { v += 1; });
+					for (int i = 0; i < perWriter; i += 2)
+						map2.erase(base + i);
+					for (int i = 1; i < perWriter; i += 2)
+						map2.insert_or_assign(base + i, (base + i) * 4 + 2);
+				});
+			}
+			for (int r = 0; r < readers; ++r)
+			{
+				threads.emplace_back([&map2, &stop, &torn, r, writers, perWriter]() {
+					int v, k = r;
+					while (!stop.load())
+					{
+						k = (k * 7 + 13) % (writers * perWriter);
+						if (map2.find(k, v) && v / 4 != k)
+							++torn;
+					}
+				});
+			}
+			for (int w = 0; w < writers; ++w)
+				threads[w].join();
+			stop.store(true);
+			for (int r = 0; r < readers; ++r)
+				threads[writers + r].join();
+			Assert::IsTrue(torn.load() == 0, L"concurrent_hash_map读到了不一致的值");
+			int correct = 0;
+			for (int k = 0; k < writers * perWriter; ++k)
+			{
+				if (k % 2 == 0)
+					correct += map2.contains(k) ? 0 : 1;
+				else
+					correct += map2.find(k, val) && val == k * 4 + 2 ? 1 : 0;
+			}
+			Assert::IsTrue(correct == writers * perWriter, L"concurrent_hash_map多线程修改结果错误");
+			Assert::IsTrue(map2.size() == static_cast<size_t>(writers * perWriter / 2), L"concurrent_hash_map多线程下元素个数错误");
+
+			// 复制值时抛出异常：迁移到一半的条带被交还，之后的写操作重新迁移，扩容最终完成
+			TinySTL::concurrent_hash_map<int, ThrowingCopy> map3;
+			int thrown = 0;
+			for (int i = 0; i < 3000; ++i)
+			{
+				if (i % 50 == 0)
+					ThrowingCopy::countdown = 7;
+				try
+				{
+					map3.insert(i, ThrowingCopy(i));
+				}
+				catch (const std::runtime_error&)
+				{
+					++thrown;
+				}
+			}
+			ThrowingCopy::countdown = 0;
+			for (int i = 0; i < 3000; ++i)
+				if (!map3.contains(i))
+					map3.insert(i, ThrowingCopy(i));
+			ThrowingCopy got(-1);
+			correct = 0;
+			for (int i = 0; i < 3000; ++i)
+				correct += map3.find(i, got) && got.value == i ? 1 : 0;
+			Assert::IsTrue(thrown > 0 && correct == 3000 && map3.size() == 3000, L"concurrent_hash_map复制抛出异常后元素错误");
+			Assert::IsTrue(map3.bucket_count() >= 2048, L"concurrent_hash_map复制抛出异常后扩容未完成");
+		}
+
+		TEST_METHOD(TestHashFunctions)
+		{
+			/*
+			* ********************************************************************
+			* test hash/hash_combine
+			* ********************************************************************
+			*/
+			constexpr size_t h1 = TinySTL::hash<int>()(1);
+			static_assert(h1 != TinySTL::hash<int>()(2), "hash<int>应可在编译期求值");
+			Assert::IsTrue(TinySTL::hash<int>()(42) == TinySTL::hash<int>()(42) && h1 != 1, L"hash<int>未经混合");
+			Assert::IsTrue(TinySTL::hash<double>()(0.0) == TinySTL::hash<double>()(-0.0), L"hash<double>(+0.0)与hash<double>(-0.0)不同");
+			Assert::IsTrue(TinySTL::hash<std::string>()("tiny") == TinySTL::hash<std::string>()(std::string("tiny")), L"hash<std::string>不确定");
+
+			// pair与hash_combine：与成员的次序有关
+			TinySTL::pair<int, int> p1(1, 2), p2(2, 1);
+			TinySTL::hash<TinySTL::pair<int, int>> pairHash;
+			Assert::IsTrue(pairHash(p1) != pairHash(p2) && pairHash(p1) == pairHash(TinySTL::pair<int, int>(1, 2)), L"hash<pair>错误");
+			size_t seed1 = 0, seed2 = 0;
+			TinySTL::hash_combine(seed1, 1);
+			TinySTL::hash_combine(seed1, std::string("a"));
+			TinySTL::hash_combine(seed2, std::string("a"));
+			TinySTL::hash_combine(seed2, 1);
+			Assert::IsTrue(seed1 != seed2 && seed1 != 0, L"hash_combine错误");
+
+			// 各种长度的字节序列：不同的内容与长度得到不同的哈希值
+			std::string text(300, 'x');
+			std::set<size_t> seen;
+			for (size_t len = 0; len <= text.size(); ++len)
+				seen.insert(TinySTL::hash<std::string>()(text.substr(0, len)));
+			Assert::IsTrue(seen.size() == text.size() + 1, L"hash<std::string>对不同长度冲突");
+
+			// 雪崩：翻转输入的任一位，输出的每一位翻转的概率都应接近1/2
+			const int samples = 1000;
+			unsigned long long state = 0x123456789ABCDEFull;
+			auto next = [&state]() { state = state * 6364136223846793005ull + 1442695040888963407ull; return state ^ (state >> 29); };
+			auto worstBias = [&](int inputBits, const std::function<unsigned long long(const unsigned char*)>& fn) {
+				double worst = 0;
+				std::vector<int> flips(64);
+				unsigned char in[32];
+				for (int bit = 0; bit < inputBits; ++bit)
+				{
+					std::fill(flips.begin(), flips.end(), 0);
+					for (int s = 0; s < samples; ++s)
+					{
+						for (int i = 0; i < 32; i += 8)
+						{
+							unsigned long long r = next();
+							std::memcpy(in + i, &r, 8);
+						}
+						unsigned long long h0 = fn(in);
+						in[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+						unsigned long long d = h0 ^ fn(in);
+						for (int o = 0; o < 64; ++o)
+							flips[o] += (d >> o) & 1;
+					}
+					for (int o = 0; o < 64; ++o)
+						worst = std::max(worst, std::abs(flips[o] / double(samples) - 0.5));
+				}
+				return worst;
+			};
+			double bias = worstBias(64, [](const unsigned char* p) {
+				unsigned long long x;
+				std::memcpy(&x, p, 8);
+				return static_cast<unsigned long long>(TinySTL::hash<unsigned long long>()(x));
+			});
+			Assert::IsTrue(bias < 0.1, L"hash<unsigned long long>雪崩效果不足");
+			for (size_t len : { 3, 8, 13, 32 })
+			{
+				bias = worstBias(static_cast<int>(len * 8), [len](const unsigned char* p) {
+					return static_cast<unsigned long long>(TinySTL::_Hash_bytes(p, len));
+				});
+				Assert::IsTrue(bias < 0.1, L"_Hash_bytes雪崩效果不足");
+			}
+		}
+
+		template<class T>
+		static void CheckFindCount(const std::vector<T>& v, T val)
+		{
+			for (size_t off = 0; off < 4 && off <= v.size(); ++off)
+			{
+				const T* first = v.data() + off;
+				const T* last = v.data() + v.size();
+				Assert::IsTrue(TinySTL::find(first, last, val) == std::find(first, last, val), L"find()结果与std::find不同");
+				Assert::IsTrue(TinySTL::count(first, last, val) == std::count(first, last, val), L"count()结果与std::count不同");
+			}
+		}
+
+		TEST_METHOD(TestSimdFind)
+		{
+			/*
+			* ********************************************************************
+			* test find/count/find_first_of on contiguous ranges
+			* ********************************************************************
+			*/
+			// 各种长度与起始偏移，命中位置分别在开头、中间、末尾或没有命中
+			for (size_t len : { 0, 1, 7, 15, 16, 17, 31, 32, 33, 64, 127, 128, 129, 300, 1000, 70000 })
+			{
+				std::vector<unsigned char> bytes(len);
+				std::vector<short> shorts(len);
+				std::vector<int> ints(len);
+				std::vector<long long> longs(len);
+				for (size_t i = 0; i < len; ++i)
+				{
+					bytes[i] = static_cast<unsigned char>(i * 7 % 251);
+					shorts[i] = static_cast<short>(i * 13 % 1009);
+					ints[i] = static_cast<int>(i * 31 % 4099);
+					longs[i] = static_cast<long long>(i % 5000) << 33;
+				}
+				CheckFindCount<unsigned char>(bytes, 0);
+				CheckFindCount<unsigned char>(bytes, 250);
+				CheckFindCount<unsigned char>(bytes, 255);
+				CheckFindCount<short>(shorts, 1008);
+				CheckFindCount<short>(shorts, -1);
+				CheckFindCount<int>(ints, 4098);
+				CheckFindCount<int>(ints, 5000);
+				CheckFindCount<long long>(longs, 4999ll << 33);
+				CheckFindCount<long long>(longs, 1); // 低32位相同、高32位不同的元素不应命中
+				if (len > 0)
+				{
+					CheckFindCount<int>(ints, ints[len - 1]);
+					CheckFindCount<long long>(longs, longs[len / 2]);
+				}
+			}
+
+			// 与元素类型不同的整数值
+			std::vector<unsigned char> bytes(100, 200);
+			bytes[60] = 44;
+			Assert::IsTrue(TinySTL::find(bytes.begin(), bytes.end(), 300) == bytes.end(), L"find()不应找到超出元素范围的值");
+			Assert::IsTrue(TinySTL::find(bytes.begin(), bytes.end(), 200) == bytes.begin() && TinySTL::count(bytes.begin(), bytes.end(), 200) == 99, L"find()/count()整数提升错误");
+			std::vector<char> chars(100, 'a');
+			chars[99] = static_cast<char>(-1);
+			Assert::IsTrue(TinySTL::find(chars.data(), chars.data() + 100, -1) == chars.data() + 99, L"find()对负值错误");
+
+			// 浮点数：NaN不等于任何值，+0.0等于-0.0
+			std::vector<double> dbls(50, 1.5);
+			dbls[10] = std::nan("");
+			dbls[40] = -0.0;
+			Assert::IsTrue(TinySTL::find(dbls.data(), dbls.data() + 50, std::nan("")) == dbls.data() + 50, L"find()不应找到NaN");
+			Assert::IsTrue(TinySTL::find(dbls.data(), dbls.data() + 50, 0.0) == dbls.data() + 40, L"find()中+0.0应等于-0.0");
+			std::vector<float> flts(70, 2.0f);
+			flts[66] = 3.0f;
+			Assert::IsTrue(TinySTL::count(flts.data(), flts.data() + 70, 2.0f) == 69, L"count()对float错误");
+
+			// 指针
+			int objs[40];
+			std::vector<int*> ptrs;
+			for (int i = 0; i < 40; ++i)
+				ptrs.push_back(objs + i);
+			Assert::IsTrue(TinySTL::find(ptrs.data(), ptrs.data() + 40, objs + 37) == ptrs.data() + 37, L"find()对指针错误");
+
+			// find_first_of：小集合、大集合与空集合
+			std::string text;
+			for (int i = 0; i < 5000; ++i)
+				text += static_cast<char>('a' + i % 20);
+			text += "xyz";
+			text += static_cast<char>(0xF0);
+			const std::string needles[] = { "", "z", "yx", "qrst", "zyx", "0123456789xy", "0123456789ABCDEFGHIJyx", std::string(1, static_cast<char>(0xF0)) };
+			for (const std::string& n : needles)
+			{
+				for (size_t off : { 0, 1, 4990, 5003 })
+				{
+					const char* first = text.data() + off;
+					const char* last = text.data() + text.size();
+					Assert::IsTrue(TinySTL::find_first_of(first, last, n.begin(), n.end()) == std::find_first_of(first, last, n.begin(), n.end()),
+						L"find_first_of()结果与std::find_first_of不同");
+				}
+			}
+			std::vector<int> ints(1000);
+			for (int i = 0; i < 1000; ++i)
+				ints[i] = i;
+			int small[] = { 2000, 999, 517 };
+			int large[20];
+			for (int i = 0; i < 20; ++i)
+				large[i] = 3000 - i * 150;
+			Assert::IsTrue(TinySTL::find_first_of(ints.begin(), ints.end(), small, small + 3) == ints.begin() + 517, L"find_first_of()对int小集合错误");
+			Assert::IsTrue(TinySTL::find_first_of(ints.begin(), ints.end(), large, large + 20) == ints.begin() + 150, L"find_first_of()对int大集合错误");
+		}
+
+		template<class T>
+		static void CheckCompare(const std::vector<T>& a, const std::vector<T>& b)
+		{
+			const T* a0 = a.data(), * a1 = a.data() + a.size();
+			const T* b0 = b.data(), * b1 = b.data() + b.size();
+			if (a.size() <= b.size())
+			{
+				Assert::IsTrue(TinySTL::mismatch(a0, a1, b0).first == std::mismatch(a0, a1, b0).first, L"mismatch()结果与std::mismatch不同");
+				Assert::AreEqual(std::equal(a0, a1, b0), TinySTL::equal(a0, a1, b0), L"equal()结果与std::equal不同");
+			}
+			Assert::IsTrue(TinySTL::mismatch(a0, a1, b0, b1).first == std::mismatch(a0, a1, b0, b1).first, L"mismatch()结果与std::mismatch不同");
+			Assert::AreEqual(std::equal(a0, a1, b0, b1), TinySTL::equal(a0, a1, b0, b1), L"equal()结果与std::equal不同");
+			Assert::AreEqual(std::lexicographical_compare(a0, a1, b0, b1), TinySTL::lexicographical_compare(a0, a1, b0, b1),
+				L"lexicographical_compare()结果与std::lexicographical_compare不同");
+			Assert::AreEqual(std::lexicographical_compare(b0, b1, a0, a1), TinySTL::lexicographical_compare(b0, b1, a0, a1, TinySTL::less<T>()),
+				L"lexicographical_compare()结果与std::lexicographical_compare不同");
+			Assert::AreEqual(std::lexicographical_compare(a0, a1, b0, b1), TinySTL::compare(a0, a1, b0, b1), L"compare()结果与std::lexicographical_compare不同");
+		}
+
+		template<class T>
+		static void CheckCompareAt(size_t len, T delta)
+		{
+			std::vector<T> a(len);
+			for (size_t i = 0; i < len; ++i)
+				a[i] = static_cast<T>(i * 37 + 11);
+			CheckCompare(a, a);
+			if (len == 0)
+				return;
+			CheckCompare(a, std::vector<T>(a.begin(), a.end() - 1)); // 一个是另一个的前缀
+			CheckCompare(std::vector<T>(a.begin(), a.end() - 1), a);
+			for (size_t pos : { size_t(0), len / 3, len / 2, len - 1 })
+			{
+				std::vector<T> b = a;
+				b[pos] = static_cast<T>(b[pos] + delta);
+				CheckCompare(a, b);
+				CheckCompare(b, a);
+			}
+		}
+
+		TEST_METHOD(TestSimdCompare)
+		{
+			/*
+			* ********************************************************************
+			* test equal/mismatch/lexicographical_compare on contiguous ranges
+			* ********************************************************************
+			*/
+			for (size_t len : { 0, 1, 3, 15, 16, 17, 31, 32, 33, 63, 64, 65, 127, 128, 129, 255, 1000, 4097 })
+			{
+				CheckCompareAt<unsigned char>(len, 1);
+				CheckCompareAt<unsigned char>(len, 200); // 差的最高位为1
+				CheckCompareAt<signed char>(len, -100); // 有符号字节不能按memcmp排序
+				CheckCompareAt<char>(len, 100);
+				CheckCompareAt<short>(len, 0x100); // 只有高位字节不同
+				CheckCompareAt<int>(len, -1);
+				CheckCompareAt<unsigned int>(len, 0x10000);
+				CheckCompareAt<long long>(len, 1ll << 40);
+			}
+
+			// 指针元素与const、非const混用
+			int arr[40];
+			std::vector<int*> p1, p2;
+			for (int i = 0; i < 40; ++i)
+				p1.push_back(arr + i);
+			p2 = p1;
+			p2[33] = arr;
+			std::vector<int> x(50, 7);
+			const std::vector<int>& cx = x;
+			std::vector<int> y(x);
+			y[45] = 8;
+			Assert::IsTrue(TinySTL::mismatch(p1.data(), p1.data() + p1.size(), p2.data()).first == p1.data() + 33, L"mismatch()没有找到不同的指针");
+			Assert::IsTrue(TinySTL::mismatch(cx.data(), cx.data() + cx.size(), y.data()).second == y.data() + 45, L"mismatch()返回的位置错误");
+			Assert::IsTrue(TinySTL::lexicographical_compare(cx.data(), cx.data() + cx.size(), y.data(), y.data() + y.size()), L"lexicographical_compare()结果错误");
+			Assert::IsFalse(TinySTL::equal(x.begin(), x.end(), y.begin()), L"equal()结果错误");
+			Assert::IsTrue(TinySTL::equal(x.begin(), x.begin() + 45, y.begin(), y.begin() + 45), L"equal()结果错误");
+			Assert::IsFalse(TinySTL::equal(x.begin(), x.begin() + 45, y.begin(), y.begin() + 44), L"equal()对长度不同的区间应返回false");
+
+			// 浮点数仍逐元素比较：-0.0与0.0相等，NaN与任何值都不相等
+			std::vector<double> d1(40, 1.0), d2(40, 1.0);
+			d1[20] = 0.0;
+			d2[20] = -0.0;
+			Assert::IsTrue(TinySTL::equal(d1.begin(), d1.end(), d2.begin()), L"equal()应认为-0.0与0.0相等");
+			d2[30] = std::nan("");
+			Assert::IsTrue(TinySTL::mismatch(d1.begin(), d1.end(), d2.begin()).first == d1.begin() + 30, L"mismatch()应在NaN处停止");
+		}
+
+		TEST_METHOD(TestSearch)
+		{
+			/*
+			* ********************************************************************
+			* test search/find_end and the searchers
+			* ********************************************************************
+			*/
+			// 小字母表上的随机文本，needle有一部分取自文本；结果应与std::search/std::find_end相同
+			unsigned seed = 12345;
+			auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return seed >> 16; };
+			for (int iter = 0; iter < 3000; ++iter)
+			{
+				const unsigned alpha = 1 + next() % 4;
+				const size_t n = next() % (iter % 10 == 0 ? 2000 : 120), m = next() % (iter % 7 == 0 ? 70 : 8);
+				std::string hay(n, 'a'), ndl(m, 'a');
+				for (char& c : hay)
+					c = static_cast<char>('a' + next() % alpha);
+				for (char& c : ndl)
+					c = static_cast<char>('a' + next() % alpha);
+				if (iter % 3 == 0 && n > m)
+					std::copy(ndl.begin(), ndl.end(), hay.begin() + next() % (n - m + 1));
+				const char* h0 = hay.data(), * h1 = hay.data() + n;
+				const char* n0 = ndl.data(), * n1 = ndl.data() + m;
+				const char* expected = std::search(h0, h1, n0, n1);
+				Assert::IsTrue(TinySTL::search(h0, h1, n0, n1) == expected, L"search()结果与std::search不同");
+				Assert::IsTrue(TinySTL::search(h0, h1, n0, n1, [](char a, char b) { return a == b; }) == expected, L"search()结果与std::search不同");
+				Assert::IsTrue(TinySTL::search(h0, h1, TinySTL::default_searcher<const char*>(n0, n1)) == expected, L"default_searcher结果错误");
+				Assert::IsTrue(TinySTL::search(h0, h1, TinySTL::boyer_moore_horspool_searcher<const char*>(n0, n1)) == expected, L"boyer_moore_horspool_searcher结果错误");
+				Assert::IsTrue(TinySTL::search(h0, h1, TinySTL::two_way_searcher<const char*>(n0, n1)) == expected, L"two_way_searcher结果错误");
+				Assert::IsTrue(TinySTL::search(h0, h1, TinySTL::simd_byte_searcher<const char*>(n0, n1)) == expected, L"simd_byte_searcher结果错误");
+				const char* last = std::find_end(h0, h1, n0, n1);
+				Assert::IsTrue(TinySTL::find_end(h0, h1, n0, n1) == last, L"find_end()结果与std::find_end不同");
+				Assert::IsTrue(TinySTL::find_end(h0, h1, n0, n1, [](char a, char b) { return a == b; }) == last, L"find_end()结果与std::find_end不同");
+
+				// 非指针的随机访问区间与多字节元素
+				TinySTL::deque<char> dq;
+				for (char c : hay)
+					dq.push_back(c);
+				Assert::IsTrue(TinySTL::search(dq.begin(), dq.end(), n0, n1) - dq.begin() == expected - h0, L"deque上的search()结果错误");
+				std::vector<int> hi(hay.begin(), hay.end()), ni(ndl.begin(), ndl.end());
+				int* i0 = hi.data() + n;
+				Assert::IsTrue(TinySTL::search(hi.data(), i0, ni.data(), ni.data() + m) - hi.data() == expected - h0, L"int区间上的search()结果错误");
+				Assert::IsTrue(TinySTL::search(hi.data(), i0, TinySTL::boyer_moore_horspool_searcher<int*>(ni.data(), ni.data() + m)) - hi.data() == expected - h0,
+					L"int区间上的boyer_moore_horspool_searcher结果错误");
+			}
+
+			// 首末字节处处相同的文本使过滤失效，应改用Two-Way
+			std::string hay(100000, 'a'), ndl(300, 'a');
+			ndl[150] = 'b';
+			Assert::IsTrue(TinySTL::search(hay.data(), hay.data() + hay.size(), ndl.data(), ndl.data() + ndl.size()) == hay.data() + hay.size(), L"search()不应找到");
+			hay[70000] = 'b';
+			Assert::IsTrue(TinySTL::search(hay.data(), hay.data() + hay.size(), ndl.data(), ndl.data() + ndl.size()) == hay.data() + 70000 - 150, L"search()结果错误");
+			hay[90000] = 'b';
+			Assert::IsTrue(TinySTL::find_end(hay.data(), hay.data() + hay.size(), ndl.data(), ndl.data() + ndl.size()) == hay.data() + 90000 - 150, L"find_end()结果错误");
+
+			// 前向迭代器与双向迭代器的find_end
+			TinySTL::slist<int> sl;
+			TinySTL::list<int> lst;
+			for (int i = 0; i < 20; ++i)
+			{
+				sl.push_front((19 - i) % 5);
+				lst.push_back(i % 5);
+			}
+			int pat[] = { 2, 3 };
+			auto sit = TinySTL::find_end(sl.begin(), sl.end(), pat, pat + 2, [](int a, int b) { return a == b; });
+			Assert::AreEqual(17, static_cast<int>(TinySTL::distance(sl.begin(), sit)), L"slist上的find_end()结果错误");
+			auto lit = TinySTL::find_end(lst.begin(), lst.end(), pat, pat + 2, [](int a, int b) { return a == b; });
+			Assert::AreEqual(17, static_cast<int>(TinySTL::distance(lst.begin(), lit)), L"list上的find_end()结果错误");
+		}
+
+		TEST_METHOD(TestParallelAlgorithms)
+		{
+			// 小粒度与独立的线程池，使各算法都真正分块执行
+			TinySTL::thread_pool pool(3);
+			const auto par = TinySTL::execution::par.with_grain(1000).on(pool);
+			unsigned seed = 3;
+			auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return seed >> 16; };
+
+			for (size_t n : { 0, 1, 999, 1000, 1001, 54321 })
+			{
+				std::vector<int> v(n), out(n), expected(n);
+				for (int& x : v)
+					x = static_cast<int>(next() % 1000);
+
+				TinySTL::transform(par, v.data(), v.data() + n, out.data(), [](int x) { return x * 3; });
+				std::transform(v.begin(), v.end(), expected.begin(), [](int x) { return x * 3; });
+				Assert::IsTrue(out == expected, L"并行transform()结果错误");
+				TinySTL::transform(TinySTL::execution::par_unseq, v.data(), v.data() + n, out.data(), out.data(), [](int x, int y) { return x + y; });
+				std::transform(v.begin(), v.end(), expected.begin(), expected.begin(), [](int x, int y) { return x + y; });
+				Assert::IsTrue(out == expected, L"并行二元transform()结果错误");
+				Assert::IsTrue(TinySTL::copy(par, v.data(), v.data() + n, out.data()) == out.data() + n && out == v, L"并行copy()结果错误");
+				TinySTL::fill(par, out.data(), out.data() + n, 7);
+				Assert::AreEqual(static_cast<std::ptrdiff_t>(n), std::count(out.begin(), out.end(), 7), L"并行fill()结果错误");
+				TinySTL::generate(par, out.data(), out.data() + n, []() { return 5; });
+				Assert::AreEqual(static_cast<std::ptrdiff_t>(n), std::count(out.begin(), out.end(), 5), L"并行generate()结果错误");
+
+				std::atomic<long long> sum(0);
+				TinySTL::for_each(par, v.data(), v.data() + n, [&sum](int x) { sum += x; });
+				long long expectedSum = 0;
+				for (int x : v)
+					expectedSum += x;
+				Assert::AreEqual(expectedSum, sum.load(), L"并行for_each()结果错误");
+				Assert::AreEqual(static_cast<std::ptrdiff_t>(std::count_if(v.begin(), v.end(), [](int x) { return x < 100; })),
+					static_cast<std::ptrdiff_t>(TinySTL::count_if(par, v.data(), v.data() + n, [](int x) { return x < 100; })), L"并行count_if()结果错误");
+
+				// 满足条件的元素分散在多个块中时应返回第一个
+				for (size_t k : { n / 5, n / 2, n - 1 })
+				{
+					if (n < 2)
+						break;
+					std::vector<int> z(n, 0);
+					z[k] = 1;
+					z[n - 1] = 1;
+					Assert::IsTrue(TinySTL::find_if(par, z.data(), z.data() + n, [](int x) { return x == 1; }) == z.data() + k, L"并行find_if()结果错误");
+					Assert::IsTrue(TinySTL::any_of(par, z.data(), z.data() + n, [](int x) { return x == 1; }), L"并行any_of()结果错误");
+					Assert::IsFalse(TinySTL::all_of(par, z.data(), z.data() + n, [](int x) { return x == 1; }), L"并行all_of()结果错误");
+					Assert::IsFalse(TinySTL::none_of(par, z.data(), z.data() + n, [](int x) { return x == 1; }), L"并行none_of()结果错误");
+					Assert::IsTrue(TinySTL::all_of(par, z.data(), z.data() + n, [](int x) { return x <= 1; }), L"并行all_of()结果错误");
+					Assert::IsFalse(TinySTL::any_of(par, z.data(), z.data() + n, [](int x) { return x > 1; }), L"并行any_of()结果错误");
+				}
+				Assert::IsTrue(TinySTL::find_if(par, v.data(), v.data() + n, [](int x) { return x < 0; }) == v.data() + n, L"并行find_if()不应找到");
+
+				expected = v;
+				std::sort(expected.begin(), expected.end());
+				TinySTL::sort(par, v.data(), v.data() + n);
+				Assert::IsTrue(v == expected, L"并行sort()结果错误");
+				TinySTL::sort(par, v.data(), v.data() + n, TinySTL::greater<int>()); // 有序输入与大量重复元素
+				std::reverse(expected.begin(), expected.end());
+				Assert::IsTrue(v == expected, L"并行sort()结果错误(降序)");
+				TinySTL::sort(TinySTL::execution::seq, v.data(), v.data() + n);
+				Assert::IsTrue(std::is_sorted(v.begin(), v.end()), L"seq策略的sort()结果错误");
+			}
+
+			// 非随机访问迭代器依次执行
+			TinySTL::list<int> lst;
+			for (int i = 0; i < 100; ++i)
+				lst.push_back(i);
+			Assert::AreEqual(50, *TinySTL::find_if(par, lst.begin(), lst.end(), [](int x) { return x == 50; }), L"list上的并行find_if()结果错误");
+
+			// 元素操作在后面的块中抛出的异常传给调用者
+			std::vector<int> big(10000);
+			big[7777] = 1;
+			bool thrown = false;
+			try
+			{
+				TinySTL::for_each(par, big.data(), big.data() + big.size(), [](int x) { if (x == 1) throw std::runtime_error("error"); });
+			}
+			catch (const std::runtime_error&)
+			{
+				thrown = true;
+			}
+			Assert::IsTrue(thrown, L"并行for_each()应抛出异常");
+		}
+
+		// 记录复制的次数，移动不计
+		struct CopyCounted
+		{
+			static inline std::atomic<int> copies{ 0 };
+			std::string s;
+			CopyCounted() {}
+			CopyCounted(const CopyCounted& x) : s(x.s) { ++copies; }
+			CopyCounted(CopyCounted&& x) noexcept : s(std::move(x.s)) {}
+			CopyCounted& operator=(const CopyCounted& x) { s = x.s; ++copies; return *this; }
+			CopyCounted& operator=(CopyCounted&& x) noexcept { s = std::move(x.s); return *this; }
+			bool operator<(const CopyCounted& x) const { return s < x.s; }
+		};
+
+		TEST_METHOD(TestParallelSort)
+		{
+			TinySTL::thread_pool pool(3);
+			const auto par = TinySTL::execution::par.with_grain(500).on(pool);
+			unsigned seed = 5;
+			auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return seed >> 16; };
+			struct Rec { int key; int idx; };
+			auto byKey = [](const Rec& a, const Rec& b) { return a.key < b.key; };
+
+			for (size_t n : { 0, 1, 40, 499, 501, 20000, 77777 })
+			{
+				// 随机、大量重复、一半为同一个值(分割元素重复)、有序、逆序
+				for (int kind = 0; kind < 5; ++kind)
+				{
+					std::vector<int> v(n);
+					for (size_t i = 0; i < n; ++i)
+						v[i] = kind == 0 ? static_cast<int>(next()) : kind == 1 ? static_cast<int>(next() % 4)
+							: kind == 2 ? (next() % 2 ? 7 : static_cast<int>(next())) : kind == 3 ? static_cast<int>(i) : static_cast<int>(n - i);
+					std::vector<int> expected = v;
+					std::sort(expected.begin(), expected.end());
+
+					std::vector<int> w = v;
+					TinySTL::sort(par, w.data(), w.data() + n);
+					Assert::IsTrue(w == expected, L"并行sort()结果错误");
+					w = v;
+					TinySTL::stable_sort(w.data(), w.data() + n);
+					Assert::IsTrue(w == expected, L"stable_sort()结果错误");
+					w = v;
+					TinySTL::stable_sort(par, w.data(), w.data() + n);
+					Assert::IsTrue(w == expected, L"并行stable_sort()结果错误");
+
+					// 稳定性：键相等的元素保持原来的次序
+					std::vector<Rec> recs(n);
+					for (size_t i = 0; i < n; ++i)
+						recs[i] = { v[i] % 16, static_cast<int>(i) };
+					std::vector<Rec> stable = recs;
+					std::stable_sort(stable.begin(), stable.end(), byKey);
+					TinySTL::stable_sort(par, recs.data(), recs.data() + n, byKey);
+					for (size_t i = 0; i < n; ++i)
+						Assert::IsTrue(recs[i].key == stable[i].key && recs[i].idx == stable[i].idx, L"并行stable_sort()不稳定");
+				}
+			}
+
+			// 不能平凡复制的元素
+			std::vector<std::string> strs(3000);
+			for (std::string& s : strs)
+				s = std::to_string(next() % 100) + "-padding-to-defeat-sso";
+			std::vector<std::string> sortedStrs = strs;
+			std::sort(sortedStrs.begin(), sortedStrs.end());
+			std::vector<std::string> s1 = strs, s2 = strs;
+			TinySTL::sort(par, s1.data(), s1.data() + s1.size());
+			TinySTL::stable_sort(par, s2.data(), s2.data() + s2.size());
+			Assert::IsTrue(s1 == sortedStrs && s2 == sortedStrs, L"std::string的并行排序结果错误");
+
+			// 粒度为1、2时归并递归到只剩单个元素
+			for (size_t grain : { 1, 2 })
+			{
+				const auto fine = TinySTL::execution::par.with_grain(grain).on(pool);
+				for (size_t n : { 2, 3, 4, 5, 17, 1000 })
+				{
+					std::vector<Rec> recs(n);
+					for (size_t i = 0; i < n; ++i)
+						recs[i] = { static_cast<int>(next() % 8), static_cast<int>(i) };
+					std::vector<Rec> stable = recs;
+					std::stable_sort(stable.begin(), stable.end(), byKey);
+					TinySTL::stable_sort(fine, recs.data(), recs.data() + n, byKey);
+					for (size_t i = 0; i < n; ++i)
+						Assert::IsTrue(recs[i].key == stable[i].key && recs[i].idx == stable[i].idx, L"小粒度的并行stable_sort()结果错误");
+					std::vector<int> w(n), expected;
+					for (size_t i = 0; i < n; ++i)
+						w[i] = static_cast<int>(i);
+					expected = w;
+					TinySTL::stable_sort(fine, w.data(), w.data() + n);
+					TinySTL::sort(fine, w.data(), w.data() + n);
+					Assert::IsTrue(w == expected, L"小粒度的并行排序结果错误");
+				}
+			}
+
+			// 临时区间以移动构造，稳定排序不复制元素
+			std::vector<CopyCounted> counted(3000);
+			for (CopyCounted& c : counted)
+				c.s = std::to_string(next() % 100) + "-padding-to-defeat-sso";
+			CopyCounted::copies = 0;
+			TinySTL::stable_sort(counted.data(), counted.data() + counted.size());
+			TinySTL::stable_sort(par, counted.data(), counted.data() + counted.size(), [](const CopyCounted& x, const CopyCounted& y) { return y < x; });
+			Assert::AreEqual(0, CopyCounted::copies.load(), L"stable_sort()不应复制元素");
+			Assert::IsTrue(std::is_sorted(counted.rbegin(), counted.rend()), L"stable_sort()结果错误");
+
+			// 多个线程同时排序各自的数据：临时区间不经过alloc的空闲链表
+			std::vector<std::thread> sorters;
+			std::atomic<int> sortErrors(0);
+			for (int t = 0; t < 4; ++t)
+			{
+				sorters.emplace_back([&pool, &sortErrors, t]() {
+					const auto tpar = TinySTL::execution::par.with_grain(64).on(pool);
+					unsigned st = 100 + t;
+					for (int round = 0; round < 200; ++round)
+					{
+						std::vector<short> x(60 + round % 40);
+						for (short& e : x)
+						{
+							st = st * 1103515245u + 12345u;
+							e = static_cast<short>(st >> 20);
+						}
+						std::vector<short> y = x, a = x, b = x;
+						std::sort(y.begin(), y.end());
+						TinySTL::stable_sort(a.data(), a.data() + a.size());
+						TinySTL::sort(tpar, b.data(), b.data() + b.size());
+						if (a != y || b != y)
+							++sortErrors;
+					}
+				});
+			}
+			for (std::thread& th : sorters)
+				th.join();
+			Assert::AreEqual(0, sortErrors.load(), L"多个线程同时排序结果错误");
+
+			int a[] = { 1, 3, 3, 5, 7 }, b[] = { 2, 3, 6 }, merged[8];
+			TinySTL::merge(a, a + 5, b, b + 3, merged);
+			int expectedMerged[] = { 1, 2, 3, 3, 3, 5, 6, 7 };
+			Assert::IsTrue(std::equal(merged, merged + 8, expectedMerged), L"merge()结果错误");
+			Assert::IsTrue(TinySTL::lower_bound(a, a + 5, 3) == a + 1 && TinySTL::upper_bound(a, a + 5, 3) == a + 3, L"lower_bound()/upper_bound()结果错误");
+			Assert::IsTrue(TinySTL::lower_bound(a, a + 5, 8) == a + 5 && TinySTL::upper_bound(a, a + 5, 0) == a, L"lower_bound()/upper_bound()结果错误");
+		}
+
+		TEST_METHOD(TestNumeric)
+		{
+			TinySTL::thread_pool pool(3);
+			const auto par = TinySTL::execution::par.with_grain(300).on(pool);
+			unsigned seed = 9;
+			auto next = [&seed]() { seed = seed * 1103515245u + 12345u; return seed >> 16; };
+
+			for (size_t n : { 0, 1, 7, 8, 9, 300, 301, 5000 })
+			{
+				std::vector<int> v(n);
+				std::vector<unsigned> u(n);
+				std::vector<double> d(n), e(n); // 八分之一的倍数，和与累加次序无关
+				for (size_t i = 0; i < n; ++i)
+				{
+					v[i] = static_cast<int>(next() % 2001) - 1000;
+					u[i] = next() * 65536u + next();
+					d[i] = (next() % 1000) / 8.0;
+					e[i] = (next() % 1000) / 8.0;
+				}
+				std::vector<long long> vl(v.begin(), v.end());
+				long long sum = 0, square = 0;
+				unsigned usum = 0;
+				double dsum = 0, dot = 0;
+				for (size_t i = 0; i < n; ++i)
+				{
+					sum += v[i];
+					square += static_cast<long long>(v[i]) * v[i];
+					usum += u[i];
+					dsum += d[i];
+					dot += d[i] * e[i];
+				}
+
+				Assert::AreEqual(static_cast<int>(sum + 3), TinySTL::accumulate(v.data(), v.data() + n, 3), L"accumulate()结果错误");
+				Assert::AreEqual(usum, TinySTL::accumulate(u.data(), u.data() + n, 0u), L"accumulate()无符号回绕结果错误");
+				Assert::AreEqual(sum, TinySTL::accumulate(v.begin(), v.end(), 0LL), L"accumulate()结果错误");
+				Assert::AreEqual(square, TinySTL::inner_product(v.data(), v.data() + n, v.data(), 0LL), L"inner_product()结果错误");
+				Assert::AreEqual(static_cast<int>(sum), TinySTL::reduce(v.data(), v.data() + n), L"reduce()结果错误");
+				Assert::AreEqual(usum, TinySTL::reduce(u.data(), u.data() + n, 0u), L"reduce()无符号回绕结果错误");
+				Assert::AreEqual(dsum, TinySTL::reduce(d.data(), d.data() + n, 0.0), L"reduce()浮点结果错误");
+				Assert::AreEqual(dot + 1, TinySTL::transform_reduce(d.data(), d.data() + n, e.data(), 1.0), L"transform_reduce()点积结果错误");
+				Assert::AreEqual(square, TinySTL::transform_reduce(v.begin(), v.end(), 0LL, TinySTL::plus<long long>(),
+					[](int x) { return static_cast<long long>(x) * x; }), L"transform_reduce()结果错误");
+
+				Assert::AreEqual(sum + 5, TinySTL::reduce(par, v.data(), v.data() + n, 5LL), L"并行reduce()结果错误");
+				Assert::AreEqual(dsum, TinySTL::reduce(par, d.data(), d.data() + n, 0.0), L"并行reduce()浮点结果错误");
+				Assert::AreEqual(dot + 1, TinySTL::transform_reduce(par, d.data(), d.data() + n, e.data(), 1.0), L"并行transform_reduce()结果错误");
+				Assert::AreEqual(square, TinySTL::transform_reduce(par, v.data(), v.data() + n, 0LL, TinySTL::plus<long long>(),
+					[](int x) { return static_cast<long long>(x) * x; }), L"并行transform_reduce()结果错误");
+
+				// 扫描：与std结果比较，并行版本也可以原地扫描
+				std::vector<long long> expected(n), out(n);
+				std::partial_sum(vl.begin(), vl.end(), expected.begin());
+				TinySTL::partial_sum(vl.begin(), vl.end(), out.begin());
+				Assert::IsTrue(out == expected, L"partial_sum()结果错误");
+				std::fill(out.begin(), out.end(), 0);
+				Assert::IsTrue(TinySTL::inclusive_scan(par, vl.data(), vl.data() + n, out.data()) == out.data() + n && out == expected, L"并行inclusive_scan()结果错误");
+				out = vl;
+				TinySTL::inclusive_scan(par, out.data(), out.data() + n, out.data());
+				Assert::IsTrue(out == expected, L"原地并行inclusive_scan()结果错误");
+				std::exclusive_scan(vl.begin(), vl.end(), expected.begin(), 10LL);
+				TinySTL::exclusive_scan(vl.begin(), vl.end(), out.begin(), 10LL);
+				Assert::IsTrue(out == expected, L"exclusive_scan()结果错误");
+				out = vl;
+				TinySTL::exclusive_scan(par, out.data(), out.data() + n, out.data(), 10LL);
+				Assert::IsTrue(out == expected, L"原地并行exclusive_scan()结果错误");
+				std::adjacent_difference(vl.begin(), vl.end(), expected.begin());
+				TinySTL::adjacent_difference(vl.begin(), vl.end(), out.begin());
+				Assert::IsTrue(out == expected, L"adjacent_difference()结果错误");
+
+				// 只满足结合律的运算：字符串拼接保持次序
+				std::vector<std::string> strs(n), scanned(n), expectedStrs(n);
+				for (size_t i = 0; i < n; ++i)
+					strs[i] = std::string(1, static_cast<char>('a' + i % 26));
+				std::inclusive_scan(strs.begin(), strs.end(), expectedStrs.begin());
+				const std::string* cstrs = strs.data();
+				TinySTL::inclusive_scan(par, cstrs, cstrs + n, scanned.data(), TinySTL::plus<std::string>());
+				Assert::IsTrue(scanned == expectedStrs, L"并行inclusive_scan()次序错误");
+			}
+
+			// 多个线程同时并行扫描：各块之和的临时区间不经过alloc的空闲链表
+			std::vector<std::thread> scanners;
+			std::atomic<int> scanErrors(0);
+			for (int t = 0; t < 4; ++t)
+			{
+				scanners.emplace_back([&pool, &scanErrors, t]() {
+					const auto tpar = TinySTL::execution::par.with_grain(50).on(pool);
+					for (int round = 0; round < 200; ++round)
+					{
+						std::vector<long long> x(100 + round % 300 + t), y(x.size()), z(x.size());
+						for (size_t i = 0; i < x.size(); ++i)
+							x[i] = static_cast<long long>(i) * (t + 1);
+						std::partial_sum(x.begin(), x.end(), y.begin());
+						TinySTL::inclusive_scan(tpar, x.data(), x.data() + x.size(), z.data());
+						if (y != z)
+							++scanErrors;
+					}
+				});
+			}
+			for (std::thread& th : scanners)
+				th.join();
+			Assert::AreEqual(0, scanErrors.load(), L"多个线程同时并行扫描结果错误");
+		}
 	};
 }